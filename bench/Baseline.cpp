@@ -0,0 +1,387 @@
+#include "Baseline.hpp"
+
+#include "common/Errors.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <iterator>
+
+namespace VkTest1::Bench
+{
+
+namespace
+{
+
+// Reads JSON token by token. Just enough for the baselines.
+class JsonReader
+{
+public:
+    explicit JsonReader(std::string_view text) :
+        m_text{ text }
+    {
+    }
+
+    // Consumes c if it is the next character after whitespace.
+    bool consume(char c)
+    {
+        skipWhitespace();
+        if (m_position != m_text.size() && m_text[m_position] == c)
+        {
+            ++m_position;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!consume(c))
+        {
+            fail(std::format("'{}' expected", c));
+        }
+    }
+
+    bool isAtEnd()
+    {
+        skipWhitespace();
+        return m_position == m_text.size();
+    }
+
+    std::string readString()
+    {
+        expect('"');
+        std::string string{};
+        for (;;)
+        {
+            const auto c{ next() };
+            if (c == '"')
+            {
+                return string;
+            }
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                fail("Control character in string");
+            }
+            if (c != '\\')
+            {
+                string += c;
+                continue;
+            }
+            switch (const auto escaped{ next() })
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    string += escaped;
+                    break;
+                case 'b':
+                    string += '\b';
+                    break;
+                case 'f':
+                    string += '\f';
+                    break;
+                case 'n':
+                    string += '\n';
+                    break;
+                case 'r':
+                    string += '\r';
+                    break;
+                case 't':
+                    string += '\t';
+                    break;
+                case 'u':
+                    appendUtf8(string, readCodeUnit());
+                    break;
+                default:
+                    fail("Invalid escape sequence");
+            }
+        }
+    }
+
+    double readNumber()
+    {
+        skipWhitespace();
+        const auto* const begin{ m_text.data() + m_position };
+        const auto* const end{ m_text.data() + m_text.size() };
+        double number{};
+        const auto [numberEnd, ec] = std::from_chars(begin, end, number);
+        if (ec != std::errc{})
+        {
+            fail("Number expected");
+        }
+        m_position += static_cast<std::size_t>(numberEnd - begin);
+        return number;
+    }
+
+    void skipValue()
+    {
+        skipWhitespace();
+        if (m_position == m_text.size())
+        {
+            fail("Value expected");
+        }
+        switch (m_text[m_position])
+        {
+            case '"':
+                readString();
+                break;
+            case '{':
+                expect('{');
+                if (!consume('}'))
+                {
+                    do
+                    {
+                        readString();
+                        expect(':');
+                        skipValue();
+                    } while (consume(','));
+                    expect('}');
+                }
+                break;
+            case '[':
+                expect('[');
+                if (!consume(']'))
+                {
+                    do
+                    {
+                        skipValue();
+                    } while (consume(','));
+                    expect(']');
+                }
+                break;
+            case 't':
+                skipLiteral("true");
+                break;
+            case 'f':
+                skipLiteral("false");
+                break;
+            case 'n':
+                skipLiteral("null");
+                break;
+            default:
+                readNumber();
+        }
+    }
+
+    [[noreturn]] void fail(std::string_view message) const
+    {
+        throw Common::FormatError{ std::format("Invalid baseline: {} at offset {}.", message, m_position) };
+    }
+
+private:
+    void skipWhitespace()
+    {
+        while (m_position != m_text.size() &&
+               (m_text[m_position] == ' ' || m_text[m_position] == '\t' || m_text[m_position] == '\n' ||
+                m_text[m_position] == '\r'))
+        {
+            ++m_position;
+        }
+    }
+
+    char next()
+    {
+        if (m_position == m_text.size())
+        {
+            fail("Unexpected end");
+        }
+        return m_text[m_position++];
+    }
+
+    void skipLiteral(std::string_view literal)
+    {
+        if (!m_text.substr(m_position).starts_with(literal))
+        {
+            fail("Value expected");
+        }
+        m_position += literal.size();
+    }
+
+    std::uint32_t readCodeUnit()
+    {
+        if (m_text.size() - m_position < 4)
+        {
+            fail("Unexpected end");
+        }
+        std::uint32_t codeUnit{};
+        const auto* const begin{ m_text.data() + m_position };
+        const auto [end, ec] = std::from_chars(begin, begin + 4, codeUnit, 16);
+        if (ec != std::errc{} || end != begin + 4)
+        {
+            fail("Invalid escape sequence");
+        }
+        m_position += 4;
+        return codeUnit;
+    }
+
+    // Surrogate pairs are not combined. The names are ASCII anyway.
+    static void appendUtf8(std::string& string, std::uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            string += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            string += static_cast<char>(0xC0 | (codePoint >> 6));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            string += static_cast<char>(0xE0 | (codePoint >> 12));
+            string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    std::string_view m_text;
+    std::size_t m_position{ 0 };
+};
+
+std::string quote(std::string_view string)
+{
+    std::string quoted{ "\"" };
+    for (const auto c : string)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            std::format_to(std::back_inserter(quoted), "\\u{:04x}", static_cast<unsigned int>(c));
+        }
+        else
+        {
+            quoted += c;
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+BenchmarkResult readResult(JsonReader& reader)
+{
+    BenchmarkResult result{};
+    auto hasName{ false };
+    auto hasMedian{ false };
+    reader.expect('{');
+    if (!reader.consume('}'))
+    {
+        do
+        {
+            const auto key{ reader.readString() };
+            reader.expect(':');
+            if (key == "name")
+            {
+                result.name = reader.readString();
+                hasName = true;
+            }
+            else if (key == "bytes_per_iteration")
+            {
+                result.bytesPerIteration = static_cast<std::uint64_t>(reader.readNumber());
+            }
+            else if (key == "iterations")
+            {
+                result.iterationCount = static_cast<std::uint64_t>(reader.readNumber());
+            }
+            else if (key == "repetitions")
+            {
+                result.repetitionCount = static_cast<unsigned int>(reader.readNumber());
+            }
+            else if (key == "min_ns")
+            {
+                result.min = reader.readNumber();
+            }
+            else if (key == "median_ns")
+            {
+                result.median = reader.readNumber();
+                hasMedian = true;
+            }
+            else if (key == "mean_ns")
+            {
+                result.mean = reader.readNumber();
+            }
+            else if (key == "stddev_ns")
+            {
+                result.standardDeviation = reader.readNumber();
+            }
+            else
+            {
+                reader.skipValue();
+            }
+        } while (reader.consume(','));
+        reader.expect('}');
+    }
+    // The comparison needs these.
+    if (!hasName || !hasMedian)
+    {
+        reader.fail("Benchmark without name or median_ns");
+    }
+    return result;
+}
+
+} // namespace
+
+std::string formatBaseline(std::span<const BenchmarkResult> results)
+{
+    std::string text{ "{\n  \"benchmarks\": [\n" };
+    for (auto i{ std::size_t{ 0 } }; i != results.size(); ++i)
+    {
+        const auto& result{ results[i] };
+        std::format_to(
+            std::back_inserter(text),
+            "    {{ \"name\": {}, \"bytes_per_iteration\": {}, \"iterations\": {}, \"repetitions\": {},\n"
+            "      \"min_ns\": {:.3f}, \"median_ns\": {:.3f}, \"mean_ns\": {:.3f}, \"stddev_ns\": {:.3f} }}{}\n",
+            quote(result.name),
+            result.bytesPerIteration,
+            result.iterationCount,
+            result.repetitionCount,
+            result.min,
+            result.median,
+            result.mean,
+            result.standardDeviation,
+            (i + 1 != results.size()) ? "," : "");
+    }
+    text += "  ]\n}\n";
+    return text;
+}
+
+std::vector<BenchmarkResult> parseBaseline(std::string_view text)
+{
+    std::vector<BenchmarkResult> results{};
+    JsonReader reader{ text };
+    reader.expect('{');
+    if (!reader.consume('}'))
+    {
+        do
+        {
+            const auto key{ reader.readString() };
+            reader.expect(':');
+            if (key != "benchmarks")
+            {
+                reader.skipValue();
+                continue;
+            }
+            reader.expect('[');
+            if (!reader.consume(']'))
+            {
+                do
+                {
+                    results.push_back(readResult(reader));
+                } while (reader.consume(','));
+                reader.expect(']');
+            }
+        } while (reader.consume(','));
+        reader.expect('}');
+    }
+    if (!reader.isAtEnd())
+    {
+        reader.fail("End expected");
+    }
+    return results;
+}
+
+} // namespace VkTest1::Bench
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VkTest1::Bench
+{
+
+//
+// The results of a run as JSON, to compare later runs against:
+//
+// {
+//   "benchmarks": [
+//     { "name": "...", "iterations": 1000, "repetitions": 15,
+//       "min_ns": 1.0, "median_ns": 1.1, "mean_ns": 1.2, "stddev_ns": 0.1 },
+//     ...
+//   ]
+// }
+//
+std::string formatBaseline(std::span<const BenchmarkResult> results);
+
+// Throws Common::FormatError if the text is not JSON in the format of formatBaseline(). Unknown members are ignored,
+// so a baseline can carry notes.
+std::vector<BenchmarkResult> parseBaseline(std::string_view text);
+
+} // namespace VkTest1::Bench
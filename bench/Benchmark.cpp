@@ -0,0 +1,109 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace VkTest1::Bench
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Calibration grows the iteration count at most this much per step, in case a short run was an outlier.
+constexpr double s_maxIterationGrowth{ 10.0 };
+// The calibrated repetitions aim this much above the minimum time, so they don't fall short of it.
+constexpr double s_iterationMargin{ 1.2 };
+
+double toNanoseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::nano>{ duration }.count();
+}
+
+double runRepetition(BenchmarkRun& run, std::uint64_t iterationCount)
+{
+    const auto startTime{ Clock::now() };
+    run(iterationCount);
+    return toNanoseconds(Clock::now() - startTime);
+}
+
+std::uint64_t calibrateIterationCount(BenchmarkRun& run, double minRepetitionTime)
+{
+    std::uint64_t iterationCount{ 1 };
+    for (;;)
+    {
+        const auto time{ runRepetition(run, iterationCount) };
+        if (time >= minRepetitionTime)
+        {
+            return iterationCount;
+        }
+        const auto growth{ time > 0.0 ? std::min(minRepetitionTime * s_iterationMargin / time, s_maxIterationGrowth)
+                                      : s_maxIterationGrowth };
+        iterationCount = std::max(
+            iterationCount + 1, static_cast<std::uint64_t>(std::ceil(static_cast<double>(iterationCount) * growth)));
+    }
+}
+
+} // namespace
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark, const BenchmarkOptions& options)
+{
+    assert(options.repetitionCount != 0);
+    auto run{ benchmark.setUp() };
+
+    const auto iterationCount{ calibrateIterationCount(run, toNanoseconds(options.minRepetitionTime)) };
+    const auto warmupEndTime{ Clock::now() + options.warmupTime };
+    while (Clock::now() < warmupEndTime)
+    {
+        runRepetition(run, iterationCount);
+    }
+
+    std::vector<double> times(options.repetitionCount);
+    for (auto& time : times)
+    {
+        time = runRepetition(run, iterationCount) / static_cast<double>(iterationCount);
+    }
+    std::ranges::sort(times);
+
+    const auto count{ static_cast<double>(times.size()) };
+    const auto middle{ times.size() / 2 };
+    const auto median{ (times.size() % 2 != 0) ? times[middle] : (times[middle - 1] + times[middle]) / 2.0 };
+    const auto mean{ std::accumulate(times.begin(), times.end(), 0.0) / count };
+    const auto squaredDeviationSum{ std::accumulate(
+        times.begin(),
+        times.end(),
+        0.0,
+        [mean](double sum, double time)
+        {
+            return sum + (time - mean) * (time - mean);
+        }) };
+    // The sample standard deviation: the repetitions are a sample of all possible runs.
+    const auto standardDeviation{ times.size() > 1 ? std::sqrt(squaredDeviationSum / (count - 1.0)) : 0.0 };
+
+    return BenchmarkResult{ benchmark.name,
+                            benchmark.bytesPerIteration,
+                            iterationCount,
+                            options.repetitionCount,
+                            /* min */ times.front(),
+                            median,
+                            mean,
+                            standardDeviation };
+}
+
+namespace Detail
+{
+
+void escape(const void* pointer)
+{
+    // Volatile, so the store is not optimized away. Never read.
+    [[maybe_unused]] static const void* volatile s_sink{ nullptr };
+    s_sink = pointer;
+}
+
+} // namespace Detail
+
+} // namespace VkTest1::Bench
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace VkTest1::Bench
+{
+
+// Runs the measured code iterationCount times.
+using BenchmarkRun = std::move_only_function<void(std::uint64_t iterationCount)>;
+
+struct Benchmark
+{
+    std::string name;
+    // Of the data one iteration processes, for the throughput. Zero if there is no such thing.
+    std::uint64_t bytesPerIteration;
+    // Prepares the data, which the run owns. Only called if the benchmark is selected.
+    std::function<BenchmarkRun()> setUp;
+};
+
+struct BenchmarkOptions
+{
+    // Runs before the measurement, for warm caches, trained branch predictors and a settled clock frequency.
+    std::chrono::milliseconds warmupTime{ 100 };
+    // A repetition runs enough iterations to take at least this long, so the clock resolution doesn't matter.
+    std::chrono::milliseconds minRepetitionTime{ 20 };
+    unsigned int repetitionCount{ 15 };
+};
+
+// The times are per iteration, in nanoseconds, over the repetitions.
+struct BenchmarkResult
+{
+    std::string name;
+    std::uint64_t bytesPerIteration{ 0 };
+    // Per repetition.
+    std::uint64_t iterationCount{ 0 };
+    unsigned int repetitionCount{ 0 };
+    double min{ 0.0 };
+    double median{ 0.0 };
+    double mean{ 0.0 };
+    double standardDeviation{ 0.0 };
+};
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark, const BenchmarkOptions& options);
+
+namespace Detail
+{
+
+// Defined in another translation unit, so the compiler has to assume it reads what the pointer points to.
+void escape(const void* pointer);
+
+} // namespace Detail
+
+// Makes the compiler assume the value is used, so the code that computes it is not optimized away.
+template<typename T>
+void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    Detail::escape(&value);
+#endif
+}
+
+} // namespace VkTest1::Bench
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <vector>
+
+namespace VkTest1::Bench
+{
+
+// Of the Common module: FileSystem::readFile, the metrics and the job system.
+std::vector<Benchmark> createCommonBenchmarks();
+
+// Of the CPU side of the renderer: mesh staging, memory type and extension lookups. None of them needs a GPU.
+std::vector<Benchmark> createRendererBenchmarks();
+
+} // namespace VkTest1::Bench
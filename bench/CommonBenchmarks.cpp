@@ -0,0 +1,267 @@
+#include "Benchmarks.hpp"
+
+#include "common/Errors.hpp"
+#include "common/FileSystem.hpp"
+#include "common/JobSystem.hpp"
+#include "common/Metrics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace VkTest1::Bench
+{
+
+namespace
+{
+
+//
+// A file of the given size in the temporary directory. Deleted when destroyed.
+//
+class TemporaryFile
+{
+public:
+    explicit TemporaryFile(std::size_t size) :
+        m_path{ std::filesystem::temp_directory_path() /
+                std::format("vulkan_test_01_microbench_{:08x}.bin", std::random_device{}()) }
+    {
+        std::vector<char> contents(size);
+        for (auto i{ std::size_t{ 0 } }; i != contents.size(); ++i)
+        {
+            contents[i] = static_cast<char>(i * 31);
+        }
+        std::ofstream stream{ m_path, std::ios::binary };
+        stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!stream.good())
+        {
+            throw Common::IoError{ std::format("Cannot write '{}'.", m_path.string()) };
+        }
+    }
+
+    ~TemporaryFile()
+    {
+        if (!m_path.empty())
+        {
+            std::error_code error{};
+            std::filesystem::remove(m_path, error);
+        }
+    }
+
+    TemporaryFile(TemporaryFile&& other) noexcept :
+        m_path{ std::exchange(other.m_path, {}) }
+    {
+    }
+
+    TemporaryFile(const TemporaryFile& other) = delete;
+    TemporaryFile& operator=(const TemporaryFile& other) = delete;
+    TemporaryFile& operator=(TemporaryFile&& other) = delete;
+
+    const std::filesystem::path& getPath() const
+    {
+        return m_path;
+    }
+
+private:
+    // Empty if moved from.
+    std::filesystem::path m_path;
+};
+
+std::string formatSize(std::size_t size)
+{
+    if (size >= 1024 * 1024)
+    {
+        return std::format("{} MiB", size / (1024 * 1024));
+    }
+    return std::format("{} KiB", size / 1024);
+}
+
+// About what the renderer registers: a few counters, two histograms and the gauges of three heaps.
+std::unique_ptr<Common::MetricsRegistry> createBenchmarkRegistry()
+{
+    auto registry{ std::make_unique<Common::MetricsRegistry>() };
+    for (const auto* const name : { "frames", "draws", "triangles", "pipeline_binds", "uploaded_bytes" })
+    {
+        registry->addCounter(std::format("benchmark_{}_total", name), "A counter.").add(123456);
+    }
+    for (const auto* const name : { "frame_time", "fence_wait" })
+    {
+        auto& histogram{ registry->addHistogram(
+            std::format("benchmark_{}_seconds", name), "A histogram.", { 0.001, 0.002, 0.004, 0.008, 0.016, 0.033 }) };
+        histogram.observe(0.005);
+    }
+    for (const auto* const name : { "size", "usage", "budget" })
+    {
+        for (auto heap{ 0 }; heap != 3; ++heap)
+        {
+            registry->addGauge(std::format("benchmark_memory_{}_bytes{{heap=\"{}\"}}", name, heap), "A gauge.")
+                .set(8.0 * 1024 * 1024 * 1024);
+        }
+    }
+    return registry;
+}
+
+// Like the application: one worker per core besides the main thread.
+std::unique_ptr<Common::JobSystem> createBenchmarkJobSystem()
+{
+    const auto coreCount{ std::max(std::thread::hardware_concurrency(), 2u) };
+    return std::make_unique<Common::JobSystem>(/* workerCount */ coreCount - 1);
+}
+
+} // namespace
+
+std::vector<Benchmark> createCommonBenchmarks()
+{
+    std::vector<Benchmark> benchmarks{};
+    // Shader binaries, small and large meshes and textures. The file stays in the page cache after the first read,
+    // so this measures the opening, the allocation and the copy, not the disk.
+    for (const std::size_t size : { 4 * 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024 })
+    {
+        benchmarks.push_back(Benchmark{
+            std::format("FileSystem::readFile/{}", formatSize(size)),
+            size,
+            [size]
+            {
+                return BenchmarkRun{ [file = TemporaryFile{ size }](std::uint64_t iterationCount)
+                {
+                    Common::FileSystem fileSystem{};
+                    for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                    {
+                        const auto contents{ fileSystem.readFile(file.getPath()) };
+                        doNotOptimize(contents.data());
+                    }
+                } };
+            } });
+    }
+
+    // The metric updates are on the hot paths of the renderer.
+    benchmarks.push_back(Benchmark{
+        "Counter::add",
+        /* bytesPerIteration */ 0,
+        []
+        {
+            return BenchmarkRun{ [counter = std::make_unique<Common::Counter>()](std::uint64_t iterationCount)
+            {
+                for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                {
+                    counter->add(i);
+                }
+                doNotOptimize(counter->getValue());
+            } };
+        } });
+    benchmarks.push_back(Benchmark{
+        "Histogram::observe",
+        /* bytesPerIteration */ 0,
+        []
+        {
+            auto histogram{ std::make_unique<Common::Histogram>(std::vector{ 0.001, 0.002, 0.004, 0.008, 0.016 }) };
+            return BenchmarkRun{ [histogram = std::move(histogram)](std::uint64_t iterationCount)
+            {
+                for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                {
+                    histogram->observe(static_cast<double>(i % 20) * 0.001);
+                }
+                doNotOptimize(histogram->getSum());
+            } };
+        } });
+    // The overhead of a job: scheduled from outside the workers, they go through the shared queue.
+    benchmarks.push_back(Benchmark{
+        "JobSystem::schedule",
+        /* bytesPerIteration */ 0,
+        []
+        {
+            return BenchmarkRun{ [jobSystem = createBenchmarkJobSystem()](std::uint64_t iterationCount)
+            {
+                Common::JobCounter counter{};
+                for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                {
+                    jobSystem->schedule([] {}, &counter);
+                }
+                jobSystem->wait(counter);
+            } };
+        } });
+    // Scheduled by a job, they go to its worker's deque, and the other workers steal them.
+    benchmarks.push_back(Benchmark{
+        "JobSystem::steal",
+        /* bytesPerIteration */ 0,
+        []
+        {
+            return BenchmarkRun{ [jobSystem = createBenchmarkJobSystem()](std::uint64_t iterationCount)
+            {
+                Common::JobCounter counter{};
+                jobSystem->schedule(
+                    [&jobSystem, iterationCount]
+                    {
+                        Common::JobCounter innerCounter{};
+                        for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                        {
+                            jobSystem->schedule([] {}, &innerCounter);
+                        }
+                        jobSystem->wait(innerCounter);
+                    },
+                    &counter);
+                jobSystem->wait(counter);
+            } };
+        } });
+    // A loop over a large array, as the renderer's culling and sorting do.
+    for (const std::size_t grainSize : { 1024, 16 * 1024 })
+    {
+        constexpr std::size_t valueCount{ 1024 * 1024 };
+        benchmarks.push_back(Benchmark{
+            std::format("JobSystem::parallelFor/grain {}", grainSize),
+            valueCount * sizeof(float),
+            [grainSize]
+            {
+                std::vector<float> values(valueCount);
+                std::iota(values.begin(), values.end(), 0.0f);
+                return BenchmarkRun{ [jobSystem = createBenchmarkJobSystem(), values = std::move(values), grainSize](
+                                         std::uint64_t iterationCount) mutable
+                {
+                    for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                    {
+                        jobSystem->parallelFor(
+                            0,
+                            values.size(),
+                            grainSize,
+                            [&values](std::size_t chunkBegin, std::size_t chunkEnd)
+                            {
+                                for (auto j{ chunkBegin }; j != chunkEnd; ++j)
+                                {
+                                    values[j] = values[j] * 0.5f + 1.0f;
+                                }
+                            });
+                    }
+                    doNotOptimize(values.data());
+                } };
+            } });
+    }
+
+    // What the metrics exporter does once per interval.
+    benchmarks.push_back(Benchmark{
+        "MetricsRegistry::format",
+        /* bytesPerIteration */ 0,
+        []
+        {
+            return BenchmarkRun{ [registry = createBenchmarkRegistry(), text = std::string{}](
+                                     std::uint64_t iterationCount) mutable
+            {
+                for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                {
+                    text.clear();
+                    registry->format(text);
+                    doNotOptimize(text.data());
+                }
+            } };
+        } });
+    return benchmarks;
+}
+
+} // namespace VkTest1::Bench
@@ -0,0 +1,220 @@
+#include "Benchmarks.hpp"
+
+#include "geometry/MeshData.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/DeviceMemory.hpp"
+#include "renderer/ExtensionSupport.hpp"
+#include "renderer/MeshStaging.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VkTest1::Bench
+{
+
+namespace
+{
+
+// The extension lookups log at debug level, which is off in production.
+class NullLogger : public Logging::ILogger
+{
+public:
+    bool isEnabled(Logging::Severity /* severity */) const override
+    {
+        return false;
+    }
+
+    void write(const Logging::LogMessage& /* message */) override
+    {
+    }
+};
+
+// A mesh like the ones mesh_convert produces: about two triangles per vertex, and meshlets of 124 triangles.
+constexpr std::size_t s_indicesPerVertex{ 6 };
+constexpr std::uint32_t s_meshletIndexCount{ 124 * 3 };
+
+struct StagingBenchmarkMesh
+{
+    std::vector<Geometry::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<Geometry::Meshlet> meshlets;
+};
+
+StagingBenchmarkMesh createStagingBenchmarkMesh(std::size_t vertexCount)
+{
+    StagingBenchmarkMesh mesh{};
+    mesh.vertices.resize(vertexCount);
+    for (auto i{ std::size_t{ 0 } }; i != vertexCount; ++i)
+    {
+        const auto position{ static_cast<float>(i) };
+        mesh.vertices[i] = Geometry::Vertex{ Geometry::Position{ position, position, position },
+                                             Geometry::Color{ 1.0f, 1.0f, 1.0f },
+                                             Geometry::TexCoord{ 0.0f, 0.0f } };
+    }
+    mesh.indices.resize(vertexCount * s_indicesPerVertex);
+    for (auto i{ std::size_t{ 0 } }; i != mesh.indices.size(); ++i)
+    {
+        mesh.indices[i] = static_cast<std::uint32_t>((i * 7) % vertexCount);
+    }
+    for (std::uint32_t first{ 0 }; first < mesh.indices.size(); first += s_meshletIndexCount)
+    {
+        const auto indexCount{ std::min(s_meshletIndexCount, static_cast<std::uint32_t>(mesh.indices.size()) - first) };
+        mesh.meshlets.push_back(Geometry::Meshlet{ /* center */ Geometry::Position{ 0.0f, 0.0f, 0.0f },
+                                                   /* radius */ 1.0f,
+                                                   /* coneAxis */ glm::vec3{ 0.0f, 0.0f, 1.0f },
+                                                   /* coneCutoff */ 1.0f,
+                                                   /* firstIndex */ first,
+                                                   indexCount });
+    }
+    return mesh;
+}
+
+Benchmark createStagingBenchmark(std::size_t vertexCount, vk::IndexType indexType)
+{
+    const auto indexCount{ vertexCount * s_indicesPerVertex };
+    const auto meshletCount{ (indexCount + s_meshletIndexCount - 1) / s_meshletIndexCount };
+    const auto dataSize{ Renderer::Detail::getStagingDataSize(vertexCount, indexCount, indexType, meshletCount) };
+    return Benchmark{ std::format(
+                          "writeStagingData/{} vertices/{}",
+                          vertexCount,
+                          indexType == vk::IndexType::eUint16 ? "uint16" : "uint32"),
+                      dataSize,
+                      [vertexCount, indexType, dataSize]
+                      {
+                          // Stands in for the mapped staging memory, which is written the same way.
+                          return BenchmarkRun{ [mesh = createStagingBenchmarkMesh(vertexCount),
+                                                destination = std::vector<std::uint32_t>((dataSize + 3) / 4),
+                                                indexType](std::uint64_t iterationCount) mutable
+                          {
+                              auto* const destinationBytes{ reinterpret_cast<std::byte*>(destination.data()) };
+                              for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                              {
+                                  Renderer::Detail::writeStagingData(
+                                      destinationBytes, mesh.vertices, mesh.indices, indexType, mesh.meshlets);
+                                  doNotOptimize(destinationBytes);
+                              }
+                          } };
+                      } };
+}
+
+// Like a discrete GPU: device local video memory, system memory in three flavors, and the small host visible part of
+// video memory.
+vk::PhysicalDeviceMemoryProperties createMemoryProperties()
+{
+    using Flags = vk::MemoryPropertyFlagBits;
+    vk::PhysicalDeviceMemoryProperties properties{};
+    properties.memoryHeapCount = 3;
+    properties.memoryHeaps[0] = vk::MemoryHeap{ 8ull << 30, vk::MemoryHeapFlagBits::eDeviceLocal };
+    properties.memoryHeaps[1] = vk::MemoryHeap{ 16ull << 30, {} };
+    properties.memoryHeaps[2] = vk::MemoryHeap{ 256ull << 20, vk::MemoryHeapFlagBits::eDeviceLocal };
+    const std::array memoryTypes{
+        vk::MemoryType{ {}, /* heapIndex */ 1 },
+        vk::MemoryType{ Flags::eDeviceLocal, /* heapIndex */ 0 },
+        vk::MemoryType{ Flags::eDeviceLocal, /* heapIndex */ 0 },
+        vk::MemoryType{ Flags::eHostVisible | Flags::eHostCoherent, /* heapIndex */ 1 },
+        vk::MemoryType{ Flags::eHostVisible | Flags::eHostCoherent | Flags::eHostCached, /* heapIndex */ 1 },
+        vk::MemoryType{ Flags::eDeviceLocal | Flags::eHostVisible | Flags::eHostCoherent, /* heapIndex */ 2 },
+    };
+    properties.memoryTypeCount = static_cast<std::uint32_t>(memoryTypes.size());
+    std::ranges::copy(memoryTypes, properties.memoryTypes.begin());
+    return properties;
+}
+
+Benchmark createMemoryTypeBenchmark(std::string_view flagsName, vk::MemoryPropertyFlags propertyFlags)
+{
+    return Benchmark{ std::format("findMemoryTypeIndex/{}", flagsName),
+                      /* bytesPerIteration */ 0,
+                      [propertyFlags]
+                      {
+                          return BenchmarkRun{ [properties = createMemoryProperties(),
+                                                propertyFlags](std::uint64_t iterationCount)
+                          {
+                              // Any type, like the requirements of most buffers.
+                              constexpr std::uint32_t allowedTypes{ 0x3F };
+                              for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                              {
+                                  doNotOptimize(properties);
+                                  doNotOptimize(
+                                      Renderer::Detail::findMemoryTypeIndex(properties, allowedTypes, propertyFlags));
+                              }
+                          } };
+                      } };
+}
+
+// The extensions of a driver: propertyCount of them, with the requested ones spread among them.
+std::vector<vk::ExtensionProperties> createExtensionProperties(
+    std::size_t propertyCount, std::span<const char* const> requestedNames)
+{
+    std::vector<vk::ExtensionProperties> properties(propertyCount);
+    for (auto i{ std::size_t{ 0 } }; i != propertyCount; ++i)
+    {
+        const auto name{ std::format("VK_EXT_benchmark_extension_{}", i) };
+        std::ranges::copy(name, properties[i].extensionName.begin());
+        properties[i].specVersion = 1;
+    }
+    for (auto i{ std::size_t{ 0 } }; i != requestedNames.size(); ++i)
+    {
+        auto& property{ properties[(i + 1) * propertyCount / (requestedNames.size() + 1)] };
+        property.extensionName.fill('\0');
+        std::ranges::copy(std::string_view{ requestedNames[i] }, property.extensionName.begin());
+    }
+    return properties;
+}
+
+Benchmark createExtensionBenchmark(
+    std::string_view name, std::size_t propertyCount, std::vector<const char*> requestedNames)
+{
+    return Benchmark{ std::format("areExtensionsSupported/{}", name),
+                      /* bytesPerIteration */ 0,
+                      [propertyCount, requestedNames]
+                      {
+                          return BenchmarkRun{ [properties = createExtensionProperties(propertyCount, requestedNames),
+                                                requestedNames,
+                                                logger = NullLogger{}](std::uint64_t iterationCount) mutable
+                          {
+                              for (auto i{ std::uint64_t{ 0 } }; i != iterationCount; ++i)
+                              {
+                                  doNotOptimize(Renderer::Detail::areExtensionsSupported(
+                                      properties, requestedNames, logger));
+                              }
+                          } };
+                      } };
+}
+
+} // namespace
+
+std::vector<Benchmark> createRendererBenchmarks()
+{
+    using Flags = vk::MemoryPropertyFlagBits;
+    std::vector<Benchmark> benchmarks{};
+    for (const std::size_t vertexCount : { 1000, 60000 })
+    {
+        benchmarks.push_back(createStagingBenchmark(vertexCount, vk::IndexType::eUint16));
+        benchmarks.push_back(createStagingBenchmark(vertexCount, vk::IndexType::eUint32));
+    }
+    benchmarks.push_back(createMemoryTypeBenchmark("device local", Flags::eDeviceLocal));
+    benchmarks.push_back(createMemoryTypeBenchmark("host coherent", Flags::eHostVisible | Flags::eHostCoherent));
+    benchmarks.push_back(createMemoryTypeBenchmark(
+        "host cached", Flags::eHostVisible | Flags::eHostCoherent | Flags::eHostCached));
+    // About what drivers report: a few dozen instance extensions, a few hundred device extensions.
+    benchmarks.push_back(createExtensionBenchmark(
+        "instance",
+        /* propertyCount */ 24,
+        { VK_KHR_SURFACE_EXTENSION_NAME, "VK_KHR_win32_surface", VK_EXT_DEBUG_UTILS_EXTENSION_NAME }));
+    benchmarks.push_back(createExtensionBenchmark(
+        "device",
+        /* propertyCount */ 200,
+        { VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, "VK_KHR_present_wait" }));
+    return benchmarks;
+}
+
+} // namespace VkTest1::Bench
@@ -0,0 +1,228 @@
+#include "Baseline.hpp"
+#include "Benchmark.hpp"
+#include "Benchmarks.hpp"
+
+#include "common/Errors.hpp"
+#include "common/FileSystem.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace VkTest1;
+
+namespace
+{
+
+void printUsage()
+{
+    std::println(
+        "Usage: vulkan_test_01_microbench [--filter <text>] [--repetitions <n>] [--warmup <ms>] [--min-time <ms>]");
+    std::println("                                 [--output <file>] [--baseline <file>] [--threshold <percent>]");
+    std::println("                                 [--list]");
+    std::println("Runs the benchmarks whose name contains the filter text, all by default.");
+    std::println("--output writes the results as a JSON baseline. --baseline compares the medians with a baseline and");
+    std::println("fails if one is more than the threshold (default 10) percent slower.");
+}
+
+template<typename T>
+std::optional<T> parseNumber(std::string_view text)
+{
+    T number{};
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (ec != std::errc{} || end != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+    return number;
+}
+
+std::string formatTime(double nanoseconds)
+{
+    if (nanoseconds >= 1'000'000.0)
+    {
+        return std::format("{:.3f} ms", nanoseconds / 1'000'000.0);
+    }
+    if (nanoseconds >= 1'000.0)
+    {
+        return std::format("{:.3f} us", nanoseconds / 1'000.0);
+    }
+    return std::format("{:.3f} ns", nanoseconds);
+}
+
+std::string formatThroughput(const Bench::BenchmarkResult& result)
+{
+    if (result.bytesPerIteration == 0 || result.median <= 0.0)
+    {
+        return {};
+    }
+    // Bytes per nanosecond are GB/s.
+    return std::format("{:.2f} GB/s", static_cast<double>(result.bytesPerIteration) / result.median);
+}
+
+// The change of the median against the baseline. True if it is a regression beyond the threshold.
+bool printComparison(
+    const Bench::BenchmarkResult& result, std::span<const Bench::BenchmarkResult> baseline, double threshold)
+{
+    const auto it{ std::ranges::find(baseline, result.name, &Bench::BenchmarkResult::name) };
+    if (it == baseline.end() || it->median <= 0.0)
+    {
+        std::println("    not in the baseline");
+        return false;
+    }
+    const auto change{ result.median / it->median - 1.0 };
+    const auto isRegression{ change > threshold };
+    std::println(
+        "    baseline {}, {:+.1f} %{}",
+        formatTime(it->median),
+        change * 100.0,
+        isRegression ? " REGRESSION" : "");
+    return isRegression;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::span<char*> args{ argv + 1, static_cast<std::size_t>(argc - 1) };
+
+    Bench::BenchmarkOptions options{};
+    std::string_view filter{};
+    std::optional<std::filesystem::path> outputPath{};
+    std::optional<std::filesystem::path> baselinePath{};
+    auto threshold{ 0.1 };
+    auto isListing{ false };
+    for (auto i{ 0u }; i != args.size(); ++i)
+    {
+        const std::string_view arg{ args[i] };
+        const auto hasValue{ i + 1 != args.size() };
+        if (arg == "--filter" && hasValue)
+        {
+            filter = args[++i];
+        }
+        else if (arg == "--repetitions" && hasValue)
+        {
+            const auto repetitionCount{ parseNumber<unsigned int>(args[++i]) };
+            if (!repetitionCount.has_value() || *repetitionCount == 0)
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            options.repetitionCount = *repetitionCount;
+        }
+        else if ((arg == "--warmup" || arg == "--min-time") && hasValue)
+        {
+            const auto milliseconds{ parseNumber<unsigned int>(args[++i]) };
+            if (!milliseconds.has_value())
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            (arg == "--warmup" ? options.warmupTime : options.minRepetitionTime) =
+                std::chrono::milliseconds{ *milliseconds };
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            outputPath = args[++i];
+        }
+        else if (arg == "--baseline" && hasValue)
+        {
+            baselinePath = args[++i];
+        }
+        else if (arg == "--threshold" && hasValue)
+        {
+            const auto percent{ parseNumber<double>(args[++i]) };
+            if (!percent.has_value() || *percent < 0.0)
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            threshold = *percent / 100.0;
+        }
+        else if (arg == "--list")
+        {
+            isListing = true;
+        }
+        else
+        {
+            printUsage();
+            return (arg == "-h" || arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    try
+    {
+        auto benchmarks{ Bench::createCommonBenchmarks() };
+        std::ranges::move(Bench::createRendererBenchmarks(), std::back_inserter(benchmarks));
+        std::erase_if(
+            benchmarks,
+            [filter](const Bench::Benchmark& benchmark)
+            {
+                return !benchmark.name.contains(filter);
+            });
+        if (isListing)
+        {
+            for (const auto& benchmark : benchmarks)
+            {
+                std::println("{}", benchmark.name);
+            }
+            return EXIT_SUCCESS;
+        }
+
+        // Read first, so a broken baseline fails before the benchmarks run.
+        std::vector<Bench::BenchmarkResult> baseline{};
+        if (baselinePath.has_value())
+        {
+            const auto text{ Common::FileSystem{}.readFile(*baselinePath) };
+            baseline = Bench::parseBaseline(
+                std::string_view{ reinterpret_cast<const char*>(text.data()), text.size() });
+        }
+
+        std::vector<Bench::BenchmarkResult> results{};
+        auto hasRegression{ false };
+        for (const auto& benchmark : benchmarks)
+        {
+            const auto& result{ results.emplace_back(Bench::runBenchmark(benchmark, options)) };
+            std::println(
+                "{:<48} median {:>12}  min {:>12}  mean {:>12}  stddev {:>12}  {}",
+                result.name,
+                formatTime(result.median),
+                formatTime(result.min),
+                formatTime(result.mean),
+                formatTime(result.standardDeviation),
+                formatThroughput(result));
+            if (baselinePath.has_value())
+            {
+                hasRegression = printComparison(result, baseline, threshold) || hasRegression;
+            }
+        }
+
+        if (outputPath.has_value())
+        {
+            std::ofstream stream{ *outputPath, std::ios::binary };
+            stream << Bench::formatBaseline(results);
+            if (!stream.good())
+            {
+                throw Common::IoError{ std::format("Cannot write '{}'.", outputPath->string()) };
+            }
+        }
+        return hasRegression ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    catch (const std::exception& ex)
+    {
+        std::println("ERROR: {}", ex.what());
+        return EXIT_FAILURE;
+    }
+}
@@ -1,8 +1,20 @@
 #include "Factory.hpp"
 
+#include "assets/AssetLoader.hpp"
 #include "common/FileSystem.hpp"
+#include "common/JobSystem.hpp"
+#include "common/Metrics.hpp"
+#include "common/MetricsExporter.hpp"
+#include "logging/AsyncLogger.hpp"
+#include "renderer/CaptureFileWriter.hpp"
+#include "renderer/RenderThread.hpp"
 #include "renderer/VulkanRenderer.hpp"
 #include "window/GlfwWindow.hpp"
+#include "world/WorldStreamer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 namespace VkTest1
 {
@@ -12,15 +24,73 @@ std::unique_ptr<Common::IFileSystem> Factory::createFileSystem()
     return std::make_unique<Common::FileSystem>();
 }
 
+std::unique_ptr<Logging::ILogger> Factory::createLogger(
+    Logging::Severity minSeverity, const std::filesystem::path& filePath)
+{
+    // 1024 messages per thread absorb a burst of validation messages between two flushes of the sink.
+    return std::make_unique<Logging::Detail::AsyncLogger>(minSeverity, filePath, /* bufferCapacity */ 1024);
+}
+
+std::unique_ptr<Common::JobSystem> Factory::createJobSystem()
+{
+    // Leaves one core for the thread that waits for the jobs, which runs jobs too while it waits.
+    const auto coreCount{ std::max(std::thread::hardware_concurrency(), 2u) };
+    return std::make_unique<Common::JobSystem>(/* workerCount */ coreCount - 1);
+}
+
+std::unique_ptr<Common::MetricsRegistry> Factory::createMetricsRegistry()
+{
+    return std::make_unique<Common::MetricsRegistry>();
+}
+
+std::unique_ptr<Common::MetricsExporter> Factory::createMetricsExporter(
+    Common::NotNull<const Common::MetricsRegistry*> registry, const std::filesystem::path& filePath)
+{
+    // About the scrape interval of a monitoring agent. 64 KiB hold the renderer metrics many times over.
+    return std::make_unique<Common::MetricsExporter>(
+        registry, filePath, /* interval */ std::chrono::seconds{ 1 }, /* capacity */ 64 * 1024);
+}
+
+std::unique_ptr<Assets::IAssetLoader> Factory::createAssetLoader(
+    Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Common::JobSystem*> jobSystem)
+{
+    // Two I/O threads keep one read in flight while the other thread hands its data over.
+    return std::make_unique<Assets::Detail::AssetLoader>(fileSystem, jobSystem, /* ioThreadCount */ 2);
+}
+
 std::unique_ptr<Window::IWindow> Factory::createWindow()
 {
     return std::make_unique<Window::Detail::GlfwWindow>(800, 600, "Hello");
 }
 
 std::unique_ptr<Renderer::IRenderer> Factory::createRenderer(
-    Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Window::IWindow*> window)
+    Common::NotNull<Assets::IAssetLoader*> assetLoader, Common::NotNull<Common::JobSystem*> jobSystem,
+    std::vector<Common::NotNull<Window::IWindow*>> windows, Common::NotNull<Logging::ILogger*> logger,
+    Common::NotNull<Common::MetricsRegistry*> metricsRegistry, const Renderer::RendererSettings& settings)
+{
+    auto renderer{ std::make_unique<Renderer::Detail::VulkanRenderer>(
+        assetLoader, jobSystem, std::move(windows), logger, metricsRegistry, settings) };
+    if (!settings.renderThread)
+    {
+        return renderer;
+    }
+    // Long enough to ride out a late frame, short enough that the window stays responsive if the GPU hangs.
+    return std::make_unique<Renderer::Detail::RenderThread>(
+        std::move(renderer), /* maxWait */ std::chrono::milliseconds{ 100 });
+}
+
+std::unique_ptr<Renderer::ICaptureWriter> Factory::createCaptureWriter(const std::filesystem::path& filePath)
+{
+    // A few frames absorb the hiccups of the disk. A slower disk slows down the frame loop rather than dropping frames.
+    return std::make_unique<Renderer::Detail::CaptureFileWriter>(filePath, /* queueCapacity */ 4);
+}
+
+std::unique_ptr<World::WorldStreamer> Factory::createWorldStreamer(
+    Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Assets::IAssetLoader*> assetLoader,
+    Common::NotNull<Renderer::IRenderer*> renderer, Common::NotNull<Logging::ILogger*> logger,
+    const std::filesystem::path& filePath, const World::WorldStreamerSettings& settings)
 {
-    return std::make_unique<Renderer::Detail::VulkanRenderer>(fileSystem, window);
+    return std::make_unique<World::WorldStreamer>(fileSystem, assetLoader, renderer, logger, filePath, settings);
 }
 
 } // namespace VkTest1
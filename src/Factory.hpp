@@ -1,8 +1,12 @@
 #pragma once
 
 #include "common/Types.hpp"
+#include "logging/LogMessage.hpp"
 
+#include <chrono>
+#include <filesystem>
 #include <memory>
+#include <vector>
 
 namespace VkTest1
 {
@@ -10,6 +14,19 @@ namespace VkTest1
 namespace Common
 {
 class IFileSystem;
+class JobSystem;
+class MetricsExporter;
+class MetricsRegistry;
+}
+
+namespace Logging
+{
+class ILogger;
+}
+
+namespace Assets
+{
+class IAssetLoader;
 }
 
 namespace Window
@@ -20,15 +37,42 @@ class IWindow;
 namespace Renderer
 {
 class IRenderer;
+class ICaptureWriter;
+struct RendererSettings;
+}
+
+namespace World
+{
+class WorldStreamer;
+struct WorldStreamerSettings;
 }
 
 class Factory
 {
 public:
     std::unique_ptr<Common::IFileSystem> createFileSystem();
+    // Writes to stdout if filePath is empty.
+    std::unique_ptr<Logging::ILogger> createLogger(Logging::Severity minSeverity, const std::filesystem::path& filePath);
+    std::unique_ptr<Common::JobSystem> createJobSystem();
+    std::unique_ptr<Common::MetricsRegistry> createMetricsRegistry();
+    // Writes snapshots of the registry to the file. Throws Common::IoError if the file cannot be mapped.
+    std::unique_ptr<Common::MetricsExporter> createMetricsExporter(
+        Common::NotNull<const Common::MetricsRegistry*> registry, const std::filesystem::path& filePath);
+    std::unique_ptr<Assets::IAssetLoader> createAssetLoader(
+        Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Common::JobSystem*> jobSystem);
     std::unique_ptr<Window::IWindow> createWindow();
+    // Draws into every window. There must be at least one.
     std::unique_ptr<Renderer::IRenderer> createRenderer(
-        Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Window::IWindow*> window);
+        Common::NotNull<Assets::IAssetLoader*> assetLoader, Common::NotNull<Common::JobSystem*> jobSystem,
+        std::vector<Common::NotNull<Window::IWindow*>> windows, Common::NotNull<Logging::ILogger*> logger,
+        Common::NotNull<Common::MetricsRegistry*> metricsRegistry, const Renderer::RendererSettings& settings);
+    // A PPM stream if the file name ends in ".ppm", raw RGBA8 otherwise.
+    std::unique_ptr<Renderer::ICaptureWriter> createCaptureWriter(const std::filesystem::path& filePath);
+    // Reads the index of the world file. Throws Common::IoError or Common::FormatError if it cannot.
+    std::unique_ptr<World::WorldStreamer> createWorldStreamer(
+        Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Assets::IAssetLoader*> assetLoader,
+        Common::NotNull<Renderer::IRenderer*> renderer, Common::NotNull<Logging::ILogger*> logger,
+        const std::filesystem::path& filePath, const World::WorldStreamerSettings& settings);
 };
 
 } // namespace VkTest1
@@ -0,0 +1,139 @@
+#include "assets/AssetLoader.hpp"
+
+namespace VkTest1::Assets::Detail
+{
+
+namespace
+{
+
+template<typename T, typename TFunction>
+void fulfill(std::promise<T>& promise, TFunction&& function)
+{
+    try
+    {
+        promise.set_value(std::forward<TFunction>(function)());
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+} // namespace
+
+AssetLoader::AssetLoader(
+    Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Common::JobSystem*> jobSystem,
+    unsigned int ioThreadCount) :
+    m_fileSystem{ fileSystem },
+    m_jobSystem{ jobSystem },
+    m_ioQueue{ ioThreadCount }
+{
+}
+
+std::future<std::vector<std::byte>> AssetLoader::loadFile(const std::filesystem::path& path, LoadPriority priority)
+{
+    std::promise<std::vector<std::byte>> promise{};
+    auto future{ promise.get_future() };
+    m_ioQueue.push(
+        priority,
+        [this, path, promise = std::move(promise)]() mutable
+        {
+            fulfill(
+                promise,
+                [this, &path]
+                {
+                    return m_fileSystem->readFile(path);
+                });
+        });
+    return future;
+}
+
+std::future<std::vector<std::byte>> AssetLoader::loadFileRange(
+    const std::filesystem::path& path, std::uint64_t offset, std::size_t size, LoadPriority priority)
+{
+    std::promise<std::vector<std::byte>> promise{};
+    auto future{ promise.get_future() };
+    m_ioQueue.push(
+        priority,
+        [this, path, offset, size, promise = std::move(promise)]() mutable
+        {
+            fulfill(
+                promise,
+                [this, &path, offset, size]
+                {
+                    return m_fileSystem->readFileRange(path, offset, size);
+                });
+        });
+    return future;
+}
+
+template<typename T>
+std::future<T> AssetLoader::loadAndDecode(
+    const std::filesystem::path& path, LoadPriority priority,
+    std::function<T(std::span<const std::byte> contents)> decoder)
+{
+    std::promise<T> promise{};
+    auto future{ promise.get_future() };
+    m_ioQueue.push(
+        priority,
+        [this, path, decoder = std::move(decoder), promise = std::move(promise)]() mutable
+        {
+            std::vector<std::byte> contents{};
+            try
+            {
+                contents = m_fileSystem->readFile(path);
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+                return;
+            }
+
+            // Hand the CPU work over to the job system, so this thread can start reading the next file.
+            // The decodes start in the order the reads finished, which already follows the priorities.
+            m_jobSystem->schedule(
+                [contents = std::move(contents), decoder = std::move(decoder), promise = std::move(promise)]() mutable
+                {
+                    fulfill(
+                        promise,
+                        [&contents, &decoder]
+                        {
+                            return decoder(contents);
+                        });
+                });
+        });
+    return future;
+}
+
+std::future<Geometry::MeshData> AssetLoader::loadMesh(
+    const std::filesystem::path& path, LoadPriority priority, MeshDecoder decoder)
+{
+    return loadAndDecode(path, priority, std::move(decoder));
+}
+
+std::future<Texture::TextureData> AssetLoader::loadTexture(
+    const std::filesystem::path& path, LoadPriority priority, TextureDecoder decoder)
+{
+    return loadAndDecode(path, priority, std::move(decoder));
+}
+
+std::future<Geometry::MeshData> AssetLoader::generateMesh(LoadPriority priority, MeshGenerator generator)
+{
+    std::promise<Geometry::MeshData> promise{};
+    auto future{ promise.get_future() };
+    // Through the I/O queue, so the generators start in priority order like the decodes. The I/O thread only hands
+    // them over to the job system.
+    m_ioQueue.push(
+        priority,
+        [this, generator = std::move(generator), promise = std::move(promise)]() mutable
+        {
+            m_jobSystem->schedule(
+                [generator = std::move(generator), promise = std::move(promise)]() mutable
+                {
+                    fulfill(promise, generator);
+                });
+        });
+    return future;
+}
+
+} // namespace VkTest1::Assets::Detail
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "assets/IAssetLoader.hpp"
+#include "assets/PriorityWorkQueue.hpp"
+#include "common/IFileSystem.hpp"
+#include "common/JobSystem.hpp"
+#include "common/Types.hpp"
+
+namespace VkTest1::Assets::Detail
+{
+
+//
+// Loads assets in the background.
+//
+// Loading is split into two stages:
+//
+// 1. I/O: Read the file contents. Served by its own threads, in priority order.
+// 2. Decode: Convert the file contents into the in-memory representation. Runs on the shared job system.
+//
+// This way a slow decode does not keep the disk idle and a slow disk does not keep the CPUs idle.
+//
+class AssetLoader : public IAssetLoader
+{
+public:
+    // The file system must be safe to use from multiple threads.
+    // The job system must outlive the jobs scheduled by the loader.
+    explicit AssetLoader(
+        Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Common::JobSystem*> jobSystem,
+        unsigned int ioThreadCount);
+
+    std::future<std::vector<std::byte>> loadFile(const std::filesystem::path& path, LoadPriority priority) override;
+
+    std::future<std::vector<std::byte>> loadFileRange(
+        const std::filesystem::path& path, std::uint64_t offset, std::size_t size, LoadPriority priority) override;
+
+    std::future<Geometry::MeshData> loadMesh(
+        const std::filesystem::path& path, LoadPriority priority, MeshDecoder decoder) override;
+
+    std::future<Texture::TextureData> loadTexture(
+        const std::filesystem::path& path, LoadPriority priority, TextureDecoder decoder) override;
+
+    std::future<Geometry::MeshData> generateMesh(LoadPriority priority, MeshGenerator generator) override;
+
+private:
+    // Reads the file on an I/O thread and decodes it on the job system.
+    template<typename T>
+    std::future<T> loadAndDecode(
+        const std::filesystem::path& path, LoadPriority priority,
+        std::function<T(std::span<const std::byte> contents)> decoder);
+
+    Common::NotNull<Common::IFileSystem*> m_fileSystem;
+    Common::NotNull<Common::JobSystem*> m_jobSystem;
+    PriorityWorkQueue m_ioQueue;
+};
+
+} // namespace VkTest1::Assets::Detail
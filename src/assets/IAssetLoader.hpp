@@ -0,0 +1,57 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+#include "texture/TextureData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Assets
+{
+
+// Requests with higher priority are read first.
+// Requests with the same priority are read in submission order.
+enum class LoadPriority
+{
+    Background,
+    Normal,
+    High,
+    Immediate
+};
+
+// Converts the raw file contents into mesh data. Runs on a job system worker.
+using MeshDecoder = std::function<Geometry::MeshData(std::span<const std::byte> contents)>;
+
+// Converts the raw file contents into texture data. Runs on a job system worker.
+using TextureDecoder = std::function<Texture::TextureData(std::span<const std::byte> contents)>;
+
+// Produces mesh data without reading any file (e.g. procedural geometry). Runs on a job system worker.
+using MeshGenerator = std::function<Geometry::MeshData()>;
+
+class IAssetLoader
+{
+public:
+    virtual ~IAssetLoader() = default;
+
+    virtual std::future<std::vector<std::byte>> loadFile(const std::filesystem::path& path, LoadPriority priority) = 0;
+
+    // The size bytes at the offset, e.g. one chunk of a large file.
+    virtual std::future<std::vector<std::byte>> loadFileRange(
+        const std::filesystem::path& path, std::uint64_t offset, std::size_t size, LoadPriority priority) = 0;
+
+    virtual std::future<Geometry::MeshData> loadMesh(
+        const std::filesystem::path& path, LoadPriority priority, MeshDecoder decoder) = 0;
+
+    virtual std::future<Texture::TextureData> loadTexture(
+        const std::filesystem::path& path, LoadPriority priority, TextureDecoder decoder) = 0;
+
+    // The generators start in the order of their priorities, queued with the reads.
+    virtual std::future<Geometry::MeshData> generateMesh(LoadPriority priority, MeshGenerator generator) = 0;
+};
+
+} // namespace VkTest1::Assets
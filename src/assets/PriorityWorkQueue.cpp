@@ -0,0 +1,82 @@
+#include "assets/PriorityWorkQueue.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Assets::Detail
+{
+
+namespace
+{
+
+// The heap keeps the "largest" element at the front.
+// Higher priority wins. For the same priority, the older job (smaller sequence number) wins.
+constexpr auto s_isLessUrgent = [](const auto& lhs, const auto& rhs)
+{
+    if (lhs.priority != rhs.priority)
+    {
+        return lhs.priority < rhs.priority;
+    }
+    return lhs.sequenceNumber > rhs.sequenceNumber;
+};
+
+} // namespace
+
+PriorityWorkQueue::PriorityWorkQueue(unsigned int threadCount)
+{
+    m_threads.reserve(std::max(threadCount, 1u));
+    for (auto i{ 0u }; i != std::max(threadCount, 1u); ++i)
+    {
+        m_threads.emplace_back(
+            [this](std::stop_token stopToken)
+            {
+                run(stopToken);
+            });
+    }
+}
+
+PriorityWorkQueue::~PriorityWorkQueue()
+{
+    for (auto& thread : m_threads)
+    {
+        thread.request_stop();
+    }
+    m_threads.clear();
+}
+
+void PriorityWorkQueue::push(LoadPriority priority, Job job)
+{
+    {
+        const std::scoped_lock lock{ m_mutex };
+        m_jobs.push_back(QueuedJob{ priority, m_nextSequenceNumber++, std::move(job) });
+        std::ranges::push_heap(m_jobs, s_isLessUrgent);
+    }
+    m_jobAvailable.notify_one();
+}
+
+void PriorityWorkQueue::run(std::stop_token stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        Job job{};
+        {
+            std::unique_lock lock{ m_mutex };
+            if (!m_jobAvailable.wait(
+                    lock,
+                    stopToken,
+                    [this]
+                    {
+                        return !m_jobs.empty();
+                    }))
+            {
+                // Stop was requested.
+                return;
+            }
+            std::ranges::pop_heap(m_jobs, s_isLessUrgent);
+            job = std::move(m_jobs.back().job);
+            m_jobs.pop_back();
+        }
+        job();
+    }
+}
+
+} // namespace VkTest1::Assets::Detail
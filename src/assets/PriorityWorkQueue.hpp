@@ -0,0 +1,50 @@
+#pragma once
+
+#include "assets/IAssetLoader.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VkTest1::Assets::Detail
+{
+
+// A set of worker threads serving a shared priority queue of jobs.
+class PriorityWorkQueue
+{
+public:
+    using Job = std::move_only_function<void()>;
+
+    explicit PriorityWorkQueue(unsigned int threadCount);
+
+    PriorityWorkQueue(const PriorityWorkQueue& other) = delete;
+    PriorityWorkQueue& operator=(const PriorityWorkQueue& other) = delete;
+
+    // Jobs that are still queued at destruction are dropped.
+    ~PriorityWorkQueue();
+
+    void push(LoadPriority priority, Job job);
+
+private:
+    struct QueuedJob
+    {
+        LoadPriority priority;
+        std::uint64_t sequenceNumber;
+        Job job;
+    };
+
+    void run(std::stop_token stopToken);
+
+    std::mutex m_mutex{};
+    std::condition_variable_any m_jobAvailable{};
+    // Max-heap ordered by (priority, -sequenceNumber).
+    std::vector<QueuedJob> m_jobs{};
+    std::uint64_t m_nextSequenceNumber{ 0 };
+    // Must be the last member so the threads are stopped before anything else is destroyed.
+    std::vector<std::jthread> m_threads{};
+};
+
+} // namespace VkTest1::Assets::Detail
@@ -0,0 +1,60 @@
+#include "common/CpuFeatures.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace VkTest1::Common
+{
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+
+bool isSse41Supported()
+{
+    int info[4]{};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+}
+
+bool isAvx2Supported()
+{
+    int info[4]{};
+    __cpuid(info, 1);
+    // AVX, and the OS saves the YMM registers (OSXSAVE, then XCR0 bits 1 and 2).
+    constexpr auto avxAndOsxsave{ (1 << 28) | (1 << 27) };
+    if ((info[2] & avxAndOsxsave) != avxAndOsxsave || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+#elif defined(__x86_64__) || defined(__i386__)
+
+bool isSse41Supported()
+{
+    return __builtin_cpu_supports("sse4.1");
+}
+
+bool isAvx2Supported()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+bool isSse41Supported()
+{
+    return false;
+}
+
+bool isAvx2Supported()
+{
+    return false;
+}
+
+#endif
+
+} // namespace VkTest1::Common
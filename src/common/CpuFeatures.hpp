@@ -0,0 +1,10 @@
+#pragma once
+
+namespace VkTest1::Common
+{
+
+// Whether the CPU and the OS support the instruction set. Always false on other architectures.
+bool isSse41Supported();
+bool isAvx2Supported();
+
+} // namespace VkTest1::Common
@@ -11,6 +11,18 @@ public:
     using std::runtime_error::runtime_error;
 };
 
+class FormatError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class SettingsError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
 class WindowError : public std::runtime_error
 {
 public:
@@ -23,4 +35,12 @@ public:
     using std::runtime_error::runtime_error;
 };
 
+// The device memory or an arena is exhausted. Unlike the other renderer errors, a retry can succeed once something was
+// freed.
+class OutOfMemoryError : public RendererError
+{
+public:
+    using RendererError::RendererError;
+};
+
 } // namespace VkTest1::Common
@@ -29,4 +29,24 @@ std::vector<std::byte> FileSystem::readFile(const std::filesystem::path& path)
     return contents;
 }
 
+std::vector<std::byte> FileSystem::readFileRange(
+    const std::filesystem::path& path, std::uint64_t offset, std::size_t size)
+{
+    std::ifstream fileStream{ path, std::ios::binary };
+    if (!fileStream.is_open())
+    {
+        throw IoError{ "Cannot open file." };
+    }
+
+    fileStream.seekg(static_cast<std::streamoff>(offset));
+    std::vector<std::byte> contents(size);
+    fileStream.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(size));
+    if (!fileStream.good())
+    {
+        throw IoError{ "Cannot read file." };
+    }
+
+    return contents;
+}
+
 } // namespace VkTest1::Common
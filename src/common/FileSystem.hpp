@@ -9,6 +9,9 @@ class FileSystem : public IFileSystem
 {
 public:
     std::vector<std::byte> readFile(const std::filesystem::path& path) override;
+
+    std::vector<std::byte> readFileRange(
+        const std::filesystem::path& path, std::uint64_t offset, std::size_t size) override;
 };
 
 } // namespace VkTest1::Common
@@ -0,0 +1,49 @@
+#include "common/FrameArena.hpp"
+
+#include "common/JobSystem.hpp"
+
+#include <cassert>
+
+namespace VkTest1::Common
+{
+
+FrameArena::FrameArena(NotNull<const JobSystem*> jobSystem, unsigned int frameCount, std::size_t capacity) :
+    m_jobSystem{ jobSystem },
+    m_arenasPerFrame{ jobSystem->getWorkerCount() + 1 }
+{
+    m_arenas.reserve(frameCount * m_arenasPerFrame);
+    for (auto i{ 0u }; i != frameCount * m_arenasPerFrame; ++i)
+    {
+        m_arenas.emplace_back(capacity);
+    }
+}
+
+void FrameArena::beginFrame(unsigned int frame)
+{
+    assert(frame * m_arenasPerFrame < m_arenas.size());
+    m_currentFrame = frame;
+    for (auto i{ 0u }; i != m_arenasPerFrame; ++i)
+    {
+        m_arenas[m_currentFrame * m_arenasPerFrame + i].reset();
+    }
+}
+
+std::pmr::memory_resource& FrameArena::getResource()
+{
+    const auto workerIndex{ m_jobSystem->getWorkerIndex() };
+    const auto arenaIndex{ workerIndex.has_value() ? *workerIndex + 1 : 0u };
+    assert(arenaIndex < m_arenasPerFrame);
+    return m_arenas[m_currentFrame * m_arenasPerFrame + arenaIndex];
+}
+
+std::size_t FrameArena::getUsedSize() const
+{
+    auto usedSize{ std::size_t{ 0 } };
+    for (auto i{ 0u }; i != m_arenasPerFrame; ++i)
+    {
+        usedSize += m_arenas[m_currentFrame * m_arenasPerFrame + i].getUsedSize();
+    }
+    return usedSize;
+}
+
+} // namespace VkTest1::Common
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common/LinearArena.hpp"
+#include "common/Types.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace VkTest1::Common
+{
+
+class JobSystem;
+
+//
+// Memory for the data that lives only during a frame (e.g. draw lists, sort keys, submit info arrays).
+//
+// Every frame in flight has its own arenas: one for the thread that draws and one per job system worker, so the jobs
+// of a frame (e.g. the cluster culling) allocate without locking. Beginning a frame frees what the same frame allocated last time, so the frame
+// must not be in use anymore (its fence has signaled), and neither may its jobs. Allocating never calls the heap once
+// the arenas have grown to the peak usage.
+//
+class FrameArena
+{
+public:
+    // capacity is the initial capacity of every arena.
+    explicit FrameArena(NotNull<const JobSystem*> jobSystem, unsigned int frameCount, std::size_t capacity);
+
+    // Makes the frame the current one and frees what it allocated last time.
+    void beginFrame(unsigned int frame);
+
+    // The arena of the calling thread: its own if it is a worker of the job system, otherwise the one of the thread
+    // that draws. Only that thread may use it. Valid until the current frame begins again.
+    std::pmr::memory_resource& getResource();
+
+    // Used by the current frame, in all its arenas.
+    std::size_t getUsedSize() const;
+
+private:
+    NotNull<const JobSystem*> m_jobSystem;
+    // The arena of the drawing thread, then the ones of the workers.
+    unsigned int m_arenasPerFrame;
+    std::vector<LinearArena> m_arenas{};
+    unsigned int m_currentFrame{ 0 };
+};
+
+} // namespace VkTest1::Common
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <vector>
 
@@ -12,6 +14,10 @@ public:
     virtual ~IFileSystem() = default;
 
     virtual std::vector<std::byte> readFile(const std::filesystem::path& path) = 0;
+
+    // The size bytes at the offset. Throws IoError if the file is shorter.
+    virtual std::vector<std::byte> readFileRange(
+        const std::filesystem::path& path, std::uint64_t offset, std::size_t size) = 0;
 };
 
 } // namespace VkTest1::Common
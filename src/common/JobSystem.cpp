@@ -0,0 +1,261 @@
+#include "common/JobSystem.hpp"
+
+namespace VkTest1::Common
+{
+
+namespace
+{
+
+// Enough for the chunks of a large parallel loop. More go to the shared queue.
+constexpr std::size_t s_dequeCapacity{ 4096 };
+
+struct CurrentWorker
+{
+    const JobSystem* jobSystem{ nullptr };
+    unsigned int index{ 0 };
+};
+
+thread_local CurrentWorker s_currentWorker{};
+
+} // namespace
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+    workerCount = std::max(workerCount, 1u);
+    m_deques.reserve(workerCount);
+    for (auto i{ 0u }; i != workerCount; ++i)
+    {
+        m_deques.push_back(std::make_unique<WorkStealingDeque<Job>>(s_dequeCapacity));
+    }
+
+    m_threads.reserve(workerCount);
+    for (auto i{ 0u }; i != workerCount; ++i)
+    {
+        m_threads.emplace_back(
+            [this, i](std::stop_token stopToken)
+            {
+                run(i, stopToken);
+            });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    for (auto& thread : m_threads)
+    {
+        thread.request_stop();
+    }
+    m_threads.clear();
+
+    for (auto& deque : m_deques)
+    {
+        while (auto* job{ deque->pop() })
+        {
+            delete job;
+        }
+    }
+    for (auto* job : m_sharedJobs)
+    {
+        delete job;
+    }
+}
+
+unsigned int JobSystem::getWorkerCount() const
+{
+    return static_cast<unsigned int>(m_deques.size());
+}
+
+std::optional<unsigned int> JobSystem::getWorkerIndex() const
+{
+    if (s_currentWorker.jobSystem != this)
+    {
+        return std::nullopt;
+    }
+    return s_currentWorker.index;
+}
+
+void JobSystem::schedule(JobFunction function, JobCounter* counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(new Job{ std::move(function), counter });
+}
+
+void JobSystem::scheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        const std::scoped_lock lock{ dependency.m_mutex };
+        if (dependency.m_count.load(std::memory_order_acquire) != 0)
+        {
+            dependency.m_continuations.emplace_back(std::move(function), counter);
+            return;
+        }
+    }
+    push(new Job{ std::move(function), counter });
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    while (counter.m_count.load(std::memory_order_acquire) != 0)
+    {
+        if (auto* job{ findJob() })
+        {
+            execute(job);
+        }
+        else
+        {
+            // The remaining jobs run on other threads.
+            std::this_thread::yield();
+        }
+    }
+
+    // Also waits until the thread that finished the last job has let go of the counter.
+    std::exception_ptr error{};
+    {
+        const std::scoped_lock lock{ counter.m_mutex };
+        error = std::exchange(counter.m_error, nullptr);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::run(unsigned int workerIndex, std::stop_token stopToken)
+{
+    s_currentWorker = CurrentWorker{ this, workerIndex };
+
+    while (!stopToken.stop_requested())
+    {
+        if (auto* job{ findJob() })
+        {
+            execute(job);
+            continue;
+        }
+
+        // The scheduling thread increments the queued job count before it checks for sleeping workers, and this
+        // thread increments the sleeping worker count before it checks for queued jobs. So either this thread sees
+        // the job or the scheduling thread wakes it up.
+        std::unique_lock lock{ m_sleepMutex };
+        m_sleepingWorkerCount.fetch_add(1);
+        m_jobAvailable.wait(
+            lock,
+            stopToken,
+            [this]
+            {
+                return m_queuedJobCount.load() != 0;
+            });
+        m_sleepingWorkerCount.fetch_sub(1);
+    }
+}
+
+void JobSystem::push(Job* job)
+{
+    m_queuedJobCount.fetch_add(1);
+
+    const auto workerIndex{ getWorkerIndex() };
+    if (!workerIndex.has_value() || !m_deques[*workerIndex]->push(job))
+    {
+        const std::scoped_lock lock{ m_sharedJobsMutex };
+        m_sharedJobs.push_back(job);
+        m_sharedJobCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (m_sleepingWorkerCount.load() != 0)
+    {
+        const std::scoped_lock lock{ m_sleepMutex };
+        m_jobAvailable.notify_one();
+    }
+}
+
+JobSystem::Job* JobSystem::findJob()
+{
+    const auto workerIndex{ getWorkerIndex() };
+
+    Job* job{ nullptr };
+    if (workerIndex.has_value())
+    {
+        job = m_deques[*workerIndex]->pop();
+    }
+
+    if (job == nullptr && m_sharedJobCount.load(std::memory_order_relaxed) != 0)
+    {
+        const std::scoped_lock lock{ m_sharedJobsMutex };
+        if (!m_sharedJobs.empty())
+        {
+            job = m_sharedJobs.front();
+            m_sharedJobs.pop_front();
+            m_sharedJobCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Every thief starts at a different victim, so they don't all contend on the same deque.
+    const auto firstVictim{ workerIndex.has_value() ? *workerIndex + 1 : 0u };
+    for (auto i{ 0u }; job == nullptr && i != m_deques.size(); ++i)
+    {
+        const auto victim{ (firstVictim + i) % getWorkerCount() };
+        if (victim != workerIndex)
+        {
+            job = m_deques[victim]->steal();
+        }
+    }
+
+    if (job != nullptr)
+    {
+        m_queuedJobCount.fetch_sub(1);
+    }
+    return job;
+}
+
+void JobSystem::execute(Job* job)
+{
+    const std::unique_ptr<Job> ownedJob{ job };
+    try
+    {
+        ownedJob->function();
+    }
+    catch (...)
+    {
+        if (ownedJob->counter != nullptr)
+        {
+            const std::scoped_lock lock{ ownedJob->counter->m_mutex };
+            if (!ownedJob->counter->m_error)
+            {
+                ownedJob->counter->m_error = std::current_exception();
+            }
+        }
+    }
+
+    if (ownedJob->counter != nullptr)
+    {
+        finish(*ownedJob->counter);
+    }
+}
+
+void JobSystem::finish(JobCounter& counter)
+{
+    std::vector<std::pair<JobFunction, JobCounter*>> continuations{};
+    {
+        // The waiting thread may destroy the counter as soon as the count is zero and the mutex is free.
+        const std::scoped_lock lock{ counter.m_mutex };
+        if (counter.m_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        continuations = std::exchange(counter.m_continuations, {});
+    }
+
+    for (auto& [function, continuationCounter] : continuations)
+    {
+        push(new Job{ std::move(function), continuationCounter });
+    }
+}
+
+} // namespace VkTest1::Common
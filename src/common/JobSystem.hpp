@@ -0,0 +1,175 @@
+#pragma once
+
+#include "common/WorkStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace VkTest1::Common
+{
+
+using JobFunction = std::move_only_function<void()>;
+
+//
+// Counts the unfinished jobs of a group. JobSystem::wait() returns when it reaches zero.
+//
+// A counter can be reused once wait() has returned. It must not be destroyed before that.
+//
+class JobCounter
+{
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter& other) = delete;
+    JobCounter& operator=(const JobCounter& other) = delete;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<std::uint32_t> m_count{ 0 };
+    // Guards the members below, and the last decrement of the count.
+    std::mutex m_mutex{};
+    // Scheduled when the count reaches zero, with the counter they count in.
+    std::vector<std::pair<JobFunction, JobCounter*>> m_continuations{};
+    // The first exception thrown by a job of the group.
+    std::exception_ptr m_error{};
+};
+
+//
+// A pool of worker threads shared by everything that has CPU work to spread over the cores.
+//
+// Every worker has its own work-stealing deque. The jobs a worker schedules go to its own deque and it runs them
+// newest first; idle workers steal the oldest jobs from the others. Jobs scheduled by other threads go to a shared
+// queue.
+//
+// Waiting for a counter doesn't block the thread: it runs other jobs until the counter reaches zero. So jobs can
+// wait for the jobs they spawned, and a thread that waits (e.g. the render thread) helps with the work.
+//
+// Jobs must not block (e.g. on I/O), because that keeps a core idle. Those belong on their own threads.
+//
+class JobSystem
+{
+public:
+    // At least one worker.
+    explicit JobSystem(unsigned int workerCount);
+
+    JobSystem(const JobSystem& other) = delete;
+    JobSystem& operator=(const JobSystem& other) = delete;
+
+    // Jobs that are still queued at destruction are dropped.
+    ~JobSystem();
+
+    unsigned int getWorkerCount() const;
+
+    // The index of the calling thread if it is one of the workers of this job system.
+    std::optional<unsigned int> getWorkerIndex() const;
+
+    // The counter, if any, counts the job until it has finished. Without a counter, an exception thrown by the job is
+    // dropped.
+    void schedule(JobFunction function, JobCounter* counter = nullptr);
+
+    // Schedules the job when all the jobs counted by dependency have finished.
+    // No job may be added to dependency after that until the continuations are scheduled.
+    void scheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+
+    // Runs other jobs until the jobs counted by counter have finished.
+    // Rethrows the first exception that one of them has thrown.
+    void wait(JobCounter& counter);
+
+    // Calls function(chunkBegin, chunkEnd) for chunks of [begin, end) of at most grainSize elements, in parallel.
+    // The calling thread takes a chunk too. Returns when all chunks are done. Rethrows the first exception.
+    template<typename TFunction>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, TFunction&& function)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grainSize = std::max<std::size_t>(grainSize, 1);
+
+        JobCounter counter{};
+        auto chunkBegin{ begin };
+        for (; end - chunkBegin > grainSize; chunkBegin += grainSize)
+        {
+            schedule(
+                [&function, chunkBegin, grainSize]
+                {
+                    function(chunkBegin, chunkBegin + grainSize);
+                },
+                &counter);
+        }
+
+        // The scheduled chunks refer to the function, so they must finish even if this one throws.
+        std::exception_ptr error{};
+        try
+        {
+            function(chunkBegin, end);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        try
+        {
+            wait(counter);
+        }
+        catch (...)
+        {
+            if (!error)
+            {
+                throw;
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Job
+    {
+        JobFunction function;
+        JobCounter* counter;
+    };
+
+    void run(unsigned int workerIndex, std::stop_token stopToken);
+
+    void push(Job* job);
+    // Nullptr if none was found.
+    Job* findJob();
+    void execute(Job* job);
+    void finish(JobCounter& counter);
+
+    // Per worker.
+    std::vector<std::unique_ptr<WorkStealingDeque<Job>>> m_deques{};
+
+    // Scheduled by threads that are not workers, or by workers whose deque is full.
+    std::mutex m_sharedJobsMutex{};
+    std::deque<Job*> m_sharedJobs{};
+    // Lets the workers skip the mutex while the shared queue is empty.
+    std::atomic<std::uint32_t> m_sharedJobCount{ 0 };
+
+    // Scheduled but not taken yet.
+    std::atomic<std::uint32_t> m_queuedJobCount{ 0 };
+    std::atomic<std::uint32_t> m_sleepingWorkerCount{ 0 };
+    std::mutex m_sleepMutex{};
+    std::condition_variable_any m_jobAvailable{};
+
+    // Must be the last member so the threads are stopped before anything else is destroyed.
+    std::vector<std::jthread> m_threads{};
+};
+
+} // namespace VkTest1::Common
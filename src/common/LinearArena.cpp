@@ -0,0 +1,98 @@
+#include "common/LinearArena.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace VkTest1::Common
+{
+
+LinearArena::LinearArena(std::size_t capacity)
+{
+    addBlock(std::max<std::size_t>(capacity, 1));
+}
+
+LinearArena::LinearArena(LinearArena&& other) noexcept :
+    m_blocks{ std::exchange(other.m_blocks, {}) },
+    m_offset{ std::exchange(other.m_offset, 0) },
+    m_previousBlocksUsedSize{ std::exchange(other.m_previousBlocksUsedSize, 0) }
+{
+}
+
+LinearArena& LinearArena::operator=(LinearArena&& other) noexcept
+{
+    m_blocks = std::exchange(other.m_blocks, {});
+    m_offset = std::exchange(other.m_offset, 0);
+    m_previousBlocksUsedSize = std::exchange(other.m_previousBlocksUsedSize, 0);
+    return *this;
+}
+
+void LinearArena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        const auto capacity{ getCapacity() };
+        m_blocks.clear();
+        addBlock(capacity);
+    }
+    m_offset = 0;
+    m_previousBlocksUsedSize = 0;
+}
+
+std::size_t LinearArena::getCapacity() const
+{
+    auto capacity{ std::size_t{ 0 } };
+    for (const auto& block : m_blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+std::size_t LinearArena::getUsedSize() const
+{
+    return m_previousBlocksUsedSize + m_offset;
+}
+
+void* LinearArena::do_allocate(std::size_t size, std::size_t alignment)
+{
+    if (m_blocks.empty())
+    {
+        // Moved from.
+        addBlock(size + alignment);
+    }
+    for (;;)
+    {
+        auto& block{ m_blocks.back() };
+        void* pointer{ block.memory.get() + m_offset };
+        auto space{ block.size - m_offset };
+        if (std::align(alignment, size, pointer, space) != nullptr)
+        {
+            m_offset = block.size - space + size;
+            return pointer;
+        }
+
+        // Big enough even if the new block needs the worst case padding.
+        addBlock(size + alignment);
+    }
+}
+
+void LinearArena::do_deallocate(void* /* pointer */, std::size_t /* size */, std::size_t /* alignment */)
+{
+    // Freed by reset().
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void LinearArena::addBlock(std::size_t minSize)
+{
+    // Doubling keeps the number of blocks logarithmic in the peak usage.
+    const auto size{ m_blocks.empty() ? minSize : std::max(minSize, m_blocks.back().size * 2) };
+    m_previousBlocksUsedSize += m_offset;
+    m_offset = 0;
+    m_blocks.push_back(Block{ std::make_unique_for_overwrite<std::byte[]>(size), size });
+}
+
+} // namespace VkTest1::Common
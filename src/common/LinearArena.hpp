@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace VkTest1::Common
+{
+
+//
+// A bump allocator: allocating moves a pointer forward, freeing does nothing, and reset() frees everything at once.
+// It is a std::pmr::memory_resource, so std::pmr containers can allocate from it.
+//
+// When a block is full, the arena allocates a bigger one. reset() merges the blocks into one that is as big as all
+// of them, so after a few cycles of similar size the arena doesn't allocate from the heap anymore.
+//
+// Not thread-safe. Every thread needs its own arena. A moved-from arena is empty and allocates a new block when it is
+// used again.
+//
+class LinearArena : public std::pmr::memory_resource
+{
+public:
+    explicit LinearArena(std::size_t capacity);
+
+    LinearArena(const LinearArena& other) = delete;
+    LinearArena(LinearArena&& other) noexcept;
+    LinearArena& operator=(const LinearArena& other) = delete;
+    LinearArena& operator=(LinearArena&& other) noexcept;
+
+    // Everything allocated since the last reset becomes invalid.
+    void reset();
+
+    // The size of all blocks.
+    std::size_t getCapacity() const;
+
+    // Allocated since the last reset, including the alignment padding.
+    std::size_t getUsedSize() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    void addBlock(std::size_t minSize);
+
+    // The last one is the one allocated from. Empty only if moved from.
+    std::vector<Block> m_blocks{};
+    // Into the last block.
+    std::size_t m_offset{ 0 };
+    // Used in the blocks before the last one.
+    std::size_t m_previousBlocksUsedSize{ 0 };
+};
+
+} // namespace VkTest1::Common
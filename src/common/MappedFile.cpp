@@ -0,0 +1,101 @@
+#include "MappedFile.hpp"
+
+#include "Errors.hpp"
+
+#include <cstdint>
+#include <format>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace VkTest1::Common
+{
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path, std::size_t size) :
+    m_size{ size }
+{
+    // Shared, so the readers can open it while it is mapped.
+    m_file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        /* lpSecurityAttributes */ nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        /* hTemplateFile */ nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file = nullptr;
+        throw IoError{ std::format("Cannot create '{}'.", path.string()) };
+    }
+    // Mapping sets the size of the file.
+    const auto size64{ static_cast<std::uint64_t>(size) };
+    m_mapping = CreateFileMappingW(
+        m_file,
+        /* lpFileMappingAttributes */ nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(size64 >> 32),
+        static_cast<DWORD>(size64),
+        /* lpName */ nullptr);
+    if (m_mapping != nullptr)
+    {
+        m_data = static_cast<std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    }
+    if (m_data == nullptr)
+    {
+        if (m_mapping != nullptr)
+        {
+            CloseHandle(m_mapping);
+        }
+        CloseHandle(m_file);
+        throw IoError{ std::format("Cannot map '{}'.", path.string()) };
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path, std::size_t size) :
+    m_size{ size }
+{
+    m_file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_file == -1)
+    {
+        throw IoError{ std::format("Cannot create '{}'.", path.string()) };
+    }
+    if (ftruncate(m_file, static_cast<off_t>(size)) == 0)
+    {
+        auto* const data{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, /* offset */ 0) };
+        m_data = (data != MAP_FAILED) ? static_cast<std::byte*>(data) : nullptr;
+    }
+    if (m_data == nullptr)
+    {
+        close(m_file);
+        throw IoError{ std::format("Cannot map '{}'.", path.string()) };
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    munmap(m_data, m_size);
+    close(m_file);
+}
+
+#endif
+
+} // namespace VkTest1::Common
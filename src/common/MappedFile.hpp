@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace VkTest1::Common
+{
+
+//
+// A file mapped into memory for reading and writing. Other processes that map the same file see the writes without
+// any system call, so it suits data that one process publishes and another one polls.
+//
+class MappedFile
+{
+public:
+    // Creates the file, or truncates it if it exists, and makes it size bytes long, all zero. Throws IoError.
+    explicit MappedFile(const std::filesystem::path& path, std::size_t size);
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    // The file stays, so a reader can still see the last data.
+    ~MappedFile();
+
+    std::span<std::byte> getData() const
+    {
+        return { m_data, m_size };
+    }
+
+private:
+#ifdef _WIN32
+    // HANDLEs, so this header does not need windows.h.
+    void* m_file{ nullptr };
+    void* m_mapping{ nullptr };
+#else
+    int m_file{ -1 };
+#endif
+    std::byte* m_data{ nullptr };
+    std::size_t m_size;
+};
+
+} // namespace VkTest1::Common
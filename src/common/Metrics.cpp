@@ -0,0 +1,143 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <iterator>
+#include <utility>
+
+namespace VkTest1::Common
+{
+
+namespace
+{
+
+// The name without its labels.
+std::string_view getFamily(std::string_view name)
+{
+    return name.substr(0, name.find('{'));
+}
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> upperBounds) :
+    m_upperBounds{ std::move(upperBounds) },
+    m_bucketCounts{ std::make_unique<std::atomic<std::uint64_t>[]>(m_upperBounds.size() + 1) }
+{
+    assert(std::ranges::is_sorted(m_upperBounds));
+}
+
+void Histogram::observe(double value)
+{
+    // A handful of bounds. A linear search beats a binary one.
+    auto bucket{ std::size_t{ 0 } };
+    while (bucket != m_upperBounds.size() && value > m_upperBounds[bucket])
+    {
+        ++bucket;
+    }
+    m_bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Counter& MetricsRegistry::addCounter(std::string_view name, std::string_view help)
+{
+    const std::scoped_lock lock{ m_mutex };
+    if (const auto* entry{ find(name) })
+    {
+        assert(entry->kind == Kind::Counter);
+        return m_counters[entry->index];
+    }
+    m_entries.push_back(Entry{ std::string{ name }, std::string{ help }, Kind::Counter, m_counters.size() });
+    return m_counters.emplace_back();
+}
+
+Gauge& MetricsRegistry::addGauge(std::string_view name, std::string_view help)
+{
+    const std::scoped_lock lock{ m_mutex };
+    if (const auto* entry{ find(name) })
+    {
+        assert(entry->kind == Kind::Gauge);
+        return m_gauges[entry->index];
+    }
+    m_entries.push_back(Entry{ std::string{ name }, std::string{ help }, Kind::Gauge, m_gauges.size() });
+    return m_gauges.emplace_back();
+}
+
+Histogram& MetricsRegistry::addHistogram(
+    std::string_view name, std::string_view help, std::vector<double> upperBounds)
+{
+    // The buckets are labeled, so the name cannot have labels of its own.
+    assert(getFamily(name) == name);
+    const std::scoped_lock lock{ m_mutex };
+    if (const auto* entry{ find(name) })
+    {
+        assert(entry->kind == Kind::Histogram);
+        return m_histograms[entry->index];
+    }
+    m_entries.push_back(Entry{ std::string{ name }, std::string{ help }, Kind::Histogram, m_histograms.size() });
+    return m_histograms.emplace_back(std::move(upperBounds));
+}
+
+void MetricsRegistry::format(std::string& text) const
+{
+    auto out{ std::back_inserter(text) };
+    const std::scoped_lock lock{ m_mutex };
+    std::string_view family{};
+    for (const auto& entry : m_entries)
+    {
+        if (getFamily(entry.name) != family)
+        {
+            family = getFamily(entry.name);
+            std::format_to(out, "# HELP {} {}\n", family, entry.help);
+            std::format_to(out, "# TYPE {} {}\n", family, toString(entry.kind));
+        }
+        switch (entry.kind)
+        {
+            case Kind::Counter:
+                std::format_to(out, "{} {}\n", entry.name, m_counters[entry.index].getValue());
+                break;
+            case Kind::Gauge:
+                std::format_to(out, "{} {}\n", entry.name, m_gauges[entry.index].getValue());
+                break;
+            case Kind::Histogram:
+            {
+                // The buckets of the format are cumulative.
+                const auto& histogram{ m_histograms[entry.index] };
+                const auto upperBounds{ histogram.getUpperBounds() };
+                std::uint64_t count{ 0 };
+                for (auto i{ std::size_t{ 0 } }; i != upperBounds.size(); ++i)
+                {
+                    count += histogram.getBucketCount(i);
+                    std::format_to(out, "{}_bucket{{le=\"{}\"}} {}\n", entry.name, upperBounds[i], count);
+                }
+                count += histogram.getBucketCount(upperBounds.size());
+                std::format_to(out, "{}_bucket{{le=\"+Inf\"}} {}\n", entry.name, count);
+                std::format_to(out, "{}_sum {}\n", entry.name, histogram.getSum());
+                std::format_to(out, "{}_count {}\n", entry.name, count);
+                break;
+            }
+        }
+    }
+}
+
+std::string_view MetricsRegistry::toString(Kind kind)
+{
+    switch (kind)
+    {
+        case Kind::Counter:
+            return "counter";
+        case Kind::Gauge:
+            return "gauge";
+        case Kind::Histogram:
+            return "histogram";
+    }
+    return {};
+}
+
+const MetricsRegistry::Entry* MetricsRegistry::find(std::string_view name) const
+{
+    const auto it{ std::ranges::find(m_entries, name, &Entry::name) };
+    return it != m_entries.end() ? &*it : nullptr;
+}
+
+} // namespace VkTest1::Common
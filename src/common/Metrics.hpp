@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VkTest1::Common
+{
+
+//
+// The metrics are updated from any thread without locking: every update is a relaxed atomic operation. A snapshot
+// may see one metric a few updates ahead of another, which is fine for monitoring.
+//
+
+// Only goes up, e.g. the number of draws so far.
+class Counter
+{
+public:
+    void add(std::uint64_t amount = 1)
+    {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getValue() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> m_value{ 0 };
+};
+
+// Goes up and down, e.g. the memory in use.
+class Gauge
+{
+public:
+    void set(double value)
+    {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    void add(double amount)
+    {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    double getValue() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> m_value{ 0.0 };
+};
+
+// The distribution of observed values, e.g. frame times. A value is counted in the first bucket whose upper bound is
+// at least the value, or in the overflow bucket after the last bound.
+class Histogram
+{
+public:
+    // The upper bounds must be in ascending order.
+    explicit Histogram(std::vector<double> upperBounds);
+
+    void observe(double value);
+
+    std::span<const double> getUpperBounds() const
+    {
+        return m_upperBounds;
+    }
+
+    // Of the bucket alone, not cumulative. There is one more bucket than upper bounds: the overflow bucket.
+    std::uint64_t getBucketCount(std::size_t bucket) const
+    {
+        return m_bucketCounts[bucket].load(std::memory_order_relaxed);
+    }
+
+    double getSum() const
+    {
+        return m_sum.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<double> m_upperBounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_bucketCounts;
+    std::atomic<double> m_sum{ 0.0 };
+};
+
+//
+// Owns the metrics of the program under unique names. The references it hands out stay valid as long as the
+// registry, so the hot paths keep them and never look a metric up.
+//
+// The names follow the Prometheus conventions, e.g. "renderer_draws_total". A name can carry labels, e.g.
+// "renderer_device_memory_bytes{heap=\"0\"}". The metrics of a family (same name without labels) share the help
+// text of the first one and must be added one after the other.
+//
+class MetricsRegistry
+{
+public:
+    // Adding takes a lock, so it is meant for startup. Adding a name again returns the metric of that name, which
+    // must be of the same kind.
+    Counter& addCounter(std::string_view name, std::string_view help);
+    Gauge& addGauge(std::string_view name, std::string_view help);
+    // The upper bounds are ignored if the name exists.
+    Histogram& addHistogram(std::string_view name, std::string_view help, std::vector<double> upperBounds);
+
+    // The current values in the Prometheus text format. Never blocks the updates, only the adds.
+    void format(std::string& text) const;
+
+private:
+    enum class Kind
+    {
+        Counter,
+        Gauge,
+        Histogram,
+    };
+
+    struct Entry
+    {
+        std::string name;
+        std::string help;
+        Kind kind;
+        // Into the deque of the kind.
+        std::size_t index;
+    };
+
+    // The type in the text format.
+    static std::string_view toString(Kind kind);
+
+    const Entry* find(std::string_view name) const;
+
+    mutable std::mutex m_mutex{};
+    // In the order they were added. Formatted in that order.
+    std::vector<Entry> m_entries{};
+    // Deques never move their elements.
+    std::deque<Counter> m_counters{};
+    std::deque<Gauge> m_gauges{};
+    std::deque<Histogram> m_histograms{};
+};
+
+} // namespace VkTest1::Common
@@ -0,0 +1,81 @@
+#include "MetricsExporter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string_view>
+
+namespace VkTest1::Common
+{
+
+MetricsExporter::MetricsExporter(
+    NotNull<const MetricsRegistry*> registry, const std::filesystem::path& path, std::chrono::milliseconds interval,
+    std::uint32_t capacity) :
+    m_registry{ registry },
+    m_interval{ interval },
+    m_file{ path, sizeof(MetricsFileHeader) + capacity }
+{
+    // The mapping is zero filled: sequence 0, no text.
+    auto& header{ *reinterpret_cast<MetricsFileHeader*>(m_file.getData().data()) };
+    std::ranges::copy(s_metricsFileMagic, header.magic);
+    header.version = s_metricsFileVersion;
+    header.capacity = capacity;
+    m_text.reserve(capacity);
+
+    m_thread = std::jthread{ [this](std::stop_token stopToken)
+                             {
+                                 run(stopToken);
+                             } };
+}
+
+void MetricsExporter::run(std::stop_token stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        writeSnapshot();
+
+        std::unique_lock lock{ m_mutex };
+        m_wakeUp.wait_for(
+            lock,
+            stopToken,
+            m_interval,
+            []
+            {
+                return false;
+            });
+    }
+
+    // The final values, e.g. the frame count at exit.
+    writeSnapshot();
+}
+
+void MetricsExporter::writeSnapshot()
+{
+    m_text.clear();
+    m_registry->format(m_text);
+
+    const auto data{ m_file.getData() };
+    auto& header{ *reinterpret_cast<MetricsFileHeader*>(data.data()) };
+    auto size{ m_text.size() };
+    if (size > header.capacity)
+    {
+        // Cut after the last line that fits. A partial line would be misread.
+        const auto lineEnd{ std::string_view{ m_text }.substr(0, header.capacity).rfind('\n') };
+        size = (lineEnd != std::string_view::npos) ? lineEnd + 1 : 0;
+    }
+
+    // Only this thread writes, so the sequence is read without contention.
+    const std::atomic_ref sequence{ header.sequence };
+    const auto startSequence{ sequence.load(std::memory_order_relaxed) };
+    sequence.store(startSequence + 1, std::memory_order_relaxed);
+    // The odd sequence becomes visible before any of the new data.
+    std::atomic_thread_fence(std::memory_order_release);
+    header.timestamp = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    header.size = size;
+    std::memcpy(data.data() + sizeof(MetricsFileHeader), m_text.data(), size);
+    sequence.store(startSequence + 2, std::memory_order_release);
+}
+
+} // namespace VkTest1::Common
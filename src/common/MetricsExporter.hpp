@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common/MappedFile.hpp"
+#include "common/Metrics.hpp"
+#include "common/Types.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+namespace VkTest1::Common
+{
+
+// At the start of the metrics file, followed by the capacity bytes of the text. Little endian, like every platform
+// the renderer runs on.
+struct MetricsFileHeader
+{
+    // s_metricsFileMagic.
+    char magic[8];
+    std::uint32_t version;
+    // Of the text, in bytes.
+    std::uint32_t capacity;
+    // Odd while a snapshot is written. Read and written atomically.
+    std::uint64_t sequence;
+    // Of the snapshot, in milliseconds since the Unix epoch.
+    std::uint64_t timestamp;
+    // Of the text of the snapshot, in bytes.
+    std::uint64_t size;
+};
+
+inline constexpr char s_metricsFileMagic[8]{ 'V', 'K', 'M', 'E', 'T', 'R', 'I', 'C' };
+inline constexpr std::uint32_t s_metricsFileVersion{ 1 };
+
+//
+// Writes snapshots of the registry to a memory-mapped file periodically, so a scraper process can read the metrics
+// without talking to the renderer. The snapshots are written on a thread of their own. The threads that update the
+// metrics never wait for it.
+//
+// The text is in the Prometheus text format. A reader maps the file and makes a consistent copy like this (a
+// seqlock):
+//
+//   1. Read the sequence (acquire). Retry later if it is odd.
+//   2. Copy the timestamp, the size and the text.
+//   3. Read the sequence again. If it changed, retry from 1.
+//
+// A snapshot longer than the capacity is cut after its last whole line.
+//
+class MetricsExporter
+{
+public:
+    // capacity is the size of the text in bytes. Throws IoError if the file cannot be mapped.
+    explicit MetricsExporter(
+        NotNull<const MetricsRegistry*> registry, const std::filesystem::path& path,
+        std::chrono::milliseconds interval, std::uint32_t capacity);
+
+    MetricsExporter(const MetricsExporter& other) = delete;
+    MetricsExporter& operator=(const MetricsExporter& other) = delete;
+
+    // Writes a last snapshot.
+    ~MetricsExporter() = default;
+
+private:
+    void run(std::stop_token stopToken);
+
+    void writeSnapshot();
+
+    NotNull<const MetricsRegistry*> m_registry;
+    const std::chrono::milliseconds m_interval;
+    MappedFile m_file;
+    // Only used by the exporter thread. Reused, so the snapshots don't allocate.
+    std::string m_text{};
+    std::mutex m_mutex{};
+    std::condition_variable_any m_wakeUp{};
+    // Must be the last member so the thread is stopped before anything else is destroyed.
+    std::jthread m_thread{};
+};
+
+} // namespace VkTest1::Common
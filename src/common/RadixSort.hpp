@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace VkTest1::Common
+{
+
+//
+// Sorts the items by a 64 bit key, stable, in O(n): eight counting sort passes of one key byte each, from the least
+// significant byte to the most significant one. Passes in which every key has the same byte are skipped, so keys
+// that use few of their bits sort faster.
+//
+// The scratch must have the size of the items. The sorted items end up in items.
+//
+template<typename T, typename TGetKey>
+void radixSort(std::span<T> items, std::span<T> scratch, TGetKey getKey)
+{
+    assert(scratch.size() == items.size());
+    constexpr auto byteCount{ sizeof(std::uint64_t) };
+    constexpr auto bucketCount{ std::size_t{ 256 } };
+
+    // The histograms of all passes in one read of the keys.
+    std::array<std::array<std::size_t, bucketCount>, byteCount> counts{};
+    for (const auto& item : items)
+    {
+        const std::uint64_t key{ getKey(item) };
+        for (auto byte{ 0u }; byte != byteCount; ++byte)
+        {
+            ++counts[byte][(key >> (byte * 8)) & 0xFF];
+        }
+    }
+
+    auto source{ items };
+    auto destination{ scratch };
+    for (auto byte{ 0u }; byte != byteCount; ++byte)
+    {
+        auto& byteCounts{ counts[byte] };
+        if (std::ranges::any_of(
+                byteCounts,
+                [&items](std::size_t count)
+                {
+                    return count == items.size();
+                }))
+        {
+            continue;
+        }
+
+        // The counts become the first index of each bucket.
+        auto offset{ std::size_t{ 0 } };
+        for (auto& count : byteCounts)
+        {
+            offset += std::exchange(count, offset);
+        }
+        for (auto& item : source)
+        {
+            const std::uint64_t key{ getKey(item) };
+            destination[byteCounts[(key >> (byte * 8)) & 0xFF]++] = std::move(item);
+        }
+        std::swap(source, destination);
+    }
+
+    if (source.data() != items.data())
+    {
+        std::ranges::move(source, items.begin());
+    }
+}
+
+} // namespace VkTest1::Common
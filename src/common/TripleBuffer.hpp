@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace VkTest1::Common
+{
+
+//
+// Hands the newest value from one producer thread to one consumer thread. Neither side locks or waits.
+//
+// There are three slots: the producer writes one, the consumer reads one, and the third one holds the value
+// published last. Publishing and picking up swap the own slot with that third one. If the producer publishes faster
+// than the consumer picks up, the values in between are overwritten, so the consumer always gets the newest one.
+//
+// The slots are reused. The producer must overwrite the whole value (e.g. assign it), because its slot holds an
+// older value.
+//
+template<typename T>
+class TripleBuffer
+{
+public:
+    // Producer only.
+    T& getWriteBuffer()
+    {
+        return m_slots[m_writeIndex];
+    }
+
+    // Producer only. Makes the write buffer the newest value and gets a free slot to write next.
+    void publish()
+    {
+        const auto previous{ m_shared.exchange(m_writeIndex | s_newFlag, std::memory_order_acq_rel) };
+        m_writeIndex = previous & s_indexMask;
+    }
+
+    // Consumer only. Picks up the newest value. Returns false if nothing was published since the last call; the
+    // read buffer stays the same then.
+    bool update()
+    {
+        if ((m_shared.load(std::memory_order_relaxed) & s_newFlag) == 0)
+        {
+            return false;
+        }
+        const auto previous{ m_shared.exchange(m_readIndex, std::memory_order_acq_rel) };
+        m_readIndex = previous & s_indexMask;
+        return true;
+    }
+
+    // Consumer only.
+    const T& getReadBuffer() const
+    {
+        return m_slots[m_readIndex];
+    }
+
+private:
+    static constexpr std::size_t s_cacheLineSize{ 64 };
+    static constexpr std::uint8_t s_indexMask{ 0x3 };
+    // Set while the shared slot holds a value the consumer has not picked up.
+    static constexpr std::uint8_t s_newFlag{ 0x4 };
+
+    std::array<T, 3> m_slots{};
+    // The index of the slot between the producer and the consumer, and the new flag.
+    alignas(s_cacheLineSize) std::atomic<std::uint8_t> m_shared{ 1 };
+    // Producer only.
+    alignas(s_cacheLineSize) std::uint8_t m_writeIndex{ 0 };
+    // Consumer only.
+    alignas(s_cacheLineSize) std::uint8_t m_readIndex{ 2 };
+};
+
+} // namespace VkTest1::Common
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VkTest1::Common
+{
+
+//
+// A Chase-Lev deque of pointers. The owner thread pushes and pops at the bottom without locking, any thread steals
+// from the top. The owner works on its newest items (warm in its cache), thieves take the oldest ones (usually the
+// biggest pieces of work that are left).
+//
+// The capacity is fixed. push() fails if the deque is full.
+//
+// Based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli, 2013).
+//
+template<typename T>
+class WorkStealingDeque
+{
+public:
+    // The capacity is rounded up to a power of two.
+    explicit WorkStealingDeque(std::size_t capacity) :
+        m_items(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+        m_mask{ static_cast<std::int64_t>(m_items.size() - 1) }
+    {
+    }
+
+    WorkStealingDeque(const WorkStealingDeque& other) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque& other) = delete;
+
+    // Owner only. Returns false if the deque is full.
+    bool push(T* item)
+    {
+        assert(item != nullptr);
+        const auto bottom{ m_bottom.load(std::memory_order_relaxed) };
+        const auto top{ m_top.load(std::memory_order_acquire) };
+        if (bottom - top > m_mask)
+        {
+            return false;
+        }
+        m_items[bottom & m_mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only. The newest item, or nullptr if the deque is empty.
+    T* pop()
+    {
+        const auto bottom{ m_bottom.load(std::memory_order_relaxed) - 1 };
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top{ m_top.load(std::memory_order_relaxed) };
+        if (top > bottom)
+        {
+            // Empty.
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto* item{ m_items[bottom & m_mask].load(std::memory_order_relaxed) };
+        if (top == bottom)
+        {
+            // The last item. A thief may be taking it at the same time; the one that moves the top wins.
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread. The oldest item, or nullptr if the deque is empty or another thread took the item first.
+    T* steal()
+    {
+        auto top{ m_top.load(std::memory_order_acquire) };
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom{ m_bottom.load(std::memory_order_acquire) };
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        auto* item{ m_items[top & m_mask].load(std::memory_order_relaxed) };
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return item;
+    }
+
+private:
+    static constexpr std::size_t s_cacheLineSize{ 64 };
+
+    std::vector<std::atomic<T*>> m_items;
+    const std::int64_t m_mask;
+    // The thieves and the owner contend on the top, only the owner writes the bottom.
+    alignas(s_cacheLineSize) std::atomic<std::int64_t> m_top{ 0 };
+    alignas(s_cacheLineSize) std::atomic<std::int64_t> m_bottom{ 0 };
+};
+
+} // namespace VkTest1::Common
@@ -0,0 +1,27 @@
+#include "geometry/MeshData.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Geometry
+{
+
+Bounds computeBounds(std::span<const Vertex> vertices)
+{
+    if (vertices.empty())
+    {
+        return {};
+    }
+
+    Bounds bounds{ vertices.front().position, vertices.front().position };
+    for (const auto& vertex : vertices)
+    {
+        for (auto axis{ 0 }; axis != 3; ++axis)
+        {
+            bounds.min[axis] = std::min(bounds.min[axis], vertex.position[axis]);
+            bounds.max[axis] = std::max(bounds.max[axis], vertex.position[axis]);
+        }
+    }
+    return bounds;
+}
+
+} // namespace VkTest1::Geometry
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "geometry/Vertex.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Geometry
+{
+
+// Axis aligned bounding box.
+struct Bounds
+{
+    Position min{ 0.0f, 0.0f, 0.0f };
+    Position max{ 0.0f, 0.0f, 0.0f };
+};
+
+// A level of detail: a range of the index buffer. All levels of a mesh share its vertices.
+struct MeshLod
+{
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+    // How far the surface of this level deviates from the full detail one, in the units of the positions.
+    float error;
+};
+
+// The limits of a meshlet. The usual mesh shader output limits, so the meshlets suit mesh shaders as well.
+constexpr std::uint32_t s_maxMeshletVertexCount{ 64 };
+constexpr std::uint32_t s_maxMeshletTriangleCount{ 124 };
+
+//
+// A cluster of neighboring triangles: a range of the index buffer with the bounds to cull it as a whole.
+//
+// The normal cone contains the normals (cross(p1 - p0, p2 - p0), normalized) of all triangles of the meshlet: they are
+// at most acos(sqrt(1 - coneCutoff^2)) away from the cone axis. A cutoff of 1 means the normals are too spread out to
+// cull the meshlet by them.
+//
+struct Meshlet
+{
+    // Of the bounding sphere.
+    Position center;
+    float radius;
+    glm::vec3 coneAxis;
+    // The sine of the cone's half angle.
+    float coneCutoff;
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+};
+
+// CPU side mesh data. This is what the asset loader produces and the renderer uploads.
+struct MeshData
+{
+    std::vector<Vertex> vertices;
+    // Triangle list. If empty, the vertices are drawn as a non-indexed triangle list.
+    std::vector<std::uint32_t> indices{};
+    Bounds bounds{};
+    // From the most to the least detailed. Empty means one level with all indices.
+    std::vector<MeshLod> lods{};
+    // Sorted by first index. Either empty, or they cover every LOD exactly.
+    std::vector<Meshlet> meshlets{};
+};
+
+Bounds computeBounds(std::span<const Vertex> vertices);
+
+} // namespace VkTest1::Geometry
@@ -0,0 +1,311 @@
+#include "geometry/MeshFile.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace VkTest1::Geometry
+{
+
+namespace
+{
+
+// More would not halve the triangle count down to anything useful.
+constexpr std::uint32_t s_maxLodCount{ 32 };
+
+constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::uint64_t getIndexSize(IndexType indexType)
+{
+    switch (indexType)
+    {
+        case IndexType::None:
+            return 0;
+        case IndexType::Uint16:
+            return sizeof(std::uint16_t);
+        case IndexType::Uint32:
+            return sizeof(std::uint32_t);
+    }
+    throw Common::FormatError{ "Mesh file: Unknown index type." };
+}
+
+bool isRangeInside(std::uint64_t offset, std::uint64_t size, std::uint64_t totalSize)
+{
+    return offset <= totalSize && size <= totalSize - offset;
+}
+
+std::uint64_t getVertexSize(const MeshFileHeader& header)
+{
+    if (header.version == 1 && header.vertexLayout == VertexLayout::PositionColor)
+    {
+        return 6 * sizeof(float);
+    }
+    if (header.version >= 2 && header.vertexLayout == VertexLayout::PositionColorTexCoord)
+    {
+        return sizeof(Vertex);
+    }
+    throw Common::FormatError{ "Mesh file: Unsupported vertex layout." };
+}
+
+// The LOD table follows the index data.
+std::uint64_t getLodDataOffset(const MeshFileHeader& header)
+{
+    const auto indexDataSize{ header.indexCount * getIndexSize(header.indexType) };
+    return alignUp(header.indexDataOffset + indexDataSize, s_meshFileDataAlignment);
+}
+
+bool isLodValid(const MeshLod& lod, std::uint64_t indexCount)
+{
+    return lod.indexCount % 3 == 0 && isRangeInside(lod.firstIndex, lod.indexCount, indexCount) &&
+           std::isfinite(lod.error) && lod.error >= 0.0f;
+}
+
+// Sorted, not overlapping, within the limits and inside the index data.
+bool areMeshletsValid(std::span<const Meshlet> meshlets, std::uint64_t indexCount)
+{
+    auto end{ std::uint64_t{ 0 } };
+    for (const auto& meshlet : meshlets)
+    {
+        if (meshlet.firstIndex < end || meshlet.indexCount == 0 || meshlet.indexCount % 3 != 0 ||
+            meshlet.indexCount > s_maxMeshletTriangleCount * 3 ||
+            !isRangeInside(meshlet.firstIndex, meshlet.indexCount, indexCount) || !std::isfinite(meshlet.radius) ||
+            !std::isfinite(meshlet.coneCutoff))
+        {
+            return false;
+        }
+        end = std::uint64_t{ meshlet.firstIndex } + meshlet.indexCount;
+    }
+    return true;
+}
+
+// Each LOD is split into meshlets exactly, and each meshlet is part of a LOD. The meshlets must be valid.
+bool doMeshletsCoverLods(std::span<const Meshlet> meshlets, std::span<const MeshLod> lods, std::uint64_t indexCount)
+{
+    if (indexCount > std::numeric_limits<std::uint32_t>::max())
+    {
+        return false;
+    }
+    // No LOD table is one level with all indices.
+    const MeshLod allIndices{ /* firstIndex */ 0, static_cast<std::uint32_t>(indexCount), /* error */ 0.0f };
+    std::vector<bool> isCovered(meshlets.size());
+    for (const auto& lod : lods.empty() ? std::span{ &allIndices, 1 } : lods)
+    {
+        // Sorted by first index, so the meshlets of a LOD follow each other.
+        auto it{ std::ranges::lower_bound(meshlets, lod.firstIndex, {}, &Meshlet::firstIndex) };
+        const auto lodEnd{ std::uint64_t{ lod.firstIndex } + lod.indexCount };
+        auto nextIndex{ std::uint64_t{ lod.firstIndex } };
+        for (; nextIndex < lodEnd && it != meshlets.end() && it->firstIndex == nextIndex; ++it)
+        {
+            nextIndex += it->indexCount;
+            isCovered[it - meshlets.begin()] = true;
+        }
+        if (nextIndex != lodEnd)
+        {
+            return false;
+        }
+    }
+    return std::ranges::all_of(
+        isCovered,
+        [](bool value)
+        {
+            return value;
+        });
+}
+
+// The meshlets must be valid.
+bool areMeshletVertexCountsValid(std::span<const Meshlet> meshlets, std::span<const std::uint32_t> indices)
+{
+    std::vector<std::uint32_t> vertices{};
+    vertices.reserve(s_maxMeshletTriangleCount * 3);
+    for (const auto& meshlet : meshlets)
+    {
+        const auto meshletIndices{ indices.subspan(meshlet.firstIndex, meshlet.indexCount) };
+        vertices.assign(meshletIndices.begin(), meshletIndices.end());
+        std::ranges::sort(vertices);
+        if (std::ranges::distance(vertices.begin(), std::ranges::unique(vertices).begin()) > s_maxMeshletVertexCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<std::byte> encodeMeshFile(const MeshData& meshData)
+{
+    MeshFileHeader header{};
+    header.indexType = meshData.indices.empty() ? IndexType::None : IndexType::Uint32;
+    header.vertexCount = meshData.vertices.size();
+    header.indexCount = meshData.indices.size();
+    header.vertexDataOffset = alignUp(sizeof(MeshFileHeader), s_meshFileDataAlignment);
+    const auto vertexDataSize{ header.vertexCount * sizeof(Vertex) };
+    header.indexDataOffset = alignUp(header.vertexDataOffset + vertexDataSize, s_meshFileDataAlignment);
+    const auto indexDataSize{ header.indexCount * sizeof(std::uint32_t) };
+    header.lodCount = static_cast<std::uint32_t>(meshData.lods.size());
+    const auto lodDataOffset{ getLodDataOffset(header) };
+    const auto lodDataSize{ meshData.lods.size() * sizeof(MeshLod) };
+    header.meshletCount = static_cast<std::uint32_t>(meshData.meshlets.size());
+    header.meshletDataOffset = alignUp(lodDataOffset + lodDataSize, s_meshFileDataAlignment);
+    const auto meshletDataSize{ meshData.meshlets.size() * sizeof(Meshlet) };
+    for (auto axis{ 0 }; axis != 3; ++axis)
+    {
+        header.boundsMin[axis] = meshData.bounds.min[axis];
+        header.boundsMax[axis] = meshData.bounds.max[axis];
+    }
+
+    std::vector<std::byte> contents(header.meshletDataOffset + meshletDataSize);
+    std::memcpy(contents.data(), &header, sizeof(header));
+    std::memcpy(contents.data() + header.vertexDataOffset, meshData.vertices.data(), vertexDataSize);
+    std::memcpy(contents.data() + header.indexDataOffset, meshData.indices.data(), indexDataSize);
+    std::memcpy(contents.data() + lodDataOffset, meshData.lods.data(), lodDataSize);
+    std::memcpy(contents.data() + header.meshletDataOffset, meshData.meshlets.data(), meshletDataSize);
+    return contents;
+}
+
+MeshData decodeMeshFile(std::span<const std::byte> contents)
+{
+    MeshFileHeader header{};
+    if (contents.size() < s_meshFileHeaderSizeV3)
+    {
+        throw Common::FormatError{ "Mesh file: Too small." };
+    }
+    // The fields after the version 3 header are zero if the file ends before them.
+    std::memcpy(&header, contents.data(), std::min<std::size_t>(contents.size(), sizeof(header)));
+
+    if (header.magic != s_meshFileMagic)
+    {
+        throw Common::FormatError{ "Mesh file: Bad magic number." };
+    }
+    if (header.version < 1 || header.version > s_meshFileVersion)
+    {
+        throw Common::FormatError{ "Mesh file: Unsupported version." };
+    }
+    if (header.version < 4)
+    {
+        // These bytes are already part of the data.
+        header.meshletCount = 0;
+        header.meshletDataOffset = 0;
+    }
+    else if (contents.size() < sizeof(header))
+    {
+        throw Common::FormatError{ "Mesh file: Too small." };
+    }
+    const auto vertexSize{ getVertexSize(header) };
+    if (header.vertexStride != vertexSize)
+    {
+        throw Common::FormatError{ "Mesh file: Unsupported vertex layout." };
+    }
+
+    const auto indexSize{ getIndexSize(header.indexType) };
+    const auto maxCount{ std::numeric_limits<std::uint64_t>::max() / sizeof(Vertex) };
+    if (header.vertexCount > maxCount || header.indexCount > maxCount ||
+        !isRangeInside(header.vertexDataOffset, header.vertexCount * vertexSize, contents.size()) ||
+        !isRangeInside(header.indexDataOffset, header.indexCount * indexSize, contents.size()))
+    {
+        throw Common::FormatError{ "Mesh file: Data out of range." };
+    }
+
+    MeshData meshData{};
+    meshData.vertices.resize(header.vertexCount);
+    if (vertexSize == sizeof(Vertex))
+    {
+        std::memcpy(
+            meshData.vertices.data(), contents.data() + header.vertexDataOffset, header.vertexCount * sizeof(Vertex));
+    }
+    else
+    {
+        // Version 1: The position and the color are the start of the current layout.
+        for (auto i{ 0ull }; i != header.vertexCount; ++i)
+        {
+            std::memcpy(&meshData.vertices[i], contents.data() + header.vertexDataOffset + i * vertexSize, vertexSize);
+        }
+    }
+
+    meshData.indices.resize(header.indexCount);
+    if (header.indexType == IndexType::Uint32)
+    {
+        std::memcpy(
+            meshData.indices.data(),
+            contents.data() + header.indexDataOffset,
+            header.indexCount * sizeof(std::uint32_t));
+    }
+    else if (header.indexType == IndexType::Uint16)
+    {
+        // The renderer works with 32 bit indices, so these must be widened.
+        for (auto i{ 0ull }; i != header.indexCount; ++i)
+        {
+            std::uint16_t index{};
+            std::memcpy(&index, contents.data() + header.indexDataOffset + i * sizeof(index), sizeof(index));
+            meshData.indices[i] = index;
+        }
+    }
+    // The meshes share the vertex buffer on the device, so an index past the vertices of this one would read another
+    // mesh's or past the end of the buffer.
+    if (!std::ranges::all_of(
+            meshData.indices,
+            [&header](std::uint32_t index)
+            {
+                return index < header.vertexCount;
+            }))
+    {
+        throw Common::FormatError{ "Mesh file: Index out of range." };
+    }
+
+    if (header.version >= 3 && header.lodCount != 0)
+    {
+        const auto lodDataOffset{ getLodDataOffset(header) };
+        if (header.indexCount == 0 || header.lodCount > s_maxLodCount ||
+            !isRangeInside(lodDataOffset, header.lodCount * sizeof(MeshLod), contents.size()))
+        {
+            throw Common::FormatError{ "Mesh file: LOD table out of range." };
+        }
+        meshData.lods.resize(header.lodCount);
+        std::memcpy(meshData.lods.data(), contents.data() + lodDataOffset, header.lodCount * sizeof(MeshLod));
+        if (!std::ranges::all_of(
+                meshData.lods,
+                [&header](const MeshLod& lod)
+                {
+                    return isLodValid(lod, header.indexCount);
+                }))
+        {
+            throw Common::FormatError{ "Mesh file: Invalid LOD." };
+        }
+    }
+
+    if (header.meshletCount != 0)
+    {
+        if (header.indexCount == 0 ||
+            !isRangeInside(header.meshletDataOffset, header.meshletCount * sizeof(Meshlet), contents.size()))
+        {
+            throw Common::FormatError{ "Mesh file: Meshlet table out of range." };
+        }
+        meshData.meshlets.resize(header.meshletCount);
+        std::memcpy(
+            meshData.meshlets.data(),
+            contents.data() + header.meshletDataOffset,
+            header.meshletCount * sizeof(Meshlet));
+        if (!areMeshletsValid(meshData.meshlets, header.indexCount) ||
+            !doMeshletsCoverLods(meshData.meshlets, meshData.lods, header.indexCount) ||
+            !areMeshletVertexCountsValid(meshData.meshlets, meshData.indices))
+        {
+            throw Common::FormatError{ "Mesh file: Invalid meshlet." };
+        }
+    }
+
+    for (auto axis{ 0 }; axis != 3; ++axis)
+    {
+        meshData.bounds.min[axis] = header.boundsMin[axis];
+        meshData.bounds.max[axis] = header.boundsMax[axis];
+    }
+    return meshData;
+}
+
+} // namespace VkTest1::Geometry
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Geometry
+{
+
+//
+// Binary mesh file format (.vtmesh).
+//
+// +--------------------+ offset 0
+// | MeshFileHeader     |
+// +--------------------+ header.vertexDataOffset (aligned to s_meshFileDataAlignment)
+// | Vertex data        | vertexCount * vertexStride bytes
+// +--------------------+ header.indexDataOffset (aligned to s_meshFileDataAlignment)
+// | Index data         | indexCount * index size bytes
+// +--------------------+ aligned to s_meshFileDataAlignment
+// | LOD table          | lodCount * MeshLod, ranges of the index data
+// +--------------------+ header.meshletDataOffset (aligned to s_meshFileDataAlignment)
+// | Meshlet table      | meshletCount * Meshlet, ranges of the index data
+// +--------------------+
+//
+// All values are little endian. The vertex and index data have exactly the layout the renderer
+// uploads, so loading is a bounds check and a copy, no parsing.
+//
+
+constexpr std::uint32_t s_meshFileMagic{ 0x4D54'4B56 }; // "VKTM"
+// Version 1 files have the PositionColor layout. They are still read; their texture coordinates are 0.
+// Version 2 files have no LOD table. They are still read as one level.
+// Version 3 files have a shorter header (s_meshFileHeaderSizeV3) and no meshlets. They are still read.
+constexpr std::uint32_t s_meshFileVersion{ 4 };
+constexpr std::uint64_t s_meshFileHeaderSizeV3{ 80 };
+constexpr std::uint64_t s_meshFileDataAlignment{ 16 };
+
+enum class VertexLayout : std::uint32_t
+{
+    // float3 position, float3 color.
+    PositionColor = 0,
+    // Geometry::Vertex: float3 position, float3 color, float2 texture coordinate.
+    PositionColorTexCoord = 1
+};
+
+enum class IndexType : std::uint32_t
+{
+    None = 0,
+    Uint16 = 1,
+    Uint32 = 2
+};
+
+struct MeshFileHeader
+{
+    std::uint32_t magic{ s_meshFileMagic };
+    std::uint32_t version{ s_meshFileVersion };
+    VertexLayout vertexLayout{ VertexLayout::PositionColorTexCoord };
+    std::uint32_t vertexStride{ sizeof(Vertex) };
+    IndexType indexType{ IndexType::None };
+    // Zero if the file has no LOD table.
+    std::uint32_t lodCount{ 0 };
+    std::uint64_t vertexCount{ 0 };
+    std::uint64_t indexCount{ 0 };
+    std::uint64_t vertexDataOffset{ 0 };
+    std::uint64_t indexDataOffset{ 0 };
+    float boundsMin[3]{};
+    float boundsMax[3]{};
+    // Version 4.
+    std::uint32_t meshletCount{ 0 };
+    std::uint32_t reserved{ 0 };
+    std::uint64_t meshletDataOffset{ 0 };
+};
+
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "The file format expects tightly packed vertices.");
+static_assert(sizeof(MeshFileHeader) == 96, "The header layout is part of the file format.");
+static_assert(sizeof(MeshLod) == 12, "The LOD table layout is part of the file format.");
+static_assert(sizeof(Meshlet) == 40, "The meshlet table layout is part of the file format.");
+
+std::vector<std::byte> encodeMeshFile(const MeshData& meshData);
+
+// Throws Common::FormatError if the contents are not a valid mesh file. Besides the ranges, that includes an index of
+// a vertex the file doesn't have and meshlets that don't cover every LOD exactly or have too many vertices.
+MeshData decodeMeshFile(std::span<const std::byte> contents);
+
+} // namespace VkTest1::Geometry
@@ -7,12 +7,14 @@ namespace VkTest1::Geometry
 
 using Position = glm::vec3;
 using Color = glm::vec3;
+using TexCoord = glm::vec2;
 
 // Vertex data representation
 struct Vertex
 {
     Position position; // Vertex Position (x, y, z)
     Color color; // Vertex Colour (r, g, b)
+    TexCoord texCoord{ 0.0f, 0.0f }; // Texture coordinate (u, v). (0, 0) is the top left corner of the texture.
 };
 
 class Mesh
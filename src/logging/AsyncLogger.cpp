@@ -0,0 +1,192 @@
+#include "logging/AsyncLogger.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Logging::Detail
+{
+
+namespace
+{
+
+// Short enough that messages show up without a noticeable delay, long enough that the sink does not compete with
+// the frame loop.
+constexpr std::chrono::milliseconds s_flushInterval{ 10 };
+
+std::atomic<std::uint64_t> s_nextLoggerId{ 1 };
+
+struct ThreadBuffer
+{
+    std::uint64_t loggerId;
+    LogRingBuffer* buffer;
+};
+
+// The buffers of this thread, one per logger it logged to. There are only a few loggers, so a search is fast.
+thread_local std::vector<ThreadBuffer> s_threadBuffers{};
+
+void formatLine(std::string& text, std::chrono::system_clock::time_point time, Severity severity)
+{
+    std::format_to(
+        std::back_inserter(text), "{:%H:%M:%S} {:<7} ",
+        std::chrono::floor<std::chrono::milliseconds>(time), toString(severity));
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger(Severity minSeverity, const std::filesystem::path& filePath, std::size_t bufferCapacity) :
+    m_id{ s_nextLoggerId++ },
+    m_minSeverity{ minSeverity },
+    m_bufferCapacity{ std::max<std::size_t>(bufferCapacity, 1) }
+{
+    if (!filePath.empty())
+    {
+        m_file.open(filePath);
+        if (!m_file.is_open())
+        {
+            throw Common::IoError{ "Cannot open log file." };
+        }
+    }
+
+    m_sinkThread = std::jthread{ [this](std::stop_token stopToken)
+                                 {
+                                     runSink(stopToken);
+                                 } };
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    m_sinkThread.request_stop();
+    m_sinkThread.join();
+}
+
+bool AsyncLogger::isEnabled(Severity severity) const
+{
+    return severity >= m_minSeverity;
+}
+
+void AsyncLogger::write(const LogMessage& message)
+{
+    if (!getThreadBuffer().push(message))
+    {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+LogRingBuffer& AsyncLogger::getThreadBuffer()
+{
+    const auto it{ std::ranges::find(s_threadBuffers, m_id, &ThreadBuffer::loggerId) };
+    if (it != s_threadBuffers.end())
+    {
+        return *it->buffer;
+    }
+
+    // First message of this thread to this logger. The buffer stays with the logger even after the thread exits, so
+    // the sink never reads a freed buffer.
+    auto buffer{ std::make_unique<LogRingBuffer>(m_bufferCapacity) };
+    s_threadBuffers.push_back(ThreadBuffer{ m_id, buffer.get() });
+    const std::scoped_lock lock{ m_buffersMutex };
+    return *m_buffers.emplace_back(std::move(buffer));
+}
+
+void AsyncLogger::runSink(std::stop_token stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        flush();
+
+        std::unique_lock lock{ m_sinkMutex };
+        m_sinkWakeUp.wait_for(
+            lock,
+            stopToken,
+            s_flushInterval,
+            []
+            {
+                return false;
+            });
+    }
+
+    // Messages logged right before the stop.
+    flush();
+}
+
+void AsyncLogger::flush()
+{
+    {
+        const std::scoped_lock lock{ m_buffersMutex };
+        for (auto& buffer : m_buffers)
+        {
+            buffer->popAll(
+                [this](const LogMessage& message)
+                {
+                    const auto extraText{ message.getExtraText() };
+                    m_pending.push_back(PendingMessage{ message, m_pendingExtraText.size() });
+                    m_pendingExtraText.insert(m_pendingExtraText.end(), extraText.begin(), extraText.end());
+                });
+        }
+    }
+
+    const auto droppedCount{ m_droppedCount.exchange(0, std::memory_order_relaxed) };
+    if (m_pending.empty() && droppedCount == 0)
+    {
+        return;
+    }
+
+    // Every buffer is in order on its own. Interleave the threads by time.
+    std::ranges::stable_sort(
+        m_pending,
+        {},
+        [](const PendingMessage& pending)
+        {
+            return pending.message.getTime();
+        });
+
+    m_text.clear();
+    auto truncatedCount{ 0u };
+    for (const auto& pending : m_pending)
+    {
+        const auto message{ pending.message.withExtraText(std::span{ m_pendingExtraText }.subspan(
+            pending.extraTextOffset, pending.message.getExtraText().size())) };
+        truncatedCount += message.isTruncated() ? 1 : 0;
+        formatLine(m_text, message.getTime(), message.getSeverity());
+        try
+        {
+            message.formatTo(m_text);
+        }
+        catch (const std::format_error& ex)
+        {
+            m_text += std::format("<Cannot format message: {}>", ex.what());
+        }
+        m_text += '\n';
+    }
+    if (droppedCount != 0)
+    {
+        formatLine(m_text, std::chrono::system_clock::now(), Severity::Warning);
+        m_text += std::format("Logger: Dropped {} messages. The log buffers were full.\n", droppedCount);
+    }
+    if (truncatedCount != 0)
+    {
+        formatLine(m_text, std::chrono::system_clock::now(), Severity::Warning);
+        m_text += std::format(
+            "Logger: Truncated {} messages. Their strings were longer than {} bytes.\n",
+            truncatedCount,
+            LogMessage::s_maxExtraTextSize);
+    }
+    m_pending.clear();
+    m_pendingExtraText.clear();
+
+    auto& output{ getOutput() };
+    output.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+    output.flush();
+}
+
+std::ostream& AsyncLogger::getOutput()
+{
+    return m_file.is_open() ? m_file : std::cout;
+}
+
+} // namespace VkTest1::Logging::Detail
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "logging/ILogger.hpp"
+#include "logging/LogRingBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VkTest1::Logging::Detail
+{
+
+//
+// Logs without blocking the calling threads on I/O.
+//
+// Every thread that logs gets its own lock-free ring buffer on its first message to the logger. Writing a message
+// only captures its arguments into that buffer. A background sink thread collects the messages of all buffers
+// periodically, formats them in time order and writes them out in one go.
+//
+// If a thread logs faster than the sink drains (e.g. a flood of validation messages), its newest messages are
+// dropped and the sink reports how many were lost. It also reports how many were truncated.
+//
+class AsyncLogger : public ILogger
+{
+public:
+    // Writes to stdout if filePath is empty.
+    // bufferCapacity is the number of messages per thread. A message with extra text counts as several.
+    explicit AsyncLogger(Severity minSeverity, const std::filesystem::path& filePath, std::size_t bufferCapacity);
+
+    AsyncLogger(const AsyncLogger& other) = delete;
+    AsyncLogger& operator=(const AsyncLogger& other) = delete;
+
+    // Writes out every message logged so far.
+    ~AsyncLogger() override;
+
+    bool isEnabled(Severity severity) const override;
+
+    void write(const LogMessage& message) override;
+
+private:
+    struct PendingMessage
+    {
+        LogMessage message;
+        // In m_pendingExtraText.
+        std::size_t extraTextOffset;
+    };
+
+    LogRingBuffer& getThreadBuffer();
+
+    void runSink(std::stop_token stopToken);
+
+    // Writes out the messages of every buffer.
+    void flush();
+
+    std::ostream& getOutput();
+
+    // Identifies this logger in the thread local buffer lists. Unlike the address, it is never reused, so the entries
+    // of destroyed loggers never match.
+    const std::uint64_t m_id;
+    const Severity m_minSeverity;
+    const std::size_t m_bufferCapacity;
+    std::ofstream m_file{};
+    std::mutex m_buffersMutex{};
+    std::vector<std::unique_ptr<LogRingBuffer>> m_buffers{};
+    std::atomic<std::uint64_t> m_droppedCount{ 0 };
+    // Only used by the sink thread.
+    std::vector<PendingMessage> m_pending{};
+    // The extra text of the pending messages.
+    std::vector<std::byte> m_pendingExtraText{};
+    std::string m_text{};
+    std::mutex m_sinkMutex{};
+    std::condition_variable_any m_sinkWakeUp{};
+    // Must be the last member so the sink is stopped before anything else is destroyed.
+    std::jthread m_sinkThread{};
+};
+
+} // namespace VkTest1::Logging::Detail
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "logging/LogMessage.hpp"
+
+#include <format>
+#include <utility>
+
+namespace VkTest1::Logging
+{
+
+class ILogger
+{
+public:
+    virtual ~ILogger() = default;
+
+    // Messages below the minimum severity are not even captured.
+    virtual bool isEnabled(Severity severity) const = 0;
+
+    // Safe to call from any thread. Never blocks: The message is dropped if the buffer of the calling thread is
+    // full. The extra text of the message is copied, so it only needs to be valid during the call.
+    virtual void write(const LogMessage& message) = 0;
+
+    template<typename... TArgs>
+    void log(Severity severity, std::format_string<TArgs...> format, TArgs&&... args)
+    {
+        if (isEnabled(severity))
+        {
+            // Only written to as far as the strings need it, so it costs nothing for short messages.
+            LogMessage::ExtraTextBuffer extraText;
+            write(LogMessage::create(severity, extraText, format, std::forward<TArgs>(args)...));
+        }
+    }
+
+    template<typename... TArgs>
+    void debug(std::format_string<TArgs...> format, TArgs&&... args)
+    {
+        log(Severity::Debug, format, std::forward<TArgs>(args)...);
+    }
+
+    template<typename... TArgs>
+    void info(std::format_string<TArgs...> format, TArgs&&... args)
+    {
+        log(Severity::Info, format, std::forward<TArgs>(args)...);
+    }
+
+    template<typename... TArgs>
+    void warning(std::format_string<TArgs...> format, TArgs&&... args)
+    {
+        log(Severity::Warning, format, std::forward<TArgs>(args)...);
+    }
+
+    template<typename... TArgs>
+    void error(std::format_string<TArgs...> format, TArgs&&... args)
+    {
+        log(Severity::Error, format, std::forward<TArgs>(args)...);
+    }
+};
+
+} // namespace VkTest1::Logging
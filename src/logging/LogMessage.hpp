@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace VkTest1::Logging
+{
+
+enum class Severity : std::uint8_t
+{
+    Debug,
+    Info,
+    Warning,
+    Error,
+};
+
+constexpr std::string_view toString(Severity severity)
+{
+    switch (severity)
+    {
+        case Severity::Debug:
+            return "DEBUG";
+        case Severity::Info:
+            return "INFO";
+        case Severity::Warning:
+            return "WARNING";
+        case Severity::Error:
+            return "ERROR";
+    }
+    return "?";
+}
+
+//
+// A log message whose formatting is deferred to the sink thread.
+//
+// The arguments are captured by value into a fixed size buffer:
+//
+// - Strings (anything convertible to std::string_view) are copied after the other arguments.
+//   Strings that do not fit go to the extra text, a buffer of the caller that the message points to.
+//   What doesn't fit there either is truncated, and the formatted message ends with a marker.
+// - Every other argument must be trivially copyable.
+//
+// So a message is trivially copyable as a whole and can be memcpy-ed into a ring buffer, with its extra text
+// after it. The format string must be a string literal, because only the pointer to it is kept.
+//
+class LogMessage
+{
+public:
+    static constexpr std::size_t s_dataSize{ 208 };
+    // Enough for the long validation messages.
+    static constexpr std::size_t s_maxExtraTextSize{ 4096 };
+
+    using ExtraTextBuffer = std::array<std::byte, s_maxExtraTextSize>;
+
+    // The message points to extraTextBuffer if the strings don't fit into it.
+    template<typename... TArgs>
+    static LogMessage create(
+        Severity severity, ExtraTextBuffer& extraTextBuffer, std::format_string<TArgs...> format, TArgs&&... args)
+    {
+        constexpr auto offsets{ getOffsets<Stored<std::remove_cvref_t<TArgs>>...>() };
+        static_assert(offsets.back() <= s_dataSize, "Too many log message arguments.");
+
+        LogMessage message{};
+        message.m_severity = severity;
+        message.m_time = std::chrono::system_clock::now();
+        message.m_format = format.get().data();
+        message.m_formatSize = static_cast<std::uint32_t>(format.get().size());
+        message.m_formatFunction = &formatArguments<Stored<std::remove_cvref_t<TArgs>>...>;
+
+        auto textOffset{ offsets.back() };
+        auto index{ 0u };
+        (message.store(offsets[index++], textOffset, extraTextBuffer, args), ...);
+        if (message.m_extraTextSize != 0)
+        {
+            message.m_extraText = extraTextBuffer.data();
+        }
+        return message;
+    }
+
+    Severity getSeverity() const
+    {
+        return m_severity;
+    }
+
+    std::chrono::system_clock::time_point getTime() const
+    {
+        return m_time;
+    }
+
+    // The strings that did not fit into the message. Empty if all did.
+    std::span<const std::byte> getExtraText() const
+    {
+        return { m_extraText, m_extraTextSize };
+    }
+
+    // A copy whose extra text is the given copy of it.
+    LogMessage withExtraText(std::span<const std::byte> extraText) const
+    {
+        auto message{ *this };
+        message.m_extraText = extraText.data();
+        return message;
+    }
+
+    // True if strings were cut off because they didn't fit into the extra text either.
+    bool isTruncated() const
+    {
+        return m_isTruncated;
+    }
+
+    // Appends the formatted message. Throws std::format_error if the arguments do not match the format string.
+    void formatTo(std::string& text) const
+    {
+        m_formatFunction(*this, text);
+        if (m_isTruncated)
+        {
+            text += " [truncated]";
+        }
+    }
+
+private:
+    // Offsets from s_dataSize on are in the extra text.
+    struct StoredText
+    {
+        std::uint16_t offset;
+        std::uint16_t size;
+    };
+
+    template<typename T>
+    static constexpr bool s_isText{ std::is_convertible_v<const T&, std::string_view> };
+
+    template<typename T>
+    using Stored = std::conditional_t<s_isText<T>, StoredText, T>;
+
+    using FormatFunction = void (*)(const LogMessage& message, std::string& text);
+
+    // Byte offset of every stored argument. The last element is the end of the arguments.
+    template<typename... TStored>
+    static constexpr std::array<std::size_t, sizeof...(TStored) + 1> getOffsets()
+    {
+        std::array<std::size_t, sizeof...(TStored) + 1> offsets{};
+        auto index{ 0u };
+        ((offsets[index + 1] = offsets[index] + sizeof(TStored), ++index), ...);
+        return offsets;
+    }
+
+    template<typename... TStored>
+    static void formatArguments(const LogMessage& message, std::string& text)
+    {
+        constexpr auto offsets{ getOffsets<TStored...>() };
+        [&message, &text, &offsets]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            auto values{ std::tuple{ message.load<TStored>(offsets[I])... } };
+            std::apply(
+                [&message, &text](auto&... value)
+                {
+                    std::vformat_to(
+                        std::back_inserter(text), std::string_view{ message.m_format, message.m_formatSize },
+                        std::make_format_args(value...));
+                },
+                values);
+        }(std::index_sequence_for<TStored...>{});
+    }
+
+    template<typename T>
+    void store(std::size_t offset, std::size_t& textOffset, ExtraTextBuffer& extraTextBuffer, const T& argument)
+    {
+        if constexpr (s_isText<T>)
+        {
+            const std::string_view text{ argument };
+            StoredText storedText{};
+            if (text.size() <= s_dataSize - textOffset)
+            {
+                std::memcpy(m_data.data() + textOffset, text.data(), text.size());
+                storedText = { static_cast<std::uint16_t>(textOffset), static_cast<std::uint16_t>(text.size()) };
+                textOffset += text.size();
+            }
+            else
+            {
+                const auto size{ std::min<std::size_t>(text.size(), s_maxExtraTextSize - m_extraTextSize) };
+                m_isTruncated = m_isTruncated || size != text.size();
+                std::memcpy(extraTextBuffer.data() + m_extraTextSize, text.data(), size);
+                storedText = { static_cast<std::uint16_t>(s_dataSize + m_extraTextSize),
+                               static_cast<std::uint16_t>(size) };
+                m_extraTextSize += static_cast<std::uint16_t>(size);
+            }
+            std::memcpy(m_data.data() + offset, &storedText, sizeof(storedText));
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Log message arguments must be trivially copyable.");
+            std::memcpy(m_data.data() + offset, &argument, sizeof(T));
+        }
+    }
+
+    template<typename TStored>
+    auto load(std::size_t offset) const
+    {
+        std::array<std::byte, sizeof(TStored)> bytes{};
+        std::memcpy(bytes.data(), m_data.data() + offset, sizeof(TStored));
+        const auto value{ std::bit_cast<TStored>(bytes) };
+        if constexpr (std::is_same_v<TStored, StoredText>)
+        {
+            const auto* const text{ value.offset < s_dataSize ? m_data.data() + value.offset
+                                                               : m_extraText + (value.offset - s_dataSize) };
+            return std::string_view{ reinterpret_cast<const char*>(text), value.size };
+        }
+        else
+        {
+            return value;
+        }
+    }
+
+    Severity m_severity{};
+    bool m_isTruncated{ false };
+    std::uint16_t m_extraTextSize{ 0 };
+    std::uint32_t m_formatSize{};
+    std::chrono::system_clock::time_point m_time{};
+    const char* m_format{};
+    FormatFunction m_formatFunction{};
+    // Not owned. Valid as long as the buffer it points to.
+    const std::byte* m_extraText{};
+    std::array<std::byte, s_dataSize> m_data{};
+};
+
+static_assert(std::is_trivially_copyable_v<LogMessage>);
+static_assert(sizeof(LogMessage) == 248);
+
+} // namespace VkTest1::Logging
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "logging/LogMessage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Logging::Detail
+{
+
+//
+// Lock-free ring buffer of log messages with a single producer and a single consumer.
+//
+// A message takes one slot, its extra text the slots after it. So a long message is one record of several slots,
+// pushed and popped as a whole.
+//
+// The head and the tail live on separate cache lines, so the producer and the consumer do not invalidate each
+// other's line on every message.
+//
+class LogRingBuffer
+{
+public:
+    // In slots. A message with extra text needs more than one.
+    explicit LogRingBuffer(std::size_t capacity) :
+        m_slots(capacity)
+    {
+    }
+
+    // Producer only. Returns false if the buffer is full.
+    bool push(const LogMessage& message)
+    {
+        const auto extraText{ message.getExtraText() };
+        const auto slotCount{ 1 + (extraText.size() + sizeof(Slot) - 1) / sizeof(Slot) };
+        const auto head{ m_head.load(std::memory_order_relaxed) };
+        if (slotCount > m_slots.size() - (head - m_tail.load(std::memory_order_acquire)))
+        {
+            return false;
+        }
+        std::memcpy(getSlot(head).data(), &message, sizeof(message));
+        for (auto i{ std::size_t{ 1 } }; i != slotCount; ++i)
+        {
+            const auto offset{ (i - 1) * sizeof(Slot) };
+            std::memcpy(
+                getSlot(head + i).data(), extraText.data() + offset, std::min(sizeof(Slot), extraText.size() - offset));
+        }
+        m_head.store(head + slotCount, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Calls function for every message pushed so far, then frees their slots. The extra text of the
+    // message passed to the function is only valid during the call.
+    template<typename TFunction>
+    void popAll(TFunction&& function)
+    {
+        const auto tail{ m_tail.load(std::memory_order_relaxed) };
+        const auto head{ m_head.load(std::memory_order_acquire) };
+        for (auto i{ tail }; i != head;)
+        {
+            LogMessage message{};
+            std::memcpy(&message, getSlot(i).data(), sizeof(message));
+            ++i;
+            // The slots wrap around, so the extra text is gathered.
+            const auto extraTextSize{ message.getExtraText().size() };
+            m_extraText.resize(extraTextSize);
+            for (auto offset{ std::size_t{ 0 } }; offset < extraTextSize; offset += sizeof(Slot), ++i)
+            {
+                std::memcpy(
+                    m_extraText.data() + offset, getSlot(i).data(), std::min(sizeof(Slot), extraTextSize - offset));
+            }
+            function(message.withExtraText(m_extraText));
+        }
+        m_tail.store(head, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t s_cacheLineSize{ 64 };
+
+    struct Slot
+    {
+        alignas(LogMessage) std::array<std::byte, sizeof(LogMessage)> bytes;
+    };
+
+    std::span<std::byte> getSlot(std::uint64_t index)
+    {
+        return m_slots[index % m_slots.size()].bytes;
+    }
+
+    std::vector<Slot> m_slots;
+    // Only used by the consumer.
+    std::vector<std::byte> m_extraText{};
+    // Written by the producer.
+    alignas(s_cacheLineSize) std::atomic<std::uint64_t> m_head{ 0 };
+    // Written by the consumer.
+    alignas(s_cacheLineSize) std::atomic<std::uint64_t> m_tail{ 0 };
+};
+
+} // namespace VkTest1::Logging::Detail
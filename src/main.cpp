@@ -1,39 +1,388 @@
 #include "Factory.hpp"
+#include "assets/IAssetLoader.hpp"
+#include "common/Errors.hpp"
 #include "common/IFileSystem.hpp"
+#include "common/JobSystem.hpp"
+#include "common/Metrics.hpp"
+#include "common/MetricsExporter.hpp"
+#include "common/Types.hpp"
+#include "geometry/MeshFile.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/ICaptureWriter.hpp"
 #include "renderer/IRenderer.hpp"
+#include "renderer/RendererSettings.hpp"
+#include "texture/TextureFile.hpp"
 #include "window/IWindow.hpp"
+#include "world/WorldStreamer.hpp"
 
-// Use a clip space between 0 to 1.
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <future>
 #include <memory>
+#include <optional>
 #include <print>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <vector>
 
 using namespace VkTest1;
 
-int main()
+namespace
 {
+
+struct Arguments
+{
+    Renderer::RendererSettings settings{};
+    Logging::Severity logLevel{ Logging::Severity::Info };
+    // Empty for stdout.
+    std::filesystem::path logFile{};
+    // Empty for no capture.
+    std::filesystem::path captureFile{};
+    // Empty for no export.
+    std::filesystem::path metricsFile{};
+    Common::Uint windowCount{ 1 };
+    // In the order of their texture index.
+    std::vector<std::string_view> texturePaths{};
+    struct MeshArgument
+    {
+        std::string_view path;
+        std::optional<std::uint32_t> texture;
+    };
+    std::vector<MeshArgument> meshes{};
+    // Empty for no world.
+    std::filesystem::path worldFile{};
+    World::WorldStreamerSettings worldSettings{};
+};
+
+Common::Uint parseWindowCount(std::string_view value)
+{
+    // One per display is the use case. More than this is most likely a typo.
+    constexpr Common::Uint maxWindowCount{ 16 };
+    auto windowCount = Common::Uint{ 0 };
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), windowCount);
+    if (ec != std::errc{} || end != value.data() + value.size() || windowCount == 0 || windowCount > maxWindowCount)
+    {
+        throw Common::SettingsError{ std::format("Invalid window count '{}'.", value) };
+    }
+    return windowCount;
+}
+
+// A non-negative number.
+template<typename T>
+T parseNumber(std::string_view key, std::string_view value)
+{
+    auto number = T{};
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (ec != std::errc{} || end != value.data() + value.size() || !(number >= T{ 0 }))
+    {
+        throw Common::SettingsError{ std::format("Invalid value '{}' for '{}'.", value, key) };
+    }
+    return number;
+}
+
+Logging::Severity parseLogLevel(std::string_view value)
+{
+    constexpr std::array<Logging::Severity, 4> severities{
+        Logging::Severity::Debug, Logging::Severity::Info, Logging::Severity::Warning, Logging::Severity::Error
+    };
+    const auto it = std::ranges::find_if(
+        severities,
+        [value](Logging::Severity severity)
+        {
+            return std::ranges::equal(
+                value,
+                Logging::toString(severity),
+                [](unsigned char lhs, unsigned char rhs)
+                {
+                    return std::tolower(lhs) == std::tolower(rhs);
+                });
+        });
+    if (it == severities.end())
+    {
+        throw Common::SettingsError{ std::format("Invalid log level '{}'.", value) };
+    }
+    return *it;
+}
+
+//
+// Options:
+//
+// --<setting>=<value> or --<setting> <value>: See RendererSettings.cpp for the settings.
+// --<flag> or --no-<flag>: Turns a flag setting on or off.
+// --config <file>: Applies a settings file ("key = value" lines).
+// --log-level <debug|info|warning|error>: Drops the log messages below this level. Default: info.
+// --log-file <file>: Writes the log to this file instead of stdout.
+// --window-count <n>: Opens n windows. The renderer draws the same scene into each of them. Default: 1.
+// --capture <file>: Writes every presented frame to this file (PPM stream if it ends in .ppm, raw RGBA8 otherwise).
+// --metrics-file <file>: Maps this file and writes the renderer metrics into it every second (see MetricsExporter.hpp).
+// --texture <file>: A texture file produced by texture_convert. The meshes after it use it, up to the next --texture.
+// --world <file>: Streams the chunks of a world file produced by world_build that are near the view.
+// --world-distance <units>: Loads the chunks this close to the view, unloads them at twice the distance. Default: 0.5.
+// --world-budget <MiB>: The chunk data loaded at a time. Default: 256.
+// --world-io-quota <KiB>: The chunk data whose reads start per frame. 0 is unlimited. Default: 0.
+//
+// The arguments are applied in order, so later ones override earlier ones.
+// Every argument that is not an option is a mesh file produced by mesh_convert.
+//
+Arguments parseArguments(std::span<char*> args, Common::IFileSystem& fileSystem)
+{
+    auto arguments = Arguments{};
+    // Of the meshes that come next.
+    auto texture = std::optional<std::uint32_t>{};
+    for (auto i = 0u; i != args.size(); ++i)
+    {
+        const auto arg = std::string_view{ args[i] };
+        if (!arg.starts_with("--"))
+        {
+            arguments.meshes.push_back(Arguments::MeshArgument{ arg, texture });
+            continue;
+        }
+
+        auto key = arg.substr(2);
+        auto value = std::string_view{};
+        if (const auto separator = key.find('='); separator != std::string_view::npos)
+        {
+            value = key.substr(separator + 1);
+            key = key.substr(0, separator);
+        }
+        else if (key.starts_with("no-") && Renderer::isFlagSetting(key.substr(3)))
+        {
+            key = key.substr(3);
+            value = "false";
+        }
+        else if (!Renderer::isFlagSetting(key) && i + 1 != args.size())
+        {
+            value = args[++i];
+        }
+
+        if (key == "config")
+        {
+            const auto text = fileSystem.readFile(value);
+            Renderer::applySettingsFile(
+                arguments.settings, std::string_view{ reinterpret_cast<const char*>(text.data()), text.size() });
+        }
+        else if (key == "log-level")
+        {
+            arguments.logLevel = parseLogLevel(value);
+        }
+        else if (key == "log-file")
+        {
+            arguments.logFile = value;
+        }
+        else if (key == "window-count")
+        {
+            arguments.windowCount = parseWindowCount(value);
+        }
+        else if (key == "capture")
+        {
+            arguments.captureFile = value;
+        }
+        else if (key == "metrics-file")
+        {
+            arguments.metricsFile = value;
+        }
+        else if (key == "texture")
+        {
+            texture = static_cast<std::uint32_t>(arguments.texturePaths.size());
+            arguments.texturePaths.push_back(value);
+        }
+        else if (key == "world")
+        {
+            arguments.worldFile = value;
+        }
+        else if (key == "world-distance")
+        {
+            arguments.worldSettings.loadDistance = parseNumber<float>(key, value);
+            arguments.worldSettings.unloadDistance = arguments.worldSettings.loadDistance * 2.0f;
+        }
+        else if (key == "world-budget")
+        {
+            arguments.worldSettings.memoryBudget = parseNumber<std::uint64_t>(key, value) << 20;
+        }
+        else if (key == "world-io-quota")
+        {
+            arguments.worldSettings.ioQuota = parseNumber<std::uint64_t>(key, value) << 10;
+        }
+        else
+        {
+            Renderer::applySetting(arguments.settings, key, value);
+        }
+    }
+    return arguments;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto getMillisecondsSinceStart = [startTime]
+    {
+        return std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - startTime }.count();
+    };
+
     try
     {
         auto factory = Factory{};
 
         auto fileSystem = factory.createFileSystem();
-        auto window = factory.createWindow();
-        auto renderer = factory.createRenderer(fileSystem.get(), window.get());
 
-        std::println("Running.");
+        const auto arguments =
+            parseArguments(std::span{ argv + 1, static_cast<std::size_t>(argc - 1) }, *fileSystem);
+
+        // Created before everything that logs, so it is destroyed after them.
+        auto logger = factory.createLogger(arguments.logLevel, arguments.logFile);
+        logger->info("Renderer settings:");
+        const auto settingsText = Renderer::formatSettings(arguments.settings);
+        for (const auto line : std::views::split(settingsText, '\n'))
+        {
+            if (!line.empty())
+            {
+                logger->info("  {}", std::string_view{ line.begin(), line.end() });
+            }
+        }
+
+        // Created before the renderer, which keeps references to its metrics. The exporter reads them until it is
+        // destroyed, right before the registry.
+        auto metricsRegistry = factory.createMetricsRegistry();
+        auto metricsExporter = std::unique_ptr<Common::MetricsExporter>{};
+        if (!arguments.metricsFile.empty())
+        {
+            metricsExporter = factory.createMetricsExporter(metricsRegistry.get(), arguments.metricsFile);
+        }
+
+        // Created before everything that schedules jobs, so it is destroyed after them.
+        auto jobSystem = factory.createJobSystem();
+
+        auto assetLoader = factory.createAssetLoader(fileSystem.get(), jobSystem.get());
 
-        while (!window->shouldClose())
+        // The meshes and textures load while the window and the renderer are created.
+        auto textures = std::vector<std::future<Texture::TextureData>>{};
+        for (const auto texturePath : arguments.texturePaths)
         {
-            renderer->draw();
-            window->handleEvents();
+            textures.push_back(
+                assetLoader->loadTexture(texturePath, Assets::LoadPriority::Normal, Texture::decodeTextureFile));
+        }
+        auto meshes = std::vector<std::future<Geometry::MeshData>>{};
+        for (const auto& mesh : arguments.meshes)
+        {
+            meshes.push_back(assetLoader->loadMesh(mesh.path, Assets::LoadPriority::Normal, Geometry::decodeMeshFile));
+        }
+
+        // Created before the renderer, which hands over the last frames when it is destroyed.
+        auto captureWriter = std::unique_ptr<Renderer::ICaptureWriter>{};
+        if (!arguments.captureFile.empty())
+        {
+            captureWriter = factory.createCaptureWriter(arguments.captureFile);
+        }
+
+        auto windows = std::vector<std::unique_ptr<Window::IWindow>>{};
+        auto windowPointers = std::vector<Common::NotNull<Window::IWindow*>>{};
+        for (auto i = 0u; i != arguments.windowCount; ++i)
+        {
+            windows.push_back(factory.createWindow());
+            windowPointers.push_back(windows.back().get());
+        }
+        auto renderer = factory.createRenderer(
+            assetLoader.get(),
+            jobSystem.get(),
+            std::move(windowPointers),
+            logger.get(),
+            metricsRegistry.get(),
+            arguments.settings);
+        logger->info("Startup: Renderer created after {:.1f} ms.", getMillisecondsSinceStart());
+
+        if (captureWriter)
+        {
+            renderer->setCaptureSink(
+                [&captureWriter](const Renderer::CapturedFrame& frame)
+                {
+                    captureWriter->write(frame);
+                });
+        }
+
+        // The textures first, so their indices are the ones the meshes refer to.
+        for (auto& texture : textures)
+        {
+            renderer->addTexture(std::move(texture));
+        }
+        for (auto i = 0u; i != meshes.size(); ++i)
+        {
+            renderer->addMesh(std::move(meshes[i]), arguments.meshes[i].texture);
+        }
+
+        // After the renderer, so it is destroyed before it. Its meshes refer to the textures by their numbers.
+        auto worldStreamer = std::unique_ptr<World::WorldStreamer>{};
+        if (!arguments.worldFile.empty())
+        {
+            worldStreamer = factory.createWorldStreamer(
+                fileSystem.get(),
+                assetLoader.get(),
+                renderer.get(),
+                logger.get(),
+                arguments.worldFile,
+                arguments.worldSettings);
+        }
+        // There is no camera: the vertices are in clip space, so the visible volume is the clip space.
+        const auto view =
+            Geometry::Bounds{ Geometry::Position{ -1.0f, -1.0f, 0.0f }, Geometry::Position{ 1.0f, 1.0f, 1.0f } };
+
+        logger->info("Running.");
+
+        // Closing any window ends the program.
+        const auto isAnyWindowClosed = [&windows]
+        {
+            return std::ranges::any_of(
+                windows,
+                [](const auto& window)
+                {
+                    return window->shouldClose();
+                });
+        };
+
+        // Reused, so the frame loop doesn't allocate.
+        auto frameState = Renderer::FrameState{};
+        frameState.windowSizes.resize(windows.size());
+        while (!isAnyWindowClosed())
+        {
+            frameState.time = std::chrono::steady_clock::now();
+            for (auto i = 0u; i != windows.size(); ++i)
+            {
+                frameState.windowSizes[i] = windows[i]->getSize();
+            }
+
+            if (worldStreamer)
+            {
+                worldStreamer->update(view);
+            }
+            renderer->draw(frameState);
+            if (frameState.frameNumber == 0)
+            {
+                // The first frame is presented, though the meshes may still be uploading.
+                logger->info("Startup: Time to first frame: {:.1f} ms.", getMillisecondsSinceStart());
+            }
+            ++frameState.frameNumber;
+
+            for (auto& window : windows)
+            {
+                window->handleEvents();
+            }
         }
 
-        std::println("Exitting.");
+        logger->info("Exitting.");
     }
     catch (const std::exception& ex)
     {
+        // The logger may not exist or may be gone already.
         std::println("EXCEPTION: {}", ex.what());
     }
 
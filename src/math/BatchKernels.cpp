@@ -0,0 +1,79 @@
+#include "math/BatchKernels.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Math::Detail
+{
+
+void multiplyScalar(
+    const ConstMat4Arrays& a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end)
+{
+    for (auto i{ begin }; i != end; ++i)
+    {
+        float aElements[16];
+        for (auto element{ 0u }; element != 16; ++element)
+        {
+            aElements[element] = a.elements[element][i];
+        }
+        multiplyUniformScalar(aElements, b, out, i, i + 1);
+    }
+}
+
+void multiplyUniformScalar(
+    const float* a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end)
+{
+    for (auto i{ begin }; i != end; ++i)
+    {
+        // Column by column, so out may be b: a column of b is read before the column of out is written.
+        for (auto column{ 0u }; column != 4; ++column)
+        {
+            const float b0{ b.elements[column * 4 + 0][i] };
+            const float b1{ b.elements[column * 4 + 1][i] };
+            const float b2{ b.elements[column * 4 + 2][i] };
+            const float b3{ b.elements[column * 4 + 3][i] };
+            for (auto row{ 0u }; row != 4; ++row)
+            {
+                const float product0{ a[0 * 4 + row] * b0 };
+                const float product1{ a[1 * 4 + row] * b1 };
+                const float product2{ a[2 * 4 + row] * b2 };
+                const float product3{ a[3 * 4 + row] * b3 };
+                out.elements[column * 4 + row][i] = product0 + product1 + product2 + product3;
+            }
+        }
+    }
+}
+
+void transformAabbsScalar(
+    const ConstMat4Arrays& matrices, const ConstAabbArrays& boxes, const AabbArrays& out, std::size_t begin,
+    std::size_t end)
+{
+    for (auto i{ begin }; i != end; ++i)
+    {
+        const float boxMin[3]{ boxes.min[0][i], boxes.min[1][i], boxes.min[2][i] };
+        const float boxMax[3]{ boxes.max[0][i], boxes.max[1][i], boxes.max[2][i] };
+        // Arvo: per output axis, the translation plus the smaller and the larger of the products with either corner.
+        for (auto row{ 0u }; row != 3; ++row)
+        {
+            auto outMin{ matrices.elements[3 * 4 + row][i] };
+            auto outMax{ outMin };
+            for (auto column{ 0u }; column != 3; ++column)
+            {
+                const float element{ matrices.elements[column * 4 + row][i] };
+                const float productMin{ element * boxMin[column] };
+                const float productMax{ element * boxMax[column] };
+                outMin = outMin + std::min(productMin, productMax);
+                outMax = outMax + std::max(productMin, productMax);
+            }
+            out.min[row][i] = outMin;
+            out.max[row][i] = outMax;
+        }
+    }
+}
+
+const BatchKernels& getScalarKernels()
+{
+    static constexpr BatchKernels s_kernels{ multiplyScalar, multiplyUniformScalar, transformAabbsScalar };
+    return s_kernels;
+}
+
+} // namespace VkTest1::Math::Detail
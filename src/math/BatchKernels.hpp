@@ -0,0 +1,70 @@
+#pragma once
+
+// Included by the translation units that are compiled with instruction set flags, so it must not pull in inline
+// functions of the standard library or glm: the linker could pick their copy for the whole program.
+#include <cstddef>
+
+namespace VkTest1::Math::Detail
+{
+
+// The 16 element arrays of a batch of column major 4x4 matrices. Element (column c, row r) is elements[c * 4 + r].
+struct Mat4Arrays
+{
+    float* elements[16];
+};
+
+struct ConstMat4Arrays
+{
+    const float* elements[16];
+};
+
+// The corner arrays of a batch of axis aligned boxes, x, y and z each.
+struct AabbArrays
+{
+    float* min[3];
+    float* max[3];
+};
+
+struct ConstAabbArrays
+{
+    const float* min[3];
+    const float* max[3];
+};
+
+//
+// The kernels of one instruction set. Each processes the matrices or boxes [begin, end) of its batches.
+//
+// The vector kernels do the same multiplications and additions in the same order as the scalar ones, without fused
+// multiply-add, and leave the remainder that doesn't fill a vector to them.
+//
+struct BatchKernels
+{
+    // out = a * b. out may be b, but not a.
+    void (*multiply)(
+        const ConstMat4Arrays& a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin,
+        std::size_t end);
+    // out = a * b with the same a, in the 16 elements of a, for every b. out may be b.
+    void (*multiplyUniform)(
+        const float* a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end);
+    // out = the bounds of the boxes transformed by the affine matrices. out may be boxes.
+    void (*transformAabbs)(
+        const ConstMat4Arrays& matrices, const ConstAabbArrays& boxes, const AabbArrays& out, std::size_t begin,
+        std::size_t end);
+};
+
+void multiplyScalar(
+    const ConstMat4Arrays& a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end);
+void multiplyUniformScalar(
+    const float* a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end);
+void transformAabbsScalar(
+    const ConstMat4Arrays& matrices, const ConstAabbArrays& boxes, const AabbArrays& out, std::size_t begin,
+    std::size_t end);
+
+const BatchKernels& getScalarKernels();
+// Null if the build has no kernels of the instruction set, e.g. on other architectures. Whether the CPU supports the
+// instruction set is up to the caller.
+const BatchKernels* getSse41Kernels();
+const BatchKernels* getAvx2Kernels();
+const BatchKernels* getNeonKernels();
+
+} // namespace VkTest1::Math::Detail
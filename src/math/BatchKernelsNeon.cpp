@@ -0,0 +1,125 @@
+#include "math/BatchKernels.hpp"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#include <arm_neon.h>
+
+namespace VkTest1::Math::Detail
+{
+
+namespace
+{
+
+constexpr std::size_t s_width{ 4 };
+
+// out = a * b for the 4 matrices at i, with the elements of a already in registers.
+// vmulq_f32 and vaddq_f32 rather than vmlaq_f32, which may fuse.
+void multiplyColumns(const float32x4_t (&a)[16], const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t i)
+{
+    for (auto column{ 0u }; column != 4; ++column)
+    {
+        const auto b0{ vld1q_f32(b.elements[column * 4 + 0] + i) };
+        const auto b1{ vld1q_f32(b.elements[column * 4 + 1] + i) };
+        const auto b2{ vld1q_f32(b.elements[column * 4 + 2] + i) };
+        const auto b3{ vld1q_f32(b.elements[column * 4 + 3] + i) };
+        for (auto row{ 0u }; row != 4; ++row)
+        {
+            const auto product0{ vmulq_f32(a[0 * 4 + row], b0) };
+            const auto product1{ vmulq_f32(a[1 * 4 + row], b1) };
+            const auto product2{ vmulq_f32(a[2 * 4 + row], b2) };
+            const auto product3{ vmulq_f32(a[3 * 4 + row], b3) };
+            vst1q_f32(
+                out.elements[column * 4 + row] + i,
+                vaddq_f32(vaddq_f32(vaddq_f32(product0, product1), product2), product3));
+        }
+    }
+}
+
+void multiply(
+    const ConstMat4Arrays& a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end)
+{
+    auto i{ begin };
+    for (; end - i >= s_width; i += s_width)
+    {
+        float32x4_t aElements[16];
+        for (auto element{ 0u }; element != 16; ++element)
+        {
+            aElements[element] = vld1q_f32(a.elements[element] + i);
+        }
+        multiplyColumns(aElements, b, out, i);
+    }
+    multiplyScalar(a, b, out, i, end);
+}
+
+void multiplyUniform(
+    const float* a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end)
+{
+    float32x4_t aElements[16];
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        aElements[element] = vdupq_n_f32(a[element]);
+    }
+    auto i{ begin };
+    for (; end - i >= s_width; i += s_width)
+    {
+        multiplyColumns(aElements, b, out, i);
+    }
+    multiplyUniformScalar(a, b, out, i, end);
+}
+
+void transformAabbs(
+    const ConstMat4Arrays& matrices, const ConstAabbArrays& boxes, const AabbArrays& out, std::size_t begin,
+    std::size_t end)
+{
+    auto i{ begin };
+    for (; end - i >= s_width; i += s_width)
+    {
+        float32x4_t boxMin[3];
+        float32x4_t boxMax[3];
+        for (auto axis{ 0u }; axis != 3; ++axis)
+        {
+            boxMin[axis] = vld1q_f32(boxes.min[axis] + i);
+            boxMax[axis] = vld1q_f32(boxes.max[axis] + i);
+        }
+        for (auto row{ 0u }; row != 3; ++row)
+        {
+            auto outMin{ vld1q_f32(matrices.elements[3 * 4 + row] + i) };
+            auto outMax{ outMin };
+            for (auto column{ 0u }; column != 3; ++column)
+            {
+                const auto element{ vld1q_f32(matrices.elements[column * 4 + row] + i) };
+                const auto productMin{ vmulq_f32(element, boxMin[column]) };
+                const auto productMax{ vmulq_f32(element, boxMax[column]) };
+                outMin = vaddq_f32(outMin, vminq_f32(productMin, productMax));
+                outMax = vaddq_f32(outMax, vmaxq_f32(productMin, productMax));
+            }
+            vst1q_f32(out.min[row] + i, outMin);
+            vst1q_f32(out.max[row] + i, outMax);
+        }
+    }
+    transformAabbsScalar(matrices, boxes, out, i, end);
+}
+
+} // namespace
+
+const BatchKernels* getNeonKernels()
+{
+    static constexpr BatchKernels s_kernels{ multiply, multiplyUniform, transformAabbs };
+    return &s_kernels;
+}
+
+} // namespace VkTest1::Math::Detail
+
+#else
+
+namespace VkTest1::Math::Detail
+{
+
+const BatchKernels* getNeonKernels()
+{
+    return nullptr;
+}
+
+} // namespace VkTest1::Math::Detail
+
+#endif
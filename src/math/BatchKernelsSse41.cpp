@@ -0,0 +1,124 @@
+#include "math/BatchKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+namespace VkTest1::Math::Detail
+{
+
+namespace
+{
+
+constexpr std::size_t s_width{ 4 };
+
+// out = a * b for the 4 matrices at i, with the elements of a already in registers.
+void multiplyColumns(const __m128 (&a)[16], const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t i)
+{
+    for (auto column{ 0u }; column != 4; ++column)
+    {
+        const auto b0{ _mm_loadu_ps(b.elements[column * 4 + 0] + i) };
+        const auto b1{ _mm_loadu_ps(b.elements[column * 4 + 1] + i) };
+        const auto b2{ _mm_loadu_ps(b.elements[column * 4 + 2] + i) };
+        const auto b3{ _mm_loadu_ps(b.elements[column * 4 + 3] + i) };
+        for (auto row{ 0u }; row != 4; ++row)
+        {
+            const auto product0{ _mm_mul_ps(a[0 * 4 + row], b0) };
+            const auto product1{ _mm_mul_ps(a[1 * 4 + row], b1) };
+            const auto product2{ _mm_mul_ps(a[2 * 4 + row], b2) };
+            const auto product3{ _mm_mul_ps(a[3 * 4 + row], b3) };
+            _mm_storeu_ps(
+                out.elements[column * 4 + row] + i,
+                _mm_add_ps(_mm_add_ps(_mm_add_ps(product0, product1), product2), product3));
+        }
+    }
+}
+
+void multiply(
+    const ConstMat4Arrays& a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end)
+{
+    auto i{ begin };
+    for (; end - i >= s_width; i += s_width)
+    {
+        __m128 aElements[16];
+        for (auto element{ 0u }; element != 16; ++element)
+        {
+            aElements[element] = _mm_loadu_ps(a.elements[element] + i);
+        }
+        multiplyColumns(aElements, b, out, i);
+    }
+    multiplyScalar(a, b, out, i, end);
+}
+
+void multiplyUniform(
+    const float* a, const ConstMat4Arrays& b, const Mat4Arrays& out, std::size_t begin, std::size_t end)
+{
+    __m128 aElements[16];
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        aElements[element] = _mm_set1_ps(a[element]);
+    }
+    auto i{ begin };
+    for (; end - i >= s_width; i += s_width)
+    {
+        multiplyColumns(aElements, b, out, i);
+    }
+    multiplyUniformScalar(a, b, out, i, end);
+}
+
+void transformAabbs(
+    const ConstMat4Arrays& matrices, const ConstAabbArrays& boxes, const AabbArrays& out, std::size_t begin,
+    std::size_t end)
+{
+    auto i{ begin };
+    for (; end - i >= s_width; i += s_width)
+    {
+        __m128 boxMin[3];
+        __m128 boxMax[3];
+        for (auto axis{ 0u }; axis != 3; ++axis)
+        {
+            boxMin[axis] = _mm_loadu_ps(boxes.min[axis] + i);
+            boxMax[axis] = _mm_loadu_ps(boxes.max[axis] + i);
+        }
+        for (auto row{ 0u }; row != 3; ++row)
+        {
+            auto outMin{ _mm_loadu_ps(matrices.elements[3 * 4 + row] + i) };
+            auto outMax{ outMin };
+            for (auto column{ 0u }; column != 3; ++column)
+            {
+                const auto element{ _mm_loadu_ps(matrices.elements[column * 4 + row] + i) };
+                const auto productMin{ _mm_mul_ps(element, boxMin[column]) };
+                const auto productMax{ _mm_mul_ps(element, boxMax[column]) };
+                outMin = _mm_add_ps(outMin, _mm_min_ps(productMin, productMax));
+                outMax = _mm_add_ps(outMax, _mm_max_ps(productMin, productMax));
+            }
+            _mm_storeu_ps(out.min[row] + i, outMin);
+            _mm_storeu_ps(out.max[row] + i, outMax);
+        }
+    }
+    transformAabbsScalar(matrices, boxes, out, i, end);
+}
+
+} // namespace
+
+const BatchKernels* getSse41Kernels()
+{
+    static constexpr BatchKernels s_kernels{ multiply, multiplyUniform, transformAabbs };
+    return &s_kernels;
+}
+
+} // namespace VkTest1::Math::Detail
+
+#else
+
+namespace VkTest1::Math::Detail
+{
+
+const BatchKernels* getSse41Kernels()
+{
+    return nullptr;
+}
+
+} // namespace VkTest1::Math::Detail
+
+#endif
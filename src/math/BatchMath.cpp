@@ -0,0 +1,246 @@
+#include "math/BatchMath.hpp"
+
+#include "common/CpuFeatures.hpp"
+#include "math/BatchKernels.hpp"
+
+#include <cassert>
+
+namespace VkTest1::Math
+{
+
+namespace
+{
+
+// Nodes per batch of composeLocalToWorld(). The world matrices of their parents are gathered on the stack.
+constexpr std::size_t s_runCapacity{ 256 };
+
+constexpr float s_identity[16]{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                                0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+const Detail::BatchKernels* findKernels(SimdLevel level)
+{
+    switch (level)
+    {
+        case SimdLevel::Scalar:
+            return &Detail::getScalarKernels();
+        case SimdLevel::Sse41:
+            return Common::isSse41Supported() ? Detail::getSse41Kernels() : nullptr;
+        case SimdLevel::Avx2:
+            return Common::isAvx2Supported() ? Detail::getAvx2Kernels() : nullptr;
+        case SimdLevel::Neon:
+            // Part of every ARM64 CPU.
+            return Detail::getNeonKernels();
+    }
+    return nullptr;
+}
+
+SimdLevel findWidestSimdLevel()
+{
+    for (const auto level : { SimdLevel::Avx2, SimdLevel::Sse41, SimdLevel::Neon })
+    {
+        if (findKernels(level) != nullptr)
+        {
+            return level;
+        }
+    }
+    return SimdLevel::Scalar;
+}
+
+// The arrays from the matrix or box at offset on.
+Detail::ConstMat4Arrays getArrays(const Mat4Batch& batch, std::size_t offset = 0)
+{
+    Detail::ConstMat4Arrays arrays{};
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        arrays.elements[element] = batch.getElements(element / 4, element % 4) + offset;
+    }
+    return arrays;
+}
+
+Detail::Mat4Arrays getArrays(Mat4Batch& batch, std::size_t offset = 0)
+{
+    Detail::Mat4Arrays arrays{};
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        arrays.elements[element] = batch.getElements(element / 4, element % 4) + offset;
+    }
+    return arrays;
+}
+
+Detail::ConstAabbArrays getArrays(const AabbBatch& batch)
+{
+    Detail::ConstAabbArrays arrays{};
+    for (auto axis{ 0u }; axis != 3; ++axis)
+    {
+        arrays.min[axis] = batch.getMin(axis);
+        arrays.max[axis] = batch.getMax(axis);
+    }
+    return arrays;
+}
+
+Detail::AabbArrays getArrays(AabbBatch& batch)
+{
+    Detail::AabbArrays arrays{};
+    for (auto axis{ 0u }; axis != 3; ++axis)
+    {
+        arrays.min[axis] = batch.getMin(axis);
+        arrays.max[axis] = batch.getMax(axis);
+    }
+    return arrays;
+}
+
+} // namespace
+
+Mat4Batch::Mat4Batch(std::size_t size)
+{
+    resize(size);
+}
+
+void Mat4Batch::resize(std::size_t size)
+{
+    for (auto& elements : m_elements)
+    {
+        elements.resize(size, 0.0f);
+    }
+}
+
+void Mat4Batch::set(std::size_t index, const glm::mat4& matrix)
+{
+    assert(index < size());
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        m_elements[element][index] = matrix[element / 4][element % 4];
+    }
+}
+
+glm::mat4 Mat4Batch::get(std::size_t index) const
+{
+    assert(index < size());
+    glm::mat4 matrix{};
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        matrix[element / 4][element % 4] = m_elements[element][index];
+    }
+    return matrix;
+}
+
+AabbBatch::AabbBatch(std::size_t size)
+{
+    resize(size);
+}
+
+void AabbBatch::resize(std::size_t size)
+{
+    for (auto axis{ 0u }; axis != 3; ++axis)
+    {
+        m_min[axis].resize(size, 0.0f);
+        m_max[axis].resize(size, 0.0f);
+    }
+}
+
+void AabbBatch::set(std::size_t index, const Geometry::Bounds& bounds)
+{
+    assert(index < size());
+    for (auto axis{ 0u }; axis != 3; ++axis)
+    {
+        m_min[axis][index] = bounds.min[axis];
+        m_max[axis][index] = bounds.max[axis];
+    }
+}
+
+Geometry::Bounds AabbBatch::get(std::size_t index) const
+{
+    assert(index < size());
+    Geometry::Bounds bounds{};
+    for (auto axis{ 0u }; axis != 3; ++axis)
+    {
+        bounds.min[axis] = m_min[axis][index];
+        bounds.max[axis] = m_max[axis][index];
+    }
+    return bounds;
+}
+
+BatchMath::BatchMath() :
+    BatchMath{ findWidestSimdLevel() }
+{
+}
+
+BatchMath::BatchMath(SimdLevel level) :
+    m_level{ level },
+    m_kernels{ findKernels(level) }
+{
+    assert(m_kernels != nullptr);
+}
+
+bool BatchMath::isSupported(SimdLevel level)
+{
+    return findKernels(level) != nullptr;
+}
+
+void BatchMath::multiply(const Mat4Batch& a, const Mat4Batch& b, Mat4Batch& out) const
+{
+    assert(a.size() == b.size() && &out != &a);
+    out.resize(b.size());
+    m_kernels->multiply(getArrays(a), getArrays(b), getArrays(out), /* begin */ 0, /* end */ b.size());
+}
+
+void BatchMath::multiply(const glm::mat4& a, const Mat4Batch& b, Mat4Batch& out) const
+{
+    float aElements[16];
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        aElements[element] = a[element / 4][element % 4];
+    }
+    out.resize(b.size());
+    m_kernels->multiplyUniform(aElements, getArrays(b), getArrays(out), /* begin */ 0, /* end */ b.size());
+}
+
+void BatchMath::transformAabbs(const Mat4Batch& matrices, const AabbBatch& boxes, AabbBatch& out) const
+{
+    assert(matrices.size() == boxes.size());
+    out.resize(boxes.size());
+    m_kernels->transformAabbs(
+        getArrays(matrices), getArrays(boxes), getArrays(out), /* begin */ 0, /* end */ boxes.size());
+}
+
+void BatchMath::composeLocalToWorld(
+    const Mat4Batch& local, std::span<const std::uint32_t> parents, Mat4Batch& world) const
+{
+    assert(parents.size() == local.size());
+    world.resize(local.size());
+
+    float parentWorlds[16][s_runCapacity];
+    Detail::ConstMat4Arrays parentArrays{};
+    for (auto element{ 0u }; element != 16; ++element)
+    {
+        parentArrays.elements[element] = parentWorlds[element];
+    }
+
+    const auto worldArrays{ getArrays(world) };
+    auto begin{ std::size_t{ 0 } };
+    while (begin != local.size())
+    {
+        // The run ends at the first node whose parent is in it, since its world matrix isn't done yet. The parent of
+        // the first node comes before it, so every run has a node.
+        auto end{ begin };
+        for (; end != local.size() && end - begin != s_runCapacity; ++end)
+        {
+            const auto parent{ parents[end] };
+            assert(parent == s_noParent || parent < end);
+            if (parent != s_noParent && parent >= begin)
+            {
+                break;
+            }
+            for (auto element{ 0u }; element != 16; ++element)
+            {
+                parentWorlds[element][end - begin] =
+                    parent == s_noParent ? s_identity[element] : worldArrays.elements[element][parent];
+            }
+        }
+        m_kernels->multiply(
+            parentArrays, getArrays(local, begin), getArrays(world, begin), /* begin */ 0, /* end */ end - begin);
+        begin = end;
+    }
+}
+
+} // namespace VkTest1::Math
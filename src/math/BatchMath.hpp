@@ -0,0 +1,175 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace VkTest1::Math
+{
+
+namespace Detail
+{
+struct BatchKernels;
+}
+
+enum class SimdLevel
+{
+    Scalar,
+    Sse41,
+    Avx2,
+    Neon
+};
+
+constexpr std::string_view toString(SimdLevel level)
+{
+    switch (level)
+    {
+        case SimdLevel::Scalar:
+            return "scalar";
+        case SimdLevel::Sse41:
+            return "SSE 4.1";
+        case SimdLevel::Avx2:
+            return "AVX2";
+        case SimdLevel::Neon:
+            return "NEON";
+    }
+    return "?";
+}
+
+//
+// 4x4 matrices as a structure of arrays: one array per element, so a vector register holds the same element of
+// consecutive matrices.
+//
+class Mat4Batch
+{
+public:
+    Mat4Batch() = default;
+    explicit Mat4Batch(std::size_t size);
+
+    std::size_t size() const
+    {
+        return m_elements[0].size();
+    }
+
+    // New matrices are zero.
+    void resize(std::size_t size);
+
+    void set(std::size_t index, const glm::mat4& matrix);
+    glm::mat4 get(std::size_t index) const;
+
+    // The array of element (column, row) of every matrix.
+    float* getElements(unsigned int column, unsigned int row)
+    {
+        return m_elements[column * 4 + row].data();
+    }
+
+    const float* getElements(unsigned int column, unsigned int row) const
+    {
+        return m_elements[column * 4 + row].data();
+    }
+
+private:
+    std::array<std::vector<float>, 16> m_elements{};
+};
+
+//
+// Axis aligned boxes as a structure of arrays, like Mat4Batch.
+//
+class AabbBatch
+{
+public:
+    AabbBatch() = default;
+    explicit AabbBatch(std::size_t size);
+
+    std::size_t size() const
+    {
+        return m_min[0].size();
+    }
+
+    // New boxes are empty at the origin.
+    void resize(std::size_t size);
+
+    void set(std::size_t index, const Geometry::Bounds& bounds);
+    Geometry::Bounds get(std::size_t index) const;
+
+    // Axis 0, 1 and 2 are x, y and z.
+    float* getMin(unsigned int axis)
+    {
+        return m_min[axis].data();
+    }
+
+    const float* getMin(unsigned int axis) const
+    {
+        return m_min[axis].data();
+    }
+
+    float* getMax(unsigned int axis)
+    {
+        return m_max[axis].data();
+    }
+
+    const float* getMax(unsigned int axis) const
+    {
+        return m_max[axis].data();
+    }
+
+private:
+    std::array<std::vector<float>, 3> m_min{};
+    std::array<std::vector<float>, 3> m_max{};
+};
+
+//
+// Transforms whole batches at a time with the widest instruction set the CPU supports: AVX2 or SSE 4.1 on x86, NEON
+// on ARM64. The products are added in the order glm adds them, so the results are the ones of its scalar operators
+// unless the compiler fuses multiplications and additions.
+//
+// Outputs are resized to the size of the inputs. The inputs of an operation must have the same size.
+//
+class BatchMath
+{
+public:
+    // The parent of the roots of a hierarchy.
+    static constexpr std::uint32_t s_noParent{ std::numeric_limits<std::uint32_t>::max() };
+
+    // Picks the widest supported instruction set.
+    BatchMath();
+    // The instruction set must be supported, e.g. to compare it with the others.
+    explicit BatchMath(SimdLevel level);
+
+    static bool isSupported(SimdLevel level);
+
+    SimdLevel getSimdLevel() const
+    {
+        return m_level;
+    }
+
+    // out = a * b, per matrix. out may be b, but not a.
+    void multiply(const Mat4Batch& a, const Mat4Batch& b, Mat4Batch& out) const;
+
+    // out = a * b with the same a for every b, e.g. a view projection matrix and the model matrices for the model
+    // view projection matrices. out may be b.
+    void multiply(const glm::mat4& a, const Mat4Batch& b, Mat4Batch& out) const;
+
+    // The bounds of the boxes transformed by the matrices, per box. The matrices must be affine. out may be boxes.
+    void transformAabbs(const Mat4Batch& matrices, const AabbBatch& boxes, AabbBatch& out) const;
+
+    // world = world of the parent * local, per node. The parent of a node must come before it, or be s_noParent.
+    // A breadth first order keeps the runs of nodes whose parents are all done long, which are multiplied as a batch.
+    // world may be local.
+    void composeLocalToWorld(
+        const Mat4Batch& local, std::span<const std::uint32_t> parents, Mat4Batch& world) const;
+
+private:
+    SimdLevel m_level;
+    const Detail::BatchKernels* m_kernels;
+};
+
+} // namespace VkTest1::Math
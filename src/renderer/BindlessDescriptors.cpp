@@ -0,0 +1,134 @@
+#include "renderer/BindlessDescriptors.hpp"
+
+#include <array>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+constexpr std::uint32_t s_textureBinding{ 0 };
+constexpr std::uint32_t s_storageBufferBinding{ 1 };
+
+vk::raii::DescriptorSetLayout createDescriptorSetLayout(
+    const vk::raii::Device& device, std::uint32_t textureCapacity, std::uint32_t storageBufferCapacity)
+{
+    const vk::ShaderStageFlags stages{ vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment |
+                                       vk::ShaderStageFlagBits::eCompute };
+    const std::array<vk::DescriptorSetLayoutBinding, 2> bindings{
+        vk::DescriptorSetLayoutBinding{ /* binding */ s_textureBinding,
+                                        /* descriptorType */ vk::DescriptorType::eCombinedImageSampler,
+                                        /* descriptorCount */ textureCapacity,
+                                        /* stageFlags */ stages },
+        vk::DescriptorSetLayoutBinding{ /* binding */ s_storageBufferBinding,
+                                        /* descriptorType */ vk::DescriptorType::eStorageBuffer,
+                                        /* descriptorCount */ storageBufferCapacity,
+                                        /* stageFlags */ stages }
+    };
+    // ePartiallyBound = The slots nobody uses don't need a valid descriptor.
+    // eUpdateAfterBind + eUpdateUnusedWhilePending = The slots the pending command buffers don't use can be written.
+    const vk::DescriptorBindingFlags bindingFlags{ vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                   vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                   vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending };
+    const std::array<vk::DescriptorBindingFlags, 2> allBindingFlags{ bindingFlags, bindingFlags };
+
+    const vk::StructureChain<vk::DescriptorSetLayoutCreateInfo, vk::DescriptorSetLayoutBindingFlagsCreateInfo>
+        createInfo{ vk::DescriptorSetLayoutCreateInfo{
+                        /* flags */ vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool, bindings },
+                    vk::DescriptorSetLayoutBindingFlagsCreateInfo{ allBindingFlags } };
+    return device.createDescriptorSetLayout(createInfo.get<vk::DescriptorSetLayoutCreateInfo>());
+}
+
+vk::raii::DescriptorPool createDescriptorPool(
+    const vk::raii::Device& device, std::uint32_t textureCapacity, std::uint32_t storageBufferCapacity)
+{
+    const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, /* descriptorCount */ textureCapacity },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, /* descriptorCount */ storageBufferCapacity }
+    };
+    // eFreeDescriptorSet is required by the raii descriptor set. It frees itself.
+    return device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+        /* flags */ vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind |
+            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+        /* maxSets */ 1,
+        poolSizes });
+}
+
+vk::raii::DescriptorSet allocateDescriptorSet(
+    const vk::raii::Device& device, const vk::raii::DescriptorPool& pool, const vk::raii::DescriptorSetLayout& layout)
+{
+    const std::array<vk::DescriptorSetLayout, 1> layouts{ layout };
+    return std::move(device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{ pool, layouts }).front());
+}
+
+} // namespace
+
+BindlessDescriptors::BindlessDescriptors(
+    Common::NotNull<const vk::raii::Device*> device, std::uint32_t textureCapacity,
+    std::uint32_t storageBufferCapacity, std::uint32_t frameCount) :
+    m_device{ device },
+    m_descriptorSetLayout{ createDescriptorSetLayout(*m_device, textureCapacity, storageBufferCapacity) },
+    m_descriptorPool{ createDescriptorPool(*m_device, textureCapacity, storageBufferCapacity) },
+    m_descriptorSet{ allocateDescriptorSet(*m_device, m_descriptorPool, m_descriptorSetLayout) },
+    m_textureSlots{ textureCapacity, frameCount },
+    m_storageBufferSlots{ storageBufferCapacity, frameCount }
+{
+}
+
+std::optional<std::uint32_t> BindlessDescriptors::allocateTextureSlot()
+{
+    return m_textureSlots.allocate();
+}
+
+void BindlessDescriptors::writeTexture(std::uint32_t slot, vk::ImageView imageView, vk::Sampler sampler)
+{
+    const std::array<vk::DescriptorImageInfo, 1> imageInfos{
+        vk::DescriptorImageInfo{ sampler, imageView, vk::ImageLayout::eShaderReadOnlyOptimal }
+    };
+    m_device->updateDescriptorSets(
+        vk::WriteDescriptorSet{ /* dstSet */ m_descriptorSet,
+                                /* dstBinding */ s_textureBinding,
+                                /* dstArrayElement */ slot,
+                                /* descriptorType */ vk::DescriptorType::eCombinedImageSampler,
+                                /* pImageInfo */ imageInfos },
+        /* descriptorCopies */ {});
+}
+
+void BindlessDescriptors::freeTextureSlot(std::uint32_t slot)
+{
+    m_textureSlots.free(slot);
+}
+
+std::optional<std::uint32_t> BindlessDescriptors::allocateStorageBufferSlot()
+{
+    return m_storageBufferSlots.allocate();
+}
+
+void BindlessDescriptors::writeStorageBuffer(std::uint32_t slot, vk::Buffer buffer)
+{
+    const std::array<vk::DescriptorBufferInfo, 1> bufferInfos{
+        vk::DescriptorBufferInfo{ buffer, /* offset */ 0, vk::WholeSize }
+    };
+    m_device->updateDescriptorSets(
+        vk::WriteDescriptorSet{ /* dstSet */ m_descriptorSet,
+                                /* dstBinding */ s_storageBufferBinding,
+                                /* dstArrayElement */ slot,
+                                /* descriptorType */ vk::DescriptorType::eStorageBuffer,
+                                /* pImageInfo */ {},
+                                /* pBufferInfo */ bufferInfos },
+        /* descriptorCopies */ {});
+}
+
+void BindlessDescriptors::freeStorageBufferSlot(std::uint32_t slot)
+{
+    m_storageBufferSlots.free(slot);
+}
+
+void BindlessDescriptors::beginFrame(unsigned int frame)
+{
+    m_textureSlots.beginFrame(frame);
+    m_storageBufferSlots.beginFrame(frame);
+}
+
+} // namespace VkTest1::Renderer::Detail
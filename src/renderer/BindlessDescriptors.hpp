@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common/Types.hpp"
+#include "renderer/SlotAllocator.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <optional>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// One descriptor set with every texture and storage buffer of the renderer (VK_EXT_descriptor_indexing). It is bound
+// once per command buffer, and the shaders pick the resources by their slot, e.g. from push constants. So the draws
+// don't bind descriptor sets, and a compute pass can reach the resources of every mesh.
+//
+// Binding 0 is an array of combined image samplers, binding 1 an array of storage buffers. Both are partially bound,
+// so unused slots need no descriptor, and update after bind, so slots can be written while the frames in flight use
+// the set. A freed slot is reused only after the frames that may use it are done (see SlotAllocator).
+//
+class BindlessDescriptors
+{
+public:
+    // The capacities must match the array sizes in the shaders.
+    explicit BindlessDescriptors(
+        Common::NotNull<const vk::raii::Device*> device, std::uint32_t textureCapacity,
+        std::uint32_t storageBufferCapacity, std::uint32_t frameCount);
+
+    const vk::raii::DescriptorSetLayout& getDescriptorSetLayout() const
+    {
+        return m_descriptorSetLayout;
+    }
+
+    vk::DescriptorSet getDescriptorSet() const
+    {
+        return m_descriptorSet;
+    }
+
+    // Empty if the array is full.
+    std::optional<std::uint32_t> allocateTextureSlot();
+    // The image must be in eShaderReadOnlyOptimal layout when a shader samples it.
+    void writeTexture(std::uint32_t slot, vk::ImageView imageView, vk::Sampler sampler);
+    void freeTextureSlot(std::uint32_t slot);
+
+    // Empty if the array is full.
+    std::optional<std::uint32_t> allocateStorageBufferSlot();
+    // The whole buffer.
+    void writeStorageBuffer(std::uint32_t slot, vk::Buffer buffer);
+    void freeStorageBufferSlot(std::uint32_t slot);
+
+    // Makes the frame in flight the current one. Its fence must have signaled.
+    void beginFrame(unsigned int frame);
+
+private:
+    Common::NotNull<const vk::raii::Device*> m_device;
+    vk::raii::DescriptorSetLayout m_descriptorSetLayout;
+    vk::raii::DescriptorPool m_descriptorPool;
+    vk::raii::DescriptorSet m_descriptorSet;
+    SlotAllocator m_textureSlots;
+    SlotAllocator m_storageBufferSlots;
+};
+
+} // namespace VkTest1::Renderer::Detail
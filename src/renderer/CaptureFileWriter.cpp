@@ -0,0 +1,166 @@
+#include "renderer/CaptureFileWriter.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <string>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+constexpr std::size_t s_bytesPerPixel{ 4 };
+
+// Indices of red, green and blue within a pixel.
+std::array<std::size_t, 3> getRgbOffsets(PixelLayout layout)
+{
+    switch (layout)
+    {
+        case PixelLayout::Rgba8:
+            return { 0, 1, 2 };
+        case PixelLayout::Bgra8:
+            return { 2, 1, 0 };
+    }
+    return { 0, 1, 2 };
+}
+
+} // namespace
+
+CaptureFileWriter::CaptureFileWriter(const std::filesystem::path& filePath, std::size_t queueCapacity) :
+    m_isPpm{ filePath.extension() == ".ppm" },
+    m_queueCapacity{ std::max<std::size_t>(queueCapacity, 1) }
+{
+    m_file.open(filePath, std::ios::binary);
+    if (!m_file.is_open())
+    {
+        throw Common::IoError{ "Cannot create capture file." };
+    }
+
+    m_writerThread = std::jthread{ [this](std::stop_token stopToken)
+                                   {
+                                       runWriter(stopToken);
+                                   } };
+}
+
+CaptureFileWriter::~CaptureFileWriter()
+{
+    m_writerThread.request_stop();
+    m_writerThread.join();
+}
+
+void CaptureFileWriter::write(const CapturedFrame& frame)
+{
+    std::unique_lock lock{ m_mutex };
+    m_frameWritten.wait(
+        lock,
+        [this]
+        {
+            return m_queue.size() < m_queueCapacity || m_hasFailed;
+        });
+    if (m_hasFailed)
+    {
+        throw Common::IoError{ "Cannot write capture file." };
+    }
+
+    auto pixels{ std::vector<std::byte>{} };
+    if (!m_freeBuffers.empty())
+    {
+        pixels = std::move(m_freeBuffers.back());
+        m_freeBuffers.pop_back();
+    }
+    pixels.assign(frame.pixels.begin(), frame.pixels.end());
+    m_queue.push_back(Frame{ frame.width, frame.height, frame.layout, std::move(pixels) });
+    lock.unlock();
+
+    m_frameQueued.notify_one();
+}
+
+void CaptureFileWriter::runWriter(std::stop_token stopToken)
+{
+    // Once the stop is requested, the wait returns false only when the queue is empty. So every queued frame is
+    // written before the thread exits.
+    while (true)
+    {
+        auto frame{ Frame{} };
+        {
+            std::unique_lock lock{ m_mutex };
+            if (!m_frameQueued.wait(
+                    lock,
+                    stopToken,
+                    [this]
+                    {
+                        return !m_queue.empty();
+                    }))
+            {
+                break;
+            }
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_frameWritten.notify_one();
+
+        if (!m_hasFailed)
+        {
+            writeFrame(frame);
+        }
+
+        const std::scoped_lock lock{ m_mutex };
+        m_freeBuffers.push_back(std::move(frame.pixels));
+    }
+    m_file.flush();
+}
+
+void CaptureFileWriter::writeFrame(const Frame& frame)
+{
+    const auto rowSize{ s_bytesPerPixel * frame.width };
+    const auto rgbOffsets{ getRgbOffsets(frame.layout) };
+
+    if (m_isPpm)
+    {
+        const auto header{ std::format("P6\n{} {}\n255\n", frame.width, frame.height) };
+        m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+
+    if (!m_isPpm && frame.layout == PixelLayout::Rgba8)
+    {
+        m_file.write(
+            reinterpret_cast<const char*>(frame.pixels.data()), static_cast<std::streamsize>(frame.pixels.size()));
+    }
+    else
+    {
+        // Converted row by row, so the conversion buffer stays small.
+        const auto outputPixelSize{ m_isPpm ? std::size_t{ 3 } : s_bytesPerPixel };
+        m_row.resize(outputPixelSize * frame.width);
+        for (auto y{ 0u }; y != frame.height; ++y)
+        {
+            const auto* input{ frame.pixels.data() + y * rowSize };
+            auto* output{ m_row.data() };
+            for (auto x{ 0u }; x != frame.width; ++x)
+            {
+                output[0] = input[rgbOffsets[0]];
+                output[1] = input[rgbOffsets[1]];
+                output[2] = input[rgbOffsets[2]];
+                if (!m_isPpm)
+                {
+                    output[3] = input[3];
+                }
+                input += s_bytesPerPixel;
+                output += outputPixelSize;
+            }
+            m_file.write(reinterpret_cast<const char*>(m_row.data()), static_cast<std::streamsize>(m_row.size()));
+        }
+    }
+
+    if (!m_file)
+    {
+        // Reported by the next write(). The writer keeps draining the queue, so write() never blocks forever.
+        m_hasFailed = true;
+        m_frameWritten.notify_one();
+    }
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "renderer/ICaptureWriter.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Writes the captured frames into one file on a background thread.
+//
+// If the path ends in ".ppm", every frame is a binary PPM image (P6) and the file is a stream of them. Tools like
+// ffmpeg read it with "-f image2pipe". Otherwise the file is raw RGBA8 pixels, frame after frame.
+//
+// write() only copies the pixels. If the disk is slower than the renderer, write() blocks once queueCapacity
+// frames are waiting, so no frame is lost and the memory use is bounded.
+//
+class CaptureFileWriter : public ICaptureWriter
+{
+public:
+    // Throws Common::IoError if the file cannot be created.
+    explicit CaptureFileWriter(const std::filesystem::path& filePath, std::size_t queueCapacity);
+
+    CaptureFileWriter(const CaptureFileWriter& other) = delete;
+    CaptureFileWriter& operator=(const CaptureFileWriter& other) = delete;
+
+    // Writes out the queued frames.
+    ~CaptureFileWriter() override;
+
+    // Throws Common::IoError if writing an earlier frame failed.
+    void write(const CapturedFrame& frame) override;
+
+private:
+    struct Frame
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        PixelLayout layout;
+        std::vector<std::byte> pixels;
+    };
+
+    void runWriter(std::stop_token stopToken);
+
+    void writeFrame(const Frame& frame);
+
+    const bool m_isPpm;
+    const std::size_t m_queueCapacity;
+    std::ofstream m_file{};
+    std::mutex m_mutex{};
+    std::condition_variable_any m_frameQueued{};
+    std::condition_variable m_frameWritten{};
+    std::deque<Frame> m_queue{};
+    // Pixel buffers of the written frames, reused by the next ones.
+    std::vector<std::vector<std::byte>> m_freeBuffers{};
+    std::atomic<bool> m_hasFailed{ false };
+    // Only used by the writer thread.
+    std::vector<std::byte> m_row{};
+    // Must be the last member so the writer is stopped before anything else is destroyed.
+    std::jthread m_writerThread{};
+};
+
+} // namespace VkTest1::Renderer::Detail
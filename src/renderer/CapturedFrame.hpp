@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace VkTest1::Renderer
+{
+
+// The byte order of the pixels, 8 bits per channel.
+enum class PixelLayout
+{
+    Rgba8,
+    Bgra8,
+};
+
+// A presented frame copied back to the host.
+struct CapturedFrame
+{
+    // Counts the captured frames from 0.
+    std::uint64_t frameNumber{ 0 };
+    std::uint32_t width{ 0 };
+    std::uint32_t height{ 0 };
+    PixelLayout layout{ PixelLayout::Rgba8 };
+    // Tightly packed rows, top row first. Only valid during the call of the sink.
+    std::span<const std::byte> pixels{};
+};
+
+using CaptureSink = std::function<void(const CapturedFrame& frame)>;
+
+} // namespace VkTest1::Renderer
@@ -0,0 +1,104 @@
+#include "renderer/ClusterCulling.hpp"
+
+#include <cassert>
+
+namespace VkTest1::Renderer::Detail
+{
+
+CullView makeClipSpaceCullView()
+{
+    return CullView{ /* frustumPlanes */ { glm::vec4{ 1.0f, 0.0f, 0.0f, 1.0f },
+                                           glm::vec4{ -1.0f, 0.0f, 0.0f, 1.0f },
+                                           glm::vec4{ 0.0f, 1.0f, 0.0f, 1.0f },
+                                           glm::vec4{ 0.0f, -1.0f, 0.0f, 1.0f },
+                                           // Near and far.
+                                           glm::vec4{ 0.0f, 0.0f, 1.0f, 0.0f },
+                                           glm::vec4{ 0.0f, 0.0f, -1.0f, 1.0f } },
+                     /* viewDirection */ glm::vec3{ 0.0f, 0.0f, 1.0f } };
+}
+
+bool isVisible(const Geometry::Bounds& bounds, const CullView& view)
+{
+    for (const auto& plane : view.frustumPlanes)
+    {
+        // The corner furthest along the plane normal.
+        const glm::vec3 corner{ plane.x >= 0.0f ? bounds.max.x : bounds.min.x,
+                                plane.y >= 0.0f ? bounds.max.y : bounds.min.y,
+                                plane.z >= 0.0f ? bounds.max.z : bounds.min.z };
+        if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+ClusterBounds makeClusterBounds(std::span<const Geometry::Meshlet> meshlets)
+{
+    ClusterBounds bounds{};
+    for (const auto& meshlet : meshlets)
+    {
+        bounds.centerX.push_back(meshlet.center.x);
+        bounds.centerY.push_back(meshlet.center.y);
+        bounds.centerZ.push_back(meshlet.center.z);
+        bounds.radius.push_back(meshlet.radius);
+        bounds.coneAxisX.push_back(meshlet.coneAxis.x);
+        bounds.coneAxisY.push_back(meshlet.coneAxis.y);
+        bounds.coneAxisZ.push_back(meshlet.coneAxis.z);
+        bounds.coneCutoff.push_back(meshlet.coneCutoff);
+        bounds.firstIndex.push_back(meshlet.firstIndex);
+        bounds.indexCount.push_back(meshlet.indexCount);
+    }
+    return bounds;
+}
+
+std::pmr::vector<IndexRange> cullClusters(
+    const ClusterBounds& bounds, MeshletRange meshlets, const CullView& view, std::pmr::memory_resource& memory)
+{
+    assert(meshlets.firstMeshlet + meshlets.meshletCount <= bounds.size());
+    const auto first{ meshlets.firstMeshlet };
+    const auto count{ meshlets.meshletCount };
+
+    // No branches and no early outs, so the compiler can vectorize it over the meshlets.
+    std::pmr::vector<std::uint8_t> isVisible(count, 0, &memory);
+    for (auto i{ 0u }; i != count; ++i)
+    {
+        const auto x{ bounds.centerX[first + i] };
+        const auto y{ bounds.centerY[first + i] };
+        const auto z{ bounds.centerZ[first + i] };
+        const auto radius{ bounds.radius[first + i] };
+        auto visible{ true };
+        for (const auto& plane : view.frustumPlanes)
+        {
+            visible &= plane.x * x + plane.y * y + plane.z * z + plane.w >= -radius;
+        }
+        // All normals face away if the direction to the eye is outside of the cone widened by 90 degrees.
+        const auto towardsEye{ -(view.viewDirection.x * bounds.coneAxisX[first + i] +
+                                 view.viewDirection.y * bounds.coneAxisY[first + i] +
+                                 view.viewDirection.z * bounds.coneAxisZ[first + i]) };
+        visible &= towardsEye <= bounds.coneCutoff[first + i];
+        isVisible[i] = static_cast<std::uint8_t>(visible);
+    }
+
+    std::pmr::vector<IndexRange> ranges{ &memory };
+    for (auto i{ 0u }; i != count; ++i)
+    {
+        if (isVisible[i] == 0)
+        {
+            continue;
+        }
+        const auto firstIndex{ bounds.firstIndex[first + i] };
+        const auto indexCount{ bounds.indexCount[first + i] };
+        if (!ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == firstIndex)
+        {
+            ranges.back().indexCount += indexCount;
+        }
+        else
+        {
+            ranges.push_back(IndexRange{ firstIndex, indexCount });
+        }
+    }
+    return ranges;
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+// A range of the index buffer of a mesh.
+struct IndexRange
+{
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+};
+
+// A range of the meshlets of a mesh.
+struct MeshletRange
+{
+    std::uint32_t firstMeshlet;
+    std::uint32_t meshletCount;
+};
+
+// What the clusters are culled against, in the space of the vertex positions.
+struct CullView
+{
+    // A point p is inside if dot(xyz, p) + w >= 0 for every plane. xyz is normalized.
+    std::array<glm::vec4, 6> frustumPlanes;
+    // Orthographic, so it is the same for every cluster. Normalized.
+    glm::vec3 viewDirection;
+};
+
+// There is no camera: the vertices are in clip space. The view volume is x and y in [-1, 1] and z in [0, 1], and the
+// view direction is +z.
+CullView makeClipSpaceCullView();
+
+// False if the box is outside of a frustum plane. Conservative: a box near an edge of the frustum can pass.
+bool isVisible(const Geometry::Bounds& bounds, const CullView& view);
+
+//
+// The bounds of the meshlets of a mesh as a structure of arrays, so the culling loop vectorizes.
+//
+struct ClusterBounds
+{
+    std::vector<float> centerX{};
+    std::vector<float> centerY{};
+    std::vector<float> centerZ{};
+    std::vector<float> radius{};
+    std::vector<float> coneAxisX{};
+    std::vector<float> coneAxisY{};
+    std::vector<float> coneAxisZ{};
+    std::vector<float> coneCutoff{};
+    std::vector<std::uint32_t> firstIndex{};
+    std::vector<std::uint32_t> indexCount{};
+
+    std::size_t size() const
+    {
+        return radius.size();
+    }
+};
+
+ClusterBounds makeClusterBounds(std::span<const Geometry::Meshlet> meshlets);
+
+//
+// Culls the meshlets of the range. A meshlet is culled if its bounding sphere is outside of a frustum plane, or if its
+// normal cone shows that all of its triangles face away from the view.
+//
+// Returns the index ranges of the visible meshlets. Meshlets that follow each other in the index buffer are merged
+// into one range, so fully visible LODs are one draw. The memory is usually the frame arena.
+//
+std::pmr::vector<IndexRange> cullClusters(
+    const ClusterBounds& bounds, MeshletRange meshlets, const CullView& view, std::pmr::memory_resource& memory);
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,48 @@
+#include "renderer/DeviceMemory.hpp"
+
+#include "common/Errors.hpp"
+#include "common/Types.hpp"
+
+namespace VkTest1::Renderer::Detail
+{
+
+std::uint32_t findMemoryTypeIndex(
+    const vk::PhysicalDevice& physicalDevice, std::uint32_t allowedTypes, vk::MemoryPropertyFlags propertyFlags)
+{
+    return findMemoryTypeIndex(physicalDevice.getMemoryProperties(), allowedTypes, propertyFlags);
+}
+
+std::uint32_t findMemoryTypeIndex(
+    const vk::PhysicalDeviceMemoryProperties& memoryProperties, std::uint32_t allowedTypes,
+    vk::MemoryPropertyFlags propertyFlags)
+{
+    for (auto i{ 0u }; i != memoryProperties.memoryTypeCount; ++i)
+    {
+        if (Common::Flags::isFlagSet(allowedTypes, i) &&
+            Common::Flags::isMaskSet(memoryProperties.memoryTypes[i].propertyFlags, propertyFlags))
+        {
+            return i;
+        }
+    }
+    throw Common::RendererError{ "Cannot find memory type index." };
+}
+
+vk::raii::DeviceMemory allocateDeviceMemory(
+    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device,
+    const vk::MemoryRequirements& memoryRequirements, vk::MemoryPropertyFlags propertyFlags)
+{
+    const auto memoryTypeIndex{
+        findMemoryTypeIndex(physicalDevice, /* allowedTypes */ memoryRequirements.memoryTypeBits, propertyFlags)
+    };
+    try
+    {
+        return device.allocateMemory(vk::MemoryAllocateInfo{ /* allocationSize */ memoryRequirements.size,
+                                                             /* memoryTypeIndex */ memoryTypeIndex });
+    }
+    catch (const vk::OutOfDeviceMemoryError& ex)
+    {
+        throw Common::OutOfMemoryError{ ex.what() };
+    }
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+
+namespace VkTest1::Renderer::Detail
+{
+
+// Returns the first memory type allowed by allowedTypes that has all the propertyFlags.
+// Throws Common::RendererError if there is no such memory type.
+std::uint32_t findMemoryTypeIndex(
+    const vk::PhysicalDevice& physicalDevice, std::uint32_t allowedTypes, vk::MemoryPropertyFlags propertyFlags);
+
+// The same, given the memory properties of the physical device.
+std::uint32_t findMemoryTypeIndex(
+    const vk::PhysicalDeviceMemoryProperties& memoryProperties, std::uint32_t allowedTypes,
+    vk::MemoryPropertyFlags propertyFlags);
+
+// Throws Common::OutOfMemoryError if the heap of the memory type is full.
+vk::raii::DeviceMemory allocateDeviceMemory(
+    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device,
+    const vk::MemoryRequirements& memoryRequirements, vk::MemoryPropertyFlags propertyFlags);
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,202 @@
+#include "renderer/DrawList.hpp"
+
+#include "common/Cast.hpp"
+#include "common/RadixSort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <optional>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+constexpr std::uint64_t s_passBits{ 4 };
+constexpr std::uint64_t s_pipelineBits{ 8 };
+constexpr std::uint64_t s_materialBits{ 12 };
+constexpr std::uint64_t s_meshBits{ 16 };
+constexpr std::uint64_t s_depthBits{ 24 };
+static_assert(s_passBits + s_pipelineBits + s_materialBits + s_meshBits + s_depthBits == 64);
+
+constexpr std::uint64_t s_passShift{ 64 - s_passBits };
+
+constexpr std::uint64_t getMask(std::uint64_t bitCount)
+{
+    return (std::uint64_t{ 1 } << bitCount) - 1;
+}
+
+std::uint64_t quantizeDepth(float depth)
+{
+    // NaN goes to the near plane.
+    const auto clampedDepth{ std::isnan(depth) ? 0.0f : std::clamp(depth, 0.0f, 1.0f) };
+    return static_cast<std::uint64_t>(clampedDepth * static_cast<float>(getMask(s_depthBits)));
+}
+
+DrawPass getPass(std::uint64_t sortKey)
+{
+    return static_cast<DrawPass>(sortKey >> s_passShift);
+}
+
+} // namespace
+
+std::uint64_t makeSortKey(const DrawState& state)
+{
+    const auto pass{ static_cast<std::uint64_t>(state.pass) & getMask(s_passBits) };
+    const auto pipeline{ state.pipelineId & getMask(s_pipelineBits) };
+    const auto material{ state.materialId & getMask(s_materialBits) };
+    const auto mesh{ state.meshId & getMask(s_meshBits) };
+    const auto depth{ quantizeDepth(state.depth) };
+
+    if (state.pass == DrawPass::Transparent)
+    {
+        const auto invertedDepth{ getMask(s_depthBits) - depth };
+        return (pass << s_passShift) | (invertedDepth << (s_pipelineBits + s_materialBits + s_meshBits)) |
+               (pipeline << (s_materialBits + s_meshBits)) | (material << s_meshBits) | mesh;
+    }
+    return (pass << s_passShift) | (pipeline << (s_materialBits + s_meshBits + s_depthBits)) |
+           (material << (s_meshBits + s_depthBits)) | (mesh << s_depthBits) | depth;
+}
+
+DrawList::DrawList(std::pmr::memory_resource& memory) :
+    m_items{ &memory }
+{
+}
+
+void DrawList::add(
+    const DrawState& state, vk::Pipeline pipeline, std::uint32_t textureIndex, const Mesh& mesh,
+    std::uint32_t lod, std::span<const IndexRange> indexRanges, const IndirectDraws& indirectDraws)
+{
+    m_items.push_back(
+        DrawItem{ makeSortKey(state), pipeline, textureIndex, &mesh, lod, indexRanges, indirectDraws });
+    m_isSorted = false;
+}
+
+void DrawList::sort()
+{
+    if (m_isSorted)
+    {
+        return;
+    }
+    std::pmr::vector<DrawItem> scratch{ m_items.size(), DrawItem{}, m_items.get_allocator() };
+    Common::radixSort(
+        std::span{ m_items },
+        std::span{ scratch },
+        [](const DrawItem& item)
+        {
+            return item.sortKey;
+        });
+    m_isSorted = true;
+}
+
+std::span<const DrawItem> DrawList::getItems(DrawPass pass) const
+{
+    assert(m_isSorted);
+    const auto passItems{ std::ranges::equal_range(
+        m_items,
+        pass,
+        {},
+        [](const DrawItem& item)
+        {
+            return getPass(item.sortKey);
+        }) };
+    return { passItems.begin(), passItems.end() };
+}
+
+DrawCounts recordDraws(
+    const vk::raii::CommandBuffer& commandBuffer, vk::PipelineLayout pipelineLayout, vk::DescriptorSet bindlessSet,
+    const GeometryArena& geometryArena, std::span<const DrawItem> items)
+{
+    DrawCounts counts{};
+    if (items.empty())
+    {
+        return counts;
+    }
+    // Every draw finds its resources in this set, so it stays bound, even across pipelines with compatible layouts.
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics, pipelineLayout, /* firstSet */ 0, bindlessSet, /* dynamicOffsets */ {});
+    // The meshes are ranges of these buffers.
+    const std::array<const vk::Buffer, 1> vertexBuffers{ geometryArena.getVertexBuffer() };
+    const std::array<const vk::DeviceSize, 1> vertexBufferOffsets{ 0 };
+    commandBuffer.bindVertexBuffers(0, vertexBuffers, vertexBufferOffsets);
+
+    vk::Pipeline boundPipeline{};
+    std::optional<std::uint32_t> pushedTextureIndex{};
+    // The index buffer is rebound only for the other index type.
+    std::optional<vk::IndexType> boundIndexType{};
+    for (const auto& item : items)
+    {
+        if (item.pipeline != boundPipeline)
+        {
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, item.pipeline);
+            boundPipeline = item.pipeline;
+            ++counts.pipelineBindCount;
+        }
+
+        // The draws of a material are grouped, so this is rare.
+        if (item.textureIndex != pushedTextureIndex)
+        {
+            commandBuffer.pushConstants<std::uint32_t>(
+                pipelineLayout, vk::ShaderStageFlagBits::eFragment, /* offset */ 0, item.textureIndex);
+            pushedTextureIndex = item.textureIndex;
+        }
+
+        const auto& mesh{ *item.mesh };
+        const auto vertexOffset{ Common::NarrowCast<std::int32_t>(mesh.getFirstVertex()) };
+        if (mesh.getIndexCount() == 0)
+        {
+            commandBuffer.draw(mesh.getVertexCount(), 1, mesh.getFirstVertex(), 0);
+            ++counts.drawCount;
+            counts.triangleCount += mesh.getVertexCount() / 3;
+            continue;
+        }
+        if (mesh.getIndexType() != boundIndexType)
+        {
+            commandBuffer.bindIndexBuffer(geometryArena.getIndexBuffer(), /* offset */ 0, mesh.getIndexType());
+            boundIndexType = mesh.getIndexType();
+        }
+        if (item.indirectDraws.drawCount != 0)
+        {
+            // The culled clusters have no instances. The commands have the offsets of the mesh in the arena.
+            commandBuffer.drawIndexedIndirect(
+                item.indirectDraws.buffer,
+                item.indirectDraws.offset,
+                item.indirectDraws.drawCount,
+                sizeof(vk::DrawIndexedIndirectCommand));
+            counts.drawCount += item.indirectDraws.drawCount;
+            counts.triangleCount += mesh.getLods()[item.lod].indexCount / 3;
+            continue;
+        }
+        if (!item.indexRanges.empty())
+        {
+            for (const auto& range : item.indexRanges)
+            {
+                commandBuffer.drawIndexed(
+                    range.indexCount,
+                    /* instanceCount */ 1,
+                    mesh.getFirstIndex() + range.firstIndex,
+                    vertexOffset,
+                    /* firstInstance */ 0);
+                counts.triangleCount += range.indexCount / 3;
+            }
+            counts.drawCount += item.indexRanges.size();
+            continue;
+        }
+        // The LODs share the indices of the mesh.
+        const auto& lod{ mesh.getLods()[item.lod] };
+        commandBuffer.drawIndexed(
+            lod.indexCount,
+            /* instanceCount */ 1,
+            mesh.getFirstIndex() + lod.firstIndex,
+            vertexOffset,
+            /* firstInstance */ 0);
+        ++counts.drawCount;
+        counts.triangleCount += lod.indexCount / 3;
+    }
+    return counts;
+}
+
+} // namespace VkTest1::Renderer::Detail
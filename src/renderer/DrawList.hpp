@@ -0,0 +1,114 @@
+#pragma once
+
+#include "renderer/Mesh.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+// The passes in the order they are drawn.
+enum class DrawPass : std::uint8_t
+{
+    DepthPrePass,
+    Opaque,
+    // Blended, so drawn back to front.
+    Transparent,
+};
+
+// What a draw needs bound. The sort key groups draws with the same state.
+struct DrawState
+{
+    DrawPass pass;
+    // Ids, not handles, so they fit into the key. Only the order depends on them; the binds compare the handles.
+    std::uint8_t pipelineId;
+    std::uint16_t materialId;
+    std::uint16_t meshId;
+    // In [0, 1], 0 is the near plane.
+    float depth;
+};
+
+//
+// Packs the draw state into a 64 bit key. Sorting by the key gives the draw order:
+//
+// Opaque passes:  pass (4) | pipeline (8) | material (12) | mesh (16) | depth (24)
+// Transparent:    pass (4) | inverted depth (24) | pipeline (8) | material (12) | mesh (16)
+//
+// The opaque draws are grouped by state, and front to back within a state, so early depth testing rejects more.
+// The transparent ones must be back to front to blend correctly, so the depth comes before the state there.
+// Ids that don't fit are wrapped. That only makes the grouping worse.
+//
+std::uint64_t makeSortKey(const DrawState& state);
+
+// Draws with the vk::DrawIndexedIndirectCommands in the buffer, written by the GPU cluster culling.
+struct IndirectDraws
+{
+    vk::Buffer buffer;
+    vk::DeviceSize offset;
+    // Zero if the draw is not indirect.
+    std::uint32_t drawCount;
+};
+
+struct DrawItem
+{
+    std::uint64_t sortKey;
+    vk::Pipeline pipeline;
+    // The slot of the texture in the bindless textures. Pushed as a constant. Ignored by the depth pre-pass.
+    std::uint32_t textureIndex;
+    // Outlives the frame.
+    const Mesh* mesh;
+    // Into the LODs of the mesh.
+    std::uint32_t lod;
+    // The parts of the LOD that survived the CPU cluster culling. Empty draws the whole LOD. In the frame arena.
+    std::span<const IndexRange> indexRanges;
+    // Replaces the draws of the LOD if the clusters are culled on the GPU.
+    IndirectDraws indirectDraws;
+};
+
+//
+// The draws of a frame. Filled, sorted, then recorded pass by pass.
+// The memory comes from the frame arena, so it must not outlive the frame.
+//
+class DrawList
+{
+public:
+    explicit DrawList(std::pmr::memory_resource& memory);
+
+    void add(
+        const DrawState& state, vk::Pipeline pipeline, std::uint32_t textureIndex, const Mesh& mesh,
+        std::uint32_t lod, std::span<const IndexRange> indexRanges, const IndirectDraws& indirectDraws);
+
+    // Radix sort by the sort keys.
+    void sort();
+
+    // The sorted draws of the pass.
+    std::span<const DrawItem> getItems(DrawPass pass) const;
+
+private:
+    std::pmr::vector<DrawItem> m_items;
+    bool m_isSorted{ true };
+};
+
+// What recordDraws() recorded. An indirect draw counts as one draw per cluster, with all the triangles of the LOD: the
+// GPU culling happens later.
+struct DrawCounts
+{
+    std::uint64_t drawCount{ 0 };
+    std::uint64_t triangleCount{ 0 };
+    std::uint64_t pipelineBindCount{ 0 };
+};
+
+// Records the draws and binds only the state that changed from the previous draw. The bindless set is bound once as
+// set 0, and the vertex and index buffers of the geometry arena, which has the meshes of the items. The pipelines of
+// the items must have a layout compatible with pipelineLayout, with the texture index as a fragment push constant at
+// offset 0.
+DrawCounts recordDraws(
+    const vk::raii::CommandBuffer& commandBuffer, vk::PipelineLayout pipelineLayout, vk::DescriptorSet bindlessSet,
+    const GeometryArena& geometryArena, std::span<const DrawItem> items);
+
+} // namespace VkTest1::Renderer::Detail
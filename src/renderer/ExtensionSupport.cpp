@@ -0,0 +1,26 @@
+#include "renderer/ExtensionSupport.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+namespace VkTest1::Renderer::Detail
+{
+
+bool areExtensionsSupported(
+    std::span<const vk::ExtensionProperties> propsList, std::span<const char* const> extensionNames,
+    Logging::ILogger& logger)
+{
+    const auto isExtensionSupported = [&propsList, &logger](const char* const extensionName)
+    {
+        logger.debug("Vulkan: Checking extension '{}'", extensionName);
+        return std::ranges::any_of(
+            propsList,
+            [extensionName](const vk::ExtensionProperties& props)
+            {
+                return std::string_view{ props.extensionName } == std::string_view{ extensionName };
+            });
+    };
+    return std::ranges::all_of(extensionNames, isExtensionSupported);
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "logging/ILogger.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <span>
+
+namespace VkTest1::Renderer::Detail
+{
+
+// Whether every extension of extensionNames is in propsList, the properties of the extensions of the instance or of
+// a physical device.
+bool areExtensionsSupported(
+    std::span<const vk::ExtensionProperties> propsList, std::span<const char* const> extensionNames,
+    Logging::ILogger& logger);
+
+} // namespace VkTest1::Renderer::Detail
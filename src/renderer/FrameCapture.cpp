@@ -0,0 +1,234 @@
+#include "renderer/FrameCapture.hpp"
+
+#include "common/Errors.hpp"
+#include "common/Types.hpp"
+#include "renderer/DeviceMemory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+constexpr vk::DeviceSize s_bytesPerPixel{ 4 };
+
+std::optional<PixelLayout> getPixelLayout(vk::Format format)
+{
+    switch (format)
+    {
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+            return PixelLayout::Rgba8;
+        case vk::Format::eB8G8R8A8Unorm:
+        case vk::Format::eB8G8R8A8Srgb:
+            return PixelLayout::Bgra8;
+        default:
+            return std::nullopt;
+    }
+}
+
+// HostCached if there is such a memory type, otherwise HostCoherent.
+std::uint32_t findReadbackMemoryTypeIndex(const vk::PhysicalDevice& physicalDevice, std::uint32_t allowedTypes)
+{
+    try
+    {
+        return findMemoryTypeIndex(
+            physicalDevice,
+            allowedTypes,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached);
+    }
+    catch (const Common::RendererError&)
+    {
+        return findMemoryTypeIndex(
+            physicalDevice,
+            allowedTypes,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
+}
+
+} // namespace
+
+FrameCapture::FrameCapture(
+    Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice, Common::NotNull<const vk::raii::Device*> device,
+    std::size_t frameCount) :
+    m_physicalDevice{ physicalDevice },
+    m_device{ device },
+    m_readbackBuffers(frameCount)
+{
+}
+
+void FrameCapture::setSink(CaptureSink sink)
+{
+    m_sink = std::move(sink);
+}
+
+bool FrameCapture::hasSink() const
+{
+    return static_cast<bool>(m_sink);
+}
+
+void FrameCapture::setSource(vk::Format format, vk::Extent2D extent, vk::ImageUsageFlags usage)
+{
+    m_extent = extent;
+    m_layout = (usage & vk::ImageUsageFlagBits::eTransferSrc) ? getPixelLayout(format) : std::nullopt;
+    m_isEnabled = hasSink() && m_layout.has_value();
+}
+
+bool FrameCapture::isEnabled() const
+{
+    return m_isEnabled;
+}
+
+void FrameCapture::recordCopy(
+    const vk::raii::CommandBuffer& commandBuffer, std::size_t frame, vk::Image image, vk::ImageLayout finalLayout)
+{
+    assert(m_isEnabled);
+    auto& readbackBuffer{ m_readbackBuffers[frame] };
+    assert(!readbackBuffer.pendingFrame.has_value());
+
+    reserve(readbackBuffer, s_bytesPerPixel * m_extent.width * m_extent.height);
+
+    // A row length of 0 means tightly packed.
+    const vk::BufferImageCopy region{ /* bufferOffset */ 0,
+                                      /* bufferRowLength */ 0,
+                                      /* bufferImageHeight */ 0,
+                                      /* imageSubresource */
+                                      { vk::ImageAspectFlagBits::eColor,
+                                        /* mipLevel */ 0,
+                                        /* baseArrayLayer */ 0,
+                                        /* layerCount */ 1 },
+                                      /* imageOffset */ { 0, 0, 0 },
+                                      /* imageExtent */ { m_extent.width, m_extent.height, 1 } };
+    commandBuffer.copyImageToBuffer(
+        image,
+        vk::ImageLayout::eTransferSrcOptimal,
+        readbackBuffer.buffer,
+        std::array<vk::BufferImageCopy, 1>{ region });
+
+    // The copy only reads the image, so the transition just has to wait for it. The semaphore signaled after the
+    // command buffer makes the image available to the presentation engine.
+    const vk::ImageMemoryBarrier imageBarrier{ /* srcAccessMask */ {},
+                                               /* dstAccessMask */ {},
+                                               /* oldLayout */ vk::ImageLayout::eTransferSrcOptimal,
+                                               /* newLayout */ finalLayout,
+                                               /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                               /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                               /* image */ image,
+                                               /* subresourceRange */
+                                               { vk::ImageAspectFlagBits::eColor,
+                                                 /* base mipmap level */ 0,
+                                                 /* mipmap level count */ 1,
+                                                 /* base array layer */ 0,
+                                                 /* array layer count */ 1 } };
+    // The host reads the buffer after the fence wait.
+    const vk::BufferMemoryBarrier bufferBarrier{ /* srcAccessMask */ vk::AccessFlagBits::eTransferWrite,
+                                                 /* dstAccessMask */ vk::AccessFlagBits::eHostRead,
+                                                 /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                 /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                 /* buffer */ readbackBuffer.buffer,
+                                                 /* offset */ 0,
+                                                 /* size */ vk::WholeSize };
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eHost | vk::PipelineStageFlagBits::eBottomOfPipe,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */ {},
+        std::array<vk::BufferMemoryBarrier, 1>{ bufferBarrier },
+        std::array<vk::ImageMemoryBarrier, 1>{ imageBarrier });
+
+    readbackBuffer.pendingFrame = PendingFrame{ m_nextFrameNumber++, m_extent, *m_layout };
+}
+
+void FrameCapture::collect(std::size_t frame)
+{
+    deliver(m_readbackBuffers[frame]);
+}
+
+void FrameCapture::collectAll()
+{
+    // The frames in flight can be in any buffer. The sink gets them in order.
+    std::vector<ReadbackBuffer*> pendingBuffers{};
+    for (auto& readbackBuffer : m_readbackBuffers)
+    {
+        if (readbackBuffer.pendingFrame.has_value())
+        {
+            pendingBuffers.push_back(&readbackBuffer);
+        }
+    }
+    std::ranges::sort(
+        pendingBuffers,
+        {},
+        [](const ReadbackBuffer* readbackBuffer)
+        {
+            return readbackBuffer->pendingFrame->frameNumber;
+        });
+    for (auto* readbackBuffer : pendingBuffers)
+    {
+        deliver(*readbackBuffer);
+    }
+}
+
+void FrameCapture::reserve(ReadbackBuffer& readbackBuffer, vk::DeviceSize size) const
+{
+    if (readbackBuffer.size >= size)
+    {
+        return;
+    }
+
+    // The old buffer is not in use anymore, because its frame was collected.
+    readbackBuffer = ReadbackBuffer{};
+    readbackBuffer.buffer = m_device->createBuffer(
+        vk::BufferCreateInfo{ /* flags */ {},
+                              /* size */ size,
+                              /* usage */ vk::BufferUsageFlagBits::eTransferDst,
+                              /* sharingMode */ vk::SharingMode::eExclusive });
+
+    const auto memoryRequirements{ readbackBuffer.buffer.getMemoryRequirements() };
+    const auto memoryTypeIndex{ findReadbackMemoryTypeIndex(*m_physicalDevice, memoryRequirements.memoryTypeBits) };
+    readbackBuffer.memory = m_device->allocateMemory(
+        vk::MemoryAllocateInfo{ /* allocationSize */ memoryRequirements.size, memoryTypeIndex });
+    readbackBuffer.buffer.bindMemory(readbackBuffer.memory, /* memoryOffset */ 0);
+
+    const auto memoryProperties{ m_physicalDevice->getMemoryProperties() };
+    readbackBuffer.isCoherent = Common::Flags::isMaskSet(
+        memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags,
+        vk::MemoryPropertyFlags{ vk::MemoryPropertyFlagBits::eHostCoherent });
+    // Freeing the memory unmaps it.
+    readbackBuffer.mappedData =
+        static_cast<const std::byte*>(readbackBuffer.memory.mapMemory(/* offset */ 0, /* size */ vk::WholeSize));
+    readbackBuffer.size = size;
+}
+
+void FrameCapture::deliver(ReadbackBuffer& readbackBuffer)
+{
+    if (!readbackBuffer.pendingFrame.has_value())
+    {
+        return;
+    }
+    const auto pendingFrame{ *readbackBuffer.pendingFrame };
+    readbackBuffer.pendingFrame.reset();
+    if (!m_sink)
+    {
+        return;
+    }
+
+    if (!readbackBuffer.isCoherent)
+    {
+        // Drops the stale cache lines, so the CPU sees what the GPU wrote.
+        m_device->invalidateMappedMemoryRanges(
+            vk::MappedMemoryRange{ readbackBuffer.memory, /* offset */ 0, /* size */ vk::WholeSize });
+    }
+
+    const auto size{ s_bytesPerPixel * pendingFrame.extent.width * pendingFrame.extent.height };
+    m_sink(CapturedFrame{ /* frameNumber */ pendingFrame.frameNumber,
+                          /* width */ pendingFrame.extent.width,
+                          /* height */ pendingFrame.extent.height,
+                          /* layout */ pendingFrame.layout,
+                          /* pixels */ { readbackBuffer.mappedData, static_cast<std::size_t>(size) } });
+}
+
+} // namespace VkTest1::Renderer::Detail
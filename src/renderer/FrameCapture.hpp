@@ -0,0 +1,94 @@
+#pragma once
+
+#include "common/Types.hpp"
+#include "renderer/CapturedFrame.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Copies the presented images back to the host without stalling the GPU or the frame loop.
+//
+// Every frame in flight has its own host-visible readback buffer. The command buffer of the frame copies the image
+// into it after rendering. When draw() waits for the fence of that frame again (frameCount frames later), the copy
+// is done and collect() hands the pixels to the sink. So the frames arrive with a latency of frameCount frames,
+// in order.
+//
+// The buffers stay mapped. They prefer cached memory, because reading uncached memory from the CPU is slow.
+//
+class FrameCapture
+{
+public:
+    explicit FrameCapture(
+        Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, std::size_t frameCount);
+
+    FrameCapture(const FrameCapture& other) = delete;
+    FrameCapture& operator=(const FrameCapture& other) = delete;
+
+    // An empty sink stops capturing. Takes effect at the next setSource().
+    void setSink(CaptureSink sink);
+    bool hasSink() const;
+
+    // The images to capture from now on. They can be captured if the usage has TransferSrc and the format is 8-bit
+    // RGBA or BGRA.
+    void setSource(vk::Format format, vk::Extent2D extent, vk::ImageUsageFlags usage);
+
+    // True if there is a sink and the source images can be captured.
+    // If so, the images must be in TransferSrcOptimal and the writes must be visible to the transfer stage
+    // before recordCopy().
+    bool isEnabled() const;
+
+    // Copies the image into the buffer of the frame and transitions the image to finalLayout.
+    // The fence of the frame must have been waited on and collect() called since its last use.
+    void recordCopy(
+        const vk::raii::CommandBuffer& commandBuffer, std::size_t frame, vk::Image image, vk::ImageLayout finalLayout);
+
+    // Call after the fence of the frame was waited on. Hands the frame copied in its last use to the sink.
+    void collect(std::size_t frame);
+
+    // Call after the device is idle. Hands every copied frame to the sink.
+    void collectAll();
+
+private:
+    struct PendingFrame
+    {
+        std::uint64_t frameNumber;
+        vk::Extent2D extent;
+        PixelLayout layout;
+    };
+
+    struct ReadbackBuffer
+    {
+        vk::raii::Buffer buffer{ nullptr };
+        vk::raii::DeviceMemory memory{ nullptr };
+        vk::DeviceSize size{ 0 };
+        bool isCoherent{ false };
+        const std::byte* mappedData{ nullptr };
+        std::optional<PendingFrame> pendingFrame{};
+    };
+
+    // Grows the buffer if the images got bigger.
+    void reserve(ReadbackBuffer& readbackBuffer, vk::DeviceSize size) const;
+
+    void deliver(ReadbackBuffer& readbackBuffer);
+
+    Common::NotNull<const vk::raii::PhysicalDevice*> m_physicalDevice;
+    Common::NotNull<const vk::raii::Device*> m_device;
+    CaptureSink m_sink{};
+    std::vector<ReadbackBuffer> m_readbackBuffers;
+    vk::Extent2D m_extent{};
+    // Empty if the source images cannot be captured.
+    std::optional<PixelLayout> m_layout{};
+    bool m_isEnabled{ false };
+    std::uint64_t m_nextFrameNumber{ 0 };
+};
+
+} // namespace VkTest1::Renderer::Detail
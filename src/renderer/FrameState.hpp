@@ -0,0 +1,25 @@
+#pragma once
+
+#include "common/Types.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace VkTest1::Renderer
+{
+
+// Everything the thread that runs the simulation hands to the renderer for a frame.
+struct FrameState
+{
+    // Counts the frames from 0.
+    std::uint64_t frameNumber{ 0 };
+    // The simulation time of the frame. The animations (e.g. the particles) advance to it.
+    std::chrono::steady_clock::time_point time{};
+    // In the order of the windows given to the renderer. They are polled by the thread that owns the windows,
+    // because the windowing system may only be used there.
+    std::vector<std::pair<Common::Uint, Common::Uint>> windowSizes{};
+};
+
+} // namespace VkTest1::Renderer
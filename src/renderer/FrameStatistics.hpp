@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace VkTest1::Renderer
+{
+
+// Where the time a frame reached the screen comes from.
+enum class PresentTimingSource
+{
+    // VK_KHR_present_wait: The renderer polls which presents have completed.
+    PresentWait,
+    // VK_GOOGLE_display_timing: The driver reports the actual presentation time.
+    DisplayTiming,
+    // No extension: The time the present call returned.
+    Cpu,
+};
+
+constexpr std::string_view toString(PresentTimingSource source)
+{
+    switch (source)
+    {
+        case PresentTimingSource::PresentWait:
+            return "present wait";
+        case PresentTimingSource::DisplayTiming:
+            return "display timing";
+        case PresentTimingSource::Cpu:
+            return "CPU";
+    }
+    return "?";
+}
+
+// Statistics of the frames presented in the last measurement interval. Durations are in milliseconds.
+struct FrameStatistics
+{
+    PresentTimingSource source{ PresentTimingSource::Cpu };
+    std::uint32_t frameCount{ 0 };
+    // From the start of draw() until the frame reached the screen.
+    double averageLatency{ 0.0 };
+    double maxLatency{ 0.0 };
+    // Frames that reached the screen more than 1.5 refresh cycles after the previous one.
+    std::uint32_t missedVsyncCount{ 0 };
+    // Time draw() was blocked waiting for the fence of the frame (the GPU is behind) and for the next swapchain
+    // image (the presentation engine is behind).
+    double averageFenceWait{ 0.0 };
+    double averageAcquireWait{ 0.0 };
+    // The refresh cycle the missed vsyncs were counted against. 0 if unknown.
+    double refreshDuration{ 0.0 };
+};
+
+} // namespace VkTest1::Renderer
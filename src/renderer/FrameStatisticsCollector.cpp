@@ -0,0 +1,184 @@
+#include "renderer/FrameStatisticsCollector.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+// Older presents than this are dropped without being measured. It only happens if the presentation engine
+// never reports them.
+constexpr std::size_t s_maxPendingFrameCount = 32;
+
+double toMilliseconds(FrameStatisticsCollector::Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>{ duration }.count();
+}
+
+} // namespace
+
+FrameStatisticsCollector::FrameStatisticsCollector(
+    PresentTimingSource source, Clock::duration interval, std::optional<Clock::duration> refreshDuration) :
+    m_source{ source },
+    m_interval{ interval },
+    m_refreshDuration{ refreshDuration }
+{
+    m_statistics.source = m_source;
+}
+
+PresentTimingSource FrameStatisticsCollector::getSource() const
+{
+    return m_source;
+}
+
+void FrameStatisticsCollector::beginFrame()
+{
+    m_currentFrame = Frame{ /* presentId */ 0, /* startTime */ Clock::now() };
+}
+
+void FrameStatisticsCollector::addFenceWait(Clock::duration duration)
+{
+    m_currentFrame.fenceWait += duration;
+}
+
+void FrameStatisticsCollector::addAcquireWait(Clock::duration duration)
+{
+    m_currentFrame.acquireWait += duration;
+}
+
+std::uint64_t FrameStatisticsCollector::getNextPresentId() const
+{
+    return m_nextPresentId;
+}
+
+void FrameStatisticsCollector::endFrame()
+{
+    m_currentFrame.presentId = m_nextPresentId++;
+
+    if (m_source == PresentTimingSource::Cpu)
+    {
+        // The best guess without help from the driver.
+        completeFrame(m_currentFrame, Clock::now());
+        return;
+    }
+
+    m_pendingFrames.push_back(m_currentFrame);
+    if (m_pendingFrames.size() > s_maxPendingFrameCount)
+    {
+        m_pendingFrames.pop_front();
+    }
+}
+
+bool FrameStatisticsCollector::update(const vk::raii::SwapchainKHR& swapchain)
+{
+    switch (m_source)
+    {
+        case PresentTimingSource::PresentWait:
+            updatePresentWait(swapchain);
+            break;
+        case PresentTimingSource::DisplayTiming:
+            updateDisplayTiming(swapchain);
+            break;
+        case PresentTimingSource::Cpu:
+            break;
+    }
+
+    const auto now{ Clock::now() };
+    if (now - m_intervalStart < m_interval || m_frameCount == 0)
+    {
+        return false;
+    }
+
+    m_statistics = FrameStatistics{
+        /* source */ m_source,
+        /* frameCount */ m_frameCount,
+        /* averageLatency */ toMilliseconds(m_latencySum) / m_frameCount,
+        /* maxLatency */ toMilliseconds(m_maxLatency),
+        /* missedVsyncCount */ m_missedVsyncCount,
+        /* averageFenceWait */ toMilliseconds(m_fenceWaitSum) / m_frameCount,
+        /* averageAcquireWait */ toMilliseconds(m_acquireWaitSum) / m_frameCount,
+        /* refreshDuration */ m_refreshDuration.has_value() ? toMilliseconds(*m_refreshDuration) : 0.0
+    };
+
+    m_intervalStart = now;
+    m_frameCount = 0;
+    m_latencySum = {};
+    m_maxLatency = {};
+    m_missedVsyncCount = 0;
+    m_fenceWaitSum = {};
+    m_acquireWaitSum = {};
+    return true;
+}
+
+void FrameStatisticsCollector::resetSwapchain(const vk::raii::SwapchainKHR& swapchain)
+{
+    m_pendingFrames.clear();
+    m_lastPresentTime.reset();
+
+    if (m_source == PresentTimingSource::DisplayTiming)
+    {
+        m_refreshDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds{ swapchain.getRefreshCycleDurationGOOGLE().refreshDuration });
+    }
+}
+
+const FrameStatistics& FrameStatisticsCollector::getStatistics() const
+{
+    return m_statistics;
+}
+
+void FrameStatisticsCollector::updatePresentWait(const vk::raii::SwapchainKHR& swapchain)
+{
+    // A zero timeout only polls. Waiting for an id also succeeds if a later present replaced it (mailbox mode).
+    // The present time is when the poll saw it, so it is late by up to one frame loop iteration.
+    while (!m_pendingFrames.empty() &&
+           swapchain.waitForPresent(m_pendingFrames.front().presentId, /* timeout */ 0) == vk::Result::eSuccess)
+    {
+        completeFrame(m_pendingFrames.front(), Clock::now());
+        m_pendingFrames.pop_front();
+    }
+}
+
+void FrameStatisticsCollector::updateDisplayTiming(const vk::raii::SwapchainKHR& swapchain)
+{
+    for (const auto& timing : swapchain.getPastPresentationTimingGOOGLE())
+    {
+        // Presents before this one were never shown (e.g. replaced in mailbox mode).
+        while (!m_pendingFrames.empty() && m_pendingFrames.front().presentId < timing.presentID)
+        {
+            m_pendingFrames.pop_front();
+        }
+        if (m_pendingFrames.empty() || m_pendingFrames.front().presentId != timing.presentID)
+        {
+            continue;
+        }
+
+        // The presentation times are in the CLOCK_MONOTONIC time base, which is also the time base of the steady
+        // clock on the platforms that have this extension.
+        const Clock::time_point presentTime{ std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds{ timing.actualPresentTime }) };
+        completeFrame(m_pendingFrames.front(), presentTime);
+        m_pendingFrames.pop_front();
+    }
+}
+
+void FrameStatisticsCollector::completeFrame(const Frame& frame, Clock::time_point presentTime)
+{
+    const auto latency{ presentTime - frame.startTime };
+    ++m_frameCount;
+    m_latencySum += latency;
+    m_maxLatency = std::max(m_maxLatency, latency);
+    m_fenceWaitSum += frame.fenceWait;
+    m_acquireWaitSum += frame.acquireWait;
+
+    if (m_lastPresentTime.has_value() && m_refreshDuration.has_value() &&
+        (presentTime - *m_lastPresentTime) * 2 > *m_refreshDuration * 3)
+    {
+        ++m_missedVsyncCount;
+    }
+    m_lastPresentTime = presentTime;
+}
+
+} // namespace VkTest1::Renderer::Detail
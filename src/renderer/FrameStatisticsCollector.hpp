@@ -0,0 +1,90 @@
+#pragma once
+
+#include "renderer/FrameStatistics.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Measures when the frames reach the screen and summarizes them per interval.
+//
+// Per frame, draw() calls:
+//
+// 1. beginFrame()
+// 2. addFenceWait() and addAcquireWait() with the time it was blocked
+// 3. getNextPresentId(): The id to chain into the present (VkPresentIdKHR or VkPresentTimeGOOGLE).
+// 4. endFrame() after the present call.
+// 5. update(): Picks up the presents that have completed since. Never blocks.
+//
+class FrameStatisticsCollector
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // refreshDuration is the refresh cycle of the display, if known. Display timing replaces it with the exact one.
+    explicit FrameStatisticsCollector(
+        PresentTimingSource source, Clock::duration interval, std::optional<Clock::duration> refreshDuration);
+
+    PresentTimingSource getSource() const;
+
+    void beginFrame();
+    void addFenceWait(Clock::duration duration);
+    void addAcquireWait(Clock::duration duration);
+
+    // Never 0.
+    std::uint64_t getNextPresentId() const;
+
+    void endFrame();
+
+    // Returns true if an interval was completed. getStatistics() returns its summary.
+    bool update(const vk::raii::SwapchainKHR& swapchain);
+
+    // The presents still pending belong to the old swapchain. They are dropped.
+    void resetSwapchain(const vk::raii::SwapchainKHR& swapchain);
+
+    // The summary of the last completed interval.
+    const FrameStatistics& getStatistics() const;
+
+private:
+    struct Frame
+    {
+        std::uint64_t presentId{ 0 };
+        Clock::time_point startTime{};
+        Clock::duration fenceWait{};
+        Clock::duration acquireWait{};
+    };
+
+    void updatePresentWait(const vk::raii::SwapchainKHR& swapchain);
+    void updateDisplayTiming(const vk::raii::SwapchainKHR& swapchain);
+    void completeFrame(const Frame& frame, Clock::time_point presentTime);
+
+    PresentTimingSource m_source;
+    Clock::duration m_interval;
+    std::optional<Clock::duration> m_refreshDuration;
+    std::uint64_t m_nextPresentId{ 1 };
+    Frame m_currentFrame{};
+    // Presented but not yet on the screen. In present order.
+    std::deque<Frame> m_pendingFrames{};
+    std::optional<Clock::time_point> m_lastPresentTime{};
+
+    // -- CURRENT INTERVAL
+
+    Clock::time_point m_intervalStart{ Clock::now() };
+    std::uint32_t m_frameCount{ 0 };
+    Clock::duration m_latencySum{};
+    Clock::duration m_maxLatency{};
+    std::uint32_t m_missedVsyncCount{ 0 };
+    Clock::duration m_fenceWaitSum{};
+    Clock::duration m_acquireWaitSum{};
+
+    FrameStatistics m_statistics{};
+};
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,292 @@
+#include "renderer/GeometryArena.hpp"
+
+#include "common/Errors.hpp"
+#include "geometry/MeshData.hpp"
+#include "renderer/DeviceMemory.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <utility>
+
+using namespace VkTest1;
+
+namespace
+{
+
+// Per command buffer. Small enough that the copies don't delay the frame noticeably.
+constexpr vk::DeviceSize s_relocationBudget{ 1024 * 1024 };
+
+Renderer::Detail::GeometryRange allocateRange(
+    Renderer::Detail::RangeAllocator& allocator, std::uint32_t count, const char* bufferName)
+{
+    if (count == 0)
+    {
+        return Renderer::Detail::GeometryRange{ /* offset */ 0, /* count */ 0 };
+    }
+    const auto offset{ allocator.allocate(count) };
+    if (!offset.has_value())
+    {
+        throw Common::OutOfMemoryError{ std::string{ "The geometry arena has no room in the " } + bufferName + "." };
+    }
+    return Renderer::Detail::GeometryRange{ *offset, count };
+}
+
+std::uint32_t allocateMeshletBufferIndex(Renderer::Detail::BindlessDescriptors& descriptors)
+{
+    const auto slot{ descriptors.allocateStorageBufferSlot() };
+    if (!slot.has_value())
+    {
+        throw Common::RendererError{ "No free storage buffer slot." };
+    }
+    return *slot;
+}
+
+} // namespace
+
+namespace VkTest1::Renderer::Detail
+{
+
+GeometryAllocation::GeometryAllocation(GeometryArena* arena, const GeometryRanges& ranges) :
+    m_arena{ arena },
+    m_ranges{ ranges }
+{
+}
+
+GeometryAllocation::~GeometryAllocation()
+{
+    if (m_arena != nullptr)
+    {
+        m_arena->free(m_ranges);
+    }
+}
+
+GeometryAllocation::GeometryAllocation(GeometryAllocation&& other) noexcept :
+    m_arena{ std::exchange(other.m_arena, nullptr) },
+    m_ranges{ other.m_ranges }
+{
+}
+
+GeometryAllocation& GeometryAllocation::operator=(GeometryAllocation&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_arena != nullptr)
+        {
+            m_arena->free(m_ranges);
+        }
+        m_arena = std::exchange(other.m_arena, nullptr);
+        m_ranges = other.m_ranges;
+    }
+    return *this;
+}
+
+GeometryArena::Pool GeometryArena::createPool(
+    const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::Device& device, vk::DeviceSize elementSize,
+    std::uint32_t capacity, vk::BufferUsageFlags usage, std::uint32_t frameCount)
+{
+    // TransferSrc and TransferDst for the relocations within the buffer.
+    auto buffer{ device.createBuffer(vk::BufferCreateInfo{
+        /* flags */ {},
+        /* size */ elementSize * capacity,
+        /* usage */ usage | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+        /* sharingMode */ vk::SharingMode::eExclusive }) };
+    auto memory{ allocateDeviceMemory(
+        *physicalDevice, device, buffer.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal) };
+    buffer.bindMemory(memory, /* memoryOffset */ 0);
+    return GeometryArena::Pool{ elementSize,
+                                std::move(buffer),
+                                std::move(memory),
+                                RangeAllocator{ capacity, frameCount },
+                                /* relocations */ {} };
+}
+
+GeometryArena::GeometryArena(
+    Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice, Common::NotNull<const vk::raii::Device*> device,
+    Common::NotNull<BindlessDescriptors*> descriptors, std::uint32_t vertexCapacity, std::uint32_t indexCapacity,
+    std::uint32_t meshletCapacity, std::uint32_t frameCount) :
+    m_descriptors{ descriptors },
+    m_pools{ createPool(
+                 *physicalDevice,
+                 *device,
+                 sizeof(Geometry::Vertex),
+                 vertexCapacity,
+                 vk::BufferUsageFlagBits::eVertexBuffer,
+                 frameCount),
+             createPool(
+                 *physicalDevice,
+                 *device,
+                 sizeof(std::uint32_t),
+                 indexCapacity,
+                 vk::BufferUsageFlagBits::eIndexBuffer,
+                 frameCount),
+             createPool(
+                 *physicalDevice,
+                 *device,
+                 sizeof(Geometry::Meshlet),
+                 meshletCapacity,
+                 vk::BufferUsageFlagBits::eStorageBuffer,
+                 frameCount) },
+    m_meshletBufferIndex{ allocateMeshletBufferIndex(*m_descriptors) }
+{
+    m_descriptors->writeStorageBuffer(m_meshletBufferIndex, getMeshletBuffer());
+}
+
+GeometryArena::~GeometryArena()
+{
+    m_descriptors->freeStorageBufferSlot(m_meshletBufferIndex);
+}
+
+GeometryAllocation GeometryArena::allocate(
+    std::uint32_t vertexCount, std::size_t indexDataSize, std::uint32_t meshletCount)
+{
+    const auto indexWordCount{ (indexDataSize + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t) };
+    // Never fits, no matter what is freed.
+    if (vertexCount > m_pools[s_vertexPool].allocator.getCapacity() ||
+        indexWordCount > m_pools[s_indexPool].allocator.getCapacity() ||
+        meshletCount > m_pools[s_meshletPool].allocator.getCapacity())
+    {
+        throw Common::RendererError{ "The mesh is larger than the geometry arena." };
+    }
+
+    // Owns the ranges as soon as they are allocated, so a failure frees the others.
+    GeometryAllocation allocation{ this, GeometryRanges{} };
+    auto& ranges{ allocation.m_ranges };
+    ranges.vertices = allocateRange(m_pools[s_vertexPool].allocator, vertexCount, "vertex buffer");
+    ranges.indexWords = allocateRange(
+        m_pools[s_indexPool].allocator, static_cast<std::uint32_t>(indexWordCount), "index buffer");
+    ranges.meshlets = allocateRange(m_pools[s_meshletPool].allocator, meshletCount, "meshlet buffer");
+    return allocation;
+}
+
+bool GeometryArena::relocate(GeometryAllocation& allocation)
+{
+    assert(allocation.m_arena == this);
+    auto isRelocated{ false };
+    const auto ranges{ getRanges(allocation.m_ranges) };
+    for (auto i{ 0u }; i != m_pools.size(); ++i)
+    {
+        auto& pool{ m_pools[i] };
+        auto& range{ *ranges[i] };
+        if (range.count == 0 || m_relocatedSize >= s_relocationBudget)
+        {
+            continue;
+        }
+        // Moved already, but not copied yet. Moving it again would copy from a range that is not filled yet.
+        const auto isPending{ std::ranges::any_of(
+            pool.relocations,
+            [&range](const Relocation& relocation)
+            {
+                return relocation.destination == range.offset;
+            }) };
+        if (isPending)
+        {
+            continue;
+        }
+        const auto destination{ pool.allocator.allocateBefore(range.count, range.offset) };
+        if (!destination.has_value())
+        {
+            continue;
+        }
+        pool.relocations.push_back(Relocation{ range.offset, *destination, range.count });
+        m_relocatedSize += pool.elementSize * range.count;
+        range.offset = *destination;
+        isRelocated = true;
+    }
+    return isRelocated;
+}
+
+void GeometryArena::recordCopies(const vk::raii::CommandBuffer& commandBuffer)
+{
+    if (m_relocatedSize == 0)
+    {
+        return;
+    }
+
+    for (auto& pool : m_pools)
+    {
+        if (pool.relocations.empty())
+        {
+            continue;
+        }
+        // A free range never overlaps an allocated one, so the regions of a copy don't overlap.
+        std::vector<vk::BufferCopy> regions{};
+        regions.reserve(pool.relocations.size());
+        for (const auto& relocation : pool.relocations)
+        {
+            regions.push_back(vk::BufferCopy{ /* srcOffset */ pool.elementSize * relocation.source,
+                                              /* dstOffset */ pool.elementSize * relocation.destination,
+                                              /* size */ pool.elementSize * relocation.count });
+            // The copy reads it in this frame. Free once the frame is done.
+            pool.allocator.free(relocation.source, relocation.count);
+        }
+        commandBuffer.copyBuffer(pool.buffer, pool.buffer, regions);
+        pool.relocations.clear();
+    }
+    m_relocatedSize = 0;
+
+    // The draws read the vertices and indices, the GPU culling the meshlets.
+    commandBuffer.pipelineBarrier(
+        /* srcStageMask */ vk::PipelineStageFlagBits::eTransfer,
+        /* dstStageMask */ vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eComputeShader,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */
+        vk::MemoryBarrier{ vk::AccessFlagBits::eTransferWrite,
+                           vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+                               vk::AccessFlagBits::eShaderRead },
+        /* bufferMemoryBarriers */ {},
+        /* imageMemoryBarriers */ {});
+}
+
+void GeometryArena::beginFrame(unsigned int frame)
+{
+    for (auto& pool : m_pools)
+    {
+        pool.allocator.beginFrame(frame);
+    }
+}
+
+vk::DeviceSize GeometryArena::getSize() const
+{
+    vk::DeviceSize size{ 0 };
+    for (const auto& pool : m_pools)
+    {
+        size += pool.elementSize * pool.allocator.getCapacity();
+    }
+    return size;
+}
+
+std::array<GeometryRange*, 3> GeometryArena::getRanges(GeometryRanges& ranges)
+{
+    return { &ranges.vertices, &ranges.indexWords, &ranges.meshlets };
+}
+
+void GeometryArena::free(GeometryRanges ranges)
+{
+    const auto rangePointers{ getRanges(ranges) };
+    for (auto i{ 0u }; i != m_pools.size(); ++i)
+    {
+        auto& pool{ m_pools[i] };
+        const auto& range{ *rangePointers[i] };
+        if (range.count == 0)
+        {
+            continue;
+        }
+        // A copy into the range must not be recorded anymore, since the range may be reused by then.
+        std::erase_if(
+            pool.relocations,
+            [&pool, &range, this](const Relocation& relocation)
+            {
+                if (relocation.destination != range.offset)
+                {
+                    return false;
+                }
+                pool.allocator.free(relocation.source, relocation.count);
+                m_relocatedSize -= pool.elementSize * relocation.count;
+                return true;
+            });
+        pool.allocator.free(range.offset, range.count);
+    }
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "common/Types.hpp"
+#include "renderer/BindlessDescriptors.hpp"
+#include "renderer/RangeAllocator.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+class GeometryArena;
+
+struct GeometryRange
+{
+    std::uint32_t offset;
+    std::uint32_t count;
+};
+
+// Where the data of a mesh is in the arena, in elements of each buffer.
+struct GeometryRanges
+{
+    GeometryRange vertices;
+    // 32 bit words, so a mesh with 16 bit indices starts at a 4 byte boundary too.
+    GeometryRange indexWords;
+    GeometryRange meshlets;
+};
+
+//
+// The ranges of a mesh in the arena. Frees them when destroyed. The arena must outlive it.
+//
+class GeometryAllocation
+{
+public:
+    GeometryAllocation() = default;
+    ~GeometryAllocation();
+
+    GeometryAllocation(const GeometryAllocation& other) = delete;
+    GeometryAllocation& operator=(const GeometryAllocation& other) = delete;
+
+    GeometryAllocation(GeometryAllocation&& other) noexcept;
+    GeometryAllocation& operator=(GeometryAllocation&& other) noexcept;
+
+    // Change when the arena relocates the allocation.
+    const GeometryRanges& getRanges() const
+    {
+        return m_ranges;
+    }
+
+private:
+    friend class GeometryArena;
+
+    explicit GeometryAllocation(GeometryArena* arena, const GeometryRanges& ranges);
+
+    // Null if moved from.
+    GeometryArena* m_arena{ nullptr };
+    GeometryRanges m_ranges{};
+};
+
+//
+// The vertices, indices and meshlets of every mesh, sub-allocated from one vertex, one index and one meshlet buffer.
+// So the draws of all meshes share the vertex and index buffer bindings, and the GPU culling reads every meshlet
+// through one bindless storage buffer.
+//
+// The index buffer holds 16 and 32 bit indices. The indices of a mesh are relative to its first vertex, which the
+// draws pass as the vertex offset.
+//
+// Freed ranges leave holes, which the free lists reuse. relocate() moves the ranges of a mesh into a hole closer to the
+// start of the buffer, so the holes gather at the end. The copies are recorded at the start of the next command buffer
+// and limited to s_relocationBudget bytes per command buffer, so the defragmentation runs in the background of the
+// frames.
+//
+class GeometryArena
+{
+public:
+    // The capacities are in vertices, 32 bit indices (or twice as many 16 bit ones) and meshlets.
+    // Throws Common::RendererError if there is no bindless slot for the meshlet buffer.
+    explicit GeometryArena(
+        Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, Common::NotNull<BindlessDescriptors*> descriptors,
+        std::uint32_t vertexCapacity, std::uint32_t indexCapacity, std::uint32_t meshletCapacity,
+        std::uint32_t frameCount);
+    ~GeometryArena();
+
+    // The allocations point to the arena.
+    GeometryArena(const GeometryArena& other) = delete;
+    GeometryArena& operator=(const GeometryArena& other) = delete;
+
+    // Throws Common::OutOfMemoryError if a buffer has no free range that is large enough, and Common::RendererError
+    // if a buffer is smaller than the mesh.
+    GeometryAllocation allocate(std::uint32_t vertexCount, std::size_t indexDataSize, std::uint32_t meshletCount);
+
+    // Moves the ranges of the allocation into free ranges before them, if the budget allows. The new ranges can be
+    // used in the command buffer that recordCopies() is called for next. Returns true if a range was moved.
+    bool relocate(GeometryAllocation& allocation);
+
+    // Records the copies of the relocations since the last call. Before anything in the command buffer reads the
+    // geometry.
+    void recordCopies(const vk::raii::CommandBuffer& commandBuffer);
+
+    // Makes the frame in flight the current one. Its fence must have signaled.
+    void beginFrame(unsigned int frame);
+
+    vk::Buffer getVertexBuffer() const
+    {
+        return m_pools[s_vertexPool].buffer;
+    }
+
+    vk::Buffer getIndexBuffer() const
+    {
+        return m_pools[s_indexPool].buffer;
+    }
+
+    // Geometry::Meshlet each.
+    vk::Buffer getMeshletBuffer() const
+    {
+        return m_pools[s_meshletPool].buffer;
+    }
+
+    // The slot of the meshlet buffer in the bindless storage buffers.
+    std::uint32_t getMeshletBufferIndex() const
+    {
+        return m_meshletBufferIndex;
+    }
+
+    // Of the vertex, index and meshlet buffers together.
+    vk::DeviceSize getSize() const;
+
+private:
+    friend class GeometryAllocation;
+
+    static constexpr std::size_t s_vertexPool{ 0 };
+    static constexpr std::size_t s_indexPool{ 1 };
+    static constexpr std::size_t s_meshletPool{ 2 };
+
+    // A move of a range within a pool.
+    struct Relocation
+    {
+        std::uint32_t source;
+        std::uint32_t destination;
+        std::uint32_t count;
+    };
+
+    // One of the buffers.
+    struct Pool
+    {
+        vk::DeviceSize elementSize;
+        vk::raii::Buffer buffer;
+        vk::raii::DeviceMemory memory;
+        RangeAllocator allocator;
+        // Not recorded yet. The sources stay allocated until they are.
+        std::vector<Relocation> relocations;
+    };
+
+    static Pool createPool(
+        const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::Device& device, vk::DeviceSize elementSize,
+        std::uint32_t capacity, vk::BufferUsageFlags usage, std::uint32_t frameCount);
+    static std::array<GeometryRange*, 3> getRanges(GeometryRanges& ranges);
+
+    void free(GeometryRanges ranges);
+
+    Common::NotNull<BindlessDescriptors*> m_descriptors;
+    std::array<Pool, 3> m_pools;
+    std::uint32_t m_meshletBufferIndex;
+    // Of the relocations not recorded yet.
+    vk::DeviceSize m_relocatedSize{ 0 };
+};
+
+} // namespace VkTest1::Renderer::Detail
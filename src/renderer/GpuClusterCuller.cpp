@@ -0,0 +1,231 @@
+#include "renderer/GpuClusterCuller.hpp"
+
+#include "common/Cast.hpp"
+#include "renderer/DeviceMemory.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+using namespace VkTest1;
+
+namespace
+{
+
+// Must match cluster_cull.comp.glsl.
+constexpr std::uint32_t s_groupSize = 64;
+// Of a frame. 1.25 MiB per frame in flight.
+constexpr std::uint32_t s_maxDrawCount = 65536;
+
+// Must match cluster_cull.comp.glsl.
+struct PushConstants
+{
+    std::array<glm::vec4, 6> frustumPlanes;
+    glm::vec3 viewDirection;
+    std::uint32_t firstMeshlet;
+    std::uint32_t meshletCount;
+    std::uint32_t firstDraw;
+    // Of the mesh in the geometry arena.
+    std::uint32_t firstIndex;
+    std::int32_t vertexOffset;
+};
+// The minimum maxPushConstantsSize.
+static_assert(sizeof(PushConstants) == 128);
+static_assert(sizeof(Geometry::Meshlet) == 40);
+
+vk::DeviceSize getFrameRegionSize(const vk::raii::PhysicalDevice& physicalDevice)
+{
+    // The dynamic offsets of the regions must be aligned.
+    const auto alignment{ physicalDevice.getProperties().limits.minStorageBufferOffsetAlignment };
+    const auto size{ vk::DeviceSize{ s_maxDrawCount } * sizeof(vk::DrawIndexedIndirectCommand) };
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device)
+{
+    // The draws. The dynamic offset selects the region of the frame.
+    const std::array<vk::DescriptorSetLayoutBinding, 1> bindings{
+        vk::DescriptorSetLayoutBinding{ /* binding */ 0,
+                                        vk::DescriptorType::eStorageBufferDynamic,
+                                        /* count */ 1,
+                                        vk::ShaderStageFlagBits::eCompute }
+    };
+    return device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{ /* flags */ {}, bindings });
+}
+
+vk::raii::DescriptorPool createDescriptorPool(const vk::raii::Device& device)
+{
+    const std::array<vk::DescriptorPoolSize, 1> poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBufferDynamic, /* descriptorCount */ 1 }
+    };
+    // eFreeDescriptorSet is required by the raii descriptor set. It frees itself.
+    return device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+        /* flags */ vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, /* maxSets */ 1, poolSizes });
+}
+
+vk::raii::DescriptorSet createDescriptorSet(
+    const vk::raii::Device& device, const vk::raii::DescriptorPool& pool, const vk::raii::DescriptorSetLayout& layout,
+    const vk::raii::Buffer& drawBuffer, vk::DeviceSize frameRegionSize)
+{
+    const std::array<vk::DescriptorSetLayout, 1> layouts{ layout };
+    auto descriptorSet{
+        std::move(device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{ pool, layouts }).front()) };
+
+    const std::array<vk::DescriptorBufferInfo, 1> drawBufferInfos{
+        vk::DescriptorBufferInfo{ drawBuffer, /* offset */ 0, /* range */ frameRegionSize }
+    };
+    device.updateDescriptorSets(
+        vk::WriteDescriptorSet{ /* dstSet */ descriptorSet,
+                                /* dstBinding */ 0,
+                                /* dstArrayElement */ 0,
+                                vk::DescriptorType::eStorageBufferDynamic,
+                                /* pImageInfo */ {},
+                                /* pBufferInfo */ drawBufferInfos },
+        /* descriptorCopies */ {});
+    return descriptorSet;
+}
+
+vk::raii::PipelineLayout createPipelineLayout(
+    const vk::raii::Device& device, const vk::raii::DescriptorSetLayout& bindlessLayout,
+    const vk::raii::DescriptorSetLayout& descriptorSetLayout)
+{
+    const std::array<vk::DescriptorSetLayout, 2> setLayouts{ bindlessLayout, descriptorSetLayout };
+    const std::array<vk::PushConstantRange, 1> pushConstantRanges{
+        vk::PushConstantRange{ vk::ShaderStageFlagBits::eCompute, /* offset */ 0, sizeof(PushConstants) }
+    };
+    return device.createPipelineLayout(vk::PipelineLayoutCreateInfo{ /* flags */ {}, setLayouts, pushConstantRanges });
+}
+
+vk::raii::Pipeline createComputePipeline(
+    const vk::raii::Device& device, const vk::raii::PipelineLayout& layout, std::span<const std::byte> shaderSpv,
+    std::uint32_t meshletBufferIndex)
+{
+    // The shader module doesn't need to be retained.
+    const vk::raii::ShaderModule shaderModule{
+        device,
+        vk::ShaderModuleCreateInfo{
+            /* flags */ {}, shaderSpv.size(), reinterpret_cast<const uint32_t*>(shaderSpv.data()) }
+    };
+
+    // The slot of the meshlet buffer never changes. The push constants have no room left for it.
+    const std::array<vk::SpecializationMapEntry, 1> mapEntries{
+        vk::SpecializationMapEntry{ /* constantID */ 0, /* offset */ 0, sizeof(std::uint32_t) }
+    };
+    const std::array<std::uint32_t, 1> specializationData{ meshletBufferIndex };
+    const vk::SpecializationInfo specializationInfo{ mapEntries, specializationData };
+
+    const vk::ComputePipelineCreateInfo computePipelineCI{
+        /* flags */ {},
+        /* stage */
+        vk::PipelineShaderStageCreateInfo{ /* flags */ {},
+                                           /* stage */ vk::ShaderStageFlagBits::eCompute,
+                                           shaderModule,
+                                           "main",
+                                           &specializationInfo },
+        /* layout */ layout
+    };
+    return device.createComputePipeline(nullptr, computePipelineCI);
+}
+
+} // namespace
+
+namespace VkTest1::Renderer::Detail
+{
+
+GpuClusterCuller::GpuClusterCuller(
+    std::span<const std::byte> shader, Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+    Common::NotNull<const vk::raii::Device*> device, Common::NotNull<const BindlessDescriptors*> descriptors,
+    std::uint32_t meshletBufferIndex, std::uint32_t frameCount) :
+    m_device{ device },
+    m_descriptors{ descriptors },
+    m_frameRegionSize{ getFrameRegionSize(*physicalDevice) },
+    m_drawBuffer{ m_device->createBuffer(vk::BufferCreateInfo{
+        /* flags */ {},
+        /* size */ m_frameRegionSize * frameCount,
+        /* usage */ vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+        /* sharingMode */ vk::SharingMode::eExclusive }) },
+    m_drawBufferMemory{ allocateDeviceMemory(
+        *physicalDevice,
+        *m_device,
+        m_drawBuffer.getMemoryRequirements(),
+        vk::MemoryPropertyFlagBits::eDeviceLocal) },
+    m_descriptorSetLayout{ createDescriptorSetLayout(*m_device) },
+    m_descriptorPool{ createDescriptorPool(*m_device) },
+    m_descriptorSet{
+        createDescriptorSet(*m_device, m_descriptorPool, m_descriptorSetLayout, m_drawBuffer, m_frameRegionSize) },
+    m_pipelineLayout{
+        createPipelineLayout(*m_device, m_descriptors->getDescriptorSetLayout(), m_descriptorSetLayout) },
+    m_pipeline{ createComputePipeline(*m_device, m_pipelineLayout, shader, meshletBufferIndex) }
+{
+    m_drawBuffer.bindMemory(m_drawBufferMemory, /* memoryOffset */ 0);
+}
+
+void GpuClusterCuller::beginFrame(unsigned int frame, const CullView& view)
+{
+    m_frame = frame;
+    m_view = view;
+    m_dispatches.clear();
+    m_drawCount = 0;
+}
+
+std::optional<IndirectDraws> GpuClusterCuller::add(const Mesh& mesh, std::uint32_t lod)
+{
+    const auto meshlets{ mesh.getLodMeshlets(lod) };
+    if (meshlets.meshletCount == 0 || meshlets.meshletCount > s_maxDrawCount - m_drawCount)
+    {
+        return std::nullopt;
+    }
+
+    // The meshlets of the LOD are relative to the first meshlet of the mesh in the arena.
+    m_dispatches.push_back(Dispatch{
+        MeshletRange{ mesh.getFirstMeshlet() + meshlets.firstMeshlet, meshlets.meshletCount },
+        m_drawCount,
+        mesh.getFirstIndex(),
+        Common::NarrowCast<std::int32_t>(mesh.getFirstVertex()) });
+    const IndirectDraws draws{ /* buffer */ m_drawBuffer,
+                               /* offset */ m_frame * m_frameRegionSize +
+                                   m_drawCount * sizeof(vk::DrawIndexedIndirectCommand),
+                               /* drawCount */ meshlets.meshletCount };
+    m_drawCount += meshlets.meshletCount;
+    return draws;
+}
+
+void GpuClusterCuller::record(const vk::raii::CommandBuffer& commandBuffer) const
+{
+    if (m_dispatches.empty())
+    {
+        return;
+    }
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+    const std::array<vk::DescriptorSet, 2> descriptorSets{ m_descriptors->getDescriptorSet(), m_descriptorSet };
+    const std::array<std::uint32_t, 1> dynamicOffsets{ Common::NarrowCast<std::uint32_t>(
+        m_frame * m_frameRegionSize) };
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute, m_pipelineLayout, /* firstSet */ 0, descriptorSets, dynamicOffsets);
+    for (const auto& dispatch : m_dispatches)
+    {
+        const PushConstants pushConstants{ m_view.frustumPlanes,
+                                           m_view.viewDirection,
+                                           dispatch.meshlets.firstMeshlet,
+                                           dispatch.meshlets.meshletCount,
+                                           dispatch.firstDraw,
+                                           dispatch.firstIndex,
+                                           dispatch.vertexOffset };
+        commandBuffer.pushConstants<PushConstants>(
+            m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, /* offset */ 0, pushConstants);
+        commandBuffer.dispatch((dispatch.meshlets.meshletCount + s_groupSize - 1) / s_groupSize, 1, 1);
+    }
+
+    // The draws read the commands in the DrawIndirect stage.
+    commandBuffer.pipelineBarrier(
+        /* srcStageMask */ vk::PipelineStageFlagBits::eComputeShader,
+        /* dstStageMask */ vk::PipelineStageFlagBits::eDrawIndirect,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */
+        vk::MemoryBarrier{ vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eIndirectCommandRead },
+        /* bufferMemoryBarriers */ {},
+        /* imageMemoryBarriers */ {});
+}
+
+} // namespace VkTest1::Renderer::Detail
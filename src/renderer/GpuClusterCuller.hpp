@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/Types.hpp"
+#include "renderer/BindlessDescriptors.hpp"
+#include "renderer/ClusterCulling.hpp"
+#include "renderer/DrawList.hpp"
+#include "renderer/Mesh.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Culls the meshlets of the meshes in a compute pass (cluster_cull.comp.glsl) before the draws.
+//
+// Every meshlet of a drawn LOD gets a vk::DrawIndexedIndirectCommand in the draw buffer of the frame. The culled ones
+// get no instances, so a mesh is one indirect multi-draw whatever is visible. A draw count buffer
+// (vkCmdDrawIndexedIndirectCount) would skip the empty commands, but it needs Vulkan 1.2.
+//
+// The draw buffer has a region per frame in flight, so the culling of a frame doesn't overwrite the commands that the
+// previous frames are still drawing with.
+//
+// The shader reads the meshlets of all meshes from the meshlet buffer of the geometry arena, through the bindless
+// storage buffers (set 0), so one dispatch per LOD only pushes constants. The draw buffer is set 1.
+//
+class GpuClusterCuller
+{
+public:
+    // The device must have the multiDrawIndirect feature enabled.
+    explicit GpuClusterCuller(
+        std::span<const std::byte> shader, Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, Common::NotNull<const BindlessDescriptors*> descriptors,
+        std::uint32_t meshletBufferIndex, std::uint32_t frameCount);
+
+    // Drops the culling queued for the previous frame. The fence of the frame must have signaled.
+    void beginFrame(unsigned int frame, const CullView& view);
+
+    // Queues the culling of the meshlets of the LOD. Returns the draws of the visible meshlets. Empty if the LOD has no
+    // meshlets or the draw buffer of the frame is full: then the caller has to draw the LOD otherwise.
+    std::optional<IndirectDraws> add(const Mesh& mesh, std::uint32_t lod);
+
+    // Records the culling queued since beginFrame(). Outside of render passes, before the draws.
+    void record(const vk::raii::CommandBuffer& commandBuffer) const;
+
+private:
+    // The culling of one LOD.
+    struct Dispatch
+    {
+        // In the meshlet buffer of the arena.
+        MeshletRange meshlets;
+        std::uint32_t firstDraw;
+        std::uint32_t firstIndex;
+        std::int32_t vertexOffset;
+    };
+
+    Common::NotNull<const vk::raii::Device*> m_device;
+    Common::NotNull<const BindlessDescriptors*> m_descriptors;
+    // The size of the region of a frame in the draw buffer.
+    vk::DeviceSize m_frameRegionSize;
+    vk::raii::Buffer m_drawBuffer;
+    vk::raii::DeviceMemory m_drawBufferMemory;
+    vk::raii::DescriptorSetLayout m_descriptorSetLayout;
+    vk::raii::DescriptorPool m_descriptorPool;
+    // Of the draw buffer.
+    vk::raii::DescriptorSet m_descriptorSet;
+    vk::raii::PipelineLayout m_pipelineLayout;
+    vk::raii::Pipeline m_pipeline;
+    unsigned int m_frame{ 0 };
+    CullView m_view{};
+    std::vector<Dispatch> m_dispatches{};
+    // The draws queued in the current frame.
+    std::uint32_t m_drawCount{ 0 };
+};
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "renderer/CapturedFrame.hpp"
+
+namespace VkTest1::Renderer
+{
+
+// Stores captured frames. Meant to be called from a CaptureSink.
+class ICaptureWriter
+{
+public:
+    virtual ~ICaptureWriter() = default;
+
+    // Copies the pixels, so the frame can go away after the call.
+    virtual void write(const CapturedFrame& frame) = 0;
+};
+
+} // namespace VkTest1::Renderer
@@ -1,5 +1,15 @@
 #pragma once
 
+#include "geometry/MeshData.hpp"
+#include "renderer/CapturedFrame.hpp"
+#include "renderer/FrameState.hpp"
+#include "renderer/FrameStatistics.hpp"
+#include "texture/TextureData.hpp"
+
+#include <cstdint>
+#include <future>
+#include <optional>
+
 namespace VkTest1::Renderer
 {
 
@@ -8,7 +18,29 @@ class IRenderer
 public:
     virtual ~IRenderer() = default;
 
-    virtual void draw() = 0;
+    // The textures are numbered from 0 in the order they are added. Meshes refer to them by that number.
+    virtual void addTexture(std::future<Texture::TextureData> textureData) = 0;
+
+    // The mesh is drawn from the first frame after its data is loaded and uploaded to the GPU.
+    // It is drawn with the texture, or with white if it has none or the texture isn't uploaded (yet).
+    // Returns the number of the mesh. The meshes are numbered from 0 in the order they are added.
+    virtual std::uint32_t addMesh(std::future<Geometry::MeshData> meshData, std::optional<std::uint32_t> texture) = 0;
+
+    // The mesh is no longer drawn from the next frame on, and its memory is freed once the frames in flight are done.
+    // Its number is not reused. Throws Common::RendererError if there is no mesh with the number.
+    virtual void removeMesh(std::uint32_t mesh) = 0;
+
+    // Draws the frame described by frameState. The frame states must come from the same thread.
+    virtual void draw(const FrameState& frameState) = 0;
+
+    // The statistics of the last measurement interval (one second) of the first window.
+    virtual const FrameStatistics& getFrameStatistics() const = 0;
+
+    // Every frame presented in the first window is copied back and handed to the sink on the thread that draws, a few
+    // frames later (the frames in flight). An empty sink stops capturing.
+    // Capturing starts with the next frame. It needs a swapchain that supports copies from 8-bit RGBA or BGRA images;
+    // otherwise the renderer logs a warning and the sink gets nothing.
+    virtual void setCaptureSink(CaptureSink sink) = 0;
 };
 
 } // namespace VkTest1::Renderer
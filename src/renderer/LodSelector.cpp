@@ -0,0 +1,51 @@
+#include "renderer/LodSelector.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+// A coarser LOD must have at most this fraction of the allowed error.
+constexpr float s_hysteresis{ 0.75f };
+
+} // namespace
+
+LodSelector::LodSelector(float maxScreenError) : m_maxScreenError{ maxScreenError }
+{
+}
+
+std::uint32_t LodSelector::select(std::size_t instance, std::span<const Geometry::MeshLod> lods, float pixelsPerUnit)
+{
+    if (instance >= m_currentLods.size())
+    {
+        m_currentLods.resize(instance + 1, 0);
+    }
+    if (lods.size() <= 1 || m_maxScreenError <= 0.0f)
+    {
+        return 0;
+    }
+
+    const auto getScreenError = [&lods, pixelsPerUnit](std::uint32_t lod)
+    {
+        return lods[lod].error * pixelsPerUnit;
+    };
+
+    // The mesh may have been replaced by one with fewer LODs.
+    auto lod{ std::min<std::uint32_t>(m_currentLods[instance], static_cast<std::uint32_t>(lods.size() - 1)) };
+    while (lod != 0 && getScreenError(lod) > m_maxScreenError)
+    {
+        --lod;
+    }
+    while (lod + 1 != lods.size() && getScreenError(lod + 1) <= m_maxScreenError * s_hysteresis)
+    {
+        ++lod;
+    }
+
+    m_currentLods[instance] = static_cast<std::uint8_t>(lod);
+    return lod;
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Picks the level of detail of every mesh instance from how big its simplification error is on screen: the least
+// detailed LOD whose error projects to at most maxScreenError pixels.
+//
+// The choice has hysteresis, so an instance whose size hovers around a threshold doesn't switch LODs every frame (a
+// visible pop each time): it only gets coarser once the coarser LOD's error is clearly below the threshold, and only
+// gets finer once the current LOD's error is above it.
+//
+class LodSelector
+{
+public:
+    // With a maxScreenError of 0, every instance gets its most detailed LOD.
+    explicit LodSelector(float maxScreenError);
+
+    // The instances are numbered by the caller. pixelsPerUnit is the size on screen of one unit of the positions at
+    // the instance's distance.
+    std::uint32_t select(std::size_t instance, std::span<const Geometry::MeshLod> lods, float pixelsPerUnit);
+
+private:
+    float m_maxScreenError;
+    // The LOD each instance was last drawn with.
+    std::vector<std::uint8_t> m_currentLods{};
+};
+
+} // namespace VkTest1::Renderer::Detail
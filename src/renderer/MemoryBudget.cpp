@@ -0,0 +1,90 @@
+#include "renderer/MemoryBudget.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+// Often enough to notice other processes taking memory. The allocations of the renderer are counted right away.
+constexpr std::chrono::milliseconds s_updateInterval{ 250 };
+
+// Without the extension. The rest of the heap is left for the render targets, the small buffers, the driver and the
+// other processes, none of which the estimate sees.
+constexpr double s_fallbackBudgetFraction{ 0.8 };
+
+std::uint32_t findLargestDeviceLocalHeap(const vk::PhysicalDeviceMemoryProperties& memoryProperties)
+{
+    // Every device has a device local heap.
+    std::uint32_t heapIndex{ 0 };
+    vk::DeviceSize heapSize{ 0 };
+    for (auto i{ 0u }; i != memoryProperties.memoryHeapCount; ++i)
+    {
+        const auto& heap{ memoryProperties.memoryHeaps[i] };
+        if ((heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) && heap.size > heapSize)
+        {
+            heapIndex = i;
+            heapSize = heap.size;
+        }
+    }
+    return heapIndex;
+}
+
+vk::DeviceSize applyLimit(vk::DeviceSize budget, vk::DeviceSize limit)
+{
+    return limit != 0 ? std::min(budget, limit) : budget;
+}
+
+} // namespace
+
+MemoryBudget::MemoryBudget(
+    const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget, vk::DeviceSize limit) :
+    m_hasMemoryBudget{ hasMemoryBudget },
+    m_heapIndex{ findLargestDeviceLocalHeap(physicalDevice.getMemoryProperties()) },
+    m_limit{ limit },
+    m_budget{ applyLimit(
+        static_cast<vk::DeviceSize>(
+            static_cast<double>(physicalDevice.getMemoryProperties().memoryHeaps[m_heapIndex].size) *
+            s_fallbackBudgetFraction),
+        m_limit) }
+{
+    update(physicalDevice, Clock::now());
+}
+
+void MemoryBudget::update(const vk::raii::PhysicalDevice& physicalDevice, Clock::time_point now)
+{
+    if (!m_hasMemoryBudget || (m_lastUpdate.has_value() && now - *m_lastUpdate < s_updateInterval))
+    {
+        return;
+    }
+    m_lastUpdate = now;
+
+    const auto properties{ physicalDevice.getMemoryProperties2<
+        vk::PhysicalDeviceMemoryProperties2,
+        vk::PhysicalDeviceMemoryBudgetPropertiesEXT>() };
+    const auto& budget{ properties.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>() };
+    m_driverUsage = budget.heapUsage[m_heapIndex];
+    m_budget = applyLimit(budget.heapBudget[m_heapIndex], m_limit);
+    // The usage of the driver includes them now.
+    m_allocatedSinceUpdate = 0;
+}
+
+void MemoryBudget::allocate(vk::DeviceSize size)
+{
+    m_allocatedSinceUpdate += static_cast<std::int64_t>(size);
+}
+
+void MemoryBudget::free(vk::DeviceSize size)
+{
+    m_allocatedSinceUpdate -= static_cast<std::int64_t>(size);
+}
+
+vk::DeviceSize MemoryBudget::getUsage() const
+{
+    const auto usage{ static_cast<std::int64_t>(m_driverUsage) + m_allocatedSinceUpdate };
+    return static_cast<vk::DeviceSize>(std::max(usage, std::int64_t{ 0 }));
+}
+
+} // namespace VkTest1::Renderer::Detail
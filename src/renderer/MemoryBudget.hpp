@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// How much of the device local memory the renderer may still allocate. The memory is that of the largest device
+// local heap, where the images and the geometry go.
+//
+// With VK_EXT_memory_budget the driver reports the usage and the budget of this process, so other processes count
+// too. The driver is queried now and then, and the allocations since the last query are added to its usage.
+// Without the extension, the usage is estimated from the allocations the renderer reports, and the budget is a part of
+// the heap size.
+//
+class MemoryBudget
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // hasMemoryBudget tells if VK_EXT_memory_budget is enabled on the device. A limit other than 0 caps the budget, in
+    // bytes.
+    explicit MemoryBudget(const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget, vk::DeviceSize limit);
+
+    // Once per frame. Queries the driver now and then.
+    void update(const vk::raii::PhysicalDevice& physicalDevice, Clock::time_point now);
+
+    // The renderer reports the device local allocations it makes and frees.
+    void allocate(vk::DeviceSize size);
+    void free(vk::DeviceSize size);
+
+    // True if an allocation of the size stays within the budget.
+    bool canAllocate(vk::DeviceSize size) const
+    {
+        return size <= m_budget && getUsage() <= m_budget - size;
+    }
+
+    bool isOverBudget() const
+    {
+        return getUsage() > m_budget;
+    }
+
+    vk::DeviceSize getUsage() const;
+
+    vk::DeviceSize getBudget() const
+    {
+        return m_budget;
+    }
+
+private:
+    bool m_hasMemoryBudget;
+    std::uint32_t m_heapIndex;
+    vk::DeviceSize m_limit;
+    vk::DeviceSize m_budget;
+    // As of the last query. Zero without the extension.
+    vk::DeviceSize m_driverUsage{ 0 };
+    // Allocated minus freed since the last query. Can be negative if more was freed.
+    std::int64_t m_allocatedSinceUpdate{ 0 };
+    std::optional<Clock::time_point> m_lastUpdate{};
+};
+
+} // namespace VkTest1::Renderer::Detail
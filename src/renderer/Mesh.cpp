@@ -1,68 +1,85 @@
 #include "Mesh.hpp"
 
+#include "common/Cast.hpp"
 #include "common/Errors.hpp"
-#include "common/Types.hpp"
+#include "renderer/DeviceMemory.hpp"
+#include "renderer/MeshStaging.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 using namespace VkTest1;
 
 namespace
 {
 
-std::uint32_t findMemoryTypeIndex(
-    const vk::PhysicalDevice& physicalDevice, std::uint32_t allowedTypes, vk::MemoryPropertyFlags propertyFlags)
+vk::IndexType chooseIndexType(const Geometry::MeshData& meshData, bool compactIndices)
 {
-    const auto memoryProperties{ physicalDevice.getMemoryProperties() };
+    // At most 65535 vertices, so no index is 0xFFFF. That is the primitive restart index if it is ever enabled.
+    const auto fitsUint16{ meshData.vertices.size() <= std::numeric_limits<std::uint16_t>::max() };
+    return (compactIndices && fitsUint16) ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+}
 
-    for (auto i{ 0u }; i != memoryProperties.memoryTypeCount; ++i)
+std::vector<Geometry::MeshLod> getLods(const Geometry::MeshData& meshData)
+{
+    if (meshData.lods.empty())
+    {
+        return { Geometry::MeshLod{ /* firstIndex */ 0,
+                                    /* indexCount */ Common::NarrowCast<std::uint32_t>(meshData.indices.size()),
+                                    /* error */ 0.0f } };
+    }
+    for (const auto& lod : meshData.lods)
     {
-        if (Common::Flags::isFlagSet(allowedTypes, i) &&
-            Common::Flags::isMaskSet(memoryProperties.memoryTypes[i].propertyFlags, propertyFlags))
+        if (lod.firstIndex > meshData.indices.size() || lod.indexCount > meshData.indices.size() - lod.firstIndex)
         {
-            return i;
+            throw Common::RendererError{ "LOD out of range." };
         }
     }
-    throw Common::RendererError{ "Cannot find memory type index." };
-}
-
-// This does not allocate memory.
-vk::raii::Buffer createVertexBuffer(const vk::raii::Device& device, std::span<const Geometry::Vertex> vertices)
-{
-    const auto bufferSize{ sizeof(Geometry::Vertex) * vertices.size() };
-    return device.createBuffer(vk::BufferCreateInfo{ /* flags */ {},
-                                                     /* size */ bufferSize,
-                                                     /* usage */ vk::BufferUsageFlagBits::eVertexBuffer,
-                                                     // eExclusive means "no sharing".
-                                                     /* sharingMode */ vk::SharingMode::eExclusive });
+    return meshData.lods;
 }
 
-vk::raii::DeviceMemory allocateDeviceMemory(
-    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device, const vk::raii::Buffer& buffer)
+// Only the meshlets that cover a LOD exactly are used. Otherwise the LOD has none and is drawn as a whole.
+std::vector<Renderer::Detail::MeshletRange> getLodMeshlets(
+    std::span<const Geometry::Meshlet> meshlets, std::span<const Geometry::MeshLod> lods)
 {
-    const auto memoryReqirements{ buffer.getMemoryRequirements() };
-    auto deviceMemory{ device.allocateMemory(vk::MemoryAllocateInfo{
-        /* allocationSize */ memoryReqirements.size,
-        /* memoryTypeIndex */
-        findMemoryTypeIndex(
-            physicalDevice,
-            /* allowedTypes */ memoryReqirements.memoryTypeBits,
-            // HostVisible = CPU can access it.
-            // HostCoherent = No need for manual flush (i.e. memory cache management).
-            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent) }) };
-    return deviceMemory;
+    std::vector<Renderer::Detail::MeshletRange> lodMeshlets{};
+    for (const auto& lod : lods)
+    {
+        // Sorted by first index, so the meshlets of a LOD follow each other.
+        const auto first{ std::ranges::lower_bound(meshlets, lod.firstIndex, {}, &Geometry::Meshlet::firstIndex) };
+        const auto lodEnd{ lod.firstIndex + lod.indexCount };
+        auto last{ first };
+        auto nextIndex{ lod.firstIndex };
+        while (last != meshlets.end() && last->firstIndex == nextIndex && nextIndex < lodEnd)
+        {
+            nextIndex += last->indexCount;
+            ++last;
+        }
+        const auto isCovered{ lod.indexCount != 0 && nextIndex == lodEnd };
+        lodMeshlets.push_back(
+            isCovered ? Renderer::Detail::MeshletRange{ Common::NarrowCast<std::uint32_t>(first - meshlets.begin()),
+                                                        Common::NarrowCast<std::uint32_t>(last - first) }
+                      : Renderer::Detail::MeshletRange{ /* firstMeshlet */ 0, /* meshletCount */ 0 });
+    }
+    return lodMeshlets;
 }
 
 void bindMemoryAndCopyData(
-    const vk::raii::Buffer& vertexBuffer, const vk::raii::DeviceMemory& deviceMemory,
-    std::span<const Geometry::Vertex> vertices)
+    const vk::raii::Buffer& stagingBuffer, const vk::raii::DeviceMemory& deviceMemory,
+    std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices, vk::IndexType indexType,
+    std::span<const Geometry::Meshlet> meshlets)
 {
     // Bind memory to buffer.
-    vertexBuffer.bindMemory(deviceMemory, /* memoryOffset */ 0);
+    stagingBuffer.bindMemory(deviceMemory, /* memoryOffset */ 0);
 
     // Copy data to device memory.
-    const auto bufferSize{ sizeof(Geometry::Vertex) * vertices.size() };
-    auto* mappedVertices{ static_cast<Geometry::Vertex*>(
+    const auto bufferSize{
+        Renderer::Detail::getStagingDataSize(vertices.size(), indices.size(), indexType, meshlets.size())
+    };
+    auto* mappedData{ static_cast<std::byte*>(
         deviceMemory.mapMemory(/* offset */ 0, /* size */ bufferSize, /* flags*/ {})) };
-    std::copy_n(vertices.data(), vertices.size(), mappedVertices);
+    Renderer::Detail::writeStagingData(mappedData, vertices, indices, indexType, meshlets);
     deviceMemory.unmapMemory();
 }
 
@@ -72,13 +89,119 @@ namespace VkTest1::Renderer
 {
 
 Mesh::Mesh(
-    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device,
-    std::span<const Geometry::Vertex> vertices) :
-    m_vertexCount{ vertices.size() },
-    m_vertexBuffer{ createVertexBuffer(device, vertices) },
-    m_vertexBufferMemory{ allocateDeviceMemory(physicalDevice, device, m_vertexBuffer) }
+    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device, Detail::GeometryArena& geometryArena,
+    const Geometry::MeshData& meshData, bool compactIndices, std::uint32_t textureIndex) :
+    m_vertexCount{ meshData.vertices.size() },
+    m_indexCount{ meshData.indices.size() },
+    m_indexType{ chooseIndexType(meshData, compactIndices) },
+    m_bounds{ meshData.bounds },
+    m_textureIndex{ textureIndex },
+    m_lods{ getLods(meshData) },
+    m_lodMeshlets{ getLodMeshlets(meshData.meshlets, m_lods) },
+    m_clusterBounds{ Renderer::Detail::makeClusterBounds(meshData.meshlets) },
+    m_geometry{ geometryArena.allocate(
+        Common::NarrowCast<std::uint32_t>(m_vertexCount),
+        Detail::getIndexSize(m_indexType) * m_indexCount,
+        Common::NarrowCast<std::uint32_t>(meshData.meshlets.size())) },
+    m_stagingBuffer{ device.createBuffer(vk::BufferCreateInfo{
+        /* flags */ {},
+        /* size */ Detail::getStagingDataSize(m_vertexCount, m_indexCount, m_indexType, meshData.meshlets.size()),
+        /* usage */ vk::BufferUsageFlagBits::eTransferSrc,
+        // eExclusive means "no sharing".
+        /* sharingMode */ vk::SharingMode::eExclusive }) },
+    // HostVisible = CPU can access it.
+    // HostCoherent = No need for manual flush (i.e. memory cache management).
+    m_stagingBufferMemory{ Detail::allocateDeviceMemory(
+        physicalDevice,
+        device,
+        m_stagingBuffer.getMemoryRequirements(),
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent) }
+{
+    bindMemoryAndCopyData(
+        m_stagingBuffer, m_stagingBufferMemory, meshData.vertices, meshData.indices, m_indexType, meshData.meshlets);
+}
+
+void Mesh::recordUpload(const vk::raii::CommandBuffer& commandBuffer, const Detail::GeometryArena& geometryArena) const
+{
+    const auto& ranges{ m_geometry.getRanges() };
+    const auto vertexDataSize{ sizeof(Geometry::Vertex) * m_vertexCount };
+    const auto vertexDataOffset{ vk::DeviceSize{ sizeof(Geometry::Vertex) } * ranges.vertices.offset };
+    const auto indexDataSize{ Detail::getIndexSize(m_indexType) * m_indexCount };
+    const auto indexDataOffset{ vk::DeviceSize{ sizeof(std::uint32_t) } * ranges.indexWords.offset };
+
+    commandBuffer.copyBuffer(
+        m_stagingBuffer,
+        geometryArena.getVertexBuffer(),
+        vk::BufferCopy{ /* srcOffset */ 0, /* dstOffset */ vertexDataOffset, /* size */ vertexDataSize });
+
+    std::vector<vk::BufferMemoryBarrier> barriers{};
+    // The copy must be finished and visible before any vertex shader reads the buffer.
+    barriers.push_back(vk::BufferMemoryBarrier{ /* srcAccessMask */ vk::AccessFlagBits::eTransferWrite,
+                                                /* dstAccessMask */ vk::AccessFlagBits::eVertexAttributeRead,
+                                                /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                /* buffer */ geometryArena.getVertexBuffer(),
+                                                /* offset */ vertexDataOffset,
+                                                /* size */ vertexDataSize });
+
+    if (m_indexCount != 0)
+    {
+        commandBuffer.copyBuffer(
+            m_stagingBuffer,
+            geometryArena.getIndexBuffer(),
+            vk::BufferCopy{
+                /* srcOffset */ vertexDataSize, /* dstOffset */ indexDataOffset, /* size */ indexDataSize });
+        barriers.push_back(vk::BufferMemoryBarrier{ /* srcAccessMask */ vk::AccessFlagBits::eTransferWrite,
+                                                    /* dstAccessMask */ vk::AccessFlagBits::eIndexRead,
+                                                    /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                    /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                    /* buffer */ geometryArena.getIndexBuffer(),
+                                                    /* offset */ indexDataOffset,
+                                                    /* size */ indexDataSize });
+    }
+
+    vk::PipelineStageFlags dstStages{ vk::PipelineStageFlagBits::eVertexInput };
+    if (m_clusterBounds.size() != 0)
+    {
+        const auto meshletDataSize{ sizeof(Geometry::Meshlet) * m_clusterBounds.size() };
+        const auto meshletDataOffset{ vk::DeviceSize{ sizeof(Geometry::Meshlet) } * ranges.meshlets.offset };
+        commandBuffer.copyBuffer(
+            m_stagingBuffer,
+            geometryArena.getMeshletBuffer(),
+            vk::BufferCopy{ /* srcOffset */ Detail::getMeshletDataOffset(m_vertexCount, m_indexCount, m_indexType),
+                            /* dstOffset */ meshletDataOffset,
+                            /* size */ meshletDataSize });
+        // Read by the culling compute shader.
+        barriers.push_back(vk::BufferMemoryBarrier{ /* srcAccessMask */ vk::AccessFlagBits::eTransferWrite,
+                                                    /* dstAccessMask */ vk::AccessFlagBits::eShaderRead,
+                                                    /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                    /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                    /* buffer */ geometryArena.getMeshletBuffer(),
+                                                    /* offset */ meshletDataOffset,
+                                                    /* size */ meshletDataSize });
+        dstStages |= vk::PipelineStageFlagBits::eComputeShader;
+    }
+
+    commandBuffer.pipelineBarrier(
+        /* srcStageMask */ vk::PipelineStageFlagBits::eTransfer,
+        /* dstStageMask */ dstStages,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */ {},
+        /* bufferMemoryBarriers */ barriers,
+        /* imageMemoryBarriers */ {});
+}
+
+std::uint32_t Mesh::getFirstIndex() const
+{
+    const auto firstIndexWord{ m_geometry.getRanges().indexWords.offset };
+    return Common::NarrowCast<std::uint32_t>(
+        firstIndexWord * sizeof(std::uint32_t) / Detail::getIndexSize(m_indexType));
+}
+
+void Mesh::releaseStagingBuffer()
 {
-    bindMemoryAndCopyData(m_vertexBuffer, m_vertexBufferMemory, vertices);
+    m_stagingBuffer = vk::raii::Buffer{ nullptr };
+    m_stagingBufferMemory = vk::raii::DeviceMemory{ nullptr };
 }
 
 } // namespace VkTest1::Renderer
@@ -1,10 +1,15 @@
 #pragma once
 
-#include "geometry/Vertex.hpp"
+#include "geometry/MeshData.hpp"
+#include "renderer/ClusterCulling.hpp"
+#include "renderer/GeometryArena.hpp"
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <span>
+#include <vector>
 
 namespace VkTest1::Renderer
 {
@@ -12,9 +17,15 @@ namespace VkTest1::Renderer
 class Mesh
 {
 public:
+    // Allocates the vertices, indices and meshlets in the geometry arena, and creates a host visible staging buffer
+    // holding a copy of the data. The data reaches the arena only after the commands of recordUpload() were executed.
+    // With compactIndices, meshes that have at most 65535 vertices get 16 bit indices.
+    // The texture index is the renderer's index of the texture the mesh is drawn with.
+    // Throws Common::OutOfMemoryError if the arena or the staging memory is full, and Common::RendererError if a LOD is
+    // out of the range of the indices.
     explicit Mesh(
-        const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device,
-        std::span<const Geometry::Vertex> vertices);
+        const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device, Detail::GeometryArena& geometryArena,
+        const Geometry::MeshData& meshData, bool compactIndices, std::uint32_t textureIndex);
 
     Mesh(const Mesh& other) = delete;
     Mesh& operator=(const Mesh& other) = delete;
@@ -22,20 +33,90 @@ public:
     Mesh(Mesh&& other) = default;
     Mesh& operator=(Mesh&& other) = default;
 
+    // Records the copy from the staging buffer to the arena. The arena must be the one of the constructor.
+    void recordUpload(const vk::raii::CommandBuffer& commandBuffer, const Detail::GeometryArena& geometryArena) const;
+
+    // Call this only after the upload commands finished executing.
+    void releaseStagingBuffer();
+
     std::size_t getVertexCount() const
     {
         return m_vertexCount;
     }
 
-    const vk::Buffer getVertexBuffer() const
+    // In the vertex buffer of the arena. The vertex offset of the draws.
+    std::uint32_t getFirstVertex() const
+    {
+        return m_geometry.getRanges().vertices.offset;
+    }
+
+    // Of all LODs. Zero if the mesh is not indexed.
+    std::size_t getIndexCount() const
+    {
+        return m_indexCount;
+    }
+
+    // In the index buffer of the arena, in indices of the index type. The indices of the LODs and meshlets are
+    // relative to it.
+    std::uint32_t getFirstIndex() const;
+
+    vk::IndexType getIndexType() const
+    {
+        return m_indexType;
+    }
+
+    // In the meshlet buffer of the arena. The meshlet ranges of the LODs are relative to it.
+    std::uint32_t getFirstMeshlet() const
+    {
+        return m_geometry.getRanges().meshlets.offset;
+    }
+
+    // For relocating the mesh in the arena.
+    Detail::GeometryAllocation& getGeometryAllocation()
+    {
+        return m_geometry;
+    }
+
+    const Geometry::Bounds& getBounds() const
+    {
+        return m_bounds;
+    }
+
+    std::uint32_t getTextureIndex() const
+    {
+        return m_textureIndex;
+    }
+
+    // From the most to the least detailed. At least one. A non-indexed mesh has one with no indices.
+    std::span<const Geometry::MeshLod> getLods() const
+    {
+        return m_lods;
+    }
+
+    // The meshlets that cover the LOD. None if the mesh has no meshlets for it: then the LOD is drawn as a whole.
+    MeshletRange getLodMeshlets(std::uint32_t lod) const
+    {
+        return m_lodMeshlets[lod];
+    }
+
+    const ClusterBounds& getClusterBounds() const
     {
-        return m_vertexBuffer;
+        return m_clusterBounds;
     }
 
 private:
     std::size_t m_vertexCount;
-    vk::raii::Buffer m_vertexBuffer;
-    vk::raii::DeviceMemory m_vertexBufferMemory;
+    std::size_t m_indexCount;
+    vk::IndexType m_indexType;
+    Geometry::Bounds m_bounds;
+    std::uint32_t m_textureIndex;
+    std::vector<Geometry::MeshLod> m_lods;
+    // One per LOD.
+    std::vector<MeshletRange> m_lodMeshlets;
+    ClusterBounds m_clusterBounds;
+    Detail::GeometryAllocation m_geometry;
+    vk::raii::Buffer m_stagingBuffer;
+    vk::raii::DeviceMemory m_stagingBufferMemory;
 };
 
 } // namespace VkTest1::Renderer
@@ -0,0 +1,56 @@
+#include "renderer/MeshStaging.hpp"
+
+#include "common/Cast.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace VkTest1::Renderer::Detail
+{
+
+std::size_t getIndexSize(vk::IndexType indexType)
+{
+    return (indexType == vk::IndexType::eUint16) ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+std::size_t getMeshletDataOffset(std::size_t vertexCount, std::size_t indexCount, vk::IndexType indexType)
+{
+    const auto size{ sizeof(Geometry::Vertex) * vertexCount + getIndexSize(indexType) * indexCount };
+    return (size + alignof(Geometry::Meshlet) - 1) / alignof(Geometry::Meshlet) * alignof(Geometry::Meshlet);
+}
+
+std::size_t getStagingDataSize(
+    std::size_t vertexCount, std::size_t indexCount, vk::IndexType indexType, std::size_t meshletCount)
+{
+    return getMeshletDataOffset(vertexCount, indexCount, indexType) + sizeof(Geometry::Meshlet) * meshletCount;
+}
+
+void writeStagingData(
+    std::byte* destination, std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices,
+    vk::IndexType indexType, std::span<const Geometry::Meshlet> meshlets)
+{
+    std::memcpy(destination, vertices.data(), vertices.size_bytes());
+    if (indexType == vk::IndexType::eUint16)
+    {
+        // The vertex data size is a multiple of 4, so the indices are aligned.
+        auto* destinationIndices{ reinterpret_cast<std::uint16_t*>(destination + vertices.size_bytes()) };
+        std::ranges::transform(
+            indices,
+            destinationIndices,
+            [](std::uint32_t index)
+            {
+                return Common::NarrowCast<std::uint16_t>(index);
+            });
+    }
+    else
+    {
+        std::memcpy(destination + vertices.size_bytes(), indices.data(), indices.size_bytes());
+    }
+    if (!meshlets.empty())
+    {
+        const auto meshletDataOffset{ getMeshletDataOffset(vertices.size(), indices.size(), indexType) };
+        std::memcpy(destination + meshletDataOffset, meshlets.data(), meshlets.size_bytes());
+    }
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace VkTest1::Renderer::Detail
+{
+
+std::size_t getIndexSize(vk::IndexType indexType);
+
+// The meshlets follow the indices in the staging buffer, aligned for the copy.
+std::size_t getMeshletDataOffset(std::size_t vertexCount, std::size_t indexCount, vk::IndexType indexType);
+
+// The size of the staging data of a mesh.
+std::size_t getStagingDataSize(
+    std::size_t vertexCount, std::size_t indexCount, vk::IndexType indexType, std::size_t meshletCount);
+
+// Writes the staging data of a mesh: the vertices, then the indices converted to the index type, then the meshlets.
+// The destination must have getStagingDataSize() bytes and be 4 byte aligned, like mapped memory is.
+void writeStagingData(
+    std::byte* destination, std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices,
+    vk::IndexType indexType, std::span<const Geometry::Meshlet> meshlets);
+
+} // namespace VkTest1::Renderer::Detail
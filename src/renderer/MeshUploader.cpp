@@ -0,0 +1,200 @@
+#include "renderer/MeshUploader.hpp"
+
+#include "common/Errors.hpp"
+#include "renderer/MeshStaging.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+namespace VkTest1::Renderer::Detail
+{
+
+MeshUploader::MeshUploader(
+    Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice, Common::NotNull<const vk::raii::Device*> device,
+    Common::NotNull<const vk::raii::Queue*> queue, Common::NotNull<Logging::ILogger*> logger,
+    Common::NotNull<GeometryArena*> geometryArena, Common::NotNull<Common::Counter*> uploadedBytes,
+    std::uint32_t queueFamilyIndex, bool compactIndices) :
+    m_physicalDevice{ physicalDevice },
+    m_device{ device },
+    m_queue{ queue },
+    m_logger{ logger },
+    m_geometryArena{ geometryArena },
+    m_uploadedBytes{ uploadedBytes },
+    m_compactIndices{ compactIndices },
+    // eTransient = The command buffers are short lived. They are recorded once and freed after execution.
+    m_commandPool{ device->createCommandPool(vk::CommandPoolCreateInfo{
+        /* flags */ vk::CommandPoolCreateFlagBits::eTransient,
+        /* queueFamilyIndex */ queueFamilyIndex }) }
+{
+}
+
+void MeshUploader::enqueue(
+    std::future<Geometry::MeshData> meshData, std::uint32_t meshIndex, std::uint32_t textureIndex)
+{
+    m_loading.push_back(Load{ std::move(meshData), meshIndex, textureIndex });
+}
+
+void MeshUploader::reload(std::uint32_t meshIndex)
+{
+    if (meshIndex >= m_sources.size() || !m_sources[meshIndex].has_value() || m_sources[meshIndex]->isQueued)
+    {
+        return;
+    }
+    m_sources[meshIndex]->isQueued = true;
+    m_pending.push_back(meshIndex);
+}
+
+void MeshUploader::remove(std::uint32_t meshIndex)
+{
+    // The futures of the dropped loads are never waited for.
+    std::erase_if(
+        m_loading,
+        [meshIndex](const Load& load)
+        {
+            return load.meshIndex == meshIndex;
+        });
+    std::erase(m_pending, meshIndex);
+    for (auto& upload : m_uploading)
+    {
+        if (upload.meshIndex == meshIndex)
+        {
+            upload.isRemoved = true;
+        }
+    }
+    if (meshIndex < m_sources.size())
+    {
+        m_sources[meshIndex].reset();
+    }
+}
+
+bool MeshUploader::update(std::vector<std::optional<Mesh>>& residentMeshes, std::uint64_t& uploadQuota)
+{
+    // -- PICK UP LOADED MESHES
+
+    for (auto it{ m_loading.begin() }; it != m_loading.end();)
+    {
+        if (it->meshData.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        try
+        {
+            auto meshData{ it->meshData.get() };
+            if (!meshData.vertices.empty())
+            {
+                if (it->meshIndex >= m_sources.size())
+                {
+                    m_sources.resize(it->meshIndex + 1);
+                }
+                m_sources[it->meshIndex] = Source{ std::move(meshData), it->textureIndex, /* isQueued */ true };
+                m_pending.push_back(it->meshIndex);
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            // A broken asset must not take down the frame loop.
+            m_logger->error("Vulkan: Cannot load mesh: {}", ex.what());
+        }
+        it = m_loading.erase(it);
+    }
+
+    // -- START UPLOADS
+
+    m_isWaitingForMemory = false;
+    while (!m_pending.empty() && uploadQuota != 0)
+    {
+        const auto meshIndex{ m_pending.front() };
+        auto& source{ m_sources[meshIndex] };
+        try
+        {
+            uploadQuota -= std::min<std::uint64_t>(uploadQuota, submitUpload(*source, meshIndex));
+        }
+        catch (const Common::OutOfMemoryError&)
+        {
+            // Tried again once the renderer has evicted a mesh.
+            m_isWaitingForMemory = true;
+            break;
+        }
+        catch (const std::exception& ex)
+        {
+            m_logger->error("Vulkan: Cannot upload mesh {}: {}", meshIndex, ex.what());
+            source.reset();
+        }
+        m_pending.pop_front();
+    }
+
+    // -- FINISH UPLOADS
+
+    auto isChanged{ false };
+    std::erase_if(
+        m_uploading,
+        [&residentMeshes, &isChanged, this](Upload& upload)
+        {
+            if (upload.fence.getStatus() != vk::Result::eSuccess)
+            {
+                return false;
+            }
+            if (upload.isRemoved)
+            {
+                // Its ranges in the arena are freed with the mesh.
+                return true;
+            }
+            upload.mesh.releaseStagingBuffer();
+            m_sources[upload.meshIndex]->isQueued = false;
+            if (upload.meshIndex >= residentMeshes.size())
+            {
+                residentMeshes.resize(upload.meshIndex + 1);
+            }
+            residentMeshes[upload.meshIndex] = std::move(upload.mesh);
+            isChanged = true;
+            return true;
+        });
+
+    return isChanged;
+}
+
+const Geometry::Bounds* MeshUploader::findBounds(std::uint32_t meshIndex) const
+{
+    if (meshIndex >= m_sources.size() || !m_sources[meshIndex].has_value())
+    {
+        return nullptr;
+    }
+    return &m_sources[meshIndex]->meshData.bounds;
+}
+
+std::size_t MeshUploader::submitUpload(const Source& source, std::uint32_t meshIndex)
+{
+    const auto& meshData{ source.meshData };
+    Mesh mesh{ **m_physicalDevice, *m_device, *m_geometryArena, meshData, m_compactIndices, source.textureIndex };
+
+    auto commandBuffers{ m_device->allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        /* commandPool */ m_commandPool,
+        /* level */ vk::CommandBufferLevel::ePrimary,
+        /* commandBufferCount */ 1 }) };
+    auto& commandBuffer{ commandBuffers.front() };
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo{ /* flags */ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    mesh.recordUpload(commandBuffer, *m_geometryArena);
+    commandBuffer.end();
+
+    auto fence{ m_device->createFence(vk::FenceCreateInfo{}) };
+
+    const std::array<vk::CommandBuffer, 1> submitCommandBuffers{ commandBuffer };
+    m_queue->submit(
+        std::array<vk::SubmitInfo, 1>{ vk::SubmitInfo{ /* pWaitSemaphores */ {},
+                                                       /* pWaitDstStageMask */ {},
+                                                       /* pCommandBuffers */ submitCommandBuffers } },
+        fence);
+    const auto dataSize{ getStagingDataSize(
+        mesh.getVertexCount(), mesh.getIndexCount(), mesh.getIndexType(), meshData.meshlets.size()) };
+    m_uploadedBytes->add(dataSize);
+
+    m_uploading.push_back(
+        Upload{ std::move(mesh), meshIndex, std::move(commandBuffer), std::move(fence), /* isRemoved */ false });
+    return dataSize;
+}
+
+} // namespace VkTest1::Renderer::Detail
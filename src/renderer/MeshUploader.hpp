@@ -0,0 +1,116 @@
+#pragma once
+
+#include "common/Metrics.hpp"
+#include "common/Types.hpp"
+#include "geometry/MeshData.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/GeometryArena.hpp"
+#include "renderer/Mesh.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Moves meshes from the asset loader to the GPU without blocking the frame loop.
+//
+// A mesh goes through the following states:
+//
+// 1. Loading: The asset loader is still producing its data.
+// 2. Uploading: The copy from the staging buffer is submitted. Its fence is not yet signaled.
+// 3. Resident: The fence is signaled. The mesh can be drawn.
+//
+// The data of the meshes goes into the geometry arena. The uploader keeps the data of every loaded mesh, so the
+// renderer can evict a mesh and have it uploaded again later. An upload that doesn't fit into the arena waits until
+// the renderer has evicted other meshes. The uploads after it wait too, so the meshes arrive in order.
+//
+class MeshUploader
+{
+public:
+    explicit MeshUploader(
+        Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, Common::NotNull<const vk::raii::Queue*> queue,
+        Common::NotNull<Logging::ILogger*> logger, Common::NotNull<GeometryArena*> geometryArena,
+        Common::NotNull<Common::Counter*> uploadedBytes, std::uint32_t queueFamilyIndex, bool compactIndices);
+
+    // The mesh goes to residentMeshes[meshIndex]. It is drawn with the texture at textureIndex in the renderer.
+    void enqueue(std::future<Geometry::MeshData> meshData, std::uint32_t meshIndex, std::uint32_t textureIndex);
+
+    // Uploads an evicted mesh again. Does nothing if the mesh failed to load, or is loading or uploading.
+    void reload(std::uint32_t meshIndex);
+
+    // Forgets the mesh, wherever it is. The renderer destroys the resident mesh. The mesh index can be enqueued again
+    // right away.
+    void remove(std::uint32_t meshIndex);
+
+    // Never blocks. Submits uploads for the loaded meshes and moves the uploaded meshes to residentMeshes.
+    // The staging data of the submitted uploads is taken from uploadQuota. No upload starts once it is 0.
+    // Returns true if residentMeshes changed.
+    bool update(std::vector<std::optional<Mesh>>& residentMeshes, std::uint64_t& uploadQuota);
+
+    // Of a loaded mesh, resident or not. Null while the mesh is loading or if it failed to load.
+    const Geometry::Bounds* findBounds(std::uint32_t meshIndex) const;
+
+    // True if an upload waits for room in the geometry arena, as of the last update.
+    bool isWaitingForMemory() const
+    {
+        return m_isWaitingForMemory;
+    }
+
+private:
+    struct Load
+    {
+        std::future<Geometry::MeshData> meshData;
+        std::uint32_t meshIndex;
+        std::uint32_t textureIndex;
+    };
+
+    // A loaded mesh.
+    struct Source
+    {
+        Geometry::MeshData meshData;
+        std::uint32_t textureIndex;
+        // Waiting for its upload or uploading.
+        bool isQueued;
+    };
+
+    struct Upload
+    {
+        Mesh mesh;
+        std::uint32_t meshIndex;
+        vk::raii::CommandBuffer commandBuffer;
+        vk::raii::Fence fence;
+        // The mesh was removed while uploading. Dropped once the upload is done.
+        bool isRemoved;
+    };
+
+    // Returns the size of the staging data.
+    std::size_t submitUpload(const Source& source, std::uint32_t meshIndex);
+
+    Common::NotNull<const vk::raii::PhysicalDevice*> m_physicalDevice;
+    Common::NotNull<const vk::raii::Device*> m_device;
+    Common::NotNull<const vk::raii::Queue*> m_queue;
+    Common::NotNull<Logging::ILogger*> m_logger;
+    Common::NotNull<GeometryArena*> m_geometryArena;
+    // Counts the staging data of every submitted upload.
+    Common::NotNull<Common::Counter*> m_uploadedBytes;
+    bool m_compactIndices;
+    vk::raii::CommandPool m_commandPool;
+    std::vector<Load> m_loading{};
+    // Indexed by the mesh index. Empty while the mesh is loading or if it failed to load.
+    std::vector<std::optional<Source>> m_sources{};
+    // The mesh indices of the sources to upload, in order.
+    std::deque<std::uint32_t> m_pending{};
+    std::vector<Upload> m_uploading{};
+    bool m_isWaitingForMemory{ false };
+};
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,352 @@
+#include "renderer/ParticleSystem.hpp"
+
+#include "common/Cast.hpp"
+#include "renderer/DeviceMemory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace VkTest1;
+
+namespace
+{
+
+// Must match particles.glsl.
+constexpr std::uint32_t s_groupSize = 64;
+// Average life of an emitted particle in seconds (see particle_emit.comp.glsl). The emission rate keeps the
+// system about full.
+constexpr float s_averageParticleLife = 3.0f;
+// Longer frames (e.g. a window drag) are simulated as this long. Otherwise the particles would jump.
+constexpr float s_maxDeltaTime = 0.1f;
+
+// Byte offsets into the state buffer. See particles.glsl.
+constexpr vk::DeviceSize s_drawArgumentsOffset = 0;
+constexpr vk::DeviceSize s_dispatchArgumentsOffset = sizeof(vk::DrawIndirectCommand);
+constexpr vk::DeviceSize s_stateSize = s_dispatchArgumentsOffset + sizeof(vk::DispatchIndirectCommand) +
+    /* padding */ sizeof(std::uint32_t) + /* aliveCount */ 2 * sizeof(std::uint32_t);
+
+// Must match particles.glsl.
+struct PushConstants
+{
+    float deltaTime;
+    std::uint32_t emitCount;
+    std::uint32_t seed;
+    std::uint32_t inList;
+    std::uint32_t capacity;
+};
+
+Renderer::Detail::StorageBuffer createStorageBuffer(
+    const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::Device& device, vk::DeviceSize size,
+    vk::BufferUsageFlags usage, std::uint32_t computeQueueFamilyIndex, std::uint32_t graphicsQueueFamilyIndex)
+{
+    vk::BufferCreateInfo bufferCI{ /* flags */ {}, /* size */ size, /* usage */ usage };
+    // The compute queue writes and the graphics queue reads. With concurrent sharing we don't have to transfer
+    // the ownership between the queue families every frame.
+    const std::array<std::uint32_t, 2> queueFamilyIndices{ computeQueueFamilyIndex, graphicsQueueFamilyIndex };
+    if (computeQueueFamilyIndex != graphicsQueueFamilyIndex)
+    {
+        bufferCI.setSharingMode(vk::SharingMode::eConcurrent);
+        bufferCI.setQueueFamilyIndices(queueFamilyIndices);
+    }
+    else
+    {
+        bufferCI.setSharingMode(vk::SharingMode::eExclusive);
+    }
+
+    vk::raii::Buffer buffer{ device, bufferCI };
+    auto memory{ Renderer::Detail::allocateDeviceMemory(
+        physicalDevice, device, buffer.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal) };
+    buffer.bindMemory(memory, /* memoryOffset */ 0);
+
+    return Renderer::Detail::StorageBuffer{ std::move(buffer), std::move(memory) };
+}
+
+vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device)
+{
+    // The vertex shader reads the output list.
+    const vk::ShaderStageFlags stages{ vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eVertex };
+    const std::array<vk::DescriptorSetLayoutBinding, 3> bindings{
+        // Input particles.
+        vk::DescriptorSetLayoutBinding{ /* binding */ 0, vk::DescriptorType::eStorageBuffer, /* count */ 1, stages },
+        // Output particles.
+        vk::DescriptorSetLayoutBinding{ /* binding */ 1, vk::DescriptorType::eStorageBuffer, /* count */ 1, stages },
+        // State.
+        vk::DescriptorSetLayoutBinding{ /* binding */ 2, vk::DescriptorType::eStorageBuffer, /* count */ 1, stages }
+    };
+    return device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{ /* flags */ {}, bindings });
+}
+
+vk::raii::DescriptorPool createDescriptorPool(const vk::raii::Device& device)
+{
+    const std::array<vk::DescriptorPoolSize, 1> poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, /* descriptorCount */ 2 * 3 }
+    };
+    // eFreeDescriptorSet is required by the raii descriptor sets. They free themselves.
+    return device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+        /* flags */ vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, /* maxSets */ 2, poolSizes });
+}
+
+std::vector<vk::raii::DescriptorSet> createDescriptorSets(
+    const vk::raii::Device& device, const vk::raii::DescriptorPool& pool, const vk::raii::DescriptorSetLayout& layout)
+{
+    const std::array<vk::DescriptorSetLayout, 2> layouts{ layout, layout };
+    return device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{ pool, layouts });
+}
+
+vk::raii::PipelineLayout createComputePipelineLayout(
+    const vk::raii::Device& device, const vk::raii::DescriptorSetLayout& descriptorSetLayout)
+{
+    const std::array<vk::DescriptorSetLayout, 1> setLayouts{ descriptorSetLayout };
+    const std::array<vk::PushConstantRange, 1> pushConstantRanges{
+        vk::PushConstantRange{ vk::ShaderStageFlagBits::eCompute, /* offset */ 0, sizeof(PushConstants) }
+    };
+    return device.createPipelineLayout(vk::PipelineLayoutCreateInfo{ /* flags */ {}, setLayouts, pushConstantRanges });
+}
+
+vk::raii::Pipeline createComputePipeline(
+    const vk::raii::Device& device, const vk::raii::PipelineLayout& layout, std::span<const std::byte> shaderSpv)
+{
+    // The shader module doesn't need to be retained.
+    const vk::raii::ShaderModule shaderModule{
+        device,
+        vk::ShaderModuleCreateInfo{
+            /* flags */ {}, shaderSpv.size(), reinterpret_cast<const uint32_t*>(shaderSpv.data()) }
+    };
+
+    const vk::ComputePipelineCreateInfo computePipelineCI{
+        /* flags */ {},
+        /* stage */
+        vk::PipelineShaderStageCreateInfo{
+            /* flags */ {}, /* stage */ vk::ShaderStageFlagBits::eCompute, shaderModule, "main" },
+        /* layout */ layout
+    };
+    return device.createComputePipeline(nullptr, computePipelineCI);
+}
+
+vk::raii::CommandPool createCommandPool(const vk::raii::Device& device, std::uint32_t queueFamilyIndex)
+{
+    // The command buffers are re-recorded every frame.
+    return device.createCommandPool(vk::CommandPoolCreateInfo{
+        /* flags */ vk::CommandPoolCreateFlagBits::eResetCommandBuffer, /* queueFamilyIndex */ queueFamilyIndex });
+}
+
+std::vector<vk::raii::Semaphore> createSemaphores(const vk::raii::Device& device, std::uint32_t count)
+{
+    std::vector<vk::raii::Semaphore> semaphores{};
+    semaphores.reserve(count);
+    for (auto i{ 0u }; i != count; ++i)
+    {
+        semaphores.emplace_back(device.createSemaphore(vk::SemaphoreCreateInfo{}));
+    }
+    return semaphores;
+}
+
+// Makes the compute writes before visible to the accesses after.
+void recordComputeBarrier(
+    const vk::raii::CommandBuffer& commandBuffer, vk::PipelineStageFlags dstStages, vk::AccessFlags dstAccess)
+{
+    commandBuffer.pipelineBarrier(
+        /* srcStageMask */ vk::PipelineStageFlagBits::eComputeShader,
+        /* dstStageMask */ dstStages,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */ vk::MemoryBarrier{ vk::AccessFlagBits::eShaderWrite, dstAccess },
+        /* bufferMemoryBarriers */ {},
+        /* imageMemoryBarriers */ {});
+}
+
+} // namespace
+
+namespace VkTest1::Renderer::Detail
+{
+
+ParticleSystem::ParticleSystem(
+    const ParticleShaderBinaries& shaders, Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+    Common::NotNull<const vk::raii::Device*> device, Common::NotNull<const vk::raii::Queue*> computeQueue,
+    std::uint32_t computeQueueFamilyIndex, std::uint32_t graphicsQueueFamilyIndex, std::uint32_t capacity,
+    std::uint32_t frameCount) :
+    m_device{ device },
+    m_computeQueue{ computeQueue },
+    m_capacity{ capacity },
+    m_stateBuffer{ createStorageBuffer(
+        *physicalDevice,
+        *m_device,
+        s_stateSize,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+            vk::BufferUsageFlagBits::eTransferDst,
+        computeQueueFamilyIndex,
+        graphicsQueueFamilyIndex) },
+    m_descriptorSetLayout{ createDescriptorSetLayout(*m_device) },
+    m_descriptorPool{ createDescriptorPool(*m_device) },
+    m_descriptorSets{ createDescriptorSets(*m_device, m_descriptorPool, m_descriptorSetLayout) },
+    m_pipelineLayout{ createComputePipelineLayout(*m_device, m_descriptorSetLayout) },
+    m_emitPipeline{ createComputePipeline(*m_device, m_pipelineLayout, shaders.emit) },
+    m_preparePipeline{ createComputePipeline(*m_device, m_pipelineLayout, shaders.prepare) },
+    m_simulatePipeline{ createComputePipeline(*m_device, m_pipelineLayout, shaders.simulate) },
+    m_compactPipeline{ createComputePipeline(*m_device, m_pipelineLayout, shaders.compact) },
+    m_commandPool{ createCommandPool(*m_device, computeQueueFamilyIndex) },
+    m_commandBuffers{ m_device->allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        /* commandPool */ m_commandPool,
+        /* level */ vk::CommandBufferLevel::ePrimary,
+        /* commandBufferCount */ frameCount }) },
+    m_simulationFinished{ createSemaphores(*m_device, frameCount) },
+    m_drawFinished{ createSemaphores(*m_device, frameCount) }
+{
+    for (auto i{ 0u }; i != 2; ++i)
+    {
+        m_particleBuffers.push_back(createStorageBuffer(
+            *physicalDevice,
+            *m_device,
+            sizeof(Particle) * vk::DeviceSize{ m_capacity },
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            computeQueueFamilyIndex,
+            graphicsQueueFamilyIndex));
+    }
+
+    // Set i reads list i and writes the other one.
+    for (auto i{ 0u }; i != 2; ++i)
+    {
+        const std::array<vk::DescriptorBufferInfo, 3> bufferInfos{
+            vk::DescriptorBufferInfo{ m_particleBuffers[i].buffer, /* offset */ 0, vk::WholeSize },
+            vk::DescriptorBufferInfo{ m_particleBuffers[1 - i].buffer, /* offset */ 0, vk::WholeSize },
+            vk::DescriptorBufferInfo{ m_stateBuffer.buffer, /* offset */ 0, vk::WholeSize }
+        };
+        const vk::WriteDescriptorSet write{ /* dstSet */ m_descriptorSets[i],
+                                            /* dstBinding */ 0,
+                                            /* dstArrayElement */ 0,
+                                            vk::DescriptorType::eStorageBuffer,
+                                            /* pImageInfo */ {},
+                                            /* pBufferInfo */ bufferInfos };
+        m_device->updateDescriptorSets(write, /* descriptorCopies */ {});
+    }
+}
+
+const vk::raii::DescriptorSetLayout& ParticleSystem::getDescriptorSetLayout() const
+{
+    return m_descriptorSetLayout;
+}
+
+void ParticleSystem::simulate(unsigned int frame, std::chrono::steady_clock::time_point time)
+{
+    const auto deltaTime{ (m_frameNumber == 0)
+                              ? 0.0f
+                              : std::min(std::chrono::duration<float>{ time - m_lastSimulationTime }.count(),
+                                         s_maxDeltaTime) };
+    m_lastSimulationTime = time;
+
+    m_emitRemainder += Common::NarrowCast<float>(m_capacity) / s_averageParticleLife * deltaTime;
+    const auto emitCount{ std::min(Common::NarrowCast<std::uint32_t>(std::floor(m_emitRemainder)), m_capacity) };
+    m_emitRemainder -= Common::NarrowCast<float>(emitCount);
+
+    const auto& commandBuffer{ m_commandBuffers[frame] };
+    commandBuffer.reset();
+    commandBuffer.begin(vk::CommandBufferBeginInfo{ /* flags */ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    recordSimulation(commandBuffer, emitCount, deltaTime);
+    commandBuffer.end();
+
+    // Wait for the previous draw before overwriting the list it reads.
+    std::vector<vk::Semaphore> waitSemaphores{};
+    std::vector<vk::PipelineStageFlags> waitStageFlags{};
+    if (m_lastDrawnFrame.has_value())
+    {
+        waitSemaphores.push_back(m_drawFinished[*m_lastDrawnFrame]);
+        waitStageFlags.push_back(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect);
+    }
+    const std::array<vk::CommandBuffer, 1> commandBuffers{ commandBuffer };
+    const std::array<vk::Semaphore, 1> signalSemaphores{ m_simulationFinished[frame] };
+
+    // No fence. The graphics submission waits for the semaphore and the frame fence covers both.
+    m_computeQueue->submit(std::array<vk::SubmitInfo, 1>{ vk::SubmitInfo{ /* pWaitSemaphores */ waitSemaphores,
+                                                                          /* pWaitDstStageMask */ waitStageFlags,
+                                                                          /* pCommandBuffers */ commandBuffers,
+                                                                          /* pSignalSemaphores */ signalSemaphores } });
+
+    m_lastDrawnFrame = frame;
+    m_inList = 1 - m_inList;
+    ++m_frameNumber;
+}
+
+vk::Semaphore ParticleSystem::getSimulationFinishedSemaphore(unsigned int frame) const
+{
+    return m_simulationFinished[frame];
+}
+
+vk::Semaphore ParticleSystem::getDrawFinishedSemaphore(unsigned int frame) const
+{
+    return m_drawFinished[frame];
+}
+
+void ParticleSystem::recordDraw(
+    const vk::raii::CommandBuffer& commandBuffer, const vk::raii::PipelineLayout& pipelineLayout) const
+{
+    // The last simulation read m_inList before the swap. Its set has the output list at binding 1.
+    const std::array<vk::DescriptorSet, 1> descriptorSets{ m_descriptorSets[1 - m_inList] };
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics, pipelineLayout, /* firstSet */ 0, descriptorSets, /* dynamicOffsets */ {});
+    commandBuffer.drawIndirect(
+        m_stateBuffer.buffer, s_drawArgumentsOffset, /* drawCount */ 1, sizeof(vk::DrawIndirectCommand));
+}
+
+void ParticleSystem::recordSimulation(
+    const vk::raii::CommandBuffer& commandBuffer, std::uint32_t emitCount, float deltaTime)
+{
+    if (!m_isStateInitialized)
+    {
+        // No particles, no indirect arguments.
+        commandBuffer.fillBuffer(m_stateBuffer.buffer, /* offset */ 0, vk::WholeSize, /* data */ 0);
+        commandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eComputeShader,
+            /* dependencyFlags */ {},
+            vk::MemoryBarrier{ vk::AccessFlagBits::eTransferWrite,
+                               vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite },
+            /* bufferMemoryBarriers */ {},
+            /* imageMemoryBarriers */ {});
+        m_isStateInitialized = true;
+    }
+
+    const std::array<vk::DescriptorSet, 1> descriptorSets{ m_descriptorSets[m_inList] };
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute, m_pipelineLayout, /* firstSet */ 0, descriptorSets, /* dynamicOffsets */ {});
+
+    const PushConstants pushConstants{ deltaTime, emitCount, /* seed */ m_frameNumber, m_inList, m_capacity };
+    commandBuffer.pushConstants<PushConstants>(
+        m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, /* offset */ 0, pushConstants);
+
+    const auto shaderReadWrite{ vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite };
+
+    // -- EMIT
+
+    if (emitCount != 0)
+    {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_emitPipeline);
+        commandBuffer.dispatch((emitCount + s_groupSize - 1) / s_groupSize, 1, 1);
+        recordComputeBarrier(commandBuffer, vk::PipelineStageFlagBits::eComputeShader, shaderReadWrite);
+    }
+
+    // -- PREPARE INDIRECT ARGUMENTS
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_preparePipeline);
+    commandBuffer.dispatch(1, 1, 1);
+    // The dispatch arguments are read in the DrawIndirect stage.
+    recordComputeBarrier(
+        commandBuffer,
+        vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect,
+        shaderReadWrite | vk::AccessFlagBits::eIndirectCommandRead);
+
+    // -- SIMULATE
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_simulatePipeline);
+    commandBuffer.dispatchIndirect(m_stateBuffer.buffer, s_dispatchArgumentsOffset);
+    recordComputeBarrier(commandBuffer, vk::PipelineStageFlagBits::eComputeShader, shaderReadWrite);
+
+    // -- COMPACT
+
+    // The living particles go to the output list. The draw arguments count them.
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_compactPipeline);
+    commandBuffer.dispatchIndirect(m_stateBuffer.buffer, s_dispatchArgumentsOffset);
+
+    // The semaphore signaled at the end of the submission makes the writes visible to the graphics queue.
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "common/Types.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+// Must match particles.glsl.
+struct Particle
+{
+    // xyz: Position in NDC. w: Remaining life in seconds.
+    float position[4];
+    // xyz: Velocity in NDC per second. w: Total life in seconds.
+    float velocity[4];
+    float color[4];
+};
+static_assert(sizeof(Particle) == 48);
+
+// SPIR-V binaries of the compute passes.
+struct ParticleShaderBinaries
+{
+    std::span<const std::byte> emit;
+    std::span<const std::byte> prepare;
+    std::span<const std::byte> simulate;
+    std::span<const std::byte> compact;
+};
+
+struct StorageBuffer
+{
+    vk::raii::Buffer buffer;
+    vk::raii::DeviceMemory memory;
+};
+
+//
+// Particles that live entirely on the GPU. Nothing is uploaded per frame.
+//
+// Every frame runs the following compute passes on the compute queue:
+//
+// 1. Emit: Appends the new particles to the input list.
+// 2. Prepare: Writes the dispatch arguments of the next passes and resets the draw arguments.
+// 3. Simulate: Moves the particles of the input list (indirect dispatch).
+// 4. Compact: Copies the living particles to the output list and counts them into the draw arguments
+//    (indirect dispatch).
+//
+// The draw reads the output list with an indirect draw. The next frame swaps the lists.
+//
+// Synchronization:
+//
+// - The graphics submission waits for getSimulationFinishedSemaphore() before the indirect draw.
+// - The graphics submission signals getDrawFinishedSemaphore(). The next simulation waits for it before touching
+//   the lists.
+//
+class ParticleSystem
+{
+public:
+    explicit ParticleSystem(
+        const ParticleShaderBinaries& shaders, Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, Common::NotNull<const vk::raii::Queue*> computeQueue,
+        std::uint32_t computeQueueFamilyIndex, std::uint32_t graphicsQueueFamilyIndex, std::uint32_t capacity,
+        std::uint32_t frameCount);
+
+    const vk::raii::DescriptorSetLayout& getDescriptorSetLayout() const;
+
+    // Records and submits the compute passes of the given frame in flight. The particles advance to time.
+    // The graphics submission of the same frame must follow.
+    void simulate(unsigned int frame, std::chrono::steady_clock::time_point time);
+
+    vk::Semaphore getSimulationFinishedSemaphore(unsigned int frame) const;
+    vk::Semaphore getDrawFinishedSemaphore(unsigned int frame) const;
+
+    // Records the indirect draw of the particles simulated last. The particle pipeline must be bound.
+    void recordDraw(const vk::raii::CommandBuffer& commandBuffer, const vk::raii::PipelineLayout& pipelineLayout) const;
+
+private:
+    void recordSimulation(const vk::raii::CommandBuffer& commandBuffer, std::uint32_t emitCount, float deltaTime);
+
+    Common::NotNull<const vk::raii::Device*> m_device;
+    Common::NotNull<const vk::raii::Queue*> m_computeQueue;
+    std::uint32_t m_capacity;
+    // Two lists of particles. Each frame reads one and writes the other.
+    std::vector<StorageBuffer> m_particleBuffers;
+    // Indirect arguments and particle counts. See particles.glsl.
+    StorageBuffer m_stateBuffer;
+    vk::raii::DescriptorSetLayout m_descriptorSetLayout;
+    vk::raii::DescriptorPool m_descriptorPool;
+    // Set 0 reads list 0 and writes list 1. Set 1 is the opposite.
+    std::vector<vk::raii::DescriptorSet> m_descriptorSets;
+    vk::raii::PipelineLayout m_pipelineLayout;
+    vk::raii::Pipeline m_emitPipeline;
+    vk::raii::Pipeline m_preparePipeline;
+    vk::raii::Pipeline m_simulatePipeline;
+    vk::raii::Pipeline m_compactPipeline;
+    vk::raii::CommandPool m_commandPool;
+    std::vector<vk::raii::CommandBuffer> m_commandBuffers;
+    std::vector<vk::raii::Semaphore> m_simulationFinished;
+    std::vector<vk::raii::Semaphore> m_drawFinished;
+    // The list that the next simulation reads.
+    std::uint32_t m_inList{ 0 };
+    bool m_isStateInitialized{ false };
+    // The frame whose draw the next simulation waits for. None before the first frame.
+    std::optional<unsigned int> m_lastDrawnFrame{};
+    std::uint32_t m_frameNumber{ 0 };
+    std::chrono::steady_clock::time_point m_lastSimulationTime{};
+    // Fraction of a particle left over from the previous emission.
+    float m_emitRemainder{ 0.0f };
+};
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,84 @@
+#include "renderer/RangeAllocator.hpp"
+
+#include <cassert>
+#include <iterator>
+
+namespace VkTest1::Renderer::Detail
+{
+
+RangeAllocator::RangeAllocator(std::uint32_t capacity, std::uint32_t frameCount) :
+    m_capacity{ capacity },
+    m_pendingRanges(frameCount)
+{
+    if (m_capacity != 0)
+    {
+        m_freeRanges.emplace(0, m_capacity);
+    }
+}
+
+std::optional<std::uint32_t> RangeAllocator::allocate(std::uint32_t count)
+{
+    return allocateBefore(count, m_capacity);
+}
+
+std::optional<std::uint32_t> RangeAllocator::allocateBefore(std::uint32_t count, std::uint32_t limit)
+{
+    assert(count != 0);
+    for (auto it{ m_freeRanges.begin() }; it != m_freeRanges.end() && it->first < limit; ++it)
+    {
+        const auto [offset, freeCount] = *it;
+        if (freeCount < count)
+        {
+            continue;
+        }
+        // The rest of the free range stays where it is.
+        m_freeRanges.erase(it);
+        if (freeCount != count)
+        {
+            m_freeRanges.emplace(offset + count, freeCount - count);
+        }
+        return offset;
+    }
+    return std::nullopt;
+}
+
+void RangeAllocator::free(std::uint32_t offset, std::uint32_t count)
+{
+    assert(count != 0 && offset <= m_capacity && count <= m_capacity - offset);
+    m_pendingRanges[m_currentFrame].push_back(Range{ offset, count });
+}
+
+void RangeAllocator::beginFrame(unsigned int frame)
+{
+    m_currentFrame = frame;
+    auto& pendingRanges{ m_pendingRanges[m_currentFrame] };
+    for (const auto& range : pendingRanges)
+    {
+        insertFreeRange(range);
+    }
+    pendingRanges.clear();
+}
+
+void RangeAllocator::insertFreeRange(Range range)
+{
+    auto next{ m_freeRanges.lower_bound(range.offset) };
+    assert(next == m_freeRanges.end() || next->first >= range.offset + range.count);
+    if (next != m_freeRanges.end() && next->first == range.offset + range.count)
+    {
+        range.count += next->second;
+        next = m_freeRanges.erase(next);
+    }
+    if (next != m_freeRanges.begin())
+    {
+        const auto previous{ std::prev(next) };
+        assert(previous->first + previous->second <= range.offset);
+        if (previous->first + previous->second == range.offset)
+        {
+            previous->second += range.count;
+            return;
+        }
+    }
+    m_freeRanges.emplace_hint(next, range.offset, range.count);
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Hands out ranges [offset, offset + count) of [0, capacity), e.g. of the elements of a buffer.
+//
+// First fit. A freed range merges with its free neighbours, so the holes stay as large as possible. Like with
+// SlotAllocator, the command buffers of the frames in flight may still use a freed range, so it is only reused once
+// the frame that freed it begins again.
+//
+class RangeAllocator
+{
+public:
+    explicit RangeAllocator(std::uint32_t capacity, std::uint32_t frameCount);
+
+    // The offset of the range. Empty if no free range is large enough. The count must not be zero.
+    std::optional<std::uint32_t> allocate(std::uint32_t count);
+
+    // Like allocate(), but only a range that starts before limit. For moving a range towards the start.
+    std::optional<std::uint32_t> allocateBefore(std::uint32_t count, std::uint32_t limit);
+
+    // The range becomes free when the current frame begins again.
+    void free(std::uint32_t offset, std::uint32_t count);
+
+    // Makes the frame the current one. Its fence must have signaled. The ranges it freed last time are free again.
+    void beginFrame(unsigned int frame);
+
+    std::uint32_t getCapacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    struct Range
+    {
+        std::uint32_t offset;
+        std::uint32_t count;
+    };
+
+    void insertFreeRange(Range range);
+
+    std::uint32_t m_capacity;
+    // Offset -> count. Sorted by offset, and never adjacent: neighbours are merged.
+    std::map<std::uint32_t, std::uint32_t> m_freeRanges{};
+    // Per frame in flight, the ranges freed while it was the current one.
+    std::vector<std::vector<Range>> m_pendingRanges;
+    unsigned int m_currentFrame{ 0 };
+};
+
+} // namespace VkTest1::Renderer::Detail
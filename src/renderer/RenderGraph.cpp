@@ -0,0 +1,625 @@
+#include "renderer/RenderGraph.hpp"
+
+#include "common/Cast.hpp"
+#include "common/Errors.hpp"
+#include "renderer/DeviceMemory.hpp"
+
+#include <algorithm>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+struct AccessInfo
+{
+    vk::ImageLayout layout;
+    vk::PipelineStageFlags stages;
+    vk::AccessFlags access;
+    // The subset of access that writes. Empty for read-only accesses.
+    vk::AccessFlags writeAccess;
+};
+
+AccessInfo getAccessInfo(AttachmentAccess access)
+{
+    const vk::PipelineStageFlags depthStages{ vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                                              vk::PipelineStageFlagBits::eLateFragmentTests };
+    switch (access)
+    {
+        case AttachmentAccess::ColorWrite:
+            // Blending reads the attachment too.
+            return { vk::ImageLayout::eColorAttachmentOptimal,
+                     vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                     vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite,
+                     vk::AccessFlagBits::eColorAttachmentWrite };
+        case AttachmentAccess::DepthWrite:
+            return { vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                     depthStages,
+                     vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                         vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+                     vk::AccessFlagBits::eDepthStencilAttachmentWrite };
+        case AttachmentAccess::DepthRead:
+            return { vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                     depthStages,
+                     vk::AccessFlagBits::eDepthStencilAttachmentRead,
+                     {} };
+    }
+    throw Common::RendererError{ "Render graph: Unknown attachment access." };
+}
+
+bool isWriteAccess(AttachmentAccess access)
+{
+    return access != AttachmentAccess::DepthRead;
+}
+
+// True if the access depends on the previous contents of the attachment.
+bool readsPreviousContents(const RenderGraphAttachment& attachment)
+{
+    return attachment.access == AttachmentAccess::DepthRead || !attachment.clearValue.has_value();
+}
+
+bool isDepthFormat(vk::Format format)
+{
+    return format == vk::Format::eD16Unorm || format == vk::Format::eX8D24UnormPack32 ||
+        format == vk::Format::eD32Sfloat || format == vk::Format::eD16UnormS8Uint ||
+        format == vk::Format::eD24UnormS8Uint || format == vk::Format::eD32SfloatS8Uint;
+}
+
+vk::ImageAspectFlags getAspectMask(vk::Format format)
+{
+    if (format == vk::Format::eD16UnormS8Uint || format == vk::Format::eD24UnormS8Uint ||
+        format == vk::Format::eD32SfloatS8Uint)
+    {
+        return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+    }
+    if (isDepthFormat(format))
+    {
+        return vk::ImageAspectFlagBits::eDepth;
+    }
+    return vk::ImageAspectFlagBits::eColor;
+}
+
+} // namespace
+
+RenderGraph::RenderGraph(
+    Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice, Common::NotNull<const vk::raii::Device*> device,
+    const vk::Extent2D& extent) :
+    m_physicalDevice{ physicalDevice },
+    m_device{ device },
+    m_extent{ extent }
+{
+}
+
+RenderGraphResource RenderGraph::createImage(std::string name, vk::Format format)
+{
+    m_resources.push_back(Resource{ std::move(name), format, /* isImported */ false });
+    return Common::NarrowCast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::importImage(
+    std::string name, vk::Format format, vk::ImageLayout finalLayout, vk::PipelineStageFlags availableStages,
+    vk::PipelineStageFlags finalStages, vk::AccessFlags finalAccess)
+{
+    m_resources.push_back(Resource{
+        std::move(name), format, /* isImported */ true, finalLayout, availableStages, finalStages, finalAccess });
+    return Common::NarrowCast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphPass RenderGraph::addPass(RenderGraphPassDesc pass)
+{
+    m_passes.push_back(std::move(pass));
+    return Common::NarrowCast<RenderGraphPass>(m_passes.size() - 1);
+}
+
+void RenderGraph::compile()
+{
+    cullPasses();
+    validateOrder();
+    computeLifetimes();
+    createRenderPasses();
+    allocateTransientImages();
+    computeBarriers();
+}
+
+bool RenderGraph::isPassCulled(RenderGraphPass pass) const
+{
+    return !m_compiledPassIndices.at(pass).has_value();
+}
+
+const vk::raii::RenderPass& RenderGraph::getRenderPass(RenderGraphPass pass) const
+{
+    if (isPassCulled(pass))
+    {
+        throw Common::RendererError{ "Render graph: Pass '" + m_passes[pass].name + "' is culled." };
+    }
+    return m_compiledPasses[*m_compiledPassIndices[pass]].renderPass;
+}
+
+void RenderGraph::setImportedImage(RenderGraphResource resource, vk::Image image, vk::ImageView imageView)
+{
+    auto& importedResource{ m_resources.at(resource) };
+    assert(importedResource.isImported);
+    importedResource.image = image;
+    importedResource.imageView = imageView;
+}
+
+void RenderGraph::execute(const vk::raii::CommandBuffer& commandBuffer)
+{
+    for (auto& compiledPass : m_compiledPasses)
+    {
+        recordBarriers(commandBuffer, compiledPass.barriers);
+
+        commandBuffer.beginRenderPass(
+            vk::RenderPassBeginInfo{ /* renderPass */ compiledPass.renderPass,
+                                     /* framebuffer */ getFramebuffer(compiledPass),
+                                     /* renderArea */ vk::Rect2D{ vk::Offset2D{ 0, 0 }, m_extent },
+                                     /* pClearValues */ compiledPass.clearValues },
+            vk::SubpassContents::eInline);
+
+        m_passes[compiledPass.pass].record(commandBuffer);
+
+        commandBuffer.endRenderPass();
+    }
+
+    recordBarriers(commandBuffer, m_finalBarriers);
+}
+
+void RenderGraph::cullPasses()
+{
+    // Walk backwards from the outputs. A pass is needed if it writes contents that a later needed pass
+    // (or the outside world) consumes.
+    std::vector<bool> isContentNeeded(m_resources.size(), false);
+    for (auto i{ 0u }; i != m_resources.size(); ++i)
+    {
+        isContentNeeded[i] = m_resources[i].isImported;
+    }
+
+    std::vector<bool> isPassNeeded(m_passes.size(), false);
+    for (auto i{ m_passes.size() }; i-- != 0;)
+    {
+        const auto& attachments{ m_passes[i].attachments };
+        isPassNeeded[i] = std::ranges::any_of(
+            attachments,
+            [&isContentNeeded](const RenderGraphAttachment& attachment)
+            {
+                return isWriteAccess(attachment.access) && isContentNeeded[attachment.resource];
+            });
+        if (!isPassNeeded[i])
+        {
+            continue;
+        }
+
+        // Clearing overwrites the previous contents. Reading needs them.
+        for (const auto& attachment : attachments)
+        {
+            isContentNeeded[attachment.resource] = readsPreviousContents(attachment);
+        }
+    }
+
+    m_compiledPasses.clear();
+    m_compiledPassIndices.assign(m_passes.size(), std::nullopt);
+    for (auto i{ 0u }; i != m_passes.size(); ++i)
+    {
+        if (isPassNeeded[i])
+        {
+            m_compiledPassIndices[i] = m_compiledPasses.size();
+            m_compiledPasses.push_back(CompiledPass{ i });
+        }
+    }
+}
+
+void RenderGraph::validateOrder() const
+{
+    // Imported images have contents before the graph runs. Transient ones only once a pass writes them, so a pass
+    // that reads them earlier was declared before its producer, and would get wrong barriers and garbage.
+    std::vector<bool> hasContents(m_resources.size(), false);
+    for (auto i{ 0u }; i != m_resources.size(); ++i)
+    {
+        hasContents[i] = m_resources[i].isImported;
+    }
+    for (const auto& compiledPass : m_compiledPasses)
+    {
+        const auto& pass{ m_passes[compiledPass.pass] };
+        for (const auto& attachment : pass.attachments)
+        {
+            if (readsPreviousContents(attachment) && !hasContents[attachment.resource])
+            {
+                throw Common::RendererError{ "Render graph: Pass '" + pass.name + "' reads '" +
+                                             m_resources[attachment.resource].name +
+                                             "' before a pass writes it. Declare the passes in dependency order." };
+            }
+        }
+        for (const auto& attachment : pass.attachments)
+        {
+            hasContents[attachment.resource] = hasContents[attachment.resource] || isWriteAccess(attachment.access);
+        }
+    }
+}
+
+void RenderGraph::computeLifetimes()
+{
+    for (auto i{ 0u }; i != m_compiledPasses.size(); ++i)
+    {
+        for (const auto& attachment : m_passes[m_compiledPasses[i].pass].attachments)
+        {
+            auto& resource{ m_resources[attachment.resource] };
+            if (!resource.firstPass.has_value())
+            {
+                resource.firstPass = i;
+            }
+            resource.lastPass = i;
+        }
+    }
+
+    for (auto& resource : m_resources)
+    {
+        // Used by a single pass: Loaded as "don't care" or cleared, stored as "don't care".
+        // It can live entirely in tile memory.
+        resource.isLazy = !resource.isImported && resource.firstPass.has_value() &&
+            *resource.firstPass == resource.lastPass;
+    }
+}
+
+void RenderGraph::createRenderPasses()
+{
+    for (auto i{ 0u }; i != m_compiledPasses.size(); ++i)
+    {
+        auto& compiledPass{ m_compiledPasses[i] };
+        const auto& attachments{ m_passes[compiledPass.pass].attachments };
+
+        std::vector<vk::AttachmentDescription> attachmentDescriptions{};
+        std::vector<vk::AttachmentReference> colorAttachmentRefs{};
+        std::optional<vk::AttachmentReference> depthAttachmentRef{};
+
+        for (const auto& attachment : attachments)
+        {
+            const auto& resource{ m_resources[attachment.resource] };
+            const auto accessInfo{ getAccessInfo(attachment.access) };
+
+            // Is the content needed by a later pass?
+            auto isStoreNeeded{ resource.isImported };
+            for (auto j{ i + 1 }; j < m_compiledPasses.size() && !isStoreNeeded; ++j)
+            {
+                const auto& laterAttachments{ m_passes[m_compiledPasses[j].pass].attachments };
+                const auto it{ std::ranges::find(laterAttachments, attachment.resource, &RenderGraphAttachment::resource) };
+                if (it != laterAttachments.end())
+                {
+                    isStoreNeeded = readsPreviousContents(*it);
+                    break;
+                }
+            }
+
+            const auto loadOp{ attachment.clearValue.has_value() ? vk::AttachmentLoadOp::eClear
+                                   : (*resource.firstPass == i)  ? vk::AttachmentLoadOp::eDontCare
+                                                                 : vk::AttachmentLoadOp::eLoad };
+            const auto storeOp{ isStoreNeeded ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare };
+
+            const auto attachmentIndex{ Common::NarrowCast<std::uint32_t>(attachmentDescriptions.size()) };
+            // The layout transitions happen in the barriers before the render pass, so the layout doesn't
+            // change inside the render pass.
+            attachmentDescriptions.push_back(vk::AttachmentDescription{ /* flags */ {},
+                                                                        /* format */ resource.format,
+                                                                        /* samples */ vk::SampleCountFlagBits::e1,
+                                                                        /* loadOp */ loadOp,
+                                                                        /* storeOp */ storeOp,
+                                                                        /* stencilLoadOp */ loadOp,
+                                                                        /* stencilStoreOp */ storeOp,
+                                                                        /* initialLayout_ */ accessInfo.layout,
+                                                                        /* finalLayout_ */ accessInfo.layout });
+            compiledPass.clearValues.push_back(attachment.clearValue.value_or(vk::ClearValue{}));
+
+            if (attachment.access == AttachmentAccess::ColorWrite)
+            {
+                colorAttachmentRefs.push_back(vk::AttachmentReference{ attachmentIndex, accessInfo.layout });
+            }
+            else
+            {
+                depthAttachmentRef = vk::AttachmentReference{ attachmentIndex, accessInfo.layout };
+            }
+        }
+
+        vk::SubpassDescription subpass{};
+        subpass.setPipelineBindPoint(vk::PipelineBindPoint::eGraphics);
+        subpass.setColorAttachments(colorAttachmentRefs);
+        if (depthAttachmentRef.has_value())
+        {
+            subpass.setPDepthStencilAttachment(&*depthAttachmentRef);
+        }
+
+        vk::RenderPassCreateInfo renderPassCI{};
+        renderPassCI.setAttachments(attachmentDescriptions);
+        renderPassCI.setSubpasses(subpass);
+
+        compiledPass.renderPass = m_device->createRenderPass(renderPassCI);
+    }
+}
+
+void RenderGraph::allocateTransientImages()
+{
+    std::vector<RenderGraphResource> transientResources{};
+    for (auto i{ 0u }; i != m_resources.size(); ++i)
+    {
+        if (!m_resources[i].isImported && m_resources[i].firstPass.has_value())
+        {
+            transientResources.push_back(i);
+        }
+    }
+    std::ranges::sort(
+        transientResources,
+        [this](RenderGraphResource lhs, RenderGraphResource rhs)
+        {
+            return *m_resources[lhs].firstPass < *m_resources[rhs].firstPass;
+        });
+
+    // -- CREATE IMAGES AND ASSIGN THEM TO MEMORY BLOCKS
+
+    for (const auto resourceIndex : transientResources)
+    {
+        auto& resource{ m_resources[resourceIndex] };
+
+        vk::ImageUsageFlags usage{ isDepthFormat(resource.format) ? vk::ImageUsageFlagBits::eDepthStencilAttachment
+                                                                  : vk::ImageUsageFlagBits::eColorAttachment };
+        if (resource.isLazy)
+        {
+            usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+        }
+
+        vk::ImageCreateInfo imageCI{};
+        imageCI.setImageType(vk::ImageType::e2D);
+        imageCI.setFormat(resource.format);
+        imageCI.setExtent(vk::Extent3D{ m_extent.width, m_extent.height, 1 });
+        imageCI.setMipLevels(1);
+        imageCI.setArrayLayers(1);
+        imageCI.setSamples(vk::SampleCountFlagBits::e1);
+        imageCI.setTiling(vk::ImageTiling::eOptimal);
+        imageCI.setUsage(usage);
+        imageCI.setSharingMode(vk::SharingMode::eExclusive);
+        imageCI.setInitialLayout(vk::ImageLayout::eUndefined);
+        resource.ownedImage = vk::raii::Image{ *m_device, imageCI };
+        resource.image = resource.ownedImage;
+
+        const auto memoryRequirements{ resource.ownedImage.getMemoryRequirements() };
+
+        // Reuse a block whose current occupant is dead by the time this image is first used.
+        // Lazily allocated blocks are never shared. They have no real backing memory to save.
+        const auto it{ std::ranges::find_if(
+            m_memoryBlocks,
+            [&resource, &memoryRequirements](const MemoryBlock& block)
+            {
+                return !block.isLazy && !resource.isLazy && block.lastPass < *resource.firstPass &&
+                    (block.memoryTypeBits & memoryRequirements.memoryTypeBits) != 0;
+            }) };
+        if (it != m_memoryBlocks.end())
+        {
+            it->size = std::max(it->size, memoryRequirements.size);
+            it->memoryTypeBits &= memoryRequirements.memoryTypeBits;
+            it->lastPass = resource.lastPass;
+            resource.memoryBlock = std::distance(m_memoryBlocks.begin(), it);
+        }
+        else
+        {
+            m_memoryBlocks.push_back(MemoryBlock{ memoryRequirements.size,
+                                                  memoryRequirements.memoryTypeBits,
+                                                  resource.isLazy,
+                                                  resource.lastPass });
+            resource.memoryBlock = m_memoryBlocks.size() - 1;
+        }
+    }
+
+    // -- ALLOCATE MEMORY
+
+    for (auto& block : m_memoryBlocks)
+    {
+        const vk::MemoryRequirements memoryRequirements{ block.size, /* alignment */ 1, block.memoryTypeBits };
+        if (block.isLazy)
+        {
+            try
+            {
+                block.memory = allocateDeviceMemory(
+                    **m_physicalDevice,
+                    *m_device,
+                    memoryRequirements,
+                    vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated);
+                continue;
+            }
+            catch (const Common::RendererError&)
+            {
+                // No lazily allocated memory on this device (e.g. desktop GPUs). Fallback to device local.
+            }
+        }
+        block.memory = allocateDeviceMemory(
+            **m_physicalDevice, *m_device, memoryRequirements, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    }
+
+    // -- BIND MEMORY AND CREATE VIEWS
+
+    for (const auto resourceIndex : transientResources)
+    {
+        auto& resource{ m_resources[resourceIndex] };
+        // Aliased images all start at offset 0. They are never alive at the same time.
+        resource.ownedImage.bindMemory(m_memoryBlocks[*resource.memoryBlock].memory, /* memoryOffset */ 0);
+
+        const vk::ImageViewCreateInfo imageViewCI{ /* flags */ {},
+                                                   resource.image,
+                                                   vk::ImageViewType::e2D,
+                                                   resource.format,
+                                                   /* component mapping */ {},
+                                                   { getAspectMask(resource.format),
+                                                     /* base mipmap level */ 0,
+                                                     /* mipmap level count */ 1,
+                                                     /* base array layer */ 0,
+                                                     /* array layer count */ 1 } };
+        resource.ownedImageView = vk::raii::ImageView{ *m_device, imageViewCI };
+        resource.imageView = resource.ownedImageView;
+    }
+}
+
+void RenderGraph::computeBarriers()
+{
+    const auto addAccess =
+        [](ResourceState& state,
+           const AccessInfo& info,
+           bool isDiscarding,
+           RenderGraphResource resource,
+           BarrierBatch& batch)
+    {
+        const auto oldLayout{ isDiscarding ? vk::ImageLayout::eUndefined : state.layout };
+        const auto isLayoutChange{ oldLayout != info.layout };
+        const auto isWrite{ static_cast<bool>(info.writeAccess) };
+        const auto pendingStages{ state.writeStages | state.readStages };
+
+        // Write after write/read: Wait for everything before.
+        // Read after write: Wait for the write unless this stage already sees it.
+        // Read after read: Nothing to do.
+        const auto isBarrierNeeded{ isLayoutChange ||
+                                    (isWrite ? static_cast<bool>(pendingStages)
+                                             : static_cast<bool>(state.writeStages) &&
+                                                 static_cast<bool>(info.stages & ~state.visibleStages)) };
+        if (isBarrierNeeded)
+        {
+            batch.srcStages |= pendingStages ? pendingStages : vk::PipelineStageFlags{ vk::PipelineStageFlagBits::eTopOfPipe };
+            batch.dstStages |= info.stages;
+            batch.barriers.push_back(Barrier{ resource, oldLayout, info.layout, state.writeAccess, info.access });
+        }
+
+        if (isWrite || isLayoutChange)
+        {
+            // A layout transition is a write too.
+            state.writeStages = info.stages;
+            state.writeAccess = info.writeAccess;
+            state.readStages = isWrite ? vk::PipelineStageFlags{} : info.stages;
+            state.visibleStages = info.stages;
+        }
+        else
+        {
+            state.readStages |= info.stages;
+            state.visibleStages |= info.stages;
+        }
+        state.layout = info.layout;
+    };
+
+    // The graph runs every frame. Images that share memory must wait for the previous user of that memory,
+    // which is the last occupant of the previous frame at the beginning of the frame.
+    // So we simulate the frame twice: the first run finds the state of each memory block at the end of a
+    // frame, the second run produces the barriers.
+    for (auto run{ 0 }; run != 2; ++run)
+    {
+        std::vector<ResourceState> states(m_resources.size());
+        for (auto i{ 0u }; i != m_resources.size(); ++i)
+        {
+            // The first access of an imported image waits for the stages that make it available.
+            states[i].writeStages = m_resources[i].availableStages;
+        }
+
+        for (auto i{ 0u }; i != m_compiledPasses.size(); ++i)
+        {
+            auto& compiledPass{ m_compiledPasses[i] };
+            BarrierBatch batch{};
+            for (const auto& attachment : m_passes[compiledPass.pass].attachments)
+            {
+                const auto& resource{ m_resources[attachment.resource] };
+                auto& state{ states[attachment.resource] };
+
+                const auto isFirstAccess{ *resource.firstPass == i };
+                if (isFirstAccess && resource.memoryBlock.has_value())
+                {
+                    // Take over the memory from its previous occupant.
+                    state = m_memoryBlocks[*resource.memoryBlock].lastState;
+                }
+
+                addAccess(
+                    state,
+                    getAccessInfo(attachment.access),
+                    /* isDiscarding */ isFirstAccess || attachment.clearValue.has_value(),
+                    attachment.resource,
+                    batch);
+
+                if (resource.memoryBlock.has_value())
+                {
+                    m_memoryBlocks[*resource.memoryBlock].lastState = state;
+                }
+            }
+            compiledPass.barriers = std::move(batch);
+        }
+
+        m_finalBarriers = {};
+        for (auto i{ 0u }; i != m_resources.size(); ++i)
+        {
+            const auto& resource{ m_resources[i] };
+            const auto& state{ states[i] };
+            if (!resource.isImported || !resource.firstPass.has_value() || state.layout == resource.finalLayout)
+            {
+                continue;
+            }
+            // E.g. the transition to PresentSrcKHR. The semaphore signaled after the command buffer makes it
+            // visible to the presentation engine, so there is no destination access by default.
+            m_finalBarriers.srcStages |= state.writeStages | state.readStages;
+            m_finalBarriers.dstStages |= resource.finalStages;
+            m_finalBarriers.barriers.push_back(
+                Barrier{ i, state.layout, resource.finalLayout, state.writeAccess, resource.finalAccess });
+        }
+    }
+}
+
+void RenderGraph::recordBarriers(const vk::raii::CommandBuffer& commandBuffer, const BarrierBatch& batch) const
+{
+    if (batch.barriers.empty())
+    {
+        return;
+    }
+
+    std::vector<vk::ImageMemoryBarrier> imageBarriers{};
+    imageBarriers.reserve(batch.barriers.size());
+    for (const auto& barrier : batch.barriers)
+    {
+        const auto& resource{ m_resources[barrier.resource] };
+        imageBarriers.push_back(vk::ImageMemoryBarrier{ /* srcAccessMask */ barrier.srcAccess,
+                                                        /* dstAccessMask */ barrier.dstAccess,
+                                                        /* oldLayout */ barrier.oldLayout,
+                                                        /* newLayout */ barrier.newLayout,
+                                                        /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                        /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                                        /* image */ resource.image,
+                                                        /* subresourceRange */
+                                                        { getAspectMask(resource.format),
+                                                          /* base mipmap level */ 0,
+                                                          /* mipmap level count */ 1,
+                                                          /* base array layer */ 0,
+                                                          /* array layer count */ 1 } });
+    }
+
+    commandBuffer.pipelineBarrier(
+        batch.srcStages,
+        batch.dstStages,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */ {},
+        /* bufferMemoryBarriers */ {},
+        imageBarriers);
+}
+
+const vk::raii::Framebuffer& RenderGraph::getFramebuffer(CompiledPass& compiledPass)
+{
+    // Imported images change between executions (e.g. swapchain images), so the framebuffers are cached
+    // by their attachments.
+    std::vector<vk::ImageView> attachmentViews{};
+    for (const auto& attachment : m_passes[compiledPass.pass].attachments)
+    {
+        attachmentViews.push_back(m_resources[attachment.resource].imageView);
+    }
+
+    auto it{ compiledPass.framebuffers.find(attachmentViews) };
+    if (it == compiledPass.framebuffers.end())
+    {
+        const vk::FramebufferCreateInfo framebufferCI{ /* flags */ {},
+                                                       /* renderPass */ compiledPass.renderPass,
+                                                       /* pAttachments */ attachmentViews,
+                                                       /* width */ m_extent.width,
+                                                       /* height */ m_extent.height,
+                                                       /* layers */ 1 };
+        it = compiledPass.framebuffers.emplace(attachmentViews, m_device->createFramebuffer(framebufferCI)).first;
+    }
+    return it->second;
+}
+
+} // namespace VkTest1::Renderer::Detail
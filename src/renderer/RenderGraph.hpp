@@ -0,0 +1,193 @@
+#pragma once
+
+#include "common/Types.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+using RenderGraphResource = std::uint32_t;
+using RenderGraphPass = std::uint32_t;
+
+enum class AttachmentAccess
+{
+    ColorWrite,
+    DepthWrite,
+    // Depth test without depth write.
+    DepthRead
+};
+
+struct RenderGraphAttachment
+{
+    RenderGraphResource resource;
+    AttachmentAccess access;
+    // If set, the attachment is cleared when the pass begins. Otherwise the previous contents are kept.
+    std::optional<vk::ClearValue> clearValue{};
+};
+
+struct RenderGraphPassDesc
+{
+    std::string name;
+    std::vector<RenderGraphAttachment> attachments;
+    // Records the draw commands. Called inside the render pass of this pass.
+    std::function<void(const vk::raii::CommandBuffer& commandBuffer)> record;
+};
+
+//
+// A frame described as passes that declare which attachments they read and write.
+//
+// compile() derives everything that used to be hand written:
+//
+// - Culling: Passes that don't contribute to an imported image (e.g. the swapchain image) are dropped.
+// - Ordering: A pass can only consume what earlier passes produced, so the declaration order of the
+//   remaining passes is the execution order. The passes declare attachments, not which write a read
+//   consumes, so the order of two writers of an image can't be derived; it is checked instead.
+// - Synchronization: Each pass gets one pipeline barrier with the layout transitions and the memory
+//   dependencies it needs. Read after read in the same layout needs none.
+// - Load/store ops: Contents are loaded and stored only if somebody needs them.
+// - Memory: Transient images whose lifetimes don't overlap share memory. Images that live inside a
+//   single pass use lazily allocated memory where available (i.e. on tile based GPUs they never leave
+//   the tile memory).
+//
+// Every pass becomes a render pass with a single subpass.
+//
+class RenderGraph
+{
+public:
+    explicit RenderGraph(
+        Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, const vk::Extent2D& extent);
+
+    RenderGraph(const RenderGraph& other) = delete;
+    RenderGraph& operator=(const RenderGraph& other) = delete;
+
+    RenderGraph(RenderGraph&& other) = default;
+    RenderGraph& operator=(RenderGraph&& other) = default;
+
+    // An image created and owned by the graph. Its contents don't survive between executions.
+    RenderGraphResource createImage(std::string name, vk::Format format);
+
+    // An image owned by somebody else (e.g. the swapchain). Set it with setImportedImage() before execute().
+    // It is an output of the graph. It's left in finalLayout, visible to finalAccess in finalStages (e.g. a copy
+    // recorded after the graph).
+    // The first access waits for availableStages (e.g. the stage that waits for the image-available semaphore).
+    RenderGraphResource importImage(
+        std::string name, vk::Format format, vk::ImageLayout finalLayout, vk::PipelineStageFlags availableStages,
+        vk::PipelineStageFlags finalStages = vk::PipelineStageFlagBits::eBottomOfPipe,
+        vk::AccessFlags finalAccess = {});
+
+    RenderGraphPass addPass(RenderGraphPassDesc pass);
+
+    // Throws Common::RendererError if a pass reads the contents of a transient image before a pass writes them.
+    void compile();
+
+    // Valid after compile().
+    bool isPassCulled(RenderGraphPass pass) const;
+
+    // Valid after compile(). Pipelines used in the pass must be compatible with this render pass.
+    const vk::raii::RenderPass& getRenderPass(RenderGraphPass pass) const;
+
+    void setImportedImage(RenderGraphResource resource, vk::Image image, vk::ImageView imageView);
+
+    void execute(const vk::raii::CommandBuffer& commandBuffer);
+
+private:
+    struct ResourceState
+    {
+        vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+        // Stages and accesses of the last write (or layout transition).
+        vk::PipelineStageFlags writeStages{};
+        vk::AccessFlags writeAccess{};
+        // Stages that read since the last write.
+        vk::PipelineStageFlags readStages{};
+        // Stages that already see the last write.
+        vk::PipelineStageFlags visibleStages{};
+    };
+
+    struct Resource
+    {
+        std::string name;
+        vk::Format format;
+        bool isImported;
+        vk::ImageLayout finalLayout{ vk::ImageLayout::eUndefined };
+        vk::PipelineStageFlags availableStages{};
+        vk::PipelineStageFlags finalStages{};
+        vk::AccessFlags finalAccess{};
+        vk::Image image{};
+        vk::ImageView imageView{};
+        // Transient images only.
+        vk::raii::Image ownedImage{ nullptr };
+        vk::raii::ImageView ownedImageView{ nullptr };
+        std::optional<std::size_t> memoryBlock{};
+        // Compiled pass indices of the first and last access.
+        std::optional<std::size_t> firstPass{};
+        std::size_t lastPass{ 0 };
+        bool isLazy{ false };
+    };
+
+    struct MemoryBlock
+    {
+        vk::DeviceSize size;
+        std::uint32_t memoryTypeBits;
+        bool isLazy;
+        std::size_t lastPass;
+        vk::raii::DeviceMemory memory{ nullptr };
+        ResourceState lastState{};
+    };
+
+    struct Barrier
+    {
+        RenderGraphResource resource;
+        vk::ImageLayout oldLayout;
+        vk::ImageLayout newLayout;
+        vk::AccessFlags srcAccess;
+        vk::AccessFlags dstAccess;
+    };
+
+    struct BarrierBatch
+    {
+        vk::PipelineStageFlags srcStages{};
+        vk::PipelineStageFlags dstStages{};
+        std::vector<Barrier> barriers{};
+    };
+
+    struct CompiledPass
+    {
+        RenderGraphPass pass;
+        BarrierBatch barriers{};
+        std::vector<vk::ClearValue> clearValues{};
+        vk::raii::RenderPass renderPass{ nullptr };
+        std::map<std::vector<vk::ImageView>, vk::raii::Framebuffer> framebuffers{};
+    };
+
+    void cullPasses();
+    void validateOrder() const;
+    void computeLifetimes();
+    void createRenderPasses();
+    void allocateTransientImages();
+    void computeBarriers();
+    void recordBarriers(const vk::raii::CommandBuffer& commandBuffer, const BarrierBatch& batch) const;
+    const vk::raii::Framebuffer& getFramebuffer(CompiledPass& compiledPass);
+
+    Common::NotNull<const vk::raii::PhysicalDevice*> m_physicalDevice;
+    Common::NotNull<const vk::raii::Device*> m_device;
+    vk::Extent2D m_extent;
+    std::vector<RenderGraphPassDesc> m_passes{};
+    std::vector<CompiledPass> m_compiledPasses{};
+    // Compiled pass index per pass. Empty for culled passes.
+    std::vector<std::optional<std::size_t>> m_compiledPassIndices{};
+    // Declared before the resources, so the images are destroyed before their memory.
+    std::vector<MemoryBlock> m_memoryBlocks{};
+    std::vector<Resource> m_resources{};
+    BarrierBatch m_finalBarriers{};
+};
+
+} // namespace VkTest1::Renderer::Detail
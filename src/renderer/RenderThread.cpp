@@ -0,0 +1,177 @@
+#include "renderer/RenderThread.hpp"
+
+#include "common/Errors.hpp"
+
+#include <format>
+#include <utility>
+
+namespace VkTest1::Renderer::Detail
+{
+
+RenderThread::RenderThread(std::unique_ptr<IRenderer> renderer, std::chrono::milliseconds maxWait) :
+    m_renderer{ std::move(renderer) },
+    m_maxWait{ maxWait }
+{
+    m_renderThread = std::jthread{ [this](std::stop_token stopToken)
+                                   {
+                                       runRenderer(stopToken);
+                                   } };
+}
+
+RenderThread::~RenderThread()
+{
+    m_renderThread.request_stop();
+    m_renderThread.join();
+}
+
+void RenderThread::addTexture(std::future<Texture::TextureData> textureData)
+{
+    // The commands run in order, so the textures keep their numbers.
+    enqueue(
+        [textureData = std::move(textureData)](IRenderer& renderer) mutable
+        {
+            renderer.addTexture(std::move(textureData));
+        });
+}
+
+std::uint32_t RenderThread::addMesh(std::future<Geometry::MeshData> meshData, std::optional<std::uint32_t> texture)
+{
+    enqueue(
+        [meshData = std::move(meshData), texture](IRenderer& renderer) mutable
+        {
+            renderer.addMesh(std::move(meshData), texture);
+        });
+    m_liveMeshes.push_back(true);
+    return static_cast<std::uint32_t>(m_liveMeshes.size() - 1);
+}
+
+void RenderThread::removeMesh(std::uint32_t mesh)
+{
+    if (mesh >= m_liveMeshes.size() || !m_liveMeshes[mesh])
+    {
+        throw Common::RendererError{ std::format("Mesh {} does not exist.", mesh) };
+    }
+    m_liveMeshes[mesh] = false;
+    // Runs after the addMesh() of the mesh.
+    enqueue(
+        [mesh](IRenderer& renderer)
+        {
+            renderer.removeMesh(mesh);
+        });
+}
+
+void RenderThread::draw(const FrameState& frameState)
+{
+    {
+        std::unique_lock lock{ m_mutex };
+        rethrowRendererError();
+        m_frameStateTaken.wait_for(
+            lock,
+            m_maxWait,
+            [this]
+            {
+                return m_takenFrameCount == m_publishedFrameCount || m_rendererError;
+            });
+        rethrowRendererError();
+        m_statistics = m_latestStatistics;
+    }
+
+    // Assigning reuses the memory of the older state in the slot.
+    m_frameStates.getWriteBuffer() = frameState;
+    m_frameStates.publish();
+
+    std::unique_lock lock{ m_mutex };
+    ++m_publishedFrameCount;
+    m_frameStatePublished.notify_one();
+
+    if (m_publishedFrameCount == 1)
+    {
+        m_frameStateTaken.wait(
+            lock,
+            [this]
+            {
+                return m_drawnFrameCount != 0 || m_rendererError;
+            });
+        rethrowRendererError();
+    }
+}
+
+const FrameStatistics& RenderThread::getFrameStatistics() const
+{
+    return m_statistics;
+}
+
+void RenderThread::setCaptureSink(CaptureSink sink)
+{
+    enqueue(
+        [sink = std::move(sink)](IRenderer& renderer) mutable
+        {
+            renderer.setCaptureSink(std::move(sink));
+        });
+}
+
+void RenderThread::runRenderer(std::stop_token stopToken)
+{
+    // Swapped with the queue, so both keep their memory.
+    std::vector<Command> commands{};
+
+    while (true)
+    {
+        {
+            std::unique_lock lock{ m_mutex };
+            if (!m_frameStatePublished.wait(
+                    lock,
+                    stopToken,
+                    [this]
+                    {
+                        return m_takenFrameCount != m_publishedFrameCount;
+                    }))
+            {
+                return;
+            }
+            m_takenFrameCount = m_publishedFrameCount;
+            std::swap(commands, m_commands);
+        }
+        m_frameStateTaken.notify_one();
+
+        try
+        {
+            for (auto& command : commands)
+            {
+                command(*m_renderer);
+            }
+            commands.clear();
+
+            m_frameStates.update();
+            m_renderer->draw(m_frameStates.getReadBuffer());
+
+            const std::scoped_lock lock{ m_mutex };
+            m_latestStatistics = m_renderer->getFrameStatistics();
+            ++m_drawnFrameCount;
+        }
+        catch (...)
+        {
+            const std::scoped_lock lock{ m_mutex };
+            m_rendererError = std::current_exception();
+            m_frameStateTaken.notify_one();
+            return;
+        }
+        m_frameStateTaken.notify_one();
+    }
+}
+
+void RenderThread::enqueue(Command command)
+{
+    const std::scoped_lock lock{ m_mutex };
+    m_commands.push_back(std::move(command));
+}
+
+void RenderThread::rethrowRendererError() const
+{
+    if (m_rendererError)
+    {
+        std::rethrow_exception(m_rendererError);
+    }
+}
+
+} // namespace VkTest1::Renderer::Detail
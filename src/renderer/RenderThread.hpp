@@ -0,0 +1,94 @@
+#pragma once
+
+#include "common/TripleBuffer.hpp"
+#include "renderer/IRenderer.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Runs a renderer on its own thread, so the thread that owns the windows never waits for the GPU or the presentation
+// engine, and the simulation of the next frame overlaps the submission of the current one.
+//
+// draw() only hands the frame state over through a triple buffer and returns. The render thread draws the newest
+// state it finds. The other calls are queued and run on the render thread before its next frame.
+//
+// Pacing: draw() waits until the render thread has picked up the previous state, so the caller runs at most one
+// frame ahead. It never waits longer than maxWait, so a stalled render thread doesn't stop the event handling;
+// the skipped states are replaced by newer ones.
+//
+// An exception of the wrapped renderer stops the render thread. The next call of draw() rethrows it.
+//
+class RenderThread : public IRenderer
+{
+public:
+    explicit RenderThread(std::unique_ptr<IRenderer> renderer, std::chrono::milliseconds maxWait);
+
+    RenderThread(const RenderThread& other) = delete;
+    RenderThread& operator=(const RenderThread& other) = delete;
+
+    // Finishes the frame being drawn, then destroys the renderer.
+    ~RenderThread() override;
+
+    void addTexture(std::future<Texture::TextureData> textureData) override;
+
+    // The number is known right away, because the renderer numbers the meshes in the order of the calls.
+    std::uint32_t addMesh(std::future<Geometry::MeshData> meshData, std::optional<std::uint32_t> texture) override;
+
+    // Checks the number on the calling thread, so a bad one throws here rather than stopping the render thread.
+    void removeMesh(std::uint32_t mesh) override;
+
+    // The first call returns only after its frame is drawn, so the startup ends with a frame on the screen.
+    void draw(const FrameState& frameState) override;
+
+    // As of the last draw().
+    const FrameStatistics& getFrameStatistics() const override;
+
+    // The sink is called on the render thread.
+    void setCaptureSink(CaptureSink sink) override;
+
+private:
+    using Command = std::move_only_function<void(IRenderer& renderer)>;
+
+    void runRenderer(std::stop_token stopToken);
+
+    void enqueue(Command command);
+
+    // Must be called with m_mutex locked.
+    void rethrowRendererError() const;
+
+    std::unique_ptr<IRenderer> m_renderer;
+    const std::chrono::milliseconds m_maxWait;
+    Common::TripleBuffer<FrameState> m_frameStates{};
+    // Only used by the calling thread.
+    FrameStatistics m_statistics{};
+    // Per mesh added so far, whether it is not removed yet. Only used by the calling thread.
+    std::vector<bool> m_liveMeshes{};
+
+    // -- SHARED WITH THE RENDER THREAD
+
+    std::mutex m_mutex{};
+    std::condition_variable_any m_frameStatePublished{};
+    std::condition_variable m_frameStateTaken{};
+    std::uint64_t m_publishedFrameCount{ 0 };
+    std::uint64_t m_takenFrameCount{ 0 };
+    std::uint64_t m_drawnFrameCount{ 0 };
+    std::vector<Command> m_commands{};
+    FrameStatistics m_latestStatistics{};
+    std::exception_ptr m_rendererError{};
+
+    // Must be the last member so the render thread is stopped before anything else is destroyed.
+    std::jthread m_renderThread{};
+};
+
+} // namespace VkTest1::Renderer::Detail
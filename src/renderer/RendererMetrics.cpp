@@ -0,0 +1,128 @@
+#include "renderer/RendererMetrics.hpp"
+
+#include <format>
+#include <string>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+constexpr std::chrono::seconds s_deviceMemoryUpdateInterval{ 1 };
+
+double toSeconds(RendererMetrics::Clock::duration duration)
+{
+    return std::chrono::duration<double>{ duration }.count();
+}
+
+std::string getHeapLabels(std::uint32_t heap, const vk::MemoryHeap& properties)
+{
+    return std::format(
+        "{{heap=\"{}\",device_local=\"{}\"}}",
+        heap,
+        static_cast<bool>(properties.flags & vk::MemoryHeapFlagBits::eDeviceLocal));
+}
+
+} // namespace
+
+RendererMetrics::RendererMetrics(
+    Common::MetricsRegistry& registry, const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget) :
+    m_frames{ registry.addCounter("renderer_frames_total", "Frames started.") },
+    m_draws{ registry.addCounter(
+        "renderer_draws_total", "Draw calls recorded. An indirect draw counts once per cluster.") },
+    m_triangles{ registry.addCounter(
+        "renderer_triangles_total",
+        "Triangles drawn, without the particles. The indirect draws count before the GPU culling.") },
+    m_pipelineBinds{ registry.addCounter("renderer_pipeline_binds_total", "Pipelines bound for drawing.") },
+    m_uploadedBytes{ registry.addCounter(
+        "renderer_uploaded_bytes_total", "Bytes of mesh and texture data uploaded to the device.") },
+    m_meshEvictions{ registry.addCounter(
+        "renderer_evictions_total{resource=\"mesh\"}",
+        "Meshes and textures evicted from device memory to make room for others.") },
+    m_textureEvictions{ registry.addCounter(
+        "renderer_evictions_total{resource=\"texture\"}",
+        "Meshes and textures evicted from device memory to make room for others.") },
+    // Around the usual refresh rates: 240, 144, 120, 60 and 30 Hz.
+    m_frameTime{ registry.addHistogram(
+        "renderer_frame_time_seconds",
+        "Time from the start of a frame to the start of the next one.",
+        { 0.00417, 0.00694, 0.00833, 0.0167, 0.0333, 0.05, 0.1, 0.25 }) },
+    m_fenceWait{ registry.addHistogram(
+        "renderer_fence_wait_seconds",
+        "Time the CPU waited for the GPU to finish the frame that used the same resources.",
+        { 0.0001, 0.0005, 0.001, 0.002, 0.004, 0.008, 0.0167, 0.0333 }) }
+{
+    const auto memoryProperties{ physicalDevice.getMemoryProperties() };
+    for (auto i{ 0u }; i != memoryProperties.memoryHeapCount; ++i)
+    {
+        const auto& heap{ memoryProperties.memoryHeaps[i] };
+        const auto labels{ getHeapLabels(i, heap) };
+        registry.addGauge("renderer_device_memory_heap_size_bytes" + labels, "Size of the device memory heap.")
+            .set(static_cast<double>(heap.size));
+    }
+    if (!hasMemoryBudget)
+    {
+        return;
+    }
+    for (auto i{ 0u }; i != memoryProperties.memoryHeapCount; ++i)
+    {
+        const auto labels{ getHeapLabels(i, memoryProperties.memoryHeaps[i]) };
+        m_heaps.push_back(HeapGauges{ &registry.addGauge(
+                                          "renderer_device_memory_usage_bytes" + labels,
+                                          "Device memory of the heap used by this process."),
+                                      nullptr });
+    }
+    // After the usages, so each family is in one piece.
+    for (auto i{ 0u }; i != memoryProperties.memoryHeapCount; ++i)
+    {
+        const auto labels{ getHeapLabels(i, memoryProperties.memoryHeaps[i]) };
+        m_heaps[i].budget = &registry.addGauge(
+            "renderer_device_memory_budget_bytes" + labels,
+            "Device memory of the heap this process can use without degrading performance.");
+    }
+}
+
+void RendererMetrics::beginFrame(Clock::time_point startTime)
+{
+    if (m_lastFrameStart.has_value())
+    {
+        m_frameTime.observe(toSeconds(startTime - *m_lastFrameStart));
+    }
+    m_lastFrameStart = startTime;
+    m_frames.add();
+}
+
+void RendererMetrics::addFenceWait(Clock::duration duration)
+{
+    m_fenceWait.observe(toSeconds(duration));
+}
+
+void RendererMetrics::addDraws(const DrawCounts& counts)
+{
+    m_draws.add(counts.drawCount);
+    m_triangles.add(counts.triangleCount);
+    m_pipelineBinds.add(counts.pipelineBindCount);
+}
+
+void RendererMetrics::updateDeviceMemory(const vk::raii::PhysicalDevice& physicalDevice, Clock::time_point now)
+{
+    if (m_heaps.empty() ||
+        (m_lastDeviceMemoryUpdate.has_value() && now - *m_lastDeviceMemoryUpdate < s_deviceMemoryUpdateInterval))
+    {
+        return;
+    }
+    m_lastDeviceMemoryUpdate = now;
+
+    const auto properties{ physicalDevice.getMemoryProperties2<
+        vk::PhysicalDeviceMemoryProperties2,
+        vk::PhysicalDeviceMemoryBudgetPropertiesEXT>() };
+    const auto& budget{ properties.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>() };
+    for (auto i{ std::size_t{ 0 } }; i != m_heaps.size(); ++i)
+    {
+        m_heaps[i].usage->set(static_cast<double>(budget.heapUsage[i]));
+        m_heaps[i].budget->set(static_cast<double>(budget.heapBudget[i]));
+    }
+}
+
+} // namespace VkTest1::Renderer::Detail
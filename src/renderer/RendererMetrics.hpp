@@ -0,0 +1,77 @@
+#pragma once
+
+#include "common/Metrics.hpp"
+#include "renderer/DrawList.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// The metrics of the renderer in the registry. The metrics are looked up once, so recording one is a relaxed atomic
+// operation.
+//
+// The device memory of every heap: its size, and with VK_EXT_memory_budget the usage and budget of this process.
+//
+class RendererMetrics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // hasMemoryBudget tells if VK_EXT_memory_budget is enabled on the device.
+    explicit RendererMetrics(
+        Common::MetricsRegistry& registry, const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget);
+
+    // At the start of every frame.
+    void beginFrame(Clock::time_point startTime);
+    void addFenceWait(Clock::duration duration);
+    void addDraws(const DrawCounts& counts);
+
+    void addMeshEviction()
+    {
+        m_meshEvictions.add();
+    }
+
+    void addTextureEviction()
+    {
+        m_textureEvictions.add();
+    }
+
+    // For the uploaders, which count the size of every upload.
+    Common::Counter& getUploadedBytes()
+    {
+        return m_uploadedBytes;
+    }
+
+    // Queries the memory budget now and then. Querying every frame would cost more than it tells.
+    void updateDeviceMemory(const vk::raii::PhysicalDevice& physicalDevice, Clock::time_point now);
+
+private:
+    struct HeapGauges
+    {
+        Common::Gauge* usage;
+        Common::Gauge* budget;
+    };
+
+    Common::Counter& m_frames;
+    Common::Counter& m_draws;
+    Common::Counter& m_triangles;
+    Common::Counter& m_pipelineBinds;
+    Common::Counter& m_uploadedBytes;
+    Common::Counter& m_meshEvictions;
+    Common::Counter& m_textureEvictions;
+    Common::Histogram& m_frameTime;
+    Common::Histogram& m_fenceWait;
+    // Empty without VK_EXT_memory_budget.
+    std::vector<HeapGauges> m_heaps{};
+    std::optional<Clock::time_point> m_lastFrameStart{};
+    std::optional<Clock::time_point> m_lastDeviceMemoryUpdate{};
+};
+
+} // namespace VkTest1::Renderer::Detail
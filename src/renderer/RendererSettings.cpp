@@ -0,0 +1,280 @@
+#include "renderer/RendererSettings.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <utility>
+
+using namespace VkTest1;
+
+namespace
+{
+
+template<typename TEnum>
+using EnumNames = std::span<const std::pair<TEnum, std::string_view>>;
+
+constexpr std::array<std::pair<Renderer::PresentMode, std::string_view>, 4> s_presentModeNames{ {
+    { Renderer::PresentMode::Fifo, "fifo" },
+    { Renderer::PresentMode::FifoRelaxed, "fifo-relaxed" },
+    { Renderer::PresentMode::Mailbox, "mailbox" },
+    { Renderer::PresentMode::Immediate, "immediate" },
+} };
+
+constexpr std::array<std::pair<Renderer::SwapchainFormat, std::string_view>, 2> s_swapchainFormatNames{ {
+    { Renderer::SwapchainFormat::Unorm, "unorm" },
+    { Renderer::SwapchainFormat::Srgb, "srgb" },
+} };
+
+constexpr std::array<std::pair<Renderer::DepthFormat, std::string_view>, 5> s_depthFormatNames{ {
+    { Renderer::DepthFormat::Auto, "auto" },
+    { Renderer::DepthFormat::D32, "d32" },
+    { Renderer::DepthFormat::D32S8, "d32s8" },
+    { Renderer::DepthFormat::D24S8, "d24s8" },
+    { Renderer::DepthFormat::D16, "d16" },
+} };
+
+constexpr std::array<std::pair<Renderer::ClusterCullingMode, std::string_view>, 3> s_clusterCullingModeNames{ {
+    { Renderer::ClusterCullingMode::Off, "off" },
+    { Renderer::ClusterCullingMode::Cpu, "cpu" },
+    { Renderer::ClusterCullingMode::Gpu, "gpu" },
+} };
+
+constexpr std::uint32_t s_maxFramesInFlight = 8;
+// Pixels. More only ever picks the least detailed LOD.
+constexpr float s_maxLodError = 1000.0f;
+
+[[noreturn]] void throwInvalidValue(std::string_view key, std::string_view value)
+{
+    throw Common::SettingsError{ std::format("Invalid value '{}' for setting '{}'.", value, key) };
+}
+
+bool parseBool(std::string_view key, std::string_view value)
+{
+    if (value.empty() || value == "true" || value == "1" || value == "on")
+    {
+        return true;
+    }
+    if (value == "false" || value == "0" || value == "off")
+    {
+        return false;
+    }
+    throwInvalidValue(key, value);
+}
+
+std::uint32_t parseUint(std::string_view key, std::string_view value, std::uint32_t min, std::uint32_t max)
+{
+    std::uint32_t result{};
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (ec != std::errc{} || end != value.data() + value.size() || result < min || result > max)
+    {
+        throwInvalidValue(key, value);
+    }
+    return result;
+}
+
+float parseFloat(std::string_view key, std::string_view value, float min, float max)
+{
+    float result{};
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (ec != std::errc{} || end != value.data() + value.size() || !(result >= min && result <= max))
+    {
+        throwInvalidValue(key, value);
+    }
+    return result;
+}
+
+template<typename TEnum>
+TEnum parseEnum(std::string_view key, std::string_view value, EnumNames<TEnum> names)
+{
+    const auto it{ std::ranges::find(names, value, &std::pair<TEnum, std::string_view>::second) };
+    if (it == names.end())
+    {
+        throwInvalidValue(key, value);
+    }
+    return it->first;
+}
+
+template<typename TEnum>
+std::string_view formatEnum(TEnum value, EnumNames<TEnum> names)
+{
+    return std::ranges::find(names, value, &std::pair<TEnum, std::string_view>::first)->second;
+}
+
+struct SettingDesc
+{
+    std::string_view key;
+    bool isFlag;
+    void (*parse)(Renderer::RendererSettings& settings, std::string_view key, std::string_view value);
+    std::string (*format)(const Renderer::RendererSettings& settings);
+};
+
+// In the order of formatSettings().
+const std::array<SettingDesc, 16> s_settings{ {
+    { "validation",
+      /* isFlag */ true,
+      [](auto& settings, auto key, auto value) { settings.validation = parseBool(key, value); },
+      [](const auto& settings) { return std::format("{}", settings.validation); } },
+    { "debug-messenger",
+      /* isFlag */ true,
+      [](auto& settings, auto key, auto value) { settings.debugMessenger = parseBool(key, value); },
+      [](const auto& settings) { return std::format("{}", settings.debugMessenger); } },
+    { "frames-in-flight",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.framesInFlight = parseUint(key, value, 1, s_maxFramesInFlight); },
+      [](const auto& settings) { return std::format("{}", settings.framesInFlight); } },
+    { "present-mode",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.presentMode = parseEnum<Renderer::PresentMode>(key, value, s_presentModeNames); },
+      [](const auto& settings)
+      { return std::string{ formatEnum<Renderer::PresentMode>(settings.presentMode, s_presentModeNames) }; } },
+    { "device",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value) { settings.preferredDevice = std::string{ value }; },
+      [](const auto& settings) { return settings.preferredDevice; } },
+    { "swapchain-format",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.swapchainFormat = parseEnum<Renderer::SwapchainFormat>(key, value, s_swapchainFormatNames); },
+      [](const auto& settings) {
+          return std::string{ formatEnum<Renderer::SwapchainFormat>(settings.swapchainFormat, s_swapchainFormatNames) };
+      } },
+    { "depth-format",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.depthFormat = parseEnum<Renderer::DepthFormat>(key, value, s_depthFormatNames); },
+      [](const auto& settings)
+      { return std::string{ formatEnum<Renderer::DepthFormat>(settings.depthFormat, s_depthFormatNames) }; } },
+    { "compact-indices",
+      /* isFlag */ true,
+      [](auto& settings, auto key, auto value) { settings.compactIndices = parseBool(key, value); },
+      [](const auto& settings) { return std::format("{}", settings.compactIndices); } },
+    { "depth-prepass",
+      /* isFlag */ true,
+      [](auto& settings, auto key, auto value) { settings.depthPrePass = parseBool(key, value); },
+      [](const auto& settings) { return std::format("{}", settings.depthPrePass); } },
+    { "lod-error",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value) { settings.lodError = parseFloat(key, value, 0.0f, s_maxLodError); },
+      [](const auto& settings) { return std::format("{}", settings.lodError); } },
+    { "cluster-culling",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.clusterCulling = parseEnum<Renderer::ClusterCullingMode>(key, value, s_clusterCullingModeNames); },
+      [](const auto& settings) {
+          return std::string{
+              formatEnum<Renderer::ClusterCullingMode>(settings.clusterCulling, s_clusterCullingModeNames) };
+      } },
+    { "particles",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.particleCount = parseUint(key, value, 0, std::numeric_limits<std::uint32_t>::max()); },
+      [](const auto& settings) { return std::format("{}", settings.particleCount); } },
+    { "memory-budget",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.memoryBudget = parseUint(key, value, 0, std::numeric_limits<std::uint32_t>::max()); },
+      [](const auto& settings) { return std::format("{}", settings.memoryBudget); } },
+    { "upload-quota",
+      /* isFlag */ false,
+      [](auto& settings, auto key, auto value)
+      { settings.uploadQuota = parseUint(key, value, 0, std::numeric_limits<std::uint32_t>::max()); },
+      [](const auto& settings) { return std::format("{}", settings.uploadQuota); } },
+    { "frame-stats",
+      /* isFlag */ true,
+      [](auto& settings, auto key, auto value) { settings.frameStatistics = parseBool(key, value); },
+      [](const auto& settings) { return std::format("{}", settings.frameStatistics); } },
+    { "render-thread",
+      /* isFlag */ true,
+      [](auto& settings, auto key, auto value) { settings.renderThread = parseBool(key, value); },
+      [](const auto& settings) { return std::format("{}", settings.renderThread); } },
+} };
+
+const SettingDesc* findSetting(std::string_view key)
+{
+    const auto it{ std::ranges::find(s_settings, key, &SettingDesc::key) };
+    return (it == s_settings.end()) ? nullptr : &*it;
+}
+
+std::string_view trim(std::string_view text)
+{
+    const auto first{ text.find_first_not_of(" \t\r") };
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    const auto last{ text.find_last_not_of(" \t\r") };
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+namespace VkTest1::Renderer
+{
+
+void applySetting(RendererSettings& settings, std::string_view key, std::string_view value)
+{
+    const auto* setting{ findSetting(key) };
+    if (setting == nullptr)
+    {
+        throw Common::SettingsError{ std::format("Unknown setting '{}'.", key) };
+    }
+    if (!setting->isFlag && value.empty())
+    {
+        throw Common::SettingsError{ std::format("Setting '{}' needs a value.", key) };
+    }
+    setting->parse(settings, key, value);
+}
+
+bool isFlagSetting(std::string_view key)
+{
+    const auto* setting{ findSetting(key) };
+    return setting != nullptr && setting->isFlag;
+}
+
+void applySettingsFile(RendererSettings& settings, std::string_view text)
+{
+    auto lineNumber{ 0 };
+    for (const auto lineRange : std::views::split(text, '\n'))
+    {
+        ++lineNumber;
+        const auto line{ trim(std::string_view{ lineRange.begin(), lineRange.end() }) };
+        if (line.empty() || line.starts_with('#'))
+        {
+            continue;
+        }
+
+        const auto separator{ line.find('=') };
+        if (separator == std::string_view::npos)
+        {
+            throw Common::SettingsError{ std::format("Settings line {}: Expected 'key = value'.", lineNumber) };
+        }
+        try
+        {
+            applySetting(settings, trim(line.substr(0, separator)), trim(line.substr(separator + 1)));
+        }
+        catch (const Common::SettingsError& ex)
+        {
+            throw Common::SettingsError{ std::format("Settings line {}: {}", lineNumber, ex.what()) };
+        }
+    }
+}
+
+std::string formatSettings(const RendererSettings& settings)
+{
+    std::string text{};
+    for (const auto& setting : s_settings)
+    {
+        text += std::format("{} = {}\n", setting.key, setting.format(settings));
+    }
+    return text;
+}
+
+} // namespace VkTest1::Renderer
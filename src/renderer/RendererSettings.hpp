@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace VkTest1::Renderer
+{
+
+enum class PresentMode
+{
+    // Vsync. Always supported.
+    Fifo,
+    // Vsync, but late frames are shown immediately (may tear).
+    FifoRelaxed,
+    // Vsync without blocking. The newest frame replaces the queued one.
+    Mailbox,
+    // No vsync. Tears.
+    Immediate
+};
+
+enum class SwapchainFormat
+{
+    Unorm,
+    // The presentation engine applies the sRGB transfer function.
+    Srgb
+};
+
+enum class DepthFormat
+{
+    // The first supported one of D32, D32S8 and D24S8.
+    Auto,
+    D32,
+    D32S8,
+    D24S8,
+    D16
+};
+
+enum class ClusterCullingMode
+{
+    // Every LOD is drawn as a whole.
+    Off,
+    // The meshlets are culled on the CPU and the visible ones drawn as index ranges.
+    Cpu,
+    // The meshlets are culled in a compute pass and drawn indirectly. Falls back to Cpu without multiDrawIndirect.
+    Gpu
+};
+
+struct RendererSettings
+{
+#ifdef NDEBUG
+    static constexpr bool s_isDebugBuild{ false };
+#else
+    static constexpr bool s_isDebugBuild{ true };
+#endif
+
+    // Enables VK_LAYER_KHRONOS_validation. It is expensive, so release builds don't enable it by default.
+    bool validation{ s_isDebugBuild };
+
+    // Installs the debug messenger callback (VK_EXT_debug_utils).
+    bool debugMessenger{ s_isDebugBuild };
+
+    // The number of frames the CPU can record ahead of the GPU.
+    std::uint32_t framesInFlight{ 2 };
+
+    // Fallback to Fifo if not supported.
+    PresentMode presentMode{ PresentMode::Mailbox };
+
+    // Picks the first suitable device whose name contains this. Empty means the first suitable device.
+    std::string preferredDevice{};
+
+    SwapchainFormat swapchainFormat{ SwapchainFormat::Unorm };
+
+    DepthFormat depthFormat{ DepthFormat::Auto };
+
+    // Meshes with at most 65535 vertices get 16 bit indices. Halves the index memory and bandwidth.
+    bool compactIndices{ true };
+
+    // Render depth only first, then shade only the fragments that passed (depth test eEqual).
+    // Worth it when the scene has a lot of overdraw and expensive fragment shading.
+    bool depthPrePass{ false };
+
+    // The largest simplification error of a mesh LOD on screen, in pixels. Meshes are drawn with the least detailed
+    // LOD within it. 0 always draws the most detailed LOD.
+    float lodError{ 1.0f };
+
+    // Culls the meshlets of the meshes that have them (see mesh_convert) against the view and by their normal cones.
+    ClusterCullingMode clusterCulling{ ClusterCullingMode::Cpu };
+
+    // Capacity of the GPU particle system. 0 disables it.
+    std::uint32_t particleCount{ 0 };
+
+    // Caps the device local memory the renderer plans with, in MiB. Above it, the least recently used textures are
+    // evicted. 0 leaves the budget to the device.
+    std::uint32_t memoryBudget{ 0 };
+
+    // Caps the mesh and texture data uploaded per frame, in KiB, so streaming doesn't stall the frames. An upload
+    // larger than the quota still goes through, alone in its frame. 0 is unlimited.
+    std::uint32_t uploadQuota{ 0 };
+
+    // Logs the frame statistics (latency, missed vsyncs, wait times) every second.
+    bool frameStatistics{ false };
+
+    // Draws on a dedicated thread. The window events are handled while the renderer waits for the GPU.
+    bool renderThread{ true };
+};
+
+// Sets the setting called key (e.g. "frames-in-flight") from its text form.
+// For flags (see isFlagSetting()) an empty value means true.
+// Throws Common::SettingsError if the key or the value is invalid.
+void applySetting(RendererSettings& settings, std::string_view key, std::string_view value);
+
+// Flags are booleans. They can be given without a value.
+bool isFlagSetting(std::string_view key);
+
+// Applies "key = value" lines. Empty lines and lines starting with '#' are ignored.
+// Throws Common::SettingsError.
+void applySettingsFile(RendererSettings& settings, std::string_view text);
+
+// One "key = value" line per setting. Can be read back with applySettingsFile().
+std::string formatSettings(const RendererSettings& settings);
+
+} // namespace VkTest1::Renderer
@@ -0,0 +1,21 @@
+#include "renderer/ResidencyTracker.hpp"
+
+namespace VkTest1::Renderer::Detail
+{
+
+ResidencyTracker::ResidencyTracker(std::uint32_t framesInFlight) :
+    m_framesInFlight{ framesInFlight },
+    m_frameNumber{ framesInFlight }
+{
+}
+
+void ResidencyTracker::markUsed(std::size_t resource)
+{
+    if (resource >= m_lastUsedFrames.size())
+    {
+        m_lastUsedFrames.resize(resource + 1, 0);
+    }
+    m_lastUsedFrames[resource] = m_frameNumber;
+}
+
+} // namespace VkTest1::Renderer::Detail
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// The frame in which each resource was last used, so the least recently used ones are evicted first. The resources
+// are numbered by the caller, and the frames by the number of submitted frames.
+//
+// A resource is only evicted once the frames in flight that may use it are done: it was not used in the last
+// framesInFlight submitted frames, and the fence of the current frame has signaled.
+//
+class ResidencyTracker
+{
+public:
+    explicit ResidencyTracker(std::uint32_t framesInFlight);
+
+    // A draw, an upload or a copy of the current frame uses the resource.
+    void markUsed(std::size_t resource);
+
+    // After the current frame was submitted.
+    void endFrame()
+    {
+        ++m_frameNumber;
+    }
+
+    // The least recently used of the resources [0, resourceCount) for which isCandidate is true, among the ones no
+    // frame in flight uses. Empty if there is none.
+    template<typename TPredicate>
+    std::optional<std::size_t> findLeastRecentlyUsed(std::size_t resourceCount, TPredicate isCandidate) const
+    {
+        std::optional<std::size_t> found{};
+        for (auto i{ std::size_t{ 0 } }; i != resourceCount; ++i)
+        {
+            const auto lastUsedFrame{ getLastUsedFrame(i) };
+            if (lastUsedFrame + m_framesInFlight <= m_frameNumber &&
+                (!found.has_value() || lastUsedFrame < getLastUsedFrame(*found)) && isCandidate(i))
+            {
+                found = i;
+            }
+        }
+        return found;
+    }
+
+private:
+    std::uint64_t getLastUsedFrame(std::size_t resource) const
+    {
+        return resource < m_lastUsedFrames.size() ? m_lastUsedFrames[resource] : 0;
+    }
+
+    std::uint32_t m_framesInFlight;
+    // Of the current frame. Starts at framesInFlight, so a resource that was never used is idle.
+    std::uint64_t m_frameNumber;
+    // Zero if never used.
+    std::vector<std::uint64_t> m_lastUsedFrames{};
+};
+
+} // namespace VkTest1::Renderer::Detail
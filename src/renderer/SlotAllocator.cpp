@@ -0,0 +1,44 @@
+#include "renderer/SlotAllocator.hpp"
+
+#include <cassert>
+
+namespace VkTest1::Renderer::Detail
+{
+
+SlotAllocator::SlotAllocator(std::uint32_t capacity, std::uint32_t frameCount) :
+    m_capacity{ capacity },
+    m_pendingSlots(frameCount)
+{
+}
+
+std::optional<std::uint32_t> SlotAllocator::allocate()
+{
+    // The freed slots first, so the used part of the array stays small.
+    if (!m_freeSlots.empty())
+    {
+        const auto slot{ m_freeSlots.back() };
+        m_freeSlots.pop_back();
+        return slot;
+    }
+    if (m_firstUnusedSlot != m_capacity)
+    {
+        return m_firstUnusedSlot++;
+    }
+    return std::nullopt;
+}
+
+void SlotAllocator::free(std::uint32_t slot)
+{
+    assert(slot < m_firstUnusedSlot);
+    m_pendingSlots[m_currentFrame].push_back(slot);
+}
+
+void SlotAllocator::beginFrame(unsigned int frame)
+{
+    m_currentFrame = frame;
+    auto& pendingSlots{ m_pendingSlots[m_currentFrame] };
+    m_freeSlots.insert(m_freeSlots.end(), pendingSlots.begin(), pendingSlots.end());
+    pendingSlots.clear();
+}
+
+} // namespace VkTest1::Renderer::Detail
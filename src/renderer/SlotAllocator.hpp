@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Hands out the slots [0, capacity) of a descriptor array.
+//
+// The command buffers of the frames in flight may still use a freed slot, so it is only reused once the frame that
+// freed it begins again: the fence of the frame has signaled by then, and the fences of the frames before it too.
+//
+class SlotAllocator
+{
+public:
+    explicit SlotAllocator(std::uint32_t capacity, std::uint32_t frameCount);
+
+    // Empty if every slot is in use or waiting for its frame.
+    std::optional<std::uint32_t> allocate();
+
+    // The slot becomes free when the current frame begins again.
+    void free(std::uint32_t slot);
+
+    // Makes the frame the current one. Its fence must have signaled. The slots it freed last time are free again.
+    void beginFrame(unsigned int frame);
+
+    std::uint32_t getCapacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    std::uint32_t m_capacity;
+    // The slots from here on were never allocated.
+    std::uint32_t m_firstUnusedSlot{ 0 };
+    std::vector<std::uint32_t> m_freeSlots{};
+    // Per frame in flight, the slots freed while it was the current one.
+    std::vector<std::vector<std::uint32_t>> m_pendingSlots;
+    unsigned int m_currentFrame{ 0 };
+};
+
+} // namespace VkTest1::Renderer::Detail
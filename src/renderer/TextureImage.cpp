@@ -0,0 +1,185 @@
+#include "TextureImage.hpp"
+
+#include "common/Cast.hpp"
+#include "renderer/DeviceMemory.hpp"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace VkTest1;
+
+namespace
+{
+
+vk::raii::Image createImage(const vk::raii::Device& device, const Texture::TextureData& textureData)
+{
+    vk::ImageCreateInfo imageCI{};
+    imageCI.setImageType(vk::ImageType::e2D);
+    imageCI.setFormat(Renderer::toVkFormat(textureData.format));
+    imageCI.setExtent(vk::Extent3D{ textureData.width, textureData.height, 1 });
+    imageCI.setMipLevels(Common::NarrowCast<std::uint32_t>(textureData.mipLevels.size()));
+    imageCI.setArrayLayers(1);
+    imageCI.setSamples(vk::SampleCountFlagBits::e1);
+    imageCI.setTiling(vk::ImageTiling::eOptimal);
+    imageCI.setUsage(vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst);
+    imageCI.setSharingMode(vk::SharingMode::eExclusive);
+    imageCI.setInitialLayout(vk::ImageLayout::eUndefined);
+    return device.createImage(imageCI);
+}
+
+vk::raii::DeviceMemory allocateImageMemory(
+    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device, const vk::raii::Image& image)
+{
+    auto memory{ Renderer::Detail::allocateDeviceMemory(
+        physicalDevice, device, image.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal) };
+    image.bindMemory(memory, /* memoryOffset */ 0);
+    return memory;
+}
+
+vk::ImageSubresourceRange getSubresourceRange(std::uint32_t mipLevelCount)
+{
+    return vk::ImageSubresourceRange{ /* aspectMask */ vk::ImageAspectFlagBits::eColor,
+                                      /* baseMipLevel */ 0,
+                                      /* levelCount */ mipLevelCount,
+                                      /* baseArrayLayer */ 0,
+                                      /* layerCount */ 1 };
+}
+
+vk::raii::ImageView createImageView(
+    const vk::raii::Device& device, const vk::raii::Image& image, const Texture::TextureData& textureData)
+{
+    return device.createImageView(vk::ImageViewCreateInfo{
+        /* flags */ {},
+        /* image */ image,
+        /* viewType */ vk::ImageViewType::e2D,
+        /* format */ Renderer::toVkFormat(textureData.format),
+        /* components */ {},
+        /* subresourceRange */
+        getSubresourceRange(Common::NarrowCast<std::uint32_t>(textureData.mipLevels.size())) });
+}
+
+vk::raii::Buffer createStagingBuffer(const vk::raii::Device& device, const Texture::TextureData& textureData)
+{
+    return device.createBuffer(vk::BufferCreateInfo{ /* flags */ {},
+                                                     /* size */ textureData.data.size(),
+                                                     /* usage */ vk::BufferUsageFlagBits::eTransferSrc,
+                                                     /* sharingMode */ vk::SharingMode::eExclusive });
+}
+
+// HostVisible = CPU can access it.
+// HostCoherent = No need for manual flush (i.e. memory cache management).
+vk::raii::DeviceMemory allocateStagingMemoryAndCopyData(
+    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device, const vk::raii::Buffer& stagingBuffer,
+    const Texture::TextureData& textureData)
+{
+    auto memory{ Renderer::Detail::allocateDeviceMemory(
+        physicalDevice,
+        device,
+        stagingBuffer.getMemoryRequirements(),
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent) };
+    stagingBuffer.bindMemory(memory, /* memoryOffset */ 0);
+
+    // The texture data has the layout of the copy regions, so it is copied as a whole.
+    auto* mappedData{ memory.mapMemory(/* offset */ 0, /* size */ textureData.data.size(), /* flags */ {}) };
+    std::memcpy(mappedData, textureData.data.data(), textureData.data.size());
+    memory.unmapMemory();
+    return memory;
+}
+
+} // namespace
+
+namespace VkTest1::Renderer
+{
+
+TextureImage::TextureImage(
+    const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device, const Texture::TextureData& textureData,
+    std::uint32_t descriptorIndex) :
+    m_mipLevels{ textureData.mipLevels },
+    m_image{ createImage(device, textureData) },
+    m_memorySize{ m_image.getMemoryRequirements().size },
+    // DeviceLocal = Only the GPU can access it. The fastest memory for the GPU to read.
+    m_imageMemory{ allocateImageMemory(physicalDevice, device, m_image) },
+    m_imageView{ createImageView(device, m_image, textureData) },
+    m_stagingBuffer{ createStagingBuffer(device, textureData) },
+    m_stagingBufferMemory{ allocateStagingMemoryAndCopyData(physicalDevice, device, m_stagingBuffer, textureData) },
+    m_descriptorIndex{ descriptorIndex }
+{
+}
+
+void TextureImage::recordUpload(const vk::raii::CommandBuffer& commandBuffer) const
+{
+    const auto subresourceRange{ getSubresourceRange(Common::NarrowCast<std::uint32_t>(m_mipLevels.size())) };
+
+    // The previous contents don't matter, they are all overwritten.
+    commandBuffer.pipelineBarrier(
+        /* srcStageMask */ vk::PipelineStageFlagBits::eTopOfPipe,
+        /* dstStageMask */ vk::PipelineStageFlagBits::eTransfer,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */ {},
+        /* bufferMemoryBarriers */ {},
+        /* imageMemoryBarriers */
+        vk::ImageMemoryBarrier{ /* srcAccessMask */ {},
+                                /* dstAccessMask */ vk::AccessFlagBits::eTransferWrite,
+                                /* oldLayout */ vk::ImageLayout::eUndefined,
+                                /* newLayout */ vk::ImageLayout::eTransferDstOptimal,
+                                /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                /* image */ m_image,
+                                /* subresourceRange */ subresourceRange });
+
+    // One region per mip level. The rows are tightly packed (row length 0), block rows for the compressed formats.
+    std::vector<vk::BufferImageCopy> regions{};
+    regions.reserve(m_mipLevels.size());
+    for (auto i{ 0u }; i != m_mipLevels.size(); ++i)
+    {
+        const auto& mipLevel{ m_mipLevels[i] };
+        regions.push_back(vk::BufferImageCopy{
+            /* bufferOffset */ mipLevel.offset,
+            /* bufferRowLength */ 0,
+            /* bufferImageHeight */ 0,
+            /* imageSubresource */ vk::ImageSubresourceLayers{ vk::ImageAspectFlagBits::eColor, i, 0, 1 },
+            /* imageOffset */ vk::Offset3D{ 0, 0, 0 },
+            /* imageExtent */ vk::Extent3D{ mipLevel.width, mipLevel.height, 1 } });
+    }
+    commandBuffer.copyBufferToImage(m_stagingBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, regions);
+
+    // The copy must be finished and visible before any fragment shader samples the image.
+    commandBuffer.pipelineBarrier(
+        /* srcStageMask */ vk::PipelineStageFlagBits::eTransfer,
+        /* dstStageMask */ vk::PipelineStageFlagBits::eFragmentShader,
+        /* dependencyFlags */ {},
+        /* memoryBarriers */ {},
+        /* bufferMemoryBarriers */ {},
+        /* imageMemoryBarriers */
+        vk::ImageMemoryBarrier{ /* srcAccessMask */ vk::AccessFlagBits::eTransferWrite,
+                                /* dstAccessMask */ vk::AccessFlagBits::eShaderRead,
+                                /* oldLayout */ vk::ImageLayout::eTransferDstOptimal,
+                                /* newLayout */ vk::ImageLayout::eShaderReadOnlyOptimal,
+                                /* srcQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                /* dstQueueFamilyIndex */ vk::QueueFamilyIgnored,
+                                /* image */ m_image,
+                                /* subresourceRange */ subresourceRange });
+}
+
+void TextureImage::releaseStagingBuffer()
+{
+    m_stagingBuffer = vk::raii::Buffer{ nullptr };
+    m_stagingBufferMemory = vk::raii::DeviceMemory{ nullptr };
+}
+
+vk::Format toVkFormat(Texture::TextureFormat format)
+{
+    switch (format)
+    {
+        case Texture::TextureFormat::Rgba8:
+            return vk::Format::eR8G8B8A8Unorm;
+        case Texture::TextureFormat::Bc1:
+            return vk::Format::eBc1RgbUnormBlock;
+        case Texture::TextureFormat::Bc7:
+            return vk::Format::eBc7UnormBlock;
+    }
+    return vk::Format::eUndefined;
+}
+
+} // namespace VkTest1::Renderer
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "texture/TextureData.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace VkTest1::Renderer
+{
+
+// The GPU side of a texture.
+class TextureImage
+{
+public:
+    // Creates a device local image with all the mip levels of the texture data, and a host visible staging buffer
+    // holding a copy of the data.
+    // The data reaches the image only after the commands of recordUpload() were executed.
+    // The descriptor index is the slot of the texture in the bindless descriptor set. The caller writes it.
+    // Throws Common::OutOfMemoryError if the device memory is full.
+    explicit TextureImage(
+        const vk::PhysicalDevice& physicalDevice, const vk::raii::Device& device,
+        const Texture::TextureData& textureData, std::uint32_t descriptorIndex);
+
+    TextureImage(const TextureImage& other) = delete;
+    TextureImage& operator=(const TextureImage& other) = delete;
+
+    TextureImage(TextureImage&& other) = default;
+    TextureImage& operator=(TextureImage&& other) = default;
+
+    // Records the copy from the staging buffer to every mip level, and the transition for the fragment shader.
+    void recordUpload(const vk::raii::CommandBuffer& commandBuffer) const;
+
+    // Call this only after the upload commands finished executing.
+    void releaseStagingBuffer();
+
+    vk::ImageView getImageView() const
+    {
+        return m_imageView;
+    }
+
+    // Of the image, in device local memory.
+    vk::DeviceSize getMemorySize() const
+    {
+        return m_memorySize;
+    }
+
+    // The shaders sample the texture with this index into the bindless textures.
+    std::uint32_t getDescriptorIndex() const
+    {
+        return m_descriptorIndex;
+    }
+
+private:
+    std::vector<Texture::MipLevel> m_mipLevels;
+    vk::raii::Image m_image;
+    vk::DeviceSize m_memorySize;
+    vk::raii::DeviceMemory m_imageMemory;
+    vk::raii::ImageView m_imageView;
+    vk::raii::Buffer m_stagingBuffer;
+    vk::raii::DeviceMemory m_stagingBufferMemory;
+    std::uint32_t m_descriptorIndex;
+};
+
+// The format the renderer samples the texture format as. UNORM, the texels are not decoded from sRGB.
+vk::Format toVkFormat(Texture::TextureFormat format);
+
+} // namespace VkTest1::Renderer
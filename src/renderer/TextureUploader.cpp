@@ -0,0 +1,227 @@
+#include "renderer/TextureUploader.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+namespace VkTest1::Renderer::Detail
+{
+
+namespace
+{
+
+// Trilinear filtering, repeating. Without anisotropic filtering, which would need a device feature.
+vk::raii::Sampler createSampler(const vk::raii::Device& device)
+{
+    return device.createSampler(vk::SamplerCreateInfo{ /* flags */ {},
+                                                       /* magFilter */ vk::Filter::eLinear,
+                                                       /* minFilter */ vk::Filter::eLinear,
+                                                       /* mipmapMode */ vk::SamplerMipmapMode::eLinear,
+                                                       /* addressModeU */ vk::SamplerAddressMode::eRepeat,
+                                                       /* addressModeV */ vk::SamplerAddressMode::eRepeat,
+                                                       /* addressModeW */ vk::SamplerAddressMode::eRepeat,
+                                                       /* mipLodBias */ 0.0f,
+                                                       /* anisotropyEnable */ false,
+                                                       /* maxAnisotropy */ 1.0f,
+                                                       /* compareEnable */ false,
+                                                       /* compareOp */ vk::CompareOp::eAlways,
+                                                       /* minLod */ 0.0f,
+                                                       /* maxLod */ vk::LodClampNone });
+}
+
+} // namespace
+
+TextureUploader::TextureUploader(
+    Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice, Common::NotNull<const vk::raii::Device*> device,
+    Common::NotNull<const vk::raii::Queue*> queue, Common::NotNull<Logging::ILogger*> logger,
+    Common::NotNull<BindlessDescriptors*> descriptors, Common::NotNull<MemoryBudget*> memoryBudget,
+    Common::NotNull<Common::Counter*> uploadedBytes, std::uint32_t queueFamilyIndex) :
+    m_physicalDevice{ physicalDevice },
+    m_device{ device },
+    m_queue{ queue },
+    m_logger{ logger },
+    m_descriptors{ descriptors },
+    m_memoryBudget{ memoryBudget },
+    m_uploadedBytes{ uploadedBytes },
+    m_isBcSupported{ physicalDevice->getFeatures().textureCompressionBC == vk::True },
+    m_sampler{ createSampler(*device) },
+    // eTransient = The command buffers are short lived. They are recorded once and freed after execution.
+    m_commandPool{ device->createCommandPool(vk::CommandPoolCreateInfo{
+        /* flags */ vk::CommandPoolCreateFlagBits::eTransient,
+        /* queueFamilyIndex */ queueFamilyIndex }) }
+{
+    if (!m_isBcSupported)
+    {
+        m_logger->warning("Vulkan: The device cannot sample BC textures. Only RGBA8 textures are loaded.");
+    }
+}
+
+void TextureUploader::enqueue(std::future<Texture::TextureData> textureData, std::uint32_t textureIndex)
+{
+    m_loading.push_back(Load{ std::move(textureData), textureIndex });
+}
+
+void TextureUploader::reload(std::uint32_t textureIndex)
+{
+    if (textureIndex >= m_sources.size() || !m_sources[textureIndex].has_value() ||
+        m_sources[textureIndex]->isQueued)
+    {
+        return;
+    }
+    m_sources[textureIndex]->isQueued = true;
+    m_pending.push_back(textureIndex);
+}
+
+bool TextureUploader::update(
+    std::vector<std::optional<TextureImage>>& residentTextures, std::uint64_t& uploadQuota)
+{
+    // -- PICK UP LOADED TEXTURES
+
+    for (auto it{ m_loading.begin() }; it != m_loading.end();)
+    {
+        if (it->textureData.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        try
+        {
+            auto textureData{ it->textureData.get() };
+            validate(textureData);
+            if (it->textureIndex >= m_sources.size())
+            {
+                m_sources.resize(it->textureIndex + 1);
+            }
+            m_sources[it->textureIndex] = Source{ std::move(textureData), /* isQueued */ true };
+            m_pending.push_back(it->textureIndex);
+        }
+        catch (const std::exception& ex)
+        {
+            // A broken asset must not take down the frame loop. The meshes fall back to the default texture.
+            m_logger->error("Vulkan: Cannot load texture {}: {}", it->textureIndex, ex.what());
+        }
+        it = m_loading.erase(it);
+    }
+
+    // -- START UPLOADS
+
+    m_waitingSize.reset();
+    while (!m_pending.empty() && uploadQuota != 0)
+    {
+        const auto textureIndex{ m_pending.front() };
+        auto& source{ m_sources[textureIndex] };
+        const auto dataSize{ vk::DeviceSize{ source->textureData.data.size() } };
+        if (!m_memoryBudget->canAllocate(dataSize))
+        {
+            m_waitingSize = dataSize;
+            break;
+        }
+        try
+        {
+            submitUpload(source->textureData, textureIndex);
+            uploadQuota -= std::min<std::uint64_t>(uploadQuota, dataSize);
+        }
+        catch (const Common::OutOfMemoryError&)
+        {
+            // The budget doesn't see everything. Tried again once the renderer has evicted a texture.
+            m_waitingSize = dataSize;
+            break;
+        }
+        catch (const std::exception& ex)
+        {
+            m_logger->error("Vulkan: Cannot upload texture {}: {}", textureIndex, ex.what());
+            source.reset();
+        }
+        m_pending.pop_front();
+    }
+
+    // -- FINISH UPLOADS
+
+    const auto uploadedCount{ std::erase_if(
+        m_uploading,
+        [&residentTextures, this](Upload& upload)
+        {
+            if (upload.fence.getStatus() != vk::Result::eSuccess)
+            {
+                return false;
+            }
+            upload.texture.releaseStagingBuffer();
+            m_sources[upload.textureIndex]->isQueued = false;
+            if (upload.textureIndex >= residentTextures.size())
+            {
+                residentTextures.resize(upload.textureIndex + 1);
+            }
+            residentTextures[upload.textureIndex] = std::move(upload.texture);
+            return true;
+        }) };
+
+    return uploadedCount != 0;
+}
+
+void TextureUploader::validate(const Texture::TextureData& textureData) const
+{
+    if (Texture::isBlockCompressed(textureData.format) && !m_isBcSupported)
+    {
+        throw Common::RendererError{ "The device cannot sample BC textures." };
+    }
+    if (textureData.mipLevels.empty())
+    {
+        throw Common::RendererError{ "The texture has no mip levels." };
+    }
+}
+
+void TextureUploader::submitUpload(const Texture::TextureData& textureData, std::uint32_t textureIndex)
+{
+    const auto descriptorIndex{ m_descriptors->allocateTextureSlot() };
+    if (!descriptorIndex.has_value())
+    {
+        throw Common::OutOfMemoryError{ "No free texture slot." };
+    }
+    try
+    {
+        submitUploadToSlot(textureData, textureIndex, *descriptorIndex);
+    }
+    catch (...)
+    {
+        // Nothing uses the slot yet.
+        m_descriptors->freeTextureSlot(*descriptorIndex);
+        throw;
+    }
+}
+
+void TextureUploader::submitUploadToSlot(
+    const Texture::TextureData& textureData, std::uint32_t textureIndex, std::uint32_t descriptorIndex)
+{
+    TextureImage texture{ **m_physicalDevice, *m_device, textureData, descriptorIndex };
+    // The shaders use the slot only once the texture is resident, and by then the upload has transitioned the image.
+    m_descriptors->writeTexture(descriptorIndex, texture.getImageView(), m_sampler);
+
+    auto commandBuffers{ m_device->allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+        /* commandPool */ m_commandPool,
+        /* level */ vk::CommandBufferLevel::ePrimary,
+        /* commandBufferCount */ 1 }) };
+    auto& commandBuffer{ commandBuffers.front() };
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo{ /* flags */ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    texture.recordUpload(commandBuffer);
+    commandBuffer.end();
+
+    auto fence{ m_device->createFence(vk::FenceCreateInfo{}) };
+
+    const std::array<vk::CommandBuffer, 1> submitCommandBuffers{ commandBuffer };
+    m_queue->submit(
+        std::array<vk::SubmitInfo, 1>{ vk::SubmitInfo{ /* pWaitSemaphores */ {},
+                                                       /* pWaitDstStageMask */ {},
+                                                       /* pCommandBuffers */ submitCommandBuffers } },
+        fence);
+    m_uploadedBytes->add(textureData.data.size());
+    // The renderer gives the memory back when it evicts the texture.
+    m_memoryBudget->allocate(texture.getMemorySize());
+
+    m_uploading.push_back(Upload{ std::move(texture), textureIndex, std::move(commandBuffer), std::move(fence) });
+}
+
+} // namespace VkTest1::Renderer::Detail
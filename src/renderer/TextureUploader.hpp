@@ -0,0 +1,108 @@
+#pragma once
+
+#include "common/Metrics.hpp"
+#include "common/Types.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/BindlessDescriptors.hpp"
+#include "renderer/MemoryBudget.hpp"
+#include "renderer/TextureImage.hpp"
+#include "texture/TextureData.hpp"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <optional>
+#include <vector>
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Moves textures from the asset loader to the GPU without blocking the frame loop. Works like the MeshUploader.
+//
+// Owns the sampler the textures share. Every texture gets a slot in the bindless textures.
+//
+// Keeps the data of every loaded texture, so the renderer can evict a texture and have it uploaded again later. An
+// upload that would exceed the memory budget, or that runs out of device memory or bindless slots, waits until the
+// renderer has evicted other textures. The uploads after it wait too, so the textures arrive in order.
+//
+class TextureUploader
+{
+public:
+    explicit TextureUploader(
+        Common::NotNull<const vk::raii::PhysicalDevice*> physicalDevice,
+        Common::NotNull<const vk::raii::Device*> device, Common::NotNull<const vk::raii::Queue*> queue,
+        Common::NotNull<Logging::ILogger*> logger, Common::NotNull<BindlessDescriptors*> descriptors,
+        Common::NotNull<MemoryBudget*> memoryBudget, Common::NotNull<Common::Counter*> uploadedBytes,
+        std::uint32_t queueFamilyIndex);
+
+    // The texture goes to residentTextures[textureIndex].
+    void enqueue(std::future<Texture::TextureData> textureData, std::uint32_t textureIndex);
+
+    // Uploads an evicted texture again. Does nothing if the texture failed to load, or is loading or uploading.
+    void reload(std::uint32_t textureIndex);
+
+    // Never blocks. Submits uploads for the loaded textures and moves the uploaded textures to residentTextures.
+    // The data of the submitted uploads is taken from uploadQuota. No upload starts once it is 0.
+    // Returns true if residentTextures changed.
+    bool update(std::vector<std::optional<TextureImage>>& residentTextures, std::uint64_t& uploadQuota);
+
+    // The data size of the upload that waits for memory, as of the last update. Empty if none waits.
+    std::optional<vk::DeviceSize> getWaitingSize() const
+    {
+        return m_waitingSize;
+    }
+
+private:
+    struct Load
+    {
+        std::future<Texture::TextureData> textureData;
+        std::uint32_t textureIndex;
+    };
+
+    // A loaded texture.
+    struct Source
+    {
+        Texture::TextureData textureData;
+        // Waiting for its upload or uploading.
+        bool isQueued;
+    };
+
+    struct Upload
+    {
+        TextureImage texture;
+        std::uint32_t textureIndex;
+        vk::raii::CommandBuffer commandBuffer;
+        vk::raii::Fence fence;
+    };
+
+    // Throws if the device cannot sample the texture.
+    void validate(const Texture::TextureData& textureData) const;
+    void submitUpload(const Texture::TextureData& textureData, std::uint32_t textureIndex);
+    void submitUploadToSlot(
+        const Texture::TextureData& textureData, std::uint32_t textureIndex, std::uint32_t descriptorIndex);
+
+    Common::NotNull<const vk::raii::PhysicalDevice*> m_physicalDevice;
+    Common::NotNull<const vk::raii::Device*> m_device;
+    Common::NotNull<const vk::raii::Queue*> m_queue;
+    Common::NotNull<Logging::ILogger*> m_logger;
+    Common::NotNull<BindlessDescriptors*> m_descriptors;
+    Common::NotNull<MemoryBudget*> m_memoryBudget;
+    // Counts the texture data of every submitted upload.
+    Common::NotNull<Common::Counter*> m_uploadedBytes;
+    // The textureCompressionBC feature. It is enabled on the device if the device has it.
+    bool m_isBcSupported;
+    vk::raii::Sampler m_sampler;
+    vk::raii::CommandPool m_commandPool;
+    std::vector<Load> m_loading{};
+    // Indexed by the texture index. Empty while the texture is loading or if it failed to load.
+    std::vector<std::optional<Source>> m_sources{};
+    // The texture indices of the sources to upload, in order.
+    std::deque<std::uint32_t> m_pending{};
+    std::vector<Upload> m_uploading{};
+    std::optional<vk::DeviceSize> m_waitingSize{};
+};
+
+} // namespace VkTest1::Renderer::Detail
@@ -2,14 +2,23 @@
 
 #include "common/Cast.hpp"
 #include "common/Errors.hpp"
+#include "geometry/MeshData.hpp"
 #include "geometry/Vertex.hpp"
+#include "logging/ILogger.hpp"
 #include "renderer/DebugUtilsMessenger.hpp"
+#include "renderer/ExtensionSupport.hpp"
 #include "renderer/Mesh.hpp"
 
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
-#include <print>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory_resource>
 #include <ranges>
 #include <span>
 #include <unordered_set>
@@ -19,58 +28,94 @@ using namespace VkTest1;
 namespace
 {
 
-const std::array<const char* const, 1> s_requiredInstanceLayers{ "VK_LAYER_KHRONOS_validation" };
-const std::array<const char* const, 1> s_requiredPhysicalDeviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
-
-constexpr unsigned int s_maxFrameCountInQueue = 2;
-
-std::vector<const char*> getInstanceExtensions(const Window::IWindow& window)
+const std::array<const char* const, 1> s_validationLayers{ "VK_LAYER_KHRONOS_validation" };
+// Descriptor indexing is core in Vulkan 1.2. The extension keeps the renderer on 1.1.
+const std::array<const char* const, 2> s_requiredPhysicalDeviceExtensions{
+    VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME
+};
+const std::array<vk::DynamicState, 2> s_dynamicStates{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+// The ids of the pipelines in the sort keys.
+constexpr std::uint8_t s_depthPrePassPipelineId{ 0 };
+constexpr std::uint8_t s_meshPipelineId{ 1 };
+// The sizes of the bindless arrays. Must match the shaders.
+// The mesh textures and the default texture.
+constexpr std::uint32_t s_maxTextureCount{ 1024 };
+// The meshlet buffer of the geometry arena, and room for more.
+constexpr std::uint32_t s_maxStorageBufferCount{ 4096 };
+// The capacities of the geometry arena: 64 MiB of vertices, 64 MiB of indices and 20 MiB of meshlets.
+constexpr std::uint32_t s_geometryVertexCapacity{ 2 * 1024 * 1024 };
+constexpr std::uint32_t s_geometryIndexCapacity{ 16 * 1024 * 1024 };
+constexpr std::uint32_t s_geometryMeshletCapacity{ 512 * 1024 };
+// White, for the meshes without a texture. The added textures come after it.
+constexpr std::uint32_t s_defaultTextureIndex{ 0 };
+// Per frame in flight and thread. Grows on demand; this covers a frame with a few windows without growing.
+constexpr std::size_t s_frameArenaCapacity{ 64 * 1024 };
+// The meshes per job of the culling. A bounds test is cheap, so many per job; the clusters of a mesh are not.
+constexpr std::size_t s_meshCullGrainSize{ 1024 };
+constexpr std::size_t s_clusterCullGrainSize{ 16 };
+
+std::vector<const char*> getInstanceExtensions(
+    const Window::IWindow& window, const Renderer::RendererSettings& settings)
 {
     auto extensions = window.getRendererInstanceExtensions();
 
     // To set up a callback in the program to handle messages and the associated details,
     // we have to set up a debug messenger with a callback using the VK_EXT_debug_utils extension.
-    extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    if (settings.debugMessenger)
+    {
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
 
     return extensions;
 }
 
-bool areExtensionsSupported(
-    std::span<const vk::ExtensionProperties> propsList, std::span<const char* const> extensionNames)
+bool areInstanceExtensionsSupported(std::span<const char* const> extensionNames, Logging::ILogger& logger)
 {
-    const auto isExtensionSupported = [&propsList](const char* const extensionName)
-    {
-        std::println("Vulkan: Checking extension '{}'", extensionName);
-        return std::ranges::any_of(
-            propsList,
-            [extensionName](const vk::ExtensionProperties& props)
-            {
-                return std::string_view{ props.extensionName } == std::string_view{ extensionName };
-            });
-    };
-    return std::ranges::all_of(extensionNames, isExtensionSupported);
+    logger.debug("Vulkan: Checking instance extension support:");
+    return Renderer::Detail::areExtensionsSupported(
+        vk::enumerateInstanceExtensionProperties(nullptr), extensionNames, logger);
 }
 
-bool areInstanceExtensionsSupported(std::span<const char* const> extensionNames)
+bool arePhysicalDeviceExtensionsSupported(
+    const vk::raii::PhysicalDevice& physicalDevice, std::span<const char* const> extensionNames,
+    Logging::ILogger& logger)
 {
-    std::println("Vulkan: Checking instance extension support:");
-    return areExtensionsSupported(vk::enumerateInstanceExtensionProperties(nullptr), extensionNames);
+    logger.debug("Vulkan: Checking physical device extension support:");
+    return Renderer::Detail::areExtensionsSupported(
+        physicalDevice.enumerateDeviceExtensionProperties(), extensionNames, logger);
 }
 
-bool arePhysicalDeviceExtensionsSupported(
-    const vk::raii::PhysicalDevice& physicalDevice, std::span<const char* const> extensionNames)
+// What BindlessDescriptors needs. The device must have VK_EXT_descriptor_indexing.
+bool areDescriptorIndexingFeaturesSupported(const vk::raii::PhysicalDevice& physicalDevice, Logging::ILogger& logger)
 {
-    std::println("Vulkan: Checking physical device extension support:");
-    return areExtensionsSupported(physicalDevice.enumerateDeviceExtensionProperties(), extensionNames);
+    // The feature query needs Vulkan 1.1 on the device too.
+    if (physicalDevice.getProperties().apiVersion < VK_API_VERSION_1_1)
+    {
+        logger.debug("Vulkan: No Vulkan 1.1 for the descriptor indexing features.");
+        return false;
+    }
+    const auto features{ physicalDevice.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceDescriptorIndexingFeatures>() };
+    const auto& indexingFeatures{ features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>() };
+    const auto& baseFeatures{ features.get<vk::PhysicalDeviceFeatures2>().features };
+    const auto isSupported{ baseFeatures.shaderSampledImageArrayDynamicIndexing &&
+                            baseFeatures.shaderStorageBufferArrayDynamicIndexing &&
+                            indexingFeatures.descriptorBindingPartiallyBound &&
+                            indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+                            indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind &&
+                            indexingFeatures.descriptorBindingUpdateUnusedWhilePending };
+    logger.debug("Vulkan: Descriptor indexing features: {}", isSupported ? "supported" : "not supported");
+    return isSupported;
 }
 
-bool areInstanceLayersSupported(std::span<const char* const> layerNames)
+bool areInstanceLayersSupported(std::span<const char* const> layerNames, Logging::ILogger& logger)
 {
-    std::println("Vulkan: Checking instance layer support:");
+    logger.debug("Vulkan: Checking instance layer support:");
     const auto propsList = vk::enumerateInstanceLayerProperties();
-    const auto isLayerSupported = [&propsList](const char* const layerName)
+    const auto isLayerSupported = [&propsList, &logger](const char* const layerName)
     {
-        std::println("Vulkan: Checking layer '{}'", layerName);
+        logger.debug("Vulkan: Checking layer '{}'", layerName);
         return std::ranges::any_of(
             propsList,
             [layerName](const vk::LayerProperties& props)
@@ -81,26 +126,51 @@ bool areInstanceLayersSupported(std::span<const char* const> layerNames)
     return std::ranges::all_of(layerNames, isLayerSupported);
 }
 
+Logging::Severity toSeverity(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity)
+{
+    if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+    {
+        return Logging::Severity::Error;
+    }
+    if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+    {
+        return Logging::Severity::Warning;
+    }
+    if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT)
+    {
+        return Logging::Severity::Info;
+    }
+    return Logging::Severity::Debug;
+}
+
+// Called on whatever thread made the Vulkan call, so it must not block. pUserData is the logger.
 VKAPI_ATTR vk::Bool32 VKAPI_CALL debugUtilsMessengerCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageTypes,
     const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData)
 {
-    std::println("Vulkan: Validation message: {}", pCallbackData->pMessage);
+    auto& logger{ *static_cast<Logging::ILogger*>(pUserData) };
+    logger.log(toSeverity(messageSeverity), "Vulkan: Validation message: {}", pCallbackData->pMessage);
     return vk::False;
 }
 
-vk::raii::Instance createInstance(const vk::raii::Context& context, const Window::IWindow& window)
+vk::raii::Instance createInstance(
+    const vk::raii::Context& context, const Window::IWindow& window, const Renderer::RendererSettings& settings,
+    Logging::ILogger& logger)
 {
     const vk::ApplicationInfo applicationInfo{ "Vulkan test app", 1, "Custom engine", 1, VK_API_VERSION_1_1 };
 
-    const auto extensions = getInstanceExtensions(window);
+    const auto extensions = getInstanceExtensions(window, settings);
 
-    if (!areInstanceExtensionsSupported(extensions))
+    if (!areInstanceExtensionsSupported(extensions, logger))
     {
         throw Common::RendererError{ "Some required Vulkan instance extensions are not supported." };
     }
 
-    if (!areInstanceLayersSupported(s_requiredInstanceLayers))
+    // Validation checks every call. Without it the driver does only what it must.
+    const auto layers{ settings.validation ? std::span<const char* const>{ s_validationLayers }
+                                           : std::span<const char* const>{} };
+
+    if (!areInstanceLayersSupported(layers, logger))
     {
         throw Common::RendererError{ "Some required Vulkan instance layers are not supported." };
     }
@@ -108,8 +178,8 @@ vk::raii::Instance createInstance(const vk::raii::Context& context, const Window
     const vk::InstanceCreateInfo instanceCreateInfo{
         /* flags */ {},
         /* app info */ &applicationInfo,
-        /* enabled layer count */ Common::NarrowCast<uint32_t>(s_requiredInstanceLayers.size()),
-        /* enabled layer names */ s_requiredInstanceLayers.data(),
+        /* enabled layer count */ Common::NarrowCast<uint32_t>(layers.size()),
+        /* enabled layer names */ layers.data(),
         /* extension count */ Common::NarrowCast<uint32_t>(extensions.size()),
         /* extension names */ extensions.data()
     };
@@ -117,8 +187,15 @@ vk::raii::Instance createInstance(const vk::raii::Context& context, const Window
     return vk::raii::Instance{ context, instanceCreateInfo };
 }
 
-vk::raii::DebugUtilsMessengerEXT createDebugMessenger(const vk::raii::Instance& instance)
+// Null if the debug messenger is disabled.
+vk::raii::DebugUtilsMessengerEXT createDebugMessenger(
+    const vk::raii::Instance& instance, const Renderer::RendererSettings& settings, Logging::ILogger& logger)
 {
+    if (!settings.debugMessenger)
+    {
+        return vk::raii::DebugUtilsMessengerEXT{ nullptr };
+    }
+
     Renderer::Details::initDebugUtilsMessengerExtension(instance);
 
     const vk::DebugUtilsMessengerCreateInfoEXT messengerCreateInfo{
@@ -128,27 +205,33 @@ vk::raii::DebugUtilsMessengerEXT createDebugMessenger(const vk::raii::Instance&
         /* message type flags */ vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral |
             vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation | vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance |
             vk::DebugUtilsMessageTypeFlagBitsEXT::eDeviceAddressBinding,
-        /* callback */ debugUtilsMessengerCallback
+        /* callback */ debugUtilsMessengerCallback,
+        /* user data */ &logger
     };
 
     return instance.createDebugUtilsMessengerEXT(messengerCreateInfo);
 }
 
-vk::SurfaceFormatKHR chooseSwapchainFormat(std::span<const vk::SurfaceFormatKHR> formats)
+vk::SurfaceFormatKHR chooseSwapchainFormat(
+    std::span<const vk::SurfaceFormatKHR> formats, Renderer::SwapchainFormat preferredFormat, Logging::ILogger& logger)
 {
+    const auto isSrgb{ preferredFormat == Renderer::SwapchainFormat::Srgb };
+    const auto rgbaFormat{ isSrgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm };
+    const auto bgraFormat{ isSrgb ? vk::Format::eB8G8R8A8Srgb : vk::Format::eB8G8R8A8Unorm };
+
     // This is a special case.
     // It means that every format is available. So, we can freely pick any.
     if (formats.size() == 1 && formats[0].format == vk::Format::eUndefined)
     {
-        return { vk::Format::eR8G8B8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear };
+        return { rgbaFormat, vk::ColorSpaceKHR::eSrgbNonlinear };
     }
 
     // Try to find our required surface format.
     const auto it = std::ranges::find_if(
         formats,
-        [](const vk::SurfaceFormatKHR& format)
+        [rgbaFormat, bgraFormat](const vk::SurfaceFormatKHR& format)
         {
-            return (format.format == vk::Format::eR8G8B8A8Unorm || format.format == vk::Format::eB8G8R8A8Unorm) &&
+            return (format.format == rgbaFormat || format.format == bgraFormat) &&
                 format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear;
         });
     if (it != std::end(formats))
@@ -157,30 +240,44 @@ vk::SurfaceFormatKHR chooseSwapchainFormat(std::span<const vk::SurfaceFormatKHR>
     }
 
     // Fallback to the first one. Whatever that is.
-    std::println("Vulkan: Cannot find required surface format. Fallback to the first available one.");
+    logger.warning("Vulkan: Cannot find required surface format. Fallback to the first available one.");
     return formats[0];
 }
 
-vk::PresentModeKHR chooseSwapchainPresentationMode(std::span<const vk::PresentModeKHR> presentationModes)
+vk::PresentModeKHR toVkPresentMode(Renderer::PresentMode mode)
 {
-    const auto it = std::ranges::find_if(
-        presentationModes,
-        [](const vk::PresentModeKHR& mode)
-        {
-            return mode == vk::PresentModeKHR::eMailbox;
-        });
+    switch (mode)
+    {
+        case Renderer::PresentMode::Fifo:
+            return vk::PresentModeKHR::eFifo;
+        case Renderer::PresentMode::FifoRelaxed:
+            return vk::PresentModeKHR::eFifoRelaxed;
+        case Renderer::PresentMode::Mailbox:
+            return vk::PresentModeKHR::eMailbox;
+        case Renderer::PresentMode::Immediate:
+            return vk::PresentModeKHR::eImmediate;
+    }
+    return vk::PresentModeKHR::eFifo;
+}
+
+vk::PresentModeKHR chooseSwapchainPresentationMode(
+    std::span<const vk::PresentModeKHR> presentationModes, Renderer::PresentMode preferredMode,
+    Logging::ILogger& logger)
+{
+    const auto preferredVkMode{ toVkPresentMode(preferredMode) };
+    const auto it = std::ranges::find(presentationModes, preferredVkMode);
     if (it != std::end(presentationModes))
     {
         return *it;
     }
 
     // Fallback to FIFO mode. It should always be present according to the Vulkan spec.
-    std::println("Vulkan: Cannot find mailbox presentation mode. Fallback to FIFO.");
+    logger.warning("Vulkan: Cannot find {} presentation mode. Fallback to FIFO.", vk::to_string(preferredVkMode));
     return vk::PresentModeKHR::eFifo;
 }
 
 vk::Extent2D chooseSwapchainImageExtent(
-    const vk::SurfaceCapabilitiesKHR& surfaceCapabilities, const Window::IWindow& window)
+    const vk::SurfaceCapabilitiesKHR& surfaceCapabilities, std::pair<Common::Uint, Common::Uint> windowSize)
 {
     if (surfaceCapabilities.currentExtent.width != std::numeric_limits<std::uint32_t>::max())
     {
@@ -189,7 +286,6 @@ vk::Extent2D chooseSwapchainImageExtent(
     }
 
     // The current extent is not set. We must get it from the window manually.
-    auto windowSize{ window.getSize() };
     windowSize.first = std::min(windowSize.first, surfaceCapabilities.maxImageExtent.width);
     windowSize.first = std::max(windowSize.first, surfaceCapabilities.minImageExtent.width);
     windowSize.second = std::min(windowSize.second, surfaceCapabilities.maxImageExtent.width);
@@ -223,17 +319,28 @@ vk::raii::ImageView createImageView(
     return vk::raii::ImageView{ logicalDevice, imageViewCreateInfo };
 }
 
+// The oldSwapchain is retired by the new swapchain. It can be null.
+// With isCaptureNeeded the images can be copied from, if the surface supports it.
 Renderer::Detail::Swapchain createSwapchain(
-    const Window::IWindow& window, const vk::raii::SurfaceKHR& surface,
-    const Renderer::Detail::PhysicalDevice& physicalDevice, const vk::raii::Device& logicalDevice)
+    std::pair<Common::Uint, Common::Uint> windowSize, const vk::raii::SurfaceKHR& surface,
+    const Renderer::Detail::PhysicalDevice& physicalDevice, const vk::raii::Device& logicalDevice,
+    const Renderer::RendererSettings& settings, bool isCaptureNeeded, Logging::ILogger& logger,
+    vk::SwapchainKHR oldSwapchain = {})
 {
     const auto surfaceCapabilities{ physicalDevice.device.getSurfaceCapabilitiesKHR(surface) };
 
-    const auto format{ chooseSwapchainFormat(physicalDevice.device.getSurfaceFormatsKHR(surface)) };
+    const auto format{ chooseSwapchainFormat(
+        physicalDevice.device.getSurfaceFormatsKHR(surface), settings.swapchainFormat, logger) };
     const auto presentationMode{ chooseSwapchainPresentationMode(
-        physicalDevice.device.getSurfacePresentModesKHR(surface)) };
-    const auto imageExtent{ chooseSwapchainImageExtent(surfaceCapabilities, window) };
+        physicalDevice.device.getSurfacePresentModesKHR(surface), settings.presentMode, logger) };
+    const auto imageExtent{ chooseSwapchainImageExtent(surfaceCapabilities, windowSize) };
     const auto imageCount{ chooseSwapchainImageCount(surfaceCapabilities) };
+    // Only requested for captures. It can cost performance (e.g. no framebuffer compression on some GPUs).
+    auto imageUsage{ vk::ImageUsageFlags{ vk::ImageUsageFlagBits::eColorAttachment } };
+    if (isCaptureNeeded && (surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferSrc))
+    {
+        imageUsage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
 
     vk::SwapchainCreateInfoKHR swapchainCreateInfo{};
     swapchainCreateInfo.setSurface(surface);
@@ -244,10 +351,12 @@ Renderer::Detail::Swapchain createSwapchain(
     swapchainCreateInfo.setMinImageCount(imageCount);
     // Number of layers for each image in the swapchain.
     swapchainCreateInfo.setImageArrayLayers(1);
-    swapchainCreateInfo.setImageUsage(vk::ImageUsageFlagBits::eColorAttachment);
+    swapchainCreateInfo.setImageUsage(imageUsage);
     swapchainCreateInfo.setPreTransform(surfaceCapabilities.currentTransform);
     // Clip parts of the image not being in view (e.g. by another OS window).
     swapchainCreateInfo.setClipped(true);
+    // Images of the old swapchain that are already acquired remain valid until presented.
+    swapchainCreateInfo.setOldSwapchain(oldSwapchain);
 
     if (physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex !=
         physicalDevice.queueFamilyInfo.presentationQueueFamilyIndex)
@@ -271,11 +380,14 @@ Renderer::Detail::Swapchain createSwapchain(
             image, createImageView(logicalDevice, image, format.format, vk::ImageAspectFlagBits::eColor));
     }
 
-    return Renderer::Detail::Swapchain{ std::move(swapchain), format.format, imageExtent, std::move(imageAndViewList) };
+    return Renderer::Detail::Swapchain{
+        std::move(swapchain), format.format, imageExtent, imageUsage, std::move(imageAndViewList)
+    };
 }
 
+// The presentation queue family must support every surface, so one present call can present to all of them.
 Renderer::Detail::QueueFamilyInfo getQueueFamilyInfo(
-    const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::SurfaceKHR& surface)
+    const vk::raii::PhysicalDevice& physicalDevice, std::span<const vk::raii::SurfaceKHR> surfaces)
 {
     Renderer::Detail::QueueFamilyInfo qfInfo{};
     const auto queuePropsList = physicalDevice.getQueueFamilyProperties();
@@ -289,39 +401,135 @@ Renderer::Detail::QueueFamilyInfo getQueueFamilyInfo(
             qfInfo.graphicsQueueFamilyIndex = i;
         }
 
-        // Check if this queue family supports presentation to a
-        // surface (i.e. if it's a Presentation Queue Family).
-        if (props.queueCount > 0 && physicalDevice.getSurfaceSupportKHR(i, *surface))
+        // Check if this queue family supports presentation to the
+        // surfaces (i.e. if it's a Presentation Queue Family).
+        if (props.queueCount > 0 && std::ranges::all_of(
+                                        surfaces,
+                                        [&physicalDevice, i](const vk::raii::SurfaceKHR& surface)
+                                        {
+                                            return physicalDevice.getSurfaceSupportKHR(i, *surface);
+                                        }))
         {
             qfInfo.presentationQueueFamilyIndex = i;
         }
+
+        // A compute-only queue family runs compute work asynchronously to the graphics work.
+        if (props.queueCount > 0 && (props.queueFlags & vk::QueueFlagBits::eCompute) &&
+            !(props.queueFlags & vk::QueueFlagBits::eGraphics))
+        {
+            qfInfo.computeQueueFamilyIndex = i;
+        }
+    }
+
+    // Fallback to the graphics family. The Vulkan spec guarantees a family with both graphics and compute if
+    // there is graphics at all.
+    if (!qfInfo.computeQueueFamilyIndex.has_value())
+    {
+        qfInfo.computeQueueFamilyIndex = qfInfo.graphicsQueueFamilyIndex;
     }
     return qfInfo;
 }
 
-void printPhysicalDeviceInfo(const vk::raii::PhysicalDevice& device)
+void printPhysicalDeviceInfo(const vk::raii::PhysicalDevice& device, Logging::ILogger& logger)
 {
     const auto props = device.getProperties();
-    std::println("Vulkan: Physical device name: {}", std::string_view{ props.deviceName });
+    logger.info("Vulkan: Physical device name: {}", std::string_view{ props.deviceName });
+}
+
+Renderer::PresentTimingSource getPresentTimingSource(const vk::raii::PhysicalDevice& physicalDevice)
+{
+    const auto propsList{ physicalDevice.enumerateDeviceExtensionProperties() };
+    const auto isExtensionSupported = [&propsList](std::string_view extensionName)
+    {
+        return std::ranges::any_of(
+            propsList,
+            [extensionName](const vk::ExtensionProperties& props)
+            {
+                return std::string_view{ props.extensionName } == extensionName;
+            });
+    };
+
+    // The feature query needs Vulkan 1.1 on the device too.
+    if (physicalDevice.getProperties().apiVersion >= VK_API_VERSION_1_1 &&
+        isExtensionSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        isExtensionSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        const auto features{ physicalDevice.getFeatures2<
+            vk::PhysicalDeviceFeatures2,
+            vk::PhysicalDevicePresentIdFeaturesKHR,
+            vk::PhysicalDevicePresentWaitFeaturesKHR>() };
+        if (features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId &&
+            features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait)
+        {
+            return Renderer::PresentTimingSource::PresentWait;
+        }
+    }
+    if (isExtensionSupported(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME))
+    {
+        return Renderer::PresentTimingSource::DisplayTiming;
+    }
+    return Renderer::PresentTimingSource::Cpu;
 }
 
+// The device is Vulkan 1.1, so the memory properties query the extension needs is there.
+bool isMemoryBudgetSupported(const vk::raii::PhysicalDevice& physicalDevice)
+{
+    return std::ranges::any_of(
+        physicalDevice.enumerateDeviceExtensionProperties(),
+        [](const vk::ExtensionProperties& props)
+        {
+            return std::string_view{ props.extensionName } == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+        });
+}
+
+// Picks the first suitable device whose name contains preferredDevice.
+// Fallback to the first suitable device if there is no such device.
 Renderer::Detail::PhysicalDevice getPhysicalDevice(
-    const vk::raii::Instance& instance, const vk::raii::SurfaceKHR& surface)
+    const vk::raii::Instance& instance, std::span<const vk::raii::SurfaceKHR> surfaces,
+    std::string_view preferredDevice, Logging::ILogger& logger)
 {
+    std::optional<Renderer::Detail::PhysicalDevice> firstSuitableDevice{};
     const auto physicalDevices = instance.enumeratePhysicalDevices();
     for (auto i = 0u; i != physicalDevices.size(); ++i)
     {
         const auto& physicalDevice{ physicalDevices[i] };
-        const auto queueFamilyInfo = getQueueFamilyInfo(physicalDevice, surface);
+        const auto queueFamilyInfo = getQueueFamilyInfo(physicalDevice, surfaces);
         if (queueFamilyInfo.graphicsQueueFamilyIndex.has_value() &&
             queueFamilyInfo.presentationQueueFamilyIndex.has_value() &&
-            arePhysicalDeviceExtensionsSupported(physicalDevice, s_requiredPhysicalDeviceExtensions) &&
-            !physicalDevice.getSurfacePresentModesKHR(surface).empty() &&
-            !physicalDevice.getSurfaceFormatsKHR(surface).empty())
+            arePhysicalDeviceExtensionsSupported(physicalDevice, s_requiredPhysicalDeviceExtensions, logger) &&
+            areDescriptorIndexingFeaturesSupported(physicalDevice, logger) &&
+            std::ranges::all_of(
+                surfaces,
+                [&physicalDevice](const vk::raii::SurfaceKHR& surface)
+                {
+                    return !physicalDevice.getSurfacePresentModesKHR(surface).empty() &&
+                           !physicalDevice.getSurfaceFormatsKHR(surface).empty();
+                }))
         {
-            return { physicalDevice, queueFamilyInfo, i };
+            const std::string_view deviceName{ physicalDevice.getProperties().deviceName };
+            if (preferredDevice.empty() || deviceName.find(preferredDevice) != std::string_view::npos)
+            {
+                return { physicalDevice,
+                         queueFamilyInfo,
+                         i,
+                         getPresentTimingSource(physicalDevice),
+                         isMemoryBudgetSupported(physicalDevice) };
+            }
+            if (!firstSuitableDevice.has_value())
+            {
+                firstSuitableDevice = Renderer::Detail::PhysicalDevice{ physicalDevice,
+                                                                        queueFamilyInfo,
+                                                                        i,
+                                                                        getPresentTimingSource(physicalDevice),
+                                                                        isMemoryBudgetSupported(physicalDevice) };
+            }
         }
     }
+    if (firstSuitableDevice.has_value())
+    {
+        logger.warning("Vulkan: Cannot find device '{}'. Fallback to the first suitable one.", preferredDevice);
+        return std::move(*firstSuitableDevice);
+    }
     throw Common::RendererError{ "Cannot find suitable physical device." };
 }
 
@@ -336,6 +544,10 @@ std::unordered_set<uint32_t> getUniqueQueueFamilyIndices(const Renderer::Detail:
     {
         indices.insert(*qfInfo.presentationQueueFamilyIndex);
     }
+    if (qfInfo.computeQueueFamilyIndex.has_value())
+    {
+        indices.insert(*qfInfo.computeQueueFamilyIndex);
+    }
     return indices;
 }
 
@@ -357,16 +569,63 @@ vk::raii::Device createLogicalDevice(const Renderer::Detail::PhysicalDevice& phy
                                        /* queuePriorities */ queuePriorities.data() });
     }
 
-    const vk::DeviceCreateInfo deviceCreateInfo{
-        /* flags */ {},
-        /* queue create info count */ Common::NarrowCast<uint32_t>(queueCreateInfos.size()),
-        /* queue create infos */ queueCreateInfos.data(),
-        /* enabled layer count */ 0,
-        /* enabled layer names */ nullptr,
-        /* extension count */ s_requiredPhysicalDeviceExtensions.size(),
-        /* extension names */ s_requiredPhysicalDeviceExtensions.data()
-    };
-    return physicalDevice.device.createDevice(deviceCreateInfo);
+    std::vector<const char*> extensions(
+        s_requiredPhysicalDeviceExtensions.begin(), s_requiredPhysicalDeviceExtensions.end());
+    switch (physicalDevice.presentTimingSource)
+    {
+        case Renderer::PresentTimingSource::PresentWait:
+            extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            break;
+        case Renderer::PresentTimingSource::DisplayTiming:
+            extensions.push_back(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+            break;
+        case Renderer::PresentTimingSource::Cpu:
+            break;
+    }
+    if (physicalDevice.hasMemoryBudget)
+    {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // Enabled if the device has them. Without them, the BC textures are not loaded and the clusters are culled on the
+    // CPU.
+    const auto supportedFeatures{ physicalDevice.device.getFeatures() };
+    vk::PhysicalDeviceFeatures enabledFeatures{};
+    enabledFeatures.setTextureCompressionBC(supportedFeatures.textureCompressionBC);
+    enabledFeatures.setMultiDrawIndirect(supportedFeatures.multiDrawIndirect);
+    // Checked when the device was picked. For the bindless descriptors.
+    enabledFeatures.setShaderSampledImageArrayDynamicIndexing(true);
+    enabledFeatures.setShaderStorageBufferArrayDynamicIndexing(true);
+    vk::PhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+    descriptorIndexingFeatures.setDescriptorBindingPartiallyBound(true);
+    descriptorIndexingFeatures.setDescriptorBindingSampledImageUpdateAfterBind(true);
+    descriptorIndexingFeatures.setDescriptorBindingStorageBufferUpdateAfterBind(true);
+    descriptorIndexingFeatures.setDescriptorBindingUpdateUnusedWhilePending(true);
+
+    vk::StructureChain<
+        vk::DeviceCreateInfo,
+        vk::PhysicalDeviceDescriptorIndexingFeatures,
+        vk::PhysicalDevicePresentIdFeaturesKHR,
+        vk::PhysicalDevicePresentWaitFeaturesKHR>
+        deviceCreateInfo{ vk::DeviceCreateInfo{
+                              /* flags */ {},
+                              /* queue create info count */ Common::NarrowCast<uint32_t>(queueCreateInfos.size()),
+                              /* queue create infos */ queueCreateInfos.data(),
+                              /* enabled layer count */ 0,
+                              /* enabled layer names */ nullptr,
+                              /* extension count */ Common::NarrowCast<uint32_t>(extensions.size()),
+                              /* extension names */ extensions.data(),
+                              /* enabled features */ &enabledFeatures },
+                          descriptorIndexingFeatures,
+                          vk::PhysicalDevicePresentIdFeaturesKHR{ /* presentId */ true },
+                          vk::PhysicalDevicePresentWaitFeaturesKHR{ /* presentWait */ true } };
+    if (physicalDevice.presentTimingSource != Renderer::PresentTimingSource::PresentWait)
+    {
+        deviceCreateInfo.unlink<vk::PhysicalDevicePresentIdFeaturesKHR>();
+        deviceCreateInfo.unlink<vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    }
+    return physicalDevice.device.createDevice(deviceCreateInfo.get<vk::DeviceCreateInfo>());
 }
 
 vk::raii::ShaderModule createShaderModule(const vk::raii::Device& device, std::span<const std::byte> spirvBinary)
@@ -378,108 +637,93 @@ vk::raii::ShaderModule createShaderModule(const vk::raii::Device& device, std::s
     return vk::raii::ShaderModule{ device, createInfo };
 }
 
-vk::raii::RenderPass createRenderPass(const vk::raii::Device& device, vk::Format colorAttachmentFormat)
+// Starts loading every shader the settings need. Nothing waits for them until the pipelines are created.
+Renderer::Detail::ShaderBinaries loadShaders(
+    Assets::IAssetLoader& assetLoader, const Renderer::RendererSettings& settings)
 {
-    //
-    // The color attachment image layout goes through the following conversions during the
-    // render pass:
-    //
-    // 1. Begin render pass: Expected as Undefined (no conversion).
-    // 2. Begin sub pass: Converted to ColorAttachmentOptimal.
-    // 3. End render pass: Converted to PresentSrcKHR.
-    //
-
-    const std::array<vk::AttachmentDescription, 1> attachmentDescriptions{
-        // Color attachment description of the entire render pass.
-        vk::AttachmentDescription{ /* flags */ {},
-                                   /* format */ colorAttachmentFormat,
-                                   // Number of samples to write for multisampling.
-                                   /* samples */ vk::SampleCountFlagBits::e1,
-                                   // What to do with color attachment when the render pass starts.
-                                   // The clear-value is defined by RenderPassBeginInfo.
-                                   /* loadOp */ vk::AttachmentLoadOp::eClear,
-                                   // What to do with color attachment when the render pass ends.
-                                   /* storeOp */ vk::AttachmentStoreOp::eStore,
-                                   // What to do with stencil attachment when the render pass starts.
-                                   /* loadOp */ vk::AttachmentLoadOp::eDontCare,
-                                   // What to do with stencil attachment when the render pass ends.
-                                   /* storeOp */ vk::AttachmentStoreOp::eDontCare,
-                                   // Image data layout before render pass. We don't care.
-                                   /* initialLayout_ */ vk::ImageLayout::eUndefined,
-                                   // Image data layout after render pass. Will be the source for presentation.
-                                   /* finalLayout_ */ vk::ImageLayout::ePresentSrcKHR }
-    };
-
-    const std::array<vk::AttachmentReference, 1> colorAttachmentsRefs{ vk::AttachmentReference{
-        // References an attachment by index from the render pass.
-        /* attachment */ 0,
-        /* layout */ vk::ImageLayout::eColorAttachmentOptimal } };
-
-    const std::array<vk::SubpassDescription, 1> subpasses{
-        // Subpass 0
-        vk::SubpassDescription{ /* flags */ {},
-                                // The pipeline type of the subpass.
-                                /* pipelineBindPoint */ vk::PipelineBindPoint::eGraphics,
-                                /* pInputAttachments */ {},
-                                /* pColorAttachments */ colorAttachmentsRefs }
+    const auto load = [&assetLoader](const char* path)
+    {
+        return assetLoader.loadFile(path, Assets::LoadPriority::High).share();
     };
 
-    //
-    // To see what pipeline stages a certain access can happen in, see:
-    // https://registry.khronos.org/vulkan/specs/latest/man/html/VkAccessFlagBits.html
-    //
-    const std::array<vk::SubpassDependency, 2> subpassDependencies{
-        // When going from subpass "External" to subpass 0,
-        // the conversion from Undefined to ColorAttachmentOptimal
-        // has to happen after (stage: BottomOfPipe, access: MemoryRead)
-        // but before (stage: ColorAttachmentOutput, access: ColorAttachmentRead | ColorAttachmentWrite).
-        vk::SubpassDependency{ /* srcSubpass */ vk::SubpassExternal,
-                               // 0 is the index of the first subpass.
-                               /* dstSubpass */ 0,
-                               // BottomOfPipe means the end of the pipeline.
-                               /* srcStageMask */ vk::PipelineStageFlagBits::eBottomOfPipe,
-                               /* dstStageMask */ vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                               /* srcAccessMask */ vk::AccessFlagBits::eMemoryRead,
-                               /* dstAccessMask */ vk::AccessFlagBits::eColorAttachmentRead |
-                                   vk::AccessFlagBits::eColorAttachmentWrite },
-        // When going from subpass 0 to subpass "External",
-        // the conversion from ColorAttachmentOptimal to PresentSrcKHR
-        // has to happen after (stage: ColorAttachmentOutput, access: ColorAttachmentRead | ColorAttachmentWrite)
-        // but before (stage: eBottomOfPipe, access: MemoryRead).
-        vk::SubpassDependency{ /* srcSubpass */ 0,
-                               /* dstSubpass */ vk::SubpassExternal,
-                               /* srcStageMask */ vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                               // BottomOfPipe means the end of the pipeline.
-                               /* dstStageMask */ vk::PipelineStageFlagBits::eBottomOfPipe,
-                               /* srcAccessMask */ vk::AccessFlagBits::eColorAttachmentRead |
-                                   vk::AccessFlagBits::eColorAttachmentWrite,
-                               /* dstAccessMask */ vk::AccessFlagBits::eMemoryRead }
-    };
-
-    const vk::RenderPassCreateInfo renderPassCI{ /* flags */ {},
-                                                 /* pAttachments */ attachmentDescriptions,
-                                                 /* pSubpasses */ subpasses,
-                                                 /* pDependencies */ subpassDependencies };
-
-    return device.createRenderPass(renderPassCI);
-}
-
-vk::raii::PipelineLayout createPipelineLayout(const vk::raii::Device& device)
-{
-    // Apply descriptor set layouts.
-    const vk::PipelineLayoutCreateInfo layoutCI{};
-    return device.createPipelineLayout(layoutCI);
+    Renderer::Detail::ShaderBinaries shaders{};
+    shaders.vertex = load("./renderer/shaders/vert.spv");
+    shaders.fragment = load("./renderer/shaders/frag.spv");
+    if (settings.depthPrePass)
+    {
+        shaders.depthVertex = load("./renderer/shaders/depth.vert.spv");
+    }
+    if (settings.particleCount != 0)
+    {
+        shaders.particleVertex = load("./renderer/shaders/particle.vert.spv");
+        shaders.particleFragment = load("./renderer/shaders/particle.frag.spv");
+        shaders.particleEmit = load("./renderer/shaders/particle_emit.comp.spv");
+        shaders.particlePrepare = load("./renderer/shaders/particle_prepare.comp.spv");
+        shaders.particleSimulate = load("./renderer/shaders/particle_simulate.comp.spv");
+        shaders.particleCompact = load("./renderer/shaders/particle_compact.comp.spv");
+    }
+    if (settings.clusterCulling == Renderer::ClusterCullingMode::Gpu)
+    {
+        shaders.clusterCull = load("./renderer/shaders/cluster_cull.comp.spv");
+    }
+    return shaders;
+}
+
+vk::Format chooseDepthFormat(const vk::raii::PhysicalDevice& physicalDevice, Renderer::DepthFormat preferredFormat)
+{
+    // In order of preference. We don't use stencil, so the pure depth format comes first.
+    std::vector<vk::Format> candidates{ vk::Format::eD32Sfloat,
+                                        vk::Format::eD32SfloatS8Uint,
+                                        vk::Format::eD24UnormS8Uint };
+    switch (preferredFormat)
+    {
+        case Renderer::DepthFormat::Auto:
+            break;
+        case Renderer::DepthFormat::D32:
+            candidates.insert(candidates.begin(), vk::Format::eD32Sfloat);
+            break;
+        case Renderer::DepthFormat::D32S8:
+            candidates.insert(candidates.begin(), vk::Format::eD32SfloatS8Uint);
+            break;
+        case Renderer::DepthFormat::D24S8:
+            candidates.insert(candidates.begin(), vk::Format::eD24UnormS8Uint);
+            break;
+        case Renderer::DepthFormat::D16:
+            // Half the bandwidth. Enough precision for small depth ranges.
+            candidates.insert(candidates.begin(), vk::Format::eD16Unorm);
+            break;
+    }
+
+    for (const auto format : candidates)
+    {
+        const auto props{ physicalDevice.getFormatProperties(format) };
+        if (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment)
+        {
+            return format;
+        }
+    }
+    throw Common::RendererError{ "Cannot find supported depth format." };
+}
+
+vk::raii::PipelineLayout createPipelineLayout(
+    const vk::raii::Device& device, const vk::raii::DescriptorSetLayout& bindlessDescriptorSetLayout)
+{
+    // Set 0 is the bindless set. The fragment shader gets the texture of the mesh as a push constant (see DrawList).
+    // The depth pre-pass shares the layout but uses neither.
+    const std::array<vk::DescriptorSetLayout, 1> setLayouts{ bindlessDescriptorSetLayout };
+    const std::array<vk::PushConstantRange, 1> pushConstantRanges{
+        vk::PushConstantRange{ vk::ShaderStageFlagBits::eFragment, /* offset */ 0, sizeof(std::uint32_t) }
+    };
+    return device.createPipelineLayout(vk::PipelineLayoutCreateInfo{ /* flags */ {}, setLayouts, pushConstantRanges });
 }
 
 vk::raii::Pipeline createPipeline(
-    Common::IFileSystem& fileSystem, const vk::raii::Device& device, const vk::Extent2D& viewportSize,
-    const vk::raii::RenderPass& renderPass, const vk::raii::PipelineLayout& pipelineLayout)
+    std::span<const std::byte> vertexShaderSpv, std::span<const std::byte> fragmentShaderSpv,
+    const vk::raii::Device& device, const vk::raii::RenderPass& renderPass,
+    const vk::raii::PipelineLayout& pipelineLayout, const Renderer::RendererSettings& settings)
 {
     // -- SHADER MODULES
 
-    const auto vertexShaderSpv{ fileSystem.readFile("./renderer/shaders/vert.spv") };
-    const auto fragmentShaderSpv{ fileSystem.readFile("./renderer/shaders/frag.spv") };
-
     // The shader modules don't need to be retained.
     auto vertexShaderModule{ createShaderModule(device, vertexShaderSpv) };
     auto fragmentShaderModule{ createShaderModule(device, fragmentShaderSpv) };
@@ -509,7 +753,7 @@ vk::raii::Pipeline createPipeline(
             /* inputRate */ vk::VertexInputRate::eVertex }
     };
 
-    const std::array<vk::VertexInputAttributeDescription, 2> vertexInputAttributeDescriptions{
+    const std::array<vk::VertexInputAttributeDescription, 3> vertexInputAttributeDescriptions{
         // Vertex position.
         vk::VertexInputAttributeDescription{ /* location */ 0,
                                              /* binding */ 0,
@@ -519,7 +763,12 @@ vk::raii::Pipeline createPipeline(
         vk::VertexInputAttributeDescription{ /* location */ 1,
                                              /* binding */ 0,
                                              vk::Format::eR32G32B32Sfloat,
-                                             /* offset */ offsetof(Geometry::Vertex, color) }
+                                             /* offset */ offsetof(Geometry::Vertex, color) },
+        // Texture coordinate.
+        vk::VertexInputAttributeDescription{ /* location */ 2,
+                                             /* binding */ 0,
+                                             vk::Format::eR32G32Sfloat,
+                                             /* offset */ offsetof(Geometry::Vertex, texCoord) }
     };
 
     const vk::PipelineVertexInputStateCreateInfo vertexInputStateCI{
@@ -538,23 +787,18 @@ vk::raii::Pipeline createPipeline(
 
     // -- VIEWPORT & SCISSOR
 
-    const std::array<vk::Viewport, 1> viewports{ vk::Viewport{
-        /* x */ 0,
-        /* y */ 0,
-        /* width */ Common::NarrowCast<float>(viewportSize.width),
-        /* height */ Common::NarrowCast<float>(viewportSize.height),
-        /* minDepth */ 0.0f,
-        /* maxDepth */ 1.0f } };
-    const std::array<vk::Rect2D, 1> scissors{ vk::Rect2D{ /* offset */ { 0, 0 }, /* extent */ viewportSize } };
+    // Set by recordViewport() when recording, so the pipeline works with every swapchain extent.
     const vk::PipelineViewportStateCreateInfo viewportStateCI{ /* flags */ {},
-                                                               /* viewports */ viewports,
-                                                               /* scissors */ scissors };
+                                                               /* viewportCount */ 1,
+                                                               /* pViewports */ nullptr,
+                                                               /* scissorCount */ 1,
+                                                               /* pScissors */ nullptr };
 
     // -- DYNAMIC STATE
 
-    // We don't use dynamic states for now.
-    // This could be used for example to resize the viewport/scissor with a command
-    // in the command buffer. For example, when the OS window is being resized.
+    // The viewport and the scissor. The windows can have different sizes and can be resized, but they all share
+    // this pipeline.
+    const vk::PipelineDynamicStateCreateInfo dynamicStateCI{ /* flags */ {}, /* dynamicStates */ s_dynamicStates };
 
     // -- RASTERIZER
 
@@ -618,12 +862,21 @@ vk::raii::Pipeline createPipeline(
 
     // -- DEPTH STENCIL TESTING
 
-    // TODO
+    // Without pre-pass: Keep the closest fragment.
+    // With pre-pass: The depth buffer already holds the closest depth. Shade only the fragment that produced it.
+    const vk::PipelineDepthStencilStateCreateInfo depthStencilStateCI{
+        /* flags */ {},
+        /* depthTestEnable */ true,
+        /* depthWriteEnable */ !settings.depthPrePass,
+        /* depthCompareOp */ settings.depthPrePass ? vk::CompareOp::eEqual : vk::CompareOp::eLess,
+        /* depthBoundsTestEnable */ false,
+        /* stencilTestEnable */ false
+    };
 
     // == CREATE THE PIPELINE
 
     // We have to create a separate pipeline for each subpass of the render pass.
-    // Here we create a pipeline for subpass 0.
+    // The render passes of the render graph have a single subpass.
     const vk::GraphicsPipelineCreateInfo gfxPipelineCI{
         /* flags */ {},
         /* stages */ shaderStageCIs,
@@ -633,9 +886,9 @@ vk::raii::Pipeline createPipeline(
         /* pViewportState */ &viewportStateCI,
         /* pRasterizationState */ &rasterizationStateCI,
         /* pMultisampleState */ &multisampleStateCI,
-        /* pDepthStencilState */ nullptr,
+        /* pDepthStencilState */ &depthStencilStateCI,
         /* pColorBlendState */ &colorBlendStateCI,
-        /* pDynamicState */ nullptr,
+        /* pDynamicState */ &dynamicStateCI,
         /* layout */ pipelineLayout,
         // Tell what kind of Render Pass this Pipeline is compatible with.
         // It's NOT going to store a reference to this specific Render Pass.
@@ -646,196 +899,615 @@ vk::raii::Pipeline createPipeline(
     return device.createGraphicsPipeline(nullptr, gfxPipelineCI);
 }
 
-std::vector<vk::raii::Framebuffer> createFramebuffers(
-    const vk::raii::Device& device, const Renderer::Detail::Swapchain& swapchain,
-    const vk::raii::RenderPass& renderPass)
+// Same fixed function setup as createPipeline() but it only writes depth.
+vk::raii::Pipeline createDepthPrePassPipeline(
+    std::span<const std::byte> vertexShaderSpv, const vk::raii::Device& device,
+    const vk::raii::RenderPass& renderPass, const vk::raii::PipelineLayout& pipelineLayout)
 {
-    std::vector<vk::raii::Framebuffer> framebuffers;
-    framebuffers.reserve(swapchain.images.size());
+    // -- SHADER MODULES
 
-    for (const auto& swapchainImage : swapchain.images)
-    {
-        // These attachments must match with the attachment descriptions of the Render Pass.
-        const std::array<vk::ImageView, 1> imageViewAttachments{ swapchainImage.imageView };
+    auto vertexShaderModule{ createShaderModule(device, vertexShaderSpv) };
 
-        const vk::FramebufferCreateInfo framebufferCI{
-            /* flags */ {},
-            // Tell what kind of Render Pass this Framebuffer is compatible with.
-            // It's NOT going to store a reference to this specific Render Pass.
-            /* renderPass */ renderPass,
-            /* pAttachments */ imageViewAttachments,
-            /* width */ swapchain.imageExtent.width,
-            /* height */ swapchain.imageExtent.height,
-            /* layers */ 1
-        };
+    // No fragment shader. The depth comes from the rasterizer.
+    const std::array<vk::PipelineShaderStageCreateInfo, 1> shaderStageCIs{ vk::PipelineShaderStageCreateInfo{
+        /* flags */ {}, /* stage */ vk::ShaderStageFlagBits::eVertex, vertexShaderModule, "main" } };
 
-        framebuffers.push_back(device.createFramebuffer(framebufferCI));
-    }
+    // -- VERTEX INPUT
 
-    return framebuffers;
-}
+    // Same vertex buffer as the color pass, but only the position is fetched.
+    const std::array<vk::VertexInputBindingDescription, 1> vertexInputBindingDescriptions{
+        vk::VertexInputBindingDescription{ /* binding */ 0,
+                                           /* stride */ sizeof(Geometry::Vertex),
+                                           /* inputRate */ vk::VertexInputRate::eVertex }
+    };
+    const std::array<vk::VertexInputAttributeDescription, 1> vertexInputAttributeDescriptions{
+        vk::VertexInputAttributeDescription{ /* location */ 0,
+                                             /* binding */ 0,
+                                             vk::Format::eR32G32B32Sfloat,
+                                             /* offset */ offsetof(Geometry::Vertex, position) }
+    };
+    const vk::PipelineVertexInputStateCreateInfo vertexInputStateCI{
+        /* flags */ {},
+        /* pVertexBindingDescriptions */ vertexInputBindingDescriptions,
+        /* pVertexAttributeDescriptions */ vertexInputAttributeDescriptions
+    };
 
-vk::raii::CommandPool createGraphicsCommandPool(const vk::raii::Device& device, std::uint32_t graphicsQueueFamilyIndex)
-{
-    const vk::CommandPoolCreateInfo commandPoolCI{ /* flags */ {},
-                                                   /* queueFamilyIndex */ graphicsQueueFamilyIndex };
-    return device.createCommandPool(commandPoolCI);
-}
+    // -- FIXED FUNCTION STATES
 
-std::vector<vk::raii::CommandBuffer> createCommandBuffers(
-    const vk::raii::Device& device, const vk::raii::CommandPool& commandPool, std::uint32_t count)
-{
-    const vk::CommandBufferAllocateInfo commandBufferAI{
-        /* commandPool */ commandPool,
-        // A Primary command buffer can be executed directly from a queue.
-        // A Secondary command buffer can be executed only from a Primary command buffer.
-        /* level */ vk::CommandBufferLevel::ePrimary,
-        /* commandBufferCount */ count
+    const vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateCI{
+        /* flags */ {},
+        /* topology */ vk::PrimitiveTopology::eTriangleList,
+        /* primitiveRestartEnable */ false
     };
-    return device.allocateCommandBuffers(commandBufferAI);
-}
 
-void recordCommands(
-    std::span<const vk::raii::CommandBuffer> commandBuffers, const vk::raii::RenderPass& renderPass,
-    std::span<const vk::raii::Framebuffer> framebuffers, const vk::Extent2D& swapchainImageExtent,
-    const vk::raii::Pipeline& pipeline, const Renderer::Mesh& mesh)
-{
-    assert(commandBuffers.size() == framebuffers.size());
+    // Dynamic, like in createPipeline().
+    const vk::PipelineViewportStateCreateInfo viewportStateCI{ /* flags */ {},
+                                                               /* viewportCount */ 1,
+                                                               /* pViewports */ nullptr,
+                                                               /* scissorCount */ 1,
+                                                               /* pScissors */ nullptr };
+    const vk::PipelineDynamicStateCreateInfo dynamicStateCI{ /* flags */ {}, /* dynamicStates */ s_dynamicStates };
 
-    const vk::CommandBufferBeginInfo cmdBufferBI{
-        // eSimultaneousUse means this command buffer may be in the queue (submitted) multiple times.
-        // We don't set that because only one instance of this command buffer will be in the queue at once.
-        // We use fences to ensure that (i.e. m_drawFence).
-        /* flags */ vk::CommandBufferUsageFlags{}
+    // Culling must match the color pass, otherwise the depth of back faces could hide front faces.
+    const vk::PipelineRasterizationStateCreateInfo rasterizationStateCI{
+        /* flags */ {},
+        /* depthClampEnable */ false,
+        /* rasterizerDiscardEnable */ false,
+        /* polygonMode */ vk::PolygonMode::eFill,
+        /* cullMode */ vk::CullModeFlagBits::eBack,
+        /* frontFace */ vk::FrontFace::eClockwise,
+        /* depthBiasEnable */ false,
+        /* depthBiasConstantFactor */ {},
+        /* depthBiasClamp */ {},
+        /* depthBiasSlopeFactor */ {},
+        /* lineWidth */ 1.0f
     };
 
-    const std::array<vk::ClearValue, 1> clearValues{ // Clear value for the color attachment.
-                                                     vk::ClearValue{ vk::ClearColorValue{ 0.5f, 0.5f, 0.5f, 0.5f } }
+    const vk::PipelineMultisampleStateCreateInfo multisampleStateCI{
+        /* flags */ {},
+        /* rasterizationSamples */ vk::SampleCountFlagBits::e1,
+        /* sampleShadingEnable */ false
     };
 
-    // We have a separate Command Buffer for each Framebuffer / Swapchain Image.
-    for (auto i{ 0u }; i != commandBuffers.size(); ++i)
-    {
-        auto& commandBuffer{ commandBuffers[i] };
-        commandBuffer.begin(cmdBufferBI);
-
-        {
-            commandBuffer.beginRenderPass(
-                vk::RenderPassBeginInfo{ /* renderPass */ renderPass,
-                                         /* framebuffer */ framebuffers[i],
-                                         /* renderArea */ vk::Rect2D{ vk::Offset2D{ 0, 0 }, swapchainImageExtent },
-                                         /* pClearValues */ clearValues },
-                // eInline specifies that the contents of the subpasses will be recorded inline in the primary command
-                // buffer, and secondary command buffers must not be executed within the subpass.
-                vk::SubpassContents::eInline);
-
-            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
-
-            const std::array<const vk::Buffer, 1> buffers{ mesh.getVertexBuffer() };
-            const std::array<const vk::DeviceSize, 1> offsets{ 0 };
-            commandBuffer.bindVertexBuffers(0, buffers, offsets);
+    const vk::PipelineDepthStencilStateCreateInfo depthStencilStateCI{
+        /* flags */ {},
+        /* depthTestEnable */ true,
+        /* depthWriteEnable */ true,
+        /* depthCompareOp */ vk::CompareOp::eLess,
+        /* depthBoundsTestEnable */ false,
+        /* stencilTestEnable */ false
+    };
 
-            commandBuffer.draw(mesh.getVertexCount(), 1, 0, 0);
+    // == CREATE THE PIPELINE
 
-            commandBuffer.endRenderPass();
-        }
+    const vk::GraphicsPipelineCreateInfo gfxPipelineCI{
+        /* flags */ {},
+        /* stages */ shaderStageCIs,
+        /* pVertexInputState */ &vertexInputStateCI,
+        /* pInputAssemblyState */ &inputAssemblyStateCI,
+        /* pTessellationState */ nullptr,
+        /* pViewportState */ &viewportStateCI,
+        /* pRasterizationState */ &rasterizationStateCI,
+        /* pMultisampleState */ &multisampleStateCI,
+        /* pDepthStencilState */ &depthStencilStateCI,
+        // The subpass has no color attachments.
+        /* pColorBlendState */ nullptr,
+        /* pDynamicState */ &dynamicStateCI,
+        /* layout */ pipelineLayout,
+        /* renderPass */ renderPass,
+        /* subpass */ 0
+    };
 
-        commandBuffer.end();
-    }
+    return device.createGraphicsPipeline(nullptr, gfxPipelineCI);
 }
 
-std::vector<vk::raii::Semaphore> createSemaphores(const vk::raii::Device& device, std::size_t count)
+vk::raii::PipelineLayout createParticlePipelineLayout(
+    const vk::raii::Device& device, const vk::raii::DescriptorSetLayout& descriptorSetLayout)
 {
-    const vk::SemaphoreCreateInfo semaphoreCI{};
-    std::vector<vk::raii::Semaphore> semaphores{};
-    semaphores.reserve(count);
-    for (auto i{ 0u }; i != count; ++i)
-    {
-        semaphores.emplace_back(device.createSemaphore(semaphoreCI));
-    }
-    return semaphores;
+    // The same set as the compute passes. The vertex shader reads the particles from it.
+    const std::array<vk::DescriptorSetLayout, 1> setLayouts{ descriptorSetLayout };
+    return device.createPipelineLayout(vk::PipelineLayoutCreateInfo{ /* flags */ {}, setLayouts });
 }
 
-std::vector<vk::raii::Fence> createFences(const vk::raii::Device& device, std::size_t count)
+// Draws the particles of the particle system. Every instance is a quad. The vertex shader expands it from the
+// particle storage buffer, so there is no vertex input.
+// The fragment shader outputs the interpolated color.
+vk::raii::Pipeline createParticlePipeline(
+    std::span<const std::byte> vertexShaderSpv, std::span<const std::byte> fragmentShaderSpv,
+    const vk::raii::Device& device, const vk::raii::RenderPass& renderPass,
+    const vk::raii::PipelineLayout& pipelineLayout)
 {
-    const vk::FenceCreateInfo fenceCI{ /* flags */ vk::FenceCreateFlagBits::eSignaled };
-    std::vector<vk::raii::Fence> fences{};
-    fences.reserve(count);
-    for (auto i{ 0u }; i != count; ++i)
-    {
-        fences.emplace_back(device.createFence(fenceCI));
-    }
-    return fences;
-}
+    // -- SHADER MODULES
 
-Renderer::Mesh createMesh(const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::Device& device)
-{
-    // In Vulkan we have a right-handed NDC space:
-    //
-    //              + Z
-    //             /
-    //            /
-    //           o----------+ X
-    //           |
-    //           |
-    //         Y +
-    //
-    std::vector<Geometry::Vertex> vertices{ { { 0.4, -0.4, 0.0 }, { 1.0f, 0.0f, 0.0f } },
-                                            { { 0.4, 0.4, 0.0 }, { 0.0f, 1.0f, 0.0f } },
-                                            { { -0.4, 0.4, 0.0 }, { 0.0f, 0.0f, 1.0f } },
+    auto vertexShaderModule{ createShaderModule(device, vertexShaderSpv) };
+    auto fragmentShaderModule{ createShaderModule(device, fragmentShaderSpv) };
 
-                                            { { -0.4, 0.4, 0.0 }, { 0.0f, 0.0f, 1.0f } },
-                                            { { -0.4, -0.4, 0.0 }, { 1.0f, 1.0f, 0.0f } },
-                                            { { 0.4, -0.4, 0.0 }, { 1.0f, 0.0f, 0.0f } } };
-    return Renderer::Mesh{ physicalDevice, device, vertices };
-}
+    const std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStageCIs{
+        vk::PipelineShaderStageCreateInfo{ /* flags */ {},
+                                           /* stage */ vk::ShaderStageFlagBits::eVertex,
+                                           vertexShaderModule,
+                                           "main" },
+        vk::PipelineShaderStageCreateInfo{ /* flags */ {},
+                                           /* stage */ vk::ShaderStageFlagBits::eFragment,
+                                           fragmentShaderModule,
+                                           "main" }
+    };
 
-} // namespace
+    // -- FIXED FUNCTION STATES
 
-namespace VkTest1::Renderer::Detail
-{
+    const vk::PipelineVertexInputStateCreateInfo vertexInputStateCI{};
 
-VulkanRenderer::VulkanRenderer(
-    Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Window::IWindow*> window) :
-    m_fileSystem{ fileSystem },
-    m_window{ window },
-    m_instance{ createInstance(m_context, *m_window) },
-    m_debugMessenger{ createDebugMessenger(m_instance) },
-    m_surface{ vk::raii::SurfaceKHR{ m_instance,
-                                     static_cast<VkSurfaceKHR>(m_window->createSurface(m_instance.operator*())) } },
-    m_physicalDevice{ getPhysicalDevice(m_instance, m_surface) },
-    m_device{ createLogicalDevice(m_physicalDevice) },
-    m_swapchain{ createSwapchain(*m_window, m_surface, m_physicalDevice, m_device) },
-    m_graphicsQueue{ m_device.getQueue(
-        m_physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value(), /* queueIndex */ 0) },
-    m_presentationQueue{ m_device.getQueue(
-        m_physicalDevice.queueFamilyInfo.presentationQueueFamilyIndex.value(), /* queueIndex */ 0) },
-    m_renderPass{ createRenderPass(m_device, m_swapchain.imageFormat) },
-    m_pipelineLayout{ createPipelineLayout(m_device) },
-    m_pipeline{ createPipeline(*m_fileSystem, m_device, m_swapchain.imageExtent, m_renderPass, m_pipelineLayout) },
-    m_framebuffers{ createFramebuffers(m_device, m_swapchain, m_renderPass) },
-    m_graphicsCommandPool{ createGraphicsCommandPool(
-        m_device, m_physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value()) },
-    m_commandBuffers{ createCommandBuffers(m_device, m_graphicsCommandPool, m_swapchain.images.size()) },
-    m_imageAvailable{ createSemaphores(m_device, s_maxFrameCountInQueue) },
-    m_renderFinished{ createSemaphores(m_device, s_maxFrameCountInQueue) },
-    m_drawFence{ createFences(m_device, s_maxFrameCountInQueue) },
-    m_firstMesh{ createMesh(m_physicalDevice.device, m_device) }
-{
-    printPhysicalDeviceInfo(m_physicalDevice.device);
-    recordCommands(m_commandBuffers, m_renderPass, m_framebuffers, m_swapchain.imageExtent, m_pipeline, m_firstMesh);
-}
+    const vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateCI{
+        /* flags */ {},
+        /* topology */ vk::PrimitiveTopology::eTriangleList,
+        /* primitiveRestartEnable */ false
+    };
+
+    // Dynamic, like in createPipeline().
+    const vk::PipelineViewportStateCreateInfo viewportStateCI{ /* flags */ {},
+                                                               /* viewportCount */ 1,
+                                                               /* pViewports */ nullptr,
+                                                               /* scissorCount */ 1,
+                                                               /* pScissors */ nullptr };
+    const vk::PipelineDynamicStateCreateInfo dynamicStateCI{ /* flags */ {}, /* dynamicStates */ s_dynamicStates };
+
+    // The quads always face the viewer.
+    const vk::PipelineRasterizationStateCreateInfo rasterizationStateCI{
+        /* flags */ {},
+        /* depthClampEnable */ false,
+        /* rasterizerDiscardEnable */ false,
+        /* polygonMode */ vk::PolygonMode::eFill,
+        /* cullMode */ vk::CullModeFlagBits::eNone,
+        /* frontFace */ vk::FrontFace::eClockwise,
+        /* depthBiasEnable */ false,
+        /* depthBiasConstantFactor */ {},
+        /* depthBiasClamp */ {},
+        /* depthBiasSlopeFactor */ {},
+        /* lineWidth */ 1.0f
+    };
+
+    const vk::PipelineMultisampleStateCreateInfo multisampleStateCI{
+        /* flags */ {},
+        /* rasterizationSamples */ vk::SampleCountFlagBits::e1,
+        /* sampleShadingEnable */ false
+    };
+
+    // Alpha blended, so the particles fade out.
+    const std::array<vk::PipelineColorBlendAttachmentState, 1> colorBlendAttachmentStates{
+        vk::PipelineColorBlendAttachmentState{ /* blendEnable */ true,
+                                               /* srcColorBlendFactor */ vk::BlendFactor::eSrcAlpha,
+                                               /* dstColorBlendFactor */ vk::BlendFactor::eOneMinusSrcAlpha,
+                                               /* colorBlendOp */ vk::BlendOp::eAdd,
+                                               /* srcAlphaBlendFactor */ vk::BlendFactor::eOne,
+                                               /* dstAlphaBlendFactor */ vk::BlendFactor::eZero,
+                                               /* alphaBlendOp */ vk::BlendOp::eAdd,
+                                               /* colorWriteMask */ vk::ColorComponentFlagBits::eR |
+                                                   vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB |
+                                                   vk::ColorComponentFlagBits::eA }
+    };
+    const vk::PipelineColorBlendStateCreateInfo colorBlendStateCI{ /* flags */ {},
+                                                                   /* logicOpEnable */ false,
+                                                                   /* logicOp */ vk::LogicOp::eClear,
+                                                                   /* pAttachments */ colorBlendAttachmentStates };
+
+    // Hidden behind the meshes, but they don't hide each other. The depth is read-only with the pre-pass anyway.
+    const vk::PipelineDepthStencilStateCreateInfo depthStencilStateCI{
+        /* flags */ {},
+        /* depthTestEnable */ true,
+        /* depthWriteEnable */ false,
+        /* depthCompareOp */ vk::CompareOp::eLess,
+        /* depthBoundsTestEnable */ false,
+        /* stencilTestEnable */ false
+    };
+
+    // == CREATE THE PIPELINE
+
+    const vk::GraphicsPipelineCreateInfo gfxPipelineCI{
+        /* flags */ {},
+        /* stages */ shaderStageCIs,
+        /* pVertexInputState */ &vertexInputStateCI,
+        /* pInputAssemblyState */ &inputAssemblyStateCI,
+        /* pTessellationState */ nullptr,
+        /* pViewportState */ &viewportStateCI,
+        /* pRasterizationState */ &rasterizationStateCI,
+        /* pMultisampleState */ &multisampleStateCI,
+        /* pDepthStencilState */ &depthStencilStateCI,
+        /* pColorBlendState */ &colorBlendStateCI,
+        /* pDynamicState */ &dynamicStateCI,
+        /* layout */ pipelineLayout,
+        /* renderPass */ renderPass,
+        /* subpass */ 0
+    };
+
+    return device.createGraphicsPipeline(nullptr, gfxPipelineCI);
+}
+
+vk::raii::CommandPool createGraphicsCommandPool(const vk::raii::Device& device, std::uint32_t graphicsQueueFamilyIndex)
+{
+    // eResetCommandBuffer = The command buffers can be reset individually. We re-record them every frame.
+    const vk::CommandPoolCreateInfo commandPoolCI{ /* flags */ vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                                   /* queueFamilyIndex */ graphicsQueueFamilyIndex };
+    return device.createCommandPool(commandPoolCI);
+}
+
+std::vector<vk::raii::CommandBuffer> createCommandBuffers(
+    const vk::raii::Device& device, const vk::raii::CommandPool& commandPool, std::uint32_t count)
+{
+    const vk::CommandBufferAllocateInfo commandBufferAI{
+        /* commandPool */ commandPool,
+        // A Primary command buffer can be executed directly from a queue.
+        // A Secondary command buffer can be executed only from a Primary command buffer.
+        /* level */ vk::CommandBufferLevel::ePrimary,
+        /* commandBufferCount */ count
+    };
+    return device.allocateCommandBuffers(commandBufferAI);
+}
+
+// The pipelines have a dynamic viewport and scissor. They cover the whole extent.
+void recordViewport(const vk::raii::CommandBuffer& commandBuffer, const vk::Extent2D& extent)
+{
+    commandBuffer.setViewport(
+        /* firstViewport */ 0,
+        vk::Viewport{ /* x */ 0,
+                      /* y */ 0,
+                      /* width */ Common::NarrowCast<float>(extent.width),
+                      /* height */ Common::NarrowCast<float>(extent.height),
+                      /* minDepth */ 0.0f,
+                      /* maxDepth */ 1.0f });
+    commandBuffer.setScissor(/* firstScissor */ 0, vk::Rect2D{ /* offset */ { 0, 0 }, /* extent */ extent });
+}
+
+// A swapchain image acquired for the current frame.
+struct AcquiredImage
+{
+    std::size_t output;
+    std::uint32_t imageIndex;
+};
+
+// The outputs are rendered one after the other into the same command buffer.
+// If an output is captured, its graph leaves the backbuffer for the copy, and the copy transitions it for the present.
+// The relocations in the geometry arena come first, then the GPU cluster culling (if any), because all outputs draw
+// with their results.
+void recordCommands(
+    const vk::raii::CommandBuffer& commandBuffer, std::span<Renderer::Detail::Output> outputs,
+    std::span<const AcquiredImage> acquiredImages, Renderer::Detail::FrameCapture& frameCapture, std::size_t frame,
+    Renderer::Detail::GeometryArena& geometryArena, const Renderer::Detail::GpuClusterCuller* gpuClusterCuller)
+{
+    const vk::CommandBufferBeginInfo cmdBufferBI{
+        // eOneTimeSubmit means this command buffer is re-recorded before it is submitted again.
+        // We re-record it every frame because the set of meshes can change between frames.
+        /* flags */ vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+    };
+
+    commandBuffer.reset();
+    commandBuffer.begin(cmdBufferBI);
+    // The draw list has the offsets of the relocated meshes already.
+    geometryArena.recordCopies(commandBuffer);
+    if (gpuClusterCuller != nullptr)
+    {
+        gpuClusterCuller->record(commandBuffer);
+    }
+    for (const auto& acquiredImage : acquiredImages)
+    {
+        auto& frameGraph{ outputs[acquiredImage.output].frameGraph };
+        const auto& swapchainImage{ outputs[acquiredImage.output].swapchain.images[acquiredImage.imageIndex] };
+        frameGraph.graph.setImportedImage(frameGraph.backbuffer, swapchainImage.image, swapchainImage.imageView);
+        frameGraph.graph.execute(commandBuffer);
+        if (frameGraph.isCaptured)
+        {
+            frameCapture.recordCopy(commandBuffer, frame, swapchainImage.image, vk::ImageLayout::ePresentSrcKHR);
+        }
+    }
+    commandBuffer.end();
+}
+
+std::vector<vk::raii::Semaphore> createSemaphores(const vk::raii::Device& device, std::size_t count)
+{
+    const vk::SemaphoreCreateInfo semaphoreCI{};
+    std::vector<vk::raii::Semaphore> semaphores{};
+    semaphores.reserve(count);
+    for (auto i{ 0u }; i != count; ++i)
+    {
+        semaphores.emplace_back(device.createSemaphore(semaphoreCI));
+    }
+    return semaphores;
+}
+
+std::vector<vk::raii::Fence> createFences(const vk::raii::Device& device, std::size_t count)
+{
+    const vk::FenceCreateInfo fenceCI{ /* flags */ vk::FenceCreateFlagBits::eSignaled };
+    std::vector<vk::raii::Fence> fences{};
+    fences.reserve(count);
+    for (auto i{ 0u }; i != count; ++i)
+    {
+        fences.emplace_back(device.createFence(fenceCI));
+    }
+    return fences;
+}
+
+std::optional<Renderer::Detail::ParticleSystem> createParticleSystem(
+    const Renderer::Detail::ShaderBinaries& shaders, const Renderer::Detail::PhysicalDevice& physicalDevice,
+    const vk::raii::Device& device, const vk::raii::Queue& computeQueue, const Renderer::RendererSettings& settings)
+{
+    if (settings.particleCount == 0)
+    {
+        return std::nullopt;
+    }
+    return std::make_optional<Renderer::Detail::ParticleSystem>(
+        Renderer::Detail::ParticleShaderBinaries{ shaders.particleEmit.get(),
+                                                  shaders.particlePrepare.get(),
+                                                  shaders.particleSimulate.get(),
+                                                  shaders.particleCompact.get() },
+        &physicalDevice.device,
+        &device,
+        &computeQueue,
+        physicalDevice.queueFamilyInfo.computeQueueFamilyIndex.value(),
+        physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value(),
+        settings.particleCount,
+        settings.framesInFlight);
+}
+
+std::optional<Renderer::Detail::GpuClusterCuller> createGpuClusterCuller(
+    const Renderer::Detail::ShaderBinaries& shaders, const Renderer::Detail::PhysicalDevice& physicalDevice,
+    const vk::raii::Device& device, const Renderer::Detail::BindlessDescriptors& bindlessDescriptors,
+    const Renderer::Detail::GeometryArena& geometryArena, const Renderer::RendererSettings& settings,
+    Logging::ILogger& logger)
+{
+    if (settings.clusterCulling != Renderer::ClusterCullingMode::Gpu)
+    {
+        return std::nullopt;
+    }
+    // Enabled on the device if supported.
+    if (!physicalDevice.device.getFeatures().multiDrawIndirect)
+    {
+        logger.warning("Vulkan: No multiDrawIndirect. The clusters are culled on the CPU.");
+        return std::nullopt;
+    }
+    return std::make_optional<Renderer::Detail::GpuClusterCuller>(
+        shaders.clusterCull.get(),
+        &physicalDevice.device,
+        &device,
+        &bindlessDescriptors,
+        geometryArena.getMeshletBufferIndex(),
+        settings.framesInFlight);
+}
+
+std::optional<Renderer::Detail::FrameStatisticsCollector::Clock::duration> getRefreshDuration(
+    const Window::IWindow& window)
+{
+    const auto refreshRate{ window.getRefreshRate() };
+    if (refreshRate == 0)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::duration_cast<Renderer::Detail::FrameStatisticsCollector::Clock::duration>(
+        std::chrono::duration<double>{ 1.0 / refreshRate });
+}
+
+void logFrameStatistics(Logging::ILogger& logger, std::size_t output, const Renderer::FrameStatistics& statistics)
+{
+    logger.info(
+        "Window {}: Frames: {} | Latency: {:.2f} ms avg, {:.2f} ms max ({}) | Missed vsyncs: {} | "
+        "Fence wait: {:.2f} ms | Acquire wait: {:.2f} ms",
+        output,
+        statistics.frameCount,
+        statistics.averageLatency,
+        statistics.maxLatency,
+        Renderer::toString(statistics.source),
+        statistics.missedVsyncCount,
+        statistics.averageFenceWait,
+        statistics.averageAcquireWait);
+}
+
+std::vector<vk::raii::SurfaceKHR> createSurfaces(
+    const vk::raii::Instance& instance, std::span<const Common::NotNull<Window::IWindow*>> windows)
+{
+    std::vector<vk::raii::SurfaceKHR> surfaces{};
+    surfaces.reserve(windows.size());
+    for (const auto window : windows)
+    {
+        surfaces.emplace_back(instance, static_cast<VkSurfaceKHR>(window->createSurface(instance.operator*())));
+    }
+    return surfaces;
+}
+
+Geometry::MeshData createQuadMeshData()
+{
+    // In Vulkan we have a right-handed NDC space:
+    //
+    //              + Z
+    //             /
+    //            /
+    //           o----------+ X
+    //           |
+    //           |
+    //         Y +
+    //
+    // The texture coordinates have their origin at the top left, like the textures.
+    std::vector<Geometry::Vertex> vertices{ { { 0.4, -0.4, 0.0 }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f } },
+                                            { { 0.4, 0.4, 0.0 }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f } },
+                                            { { -0.4, 0.4, 0.0 }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } },
+
+                                            { { -0.4, 0.4, 0.0 }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } },
+                                            { { -0.4, -0.4, 0.0 }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 0.0f } },
+                                            { { 0.4, -0.4, 0.0 }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f } } };
+    const auto bounds{ Geometry::computeBounds(vertices) };
+    return Geometry::MeshData{ std::move(vertices), /* indices */ {}, bounds };
+}
+
+// A single white texel. Sampling it leaves the vertex color as it is.
+std::future<Texture::TextureData> createDefaultTextureData()
+{
+    Texture::TextureData textureData{};
+    textureData.width = 1;
+    textureData.height = 1;
+    textureData.mipLevels = Texture::getMipLevels(
+        textureData.format, textureData.width, textureData.height, /* mipLevelCount */ 1, /* alignment */ 4);
+    textureData.data.assign(4, std::byte{ 0xFF });
+
+    std::promise<Texture::TextureData> promise{};
+    promise.set_value(std::move(textureData));
+    return promise.get_future();
+}
+
+} // namespace
+
+namespace VkTest1::Renderer::Detail
+{
+
+//
+// Startup is a dependency graph. The steps that don't need the device start first on the asset loader threads.
+// Meanwhile this thread creates the Vulkan objects:
+//
+//   Shader loads ---------------------------------------+---------------------+
+//                                                       v                     v
+//   Instance -> Surfaces -> Device -> Swapchains -> Particle system -> Pipelines (one thread each)
+//                                                                               |
+//   Quad mesh generation ---------------------------------------------------> Mesh uploader
+//   Default texture -------------------------------------> Texture uploader
+//
+// Only the particle system, the GPU cluster culler and the pipelines wait for the shader loads, and by then they are
+// usually done.
+//
+VulkanRenderer::VulkanRenderer(
+    Common::NotNull<Assets::IAssetLoader*> assetLoader, Common::NotNull<Common::JobSystem*> jobSystem,
+    std::vector<Common::NotNull<Window::IWindow*>> windows, Common::NotNull<Logging::ILogger*> logger,
+    Common::NotNull<Common::MetricsRegistry*> metricsRegistry, const RendererSettings& settings) :
+    m_settings{ settings },
+    m_assetLoader{ assetLoader },
+    m_jobSystem{ jobSystem },
+    m_logger{ logger },
+    m_frameArena{ &*m_jobSystem, m_settings.framesInFlight, s_frameArenaCapacity },
+    m_shaders{ loadShaders(*m_assetLoader, m_settings) },
+    m_quadMesh{ m_assetLoader->generateMesh(Assets::LoadPriority::High, createQuadMeshData) },
+    // The windows need the same instance extensions.
+    m_instance{ createInstance(m_context, *windows.front(), m_settings, *m_logger) },
+    m_debugMessenger{ createDebugMessenger(m_instance, m_settings, *m_logger) },
+    m_surfaces{ createSurfaces(m_instance, windows) },
+    m_physicalDevice{ getPhysicalDevice(m_instance, m_surfaces, m_settings.preferredDevice, *m_logger) },
+    m_device{ createLogicalDevice(m_physicalDevice) },
+    m_metrics{ *metricsRegistry, m_physicalDevice.device, m_physicalDevice.hasMemoryBudget },
+    m_memoryBudget{ m_physicalDevice.device,
+                    m_physicalDevice.hasMemoryBudget,
+                    /* limit */ vk::DeviceSize{ m_settings.memoryBudget } << 20 },
+    m_depthFormat{ chooseDepthFormat(m_physicalDevice.device, m_settings.depthFormat) },
+    m_frameCapture{ &m_physicalDevice.device, &m_device, m_settings.framesInFlight },
+    m_outputs{ createOutputs(windows) },
+    m_graphicsQueue{ m_device.getQueue(
+        m_physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value(), /* queueIndex */ 0) },
+    m_presentationQueue{ m_device.getQueue(
+        m_physicalDevice.queueFamilyInfo.presentationQueueFamilyIndex.value(), /* queueIndex */ 0) },
+    m_computeQueue{ m_device.getQueue(
+        m_physicalDevice.queueFamilyInfo.computeQueueFamilyIndex.value(), /* queueIndex */ 0) },
+    m_particleSystem{ createParticleSystem(m_shaders, m_physicalDevice, m_device, m_computeQueue, m_settings) },
+    m_bindlessDescriptors{ &m_device, s_maxTextureCount, s_maxStorageBufferCount, m_settings.framesInFlight },
+    m_geometryArena{ &m_physicalDevice.device,
+                     &m_device,
+                     &m_bindlessDescriptors,
+                     s_geometryVertexCapacity,
+                     s_geometryIndexCapacity,
+                     s_geometryMeshletCapacity,
+                     m_settings.framesInFlight },
+    m_gpuClusterCuller{ createGpuClusterCuller(
+        m_shaders, m_physicalDevice, m_device, m_bindlessDescriptors, m_geometryArena, m_settings, *m_logger) },
+    m_textureUploader{ &m_physicalDevice.device,
+                       &m_device,
+                       &m_graphicsQueue,
+                       m_logger,
+                       &m_bindlessDescriptors,
+                       &m_memoryBudget,
+                       &m_metrics.getUploadedBytes(),
+                       m_physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value() },
+    m_pipelineLayout{ createPipelineLayout(m_device, m_bindlessDescriptors.getDescriptorSetLayout()) },
+    m_particlePipelineLayout{ m_particleSystem.has_value()
+                                  ? createParticlePipelineLayout(m_device, m_particleSystem->getDescriptorSetLayout())
+                                  : vk::raii::PipelineLayout{ nullptr } },
+    m_pipelines{ createPipelines() },
+    m_graphicsCommandPool{ createGraphicsCommandPool(
+        m_device, m_physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value()) },
+    m_commandBuffers{ createCommandBuffers(m_device, m_graphicsCommandPool, m_settings.framesInFlight) },
+    m_renderFinished{ createSemaphores(m_device, m_settings.framesInFlight) },
+    m_drawFence{ createFences(m_device, m_settings.framesInFlight) },
+    m_meshUploader{ &m_physicalDevice.device,
+                    &m_device,
+                    &m_graphicsQueue,
+                    m_logger,
+                    &m_geometryArena,
+                    &m_metrics.getUploadedBytes(),
+                    m_physicalDevice.queueFamilyInfo.graphicsQueueFamilyIndex.value(),
+                    m_settings.compactIndices },
+    m_lodSelector{ m_settings.lodError },
+    m_meshResidency{ m_settings.framesInFlight },
+    m_textureResidency{ m_settings.framesInFlight }
+{
+    printPhysicalDeviceInfo(m_physicalDevice.device, *m_logger);
+    m_logger->info("Vulkan: Present timing source: {}", toString(m_physicalDevice.presentTimingSource));
+    m_logger->info("Vulkan: Memory budget: {}", m_physicalDevice.hasMemoryBudget ? "yes" : "no");
+    m_logger->info("Vulkan: Device local memory budget: {} MiB", m_memoryBudget.getBudget() >> 20);
+    m_logger->info("Vulkan: Drawing into {} window(s).", m_outputs.size());
+    // The estimate without VK_EXT_memory_budget only sees what the renderer reports.
+    m_memoryBudget.allocate(m_geometryArena.getSize());
+    m_textureUploader.enqueue(createDefaultTextureData(), s_defaultTextureIndex);
+    // Has no mesh number, so the added meshes are numbered from 0.
+    m_meshUploader.enqueue(std::move(m_quadMesh), allocateMeshIndex(), s_defaultTextureIndex);
+}
 
 VulkanRenderer::~VulkanRenderer()
 {
     // Wait for all the work to finish before destroying Vulkan objects.
     m_device.waitIdle();
+
+    // The last frames in flight are still in the readback buffers.
+    try
+    {
+        m_frameCapture.collectAll();
+    }
+    catch (const std::exception& ex)
+    {
+        m_logger->error("Capture: {}", ex.what());
+    }
+}
+
+void VulkanRenderer::addTexture(std::future<Texture::TextureData> textureData)
+{
+    // The default texture comes first.
+    ++m_addedTextureCount;
+    m_textureUploader.enqueue(std::move(textureData), s_defaultTextureIndex + m_addedTextureCount);
 }
 
-void VulkanRenderer::draw()
+std::uint32_t VulkanRenderer::addMesh(std::future<Geometry::MeshData> meshData, std::optional<std::uint32_t> texture)
+{
+    const auto textureIndex{ texture.has_value() ? s_defaultTextureIndex + 1 + *texture : s_defaultTextureIndex };
+    const auto meshIndex{ allocateMeshIndex() };
+    m_meshUploader.enqueue(std::move(meshData), meshIndex, textureIndex);
+    m_meshIndices.emplace(m_addedMeshCount, meshIndex);
+    return m_addedMeshCount++;
+}
+
+void VulkanRenderer::removeMesh(std::uint32_t mesh)
+{
+    const auto it{ m_meshIndices.find(mesh) };
+    if (it == m_meshIndices.end())
+    {
+        throw Common::RendererError{ std::format("Mesh {} does not exist.", mesh) };
+    }
+    const auto meshIndex{ it->second };
+    m_meshIndices.erase(it);
+    m_meshUploader.remove(meshIndex);
+    if (meshIndex < m_meshes.size())
+    {
+        // The arena reuses its ranges once the frames in flight are done, so the index is free right away. A mesh
+        // that gets it starts from the LOD this one was drawn with, which the LOD selector corrects in a frame.
+        m_meshes[meshIndex].reset();
+    }
+    m_freeMeshIndices.push_back(meshIndex);
+    std::ranges::push_heap(m_freeMeshIndices, std::greater{});
+}
+
+void VulkanRenderer::draw(const FrameState& frameState)
 {
     //
-    // In the queue, we allow only s_maxFrameCountInQueue frames at once.
+    // In the queue, we allow only m_settings.framesInFlight frames at once.
     // We start rendering the frame only if its fence is open.
     //
     // Rendering frame 0:
@@ -865,42 +1537,182 @@ void VulkanRenderer::draw()
     //                Swapchain_Image_0 <-imageAvailable-+
     //
 
+    // With several windows, every step is done for each window that is not minimized, but there is still one fence
+    // wait, one submission and one present per frame.
+
     // -- RATE LIMIT
 
+    const auto frameStart{ std::chrono::steady_clock::now() };
+    m_metrics.beginFrame(frameStart);
+    for (auto& output : m_outputs)
+    {
+        output.frameStatistics.beginFrame();
+    }
+
+    // The renderer doesn't touch the windows after construction. It may run on another thread than them.
+    for (auto i{ 0u }; i != std::min(m_outputs.size(), frameState.windowSizes.size()); ++i)
+    {
+        m_outputs[i].windowSize = frameState.windowSizes[i];
+    }
+
+    // -- RECREATE OUTDATED SWAPCHAINS
+
+    recreateOutdatedSwapchains();
+
     // Wait for fence.
     const std::array<vk::Fence, 1> fences{ m_drawFence[m_currentFrame] };
+    const auto fenceWaitStart{ std::chrono::steady_clock::now() };
     auto result{ m_device.waitForFences(fences, true, std::numeric_limits<uint64_t>::max()) };
+    const auto fenceWait{ std::chrono::steady_clock::now() - fenceWaitStart };
+    m_metrics.addFenceWait(fenceWait);
+    for (auto& output : m_outputs)
+    {
+        output.frameStatistics.addFenceWait(fenceWait);
+    }
     if (result != vk::Result::eSuccess)
     {
         throw Common::RendererError{ "Cannot wait for fences." };
     }
+
+    // The fence also means the CPU side data of the frame is not needed anymore, and the bindless slots and geometry
+    // ranges it freed can be reused.
+    m_frameArena.beginFrame(m_currentFrame);
+    m_bindlessDescriptors.beginFrame(m_currentFrame);
+    m_geometryArena.beginFrame(m_currentFrame);
+    auto& frameMemory{ m_frameArena.getResource() };
+    m_metrics.updateDeviceMemory(m_physicalDevice.device, frameStart);
+    m_memoryBudget.update(m_physicalDevice.device, frameStart);
+
+    // -- HAND OVER CAPTURED FRAME
+
+    // The fence also covers the copy of the frame that used this slot framesInFlight frames ago.
+    m_frameCapture.collect(m_currentFrame);
+
+    // -- PICK UP UPLOADED MESHES AND TEXTURES
+
+    auto uploadQuota{ m_settings.uploadQuota != 0 ? std::uint64_t{ m_settings.uploadQuota } << 10
+                                                   : std::numeric_limits<std::uint64_t>::max() };
+    m_meshUploader.update(m_meshes, uploadQuota);
+    m_textureUploader.update(m_textures, uploadQuota);
+
+    // -- DEFRAGMENT GEOMETRY
+
+    // Moves the meshes into the holes that freed meshes left, a little per frame. The draw list below draws them from
+    // their new ranges, and the copies are recorded before the draws.
+    for (auto i{ 0u }; i != m_meshes.size(); ++i)
+    {
+        if (m_meshes[i].has_value() && m_geometryArena.relocate(m_meshes[i]->getGeometryAllocation()))
+        {
+            // The copy reads and writes its ranges in this frame.
+            m_meshResidency.markUsed(i);
+        }
+    }
+
+    // -- BUILD DRAW LIST
+
+    buildDrawList(frameMemory);
+
+    // -- EVICT UNDER MEMORY PRESSURE
+
+    evictUnderPressure();
+
+    // -- REQUEST SWAPCHAIN IMAGES
+
+    std::pmr::vector<AcquiredImage> acquiredImages{ &frameMemory };
+    for (auto i{ 0u }; i != m_outputs.size(); ++i)
+    {
+        auto& output{ m_outputs[i] };
+        if (output.isSwapchainOutdated)
+        {
+            // Minimized. There is nothing to draw on.
+            continue;
+        }
+
+        std::pair<vk::Result, std::uint32_t> imageIndexResult{};
+        const auto acquireStart{ std::chrono::steady_clock::now() };
+        try
+        {
+            imageIndexResult = m_device.acquireNextImage2KHR(
+                vk::AcquireNextImageInfoKHR{ /* swapchain */ output.swapchain.swapchain,
+                                             /* timeout */ std::numeric_limits<std::uint64_t>::max(),
+                                             /* semaphore */ output.imageAvailable[m_currentFrame],
+                                             /* fence */ {},
+                                             /* deviceMask */ 1 /*1u << m_physicalDevice.deviceIndex*/ });
+        }
+        catch (const vk::OutOfDateKHRError&)
+        {
+            // Skipped in this frame. Its semaphore is not signaled, so nothing waits for it.
+            output.isSwapchainOutdated = true;
+            continue;
+        }
+        output.frameStatistics.addAcquireWait(std::chrono::steady_clock::now() - acquireStart);
+        if (imageIndexResult.first == vk::Result::eSuboptimalKHR)
+        {
+            // Still usable. Draw this frame and recreate before the next one.
+            output.isSwapchainOutdated = true;
+        }
+        else if (imageIndexResult.first != vk::Result::eSuccess)
+        {
+            throw Common::RendererError{ "Cannot acquire next image from swapchain." };
+        }
+        acquiredImages.push_back(AcquiredImage{ i, imageIndexResult.second });
+    }
+
+    if (acquiredImages.empty())
+    {
+        // Nothing was submitted, so the fence stays signaled for the next try. The relocations in the geometry arena
+        // are recorded then.
+        return;
+    }
+
+    // Reset the fence only when we are sure to submit work that signals it.
     m_device.resetFences(fences);
 
-    // -- REQUEST SWAPCHAIN IMAGE
+    // -- RECORD COMMAND BUFFER
 
-    const auto imageIndexResult{ m_device.acquireNextImage2KHR(
-        vk::AcquireNextImageInfoKHR{ /* swapchain */ m_swapchain.swapchain,
-                                     /* timeout */ std::numeric_limits<std::uint64_t>::max(),
-                                     /* semaphore */ m_imageAvailable[m_currentFrame],
-                                     /* fence */ {},
-                                     /* deviceMask */ 1 /*1u << m_physicalDevice.deviceIndex*/ }) };
-    if (imageIndexResult.first != vk::Result::eSuccess)
+    // The fence guarantees that the command buffer of this frame is not in use anymore.
+    recordCommands(
+        m_commandBuffers[m_currentFrame],
+        m_outputs,
+        acquiredImages,
+        m_frameCapture,
+        m_currentFrame,
+        m_geometryArena,
+        m_gpuClusterCuller.has_value() ? &*m_gpuClusterCuller : nullptr);
+
+    // -- SIMULATE PARTICLES
+
+    // Runs on the compute queue. Meanwhile the graphics queue can start the frame.
+    if (m_particleSystem.has_value())
     {
-        throw Common::RendererError{ "Cannot acquire next image from swapchain." };
+        m_particleSystem->simulate(m_currentFrame, frameState.time);
     }
-    const auto imageIndex{ imageIndexResult.second };
 
     // -- SUBMIT COMMAND BUFFER
 
     // Let the pipeline run until it reaches the Color Attachment Output stage.
-    // At that point, it has to wait for the "image available" signal before continuing.
-    const std::array<vk::Semaphore, 1> waitSemaphores{ m_imageAvailable[m_currentFrame] };
-    const std::array<vk::PipelineStageFlags, 1> waitStageFlags{ vk::PipelineStageFlagBits::eColorAttachmentOutput };
+    // At that point, it has to wait for the "image available" signals before continuing.
+    std::pmr::vector<vk::Semaphore> waitSemaphores{ &frameMemory };
+    std::pmr::vector<vk::PipelineStageFlags> waitStageFlags{ &frameMemory };
+    for (const auto& acquiredImage : acquiredImages)
+    {
+        waitSemaphores.push_back(m_outputs[acquiredImage.output].imageAvailable[m_currentFrame]);
+        waitStageFlags.push_back(vk::PipelineStageFlagBits::eColorAttachmentOutput);
+    }
 
-    const std::array<vk::CommandBuffer, 1> commandBuffers{ m_commandBuffers[imageIndex] };
+    const std::array<vk::CommandBuffer, 1> commandBuffers{ m_commandBuffers[m_currentFrame] };
 
     // After the command buffer has finished execution, we ask it to signal "render finished".
-    const std::array<vk::Semaphore, 1> signalSemaphores{ m_renderFinished[m_currentFrame] };
+    std::pmr::vector<vk::Semaphore> signalSemaphores{ { m_renderFinished[m_currentFrame] }, &frameMemory };
+
+    if (m_particleSystem.has_value())
+    {
+        // The indirect draw reads the arguments and the vertex shader reads the particles.
+        waitSemaphores.push_back(m_particleSystem->getSimulationFinishedSemaphore(m_currentFrame));
+        waitStageFlags.push_back(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader);
+        // The next simulation overwrites the particles only after this frame.
+        signalSemaphores.push_back(m_particleSystem->getDrawFinishedSemaphore(m_currentFrame));
+    }
 
     m_graphicsQueue.submit(
         std::array<vk::SubmitInfo, 1>{ vk::SubmitInfo{ /* pWaitSemaphores */ waitSemaphores,
@@ -909,20 +1721,595 @@ void VulkanRenderer::draw()
                                                        /* pSignalSemaphores */ signalSemaphores } },
         m_drawFence[m_currentFrame]);
 
-    // -- REQUEST PRESENT IMAGE
+    // -- REQUEST PRESENT IMAGES
 
-    const std::array<vk::SwapchainKHR, 1> swapchains{ m_swapchain.swapchain };
-    const std::array<std::uint32_t, 1> imageIndices{ imageIndex };
-    result = m_graphicsQueue.presentKHR(vk::PresentInfoKHR{ // Wait for the "render finished" signal before presenting.
-                                                            /* pWaitSemaphores */ signalSemaphores,
-                                                            /* pSwapchains */ swapchains,
-                                                            /* pImageIndices */ imageIndices });
-    if (result != vk::Result::eSuccess)
+    // One present call for all the swapchains. The results tell which ones are out of date.
+    std::pmr::vector<vk::SwapchainKHR> swapchains{ &frameMemory };
+    std::pmr::vector<std::uint32_t> imageIndices{ &frameMemory };
+    std::pmr::vector<std::uint64_t> presentIds{ &frameMemory };
+    std::pmr::vector<vk::PresentTimeGOOGLE> presentTimes{ &frameMemory };
+    for (const auto& acquiredImage : acquiredImages)
+    {
+        const auto& output{ m_outputs[acquiredImage.output] };
+        swapchains.push_back(output.swapchain.swapchain);
+        imageIndices.push_back(acquiredImage.imageIndex);
+        // Tag the present, so the frame statistics can find out when it reached the screen.
+        presentIds.push_back(output.frameStatistics.getNextPresentId());
+        presentTimes.push_back(vk::PresentTimeGOOGLE{
+            /* presentID */ static_cast<std::uint32_t>(presentIds.back()), /* desiredPresentTime */ 0 });
+    }
+    std::pmr::vector<vk::Result> presentResults(acquiredImages.size(), vk::Result::eSuccess, &frameMemory);
+
+    const std::array<vk::Semaphore, 1> presentWaitSemaphores{ m_renderFinished[m_currentFrame] };
+    vk::PresentInfoKHR presentInfo{ // Wait for the "render finished" signal before presenting.
+                                    /* pWaitSemaphores */ presentWaitSemaphores,
+                                    /* pSwapchains */ swapchains,
+                                    /* pImageIndices */ imageIndices,
+                                    /* pResults */ presentResults };
+
+    const vk::PresentIdKHR presentIdInfo{ presentIds };
+    const vk::PresentTimesInfoGOOGLE presentTimesInfo{ presentTimes };
+    switch (m_physicalDevice.presentTimingSource)
+    {
+        case PresentTimingSource::PresentWait:
+            presentInfo.setPNext(&presentIdInfo);
+            break;
+        case PresentTimingSource::DisplayTiming:
+            presentInfo.setPNext(&presentTimesInfo);
+            break;
+        case PresentTimingSource::Cpu:
+            break;
+    }
+
+    try
+    {
+        // Success or suboptimal. presentResults has the result of every swapchain.
+        static_cast<void>(m_graphicsQueue.presentKHR(presentInfo));
+    }
+    catch (const vk::OutOfDateKHRError&)
+    {
+        // At least one swapchain is out of date. The results tell which ones.
+    }
+    for (auto i{ 0u }; i != acquiredImages.size(); ++i)
+    {
+        auto& output{ m_outputs[acquiredImages[i].output] };
+        if (presentResults[i] == vk::Result::eSuboptimalKHR || presentResults[i] == vk::Result::eErrorOutOfDateKHR)
+        {
+            output.isSwapchainOutdated = true;
+        }
+        else if (presentResults[i] != vk::Result::eSuccess)
+        {
+            throw Common::RendererError{ "Cannot present image." };
+        }
+
+        // -- FRAME STATISTICS
+
+        output.frameStatistics.endFrame();
+        if (output.frameStatistics.update(output.swapchain.swapchain) && m_settings.frameStatistics)
+        {
+            logFrameStatistics(*m_logger, acquiredImages[i].output, output.frameStatistics.getStatistics());
+        }
+    }
+
+    m_currentFrame = (m_currentFrame + 1) % m_settings.framesInFlight;
+    m_meshResidency.endFrame();
+    m_textureResidency.endFrame();
+}
+
+void VulkanRenderer::buildDrawList(std::pmr::memory_resource& memory)
+{
+    auto& drawList{ m_drawList.emplace(memory) };
+    // Every window shows the same draws, so the clusters are culled once for all of them.
+    const auto cullView{ makeClipSpaceCullView() };
+    if (m_gpuClusterCuller.has_value())
+    {
+        m_gpuClusterCuller->beginFrame(m_currentFrame, cullView);
+    }
+    auto& indexRanges{ m_indexRanges.emplace(&memory) };
+    const auto isResident = [this](std::uint32_t textureIndex)
+    {
+        return textureIndex < m_textures.size() && m_textures[textureIndex].has_value();
+    };
+    if (!isResident(s_defaultTextureIndex))
     {
-        throw Common::RendererError{ "Cannot present image." };
+        // Uploaded with the first meshes. Until then there is nothing to sample.
+        return;
     }
 
-    m_currentFrame = (m_currentFrame + 1) % s_maxFrameCountInQueue;
+    // There is no camera: the vertices are in clip space, where the height of the window is 2 units. Every window
+    // shows the same draws, so the LOD is chosen for the tallest one.
+    auto maxWindowHeight{ Common::Uint{ 0 } };
+    for (const auto& output : m_outputs)
+    {
+        maxWindowHeight = std::max(maxWindowHeight, output.windowSize.second);
+    }
+    const auto pixelsPerUnit{ static_cast<float>(maxWindowHeight) * 0.5f };
+
+    // -- CULL MESHES
+
+    // In parallel. Only reads, so the jobs share nothing. An evicted mesh is culled by the bounds it was loaded with.
+    std::pmr::vector<std::uint8_t> isInView(m_meshes.size(), &memory);
+    m_jobSystem->parallelFor(
+        0,
+        m_meshes.size(),
+        s_meshCullGrainSize,
+        [this, &cullView, &isInView](std::size_t begin, std::size_t end)
+        {
+            for (auto i{ begin }; i != end; ++i)
+            {
+                const auto meshIndex{ static_cast<std::uint32_t>(i) };
+                const auto* bounds{ m_meshes[i].has_value() ? &m_meshes[i]->getBounds()
+                                                            : m_meshUploader.findBounds(meshIndex) };
+                isInView[i] = bounds != nullptr && isVisible(*bounds, cullView);
+            }
+        });
+
+    // -- SELECT LODS AND MATERIALS
+
+    // Serial: the LOD selector, the residency trackers, the uploaders and the GPU culling keep state per mesh.
+    struct VisibleMesh
+    {
+        const Mesh* mesh;
+        std::uint16_t meshId;
+        std::uint32_t lod;
+        std::uint32_t textureSlot;
+        std::uint16_t materialId;
+        IndirectDraws indirectDraws;
+        // The clusters are culled on the CPU below.
+        bool isCpuCulled;
+    };
+    std::pmr::vector<VisibleMesh> visibleMeshes{ &memory };
+    for (auto i{ 0u }; i != m_meshes.size(); ++i)
+    {
+        if (!isInView[i])
+        {
+            continue;
+        }
+        if (!m_meshes[i].has_value())
+        {
+            // An evicted mesh comes back once it is in view.
+            m_meshUploader.reload(i);
+            continue;
+        }
+        const auto& mesh{ *m_meshes[i] };
+        m_meshResidency.markUsed(i);
+        // Every mesh is one instance. Both passes must draw the same LOD, or the depth test (eEqual) fails.
+        const auto lod{ m_lodSelector.select(i, mesh.getLods(), pixelsPerUnit) };
+        // The texture is the material, so the draws with the same texture are grouped.
+        if (!isResident(mesh.getTextureIndex()))
+        {
+            m_textureUploader.reload(mesh.getTextureIndex());
+        }
+        const auto textureIndex{ isResident(mesh.getTextureIndex()) ? mesh.getTextureIndex() : s_defaultTextureIndex };
+        m_textureResidency.markUsed(textureIndex);
+        const auto textureSlot{ m_textures[textureIndex]->getDescriptorIndex() };
+
+        // Both passes draw the same clusters too.
+        IndirectDraws indirectDraws{};
+        auto isCpuCulled{ false };
+        if (m_settings.clusterCulling != ClusterCullingMode::Off && mesh.getLodMeshlets(lod).meshletCount != 0)
+        {
+            // The GPU culling falls back to the CPU if its draw buffer is full.
+            const auto gpuDraws{ m_gpuClusterCuller.has_value() ? m_gpuClusterCuller->add(mesh, lod)
+                                                                : std::nullopt };
+            indirectDraws = gpuDraws.value_or(IndirectDraws{});
+            isCpuCulled = !gpuDraws.has_value();
+        }
+        visibleMeshes.push_back(VisibleMesh{ &mesh,
+                                             static_cast<std::uint16_t>(i),
+                                             lod,
+                                             textureSlot,
+                                             static_cast<std::uint16_t>(textureSlot),
+                                             indirectDraws,
+                                             isCpuCulled });
+    }
+
+    // -- CULL CLUSTERS
+
+    // In parallel. Each thread allocates the ranges from its own frame arena.
+    indexRanges.resize(visibleMeshes.size());
+    m_jobSystem->parallelFor(
+        0,
+        visibleMeshes.size(),
+        s_clusterCullGrainSize,
+        [this, &cullView, &visibleMeshes, &indexRanges](std::size_t begin, std::size_t end)
+        {
+            auto& threadMemory{ m_frameArena.getResource() };
+            for (auto i{ begin }; i != end; ++i)
+            {
+                const auto& visibleMesh{ visibleMeshes[i] };
+                if (visibleMesh.isCpuCulled)
+                {
+                    indexRanges[i].emplace(cullClusters(
+                        visibleMesh.mesh->getClusterBounds(),
+                        visibleMesh.mesh->getLodMeshlets(visibleMesh.lod),
+                        cullView,
+                        threadMemory));
+                }
+            }
+        });
+
+    // -- ADD DRAWS
+
+    // Serial, in the order of the meshes, so the draw list is the same however the jobs ran.
+    for (auto i{ std::size_t{ 0 } }; i != visibleMeshes.size(); ++i)
+    {
+        const auto& [mesh, meshId, lod, textureSlot, materialId, indirectDraws, isCpuCulled] = visibleMeshes[i];
+        std::span<const IndexRange> visibleRanges{};
+        if (isCpuCulled)
+        {
+            visibleRanges = *indexRanges[i];
+            if (visibleRanges.empty())
+            {
+                continue;
+            }
+        }
+        // There is no camera: the vertices are in clip space, so the depth of a mesh is the depth of its center.
+        const auto depth{ (mesh->getBounds().min.z + mesh->getBounds().max.z) * 0.5f };
+        if (m_settings.depthPrePass)
+        {
+            drawList.add(
+                DrawState{ DrawPass::DepthPrePass, s_depthPrePassPipelineId, /* materialId */ 0, meshId, depth },
+                m_pipelines.depthPrePass,
+                textureSlot,
+                *mesh,
+                lod,
+                visibleRanges,
+                indirectDraws);
+        }
+        drawList.add(
+            DrawState{ DrawPass::Opaque, s_meshPipelineId, materialId, meshId, depth },
+            m_pipelines.mesh,
+            textureSlot,
+            *mesh,
+            lod,
+            visibleRanges,
+            indirectDraws);
+    }
+    drawList.sort();
+}
+
+void VulkanRenderer::evictUnderPressure()
+{
+    // The geometry arena has a fixed size, so evicting meshes only makes room in it. Their ranges are free once the
+    // frame is done, so one mesh per frame is evicted until the waiting upload fits.
+    if (m_meshUploader.isWaitingForMemory())
+    {
+        evictMesh();
+    }
+
+    // Evicting a texture frees its memory right away.
+    const auto waitingSize{ m_textureUploader.getWaitingSize() };
+    const auto needsMemory = [this, waitingSize]
+    {
+        return m_memoryBudget.isOverBudget() ||
+               (waitingSize.has_value() && !m_memoryBudget.canAllocate(*waitingSize));
+    };
+    if (waitingSize.has_value() && !needsMemory())
+    {
+        // The upload fits the budget, but the device memory or the bindless slots ran out. The budget sees neither.
+        evictTexture();
+    }
+    while (needsMemory())
+    {
+        if (!evictTexture())
+        {
+            // Everything left is in use. The upload waits, and the meshes keep the default texture.
+            break;
+        }
+    }
+}
+
+bool VulkanRenderer::evictMesh()
+{
+    const auto meshIndex{ m_meshResidency.findLeastRecentlyUsed(
+        m_meshes.size(),
+        [this](std::size_t i)
+        {
+            return m_meshes[i].has_value();
+        }) };
+    if (!meshIndex.has_value())
+    {
+        return false;
+    }
+    // Frees its ranges in the geometry arena. The uploader keeps its data.
+    m_meshes[*meshIndex].reset();
+    m_metrics.addMeshEviction();
+    return true;
+}
+
+bool VulkanRenderer::evictTexture()
+{
+    const auto textureIndex{ m_textureResidency.findLeastRecentlyUsed(
+        m_textures.size(),
+        [this](std::size_t i)
+        {
+            // The meshes fall back to the default texture, so it stays.
+            return i != s_defaultTextureIndex && m_textures[i].has_value();
+        }) };
+    if (!textureIndex.has_value())
+    {
+        return false;
+    }
+    auto& texture{ m_textures[*textureIndex] };
+    m_bindlessDescriptors.freeTextureSlot(texture->getDescriptorIndex());
+    m_memoryBudget.free(texture->getMemorySize());
+    // No frame in flight samples it. The uploader keeps its data.
+    texture.reset();
+    m_metrics.addTextureEviction();
+    return true;
+}
+
+std::uint32_t VulkanRenderer::allocateMeshIndex()
+{
+    if (m_freeMeshIndices.empty())
+    {
+        return m_meshIndexCount++;
+    }
+    // The lowest, so the loops over the meshes stay short.
+    std::ranges::pop_heap(m_freeMeshIndices, std::greater{});
+    const auto meshIndex{ m_freeMeshIndices.back() };
+    m_freeMeshIndices.pop_back();
+    return meshIndex;
+}
+
+const FrameStatistics& VulkanRenderer::getFrameStatistics() const
+{
+    return m_outputs.front().frameStatistics.getStatistics();
+}
+
+void VulkanRenderer::setCaptureSink(CaptureSink sink)
+{
+    // The frames captured so far go to the old sink.
+    m_device.waitIdle();
+    m_frameCapture.collectAll();
+    m_frameCapture.setSink(std::move(sink));
+
+    // The swapchain images need the transfer usage and the frame graph a different final layout.
+    m_outputs.front().isSwapchainOutdated = true;
+}
+
+std::vector<Output> VulkanRenderer::createOutputs(std::span<const Common::NotNull<Window::IWindow*>> windows)
+{
+    std::vector<Output> outputs{};
+    outputs.reserve(windows.size());
+    for (auto i{ 0u }; i != windows.size(); ++i)
+    {
+        // Only the first window is captured.
+        const auto isCaptureNeeded{ i == 0 && m_frameCapture.hasSink() };
+        auto swapchain{ createSwapchain(
+            windows[i]->getSize(), m_surfaces[i], m_physicalDevice, m_device, m_settings, isCaptureNeeded, *m_logger) };
+        // The pipelines are shared, so the render passes must be compatible.
+        if (!outputs.empty() && swapchain.imageFormat != outputs.front().swapchain.imageFormat)
+        {
+            throw Common::RendererError{ "The windows have no common swapchain format." };
+        }
+
+        auto frameGraph{ createFrameGraph(swapchain, /* isCaptured */ false) };
+        outputs.push_back(Output{ windows[i]->getSize(),
+                                  std::move(swapchain),
+                                  std::move(frameGraph),
+                                  createSemaphores(m_device, m_settings.framesInFlight),
+                                  FrameStatisticsCollector{ m_physicalDevice.presentTimingSource,
+                                                            /* interval */ std::chrono::seconds{ 1 },
+                                                            getRefreshDuration(*windows[i]) } });
+        outputs.back().frameStatistics.resetSwapchain(outputs.back().swapchain.swapchain);
+    }
+    return outputs;
+}
+
+void VulkanRenderer::recreateOutdatedSwapchains()
+{
+    const auto isRecreatable = [](const Output& output)
+    {
+        // A minimized window has nothing to draw on.
+        return output.isSwapchainOutdated && output.windowSize.first != 0 && output.windowSize.second != 0;
+    };
+    if (std::ranges::none_of(m_outputs, isRecreatable))
+    {
+        return;
+    }
+
+    // Everything that references the swapchain images must be idle before they go away.
+    m_device.waitIdle();
+    m_frameCapture.collectAll();
+
+    for (auto i{ 0u }; i != m_outputs.size(); ++i)
+    {
+        if (isRecreatable(m_outputs[i]))
+        {
+            recreateSwapchain(i);
+        }
+    }
+}
+
+void VulkanRenderer::recreateSwapchain(std::size_t outputIndex)
+{
+    auto& output{ m_outputs[outputIndex] };
+    const auto isCaptureNeeded{ outputIndex == 0 && m_frameCapture.hasSink() };
+
+    output.swapchain = createSwapchain(
+        output.windowSize,
+        m_surfaces[outputIndex],
+        m_physicalDevice,
+        m_device,
+        m_settings,
+        isCaptureNeeded,
+        *m_logger,
+        output.swapchain.swapchain);
+    output.frameStatistics.resetSwapchain(output.swapchain.swapchain);
+
+    if (outputIndex == 0)
+    {
+        m_frameCapture.setSource(
+            output.swapchain.imageFormat, output.swapchain.imageExtent, output.swapchain.imageUsage);
+        if (m_frameCapture.hasSink() && !m_frameCapture.isEnabled())
+        {
+            m_logger->warning(
+                "Capture: The swapchain images ({}) cannot be copied. Nothing is captured.",
+                vk::to_string(output.swapchain.imageFormat));
+        }
+    }
+
+    // The transient images have the size of the swapchain images.
+    // The pipelines stay. The viewport is dynamic and the new render passes are compatible with the old ones.
+    output.frameGraph = createFrameGraph(output.swapchain, outputIndex == 0 && m_frameCapture.isEnabled());
+
+    output.isSwapchainOutdated = false;
+}
+
+FrameGraph VulkanRenderer::createFrameGraph(const Swapchain& swapchain, bool isCaptured)
+{
+    RenderGraph graph{ &m_physicalDevice.device, &m_device, swapchain.imageExtent };
+
+    // The presentation engine hands over the image when the image-available semaphore is signaled.
+    // The submission waits for it in the color attachment output stage.
+    // If it is captured, the copy after the graph transitions it to the present layout.
+    const auto backbuffer{ isCaptured ? graph.importImage(
+                                            "backbuffer",
+                                            swapchain.imageFormat,
+                                            vk::ImageLayout::eTransferSrcOptimal,
+                                            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                                            vk::PipelineStageFlagBits::eTransfer,
+                                            vk::AccessFlagBits::eTransferRead)
+                                      : graph.importImage(
+                                            "backbuffer",
+                                            swapchain.imageFormat,
+                                            vk::ImageLayout::ePresentSrcKHR,
+                                            vk::PipelineStageFlagBits::eColorAttachmentOutput) };
+    const auto depth{ graph.createImage("depth", m_depthFormat) };
+
+    // 1.0 is the far plane.
+    const vk::ClearValue depthClearValue{ vk::ClearDepthStencilValue{ /* depth */ 1.0f, /* stencil */ 0 } };
+
+    // The passes capture the extent, because the graph is recreated with the swapchain.
+    const auto extent{ swapchain.imageExtent };
+
+    std::optional<RenderGraphPass> depthPrePass{};
+    if (m_settings.depthPrePass)
+    {
+        depthPrePass = graph.addPass(RenderGraphPassDesc{
+            "depth pre-pass",
+            { RenderGraphAttachment{ depth, AttachmentAccess::DepthWrite, depthClearValue } },
+            [this, extent](const vk::raii::CommandBuffer& commandBuffer)
+            {
+                recordViewport(commandBuffer, extent);
+                m_metrics.addDraws(recordDraws(
+                    commandBuffer,
+                    m_pipelineLayout,
+                    m_bindlessDescriptors.getDescriptorSet(),
+                    m_geometryArena,
+                    m_drawList->getItems(DrawPass::DepthPrePass)));
+            } });
+    }
+
+    // With the pre-pass the depth is only tested. Otherwise the color pass fills it.
+    const auto depthAttachment{ m_settings.depthPrePass
+                                    ? RenderGraphAttachment{ depth, AttachmentAccess::DepthRead }
+                                    : RenderGraphAttachment{ depth, AttachmentAccess::DepthWrite, depthClearValue } };
+    const auto colorPass{ graph.addPass(RenderGraphPassDesc{
+        "color",
+        { RenderGraphAttachment{
+              backbuffer, AttachmentAccess::ColorWrite, vk::ClearValue{ vk::ClearColorValue{ 0.5f, 0.5f, 0.5f, 0.5f } } },
+          depthAttachment },
+        [this, extent](const vk::raii::CommandBuffer& commandBuffer)
+        {
+            recordViewport(commandBuffer, extent);
+            m_metrics.addDraws(recordDraws(
+                commandBuffer,
+                m_pipelineLayout,
+                m_bindlessDescriptors.getDescriptorSet(),
+                m_geometryArena,
+                m_drawList->getItems(DrawPass::Opaque)));
+            m_metrics.addDraws(recordDraws(
+                commandBuffer,
+                m_pipelineLayout,
+                m_bindlessDescriptors.getDescriptorSet(),
+                m_geometryArena,
+                m_drawList->getItems(DrawPass::Transparent)));
+
+            // After the opaque meshes, because the particles are blended.
+            if (m_particleSystem.has_value())
+            {
+                commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipelines.particle);
+                m_particleSystem->recordDraw(commandBuffer, m_particlePipelineLayout);
+                // One indirect draw. The GPU decides how many particles it has.
+                m_metrics.addDraws(
+                    DrawCounts{ /* drawCount */ 1, /* triangleCount */ 0, /* pipelineBindCount */ 1 });
+            }
+        } }) };
+
+    graph.compile();
+
+    return FrameGraph{ std::move(graph), backbuffer, depthPrePass, colorPass, isCaptured };
+}
+
+Pipelines VulkanRenderer::createPipelines()
+{
+    // The render passes of every output are compatible. Any of them will do.
+    const auto& frameGraph{ m_outputs.front().frameGraph };
+
+    // Jobs must not block, so the shader binaries are waited for here. Before anything is scheduled, since a load
+    // error throws.
+    const auto hasParticles{ m_particleSystem.has_value() };
+    const std::span<const std::byte> vertexShader{ m_shaders.vertex.get() };
+    const std::span<const std::byte> fragmentShader{ m_shaders.fragment.get() };
+    const auto depthVertexShader{ frameGraph.depthPrePass.has_value() ? std::span{ m_shaders.depthVertex.get() }
+                                                                      : std::span<const std::byte>{} };
+    const auto particleVertexShader{ hasParticles ? std::span{ m_shaders.particleVertex.get() }
+                                                  : std::span<const std::byte>{} };
+    const auto particleFragmentShader{ hasParticles ? std::span{ m_shaders.particleFragment.get() }
+                                                    : std::span<const std::byte>{} };
+
+    // The driver compiles the shaders when the pipeline is created. That is the slowest part of startup, and
+    // creating pipelines on the same device from multiple threads is allowed. So every pipeline is a job, and this
+    // thread builds some of them while it waits.
+    vk::raii::Pipeline depthPrePassPipeline{ nullptr };
+    vk::raii::Pipeline meshPipeline{ nullptr };
+    vk::raii::Pipeline particlePipeline{ nullptr };
+    Common::JobCounter counter{};
+    if (frameGraph.depthPrePass.has_value())
+    {
+        m_jobSystem->schedule(
+            [&]
+            {
+                depthPrePassPipeline = createDepthPrePassPipeline(
+                    depthVertexShader,
+                    m_device,
+                    frameGraph.graph.getRenderPass(*frameGraph.depthPrePass),
+                    m_pipelineLayout);
+            },
+            &counter);
+    }
+    if (hasParticles)
+    {
+        m_jobSystem->schedule(
+            [&]
+            {
+                particlePipeline = createParticlePipeline(
+                    particleVertexShader,
+                    particleFragmentShader,
+                    m_device,
+                    frameGraph.graph.getRenderPass(frameGraph.colorPass),
+                    m_particlePipelineLayout);
+            },
+            &counter);
+    }
+    m_jobSystem->schedule(
+        [&]
+        {
+            meshPipeline = createPipeline(
+                vertexShader,
+                fragmentShader,
+                m_device,
+                frameGraph.graph.getRenderPass(frameGraph.colorPass),
+                m_pipelineLayout,
+                m_settings);
+        },
+        &counter);
+    m_jobSystem->wait(counter);
+
+    return Pipelines{ std::move(depthPrePassPipeline), std::move(meshPipeline), std::move(particlePipeline) };
 }
 
 } // namespace VkTest1::Renderer::Detail
@@ -1,14 +1,42 @@
 #pragma once
 
-#include "common/IFileSystem.hpp"
+#include "assets/IAssetLoader.hpp"
+#include "common/FrameArena.hpp"
+#include "common/JobSystem.hpp"
+#include "common/Metrics.hpp"
 #include "common/Types.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/BindlessDescriptors.hpp"
+#include "renderer/ClusterCulling.hpp"
+#include "renderer/DrawList.hpp"
+#include "renderer/FrameCapture.hpp"
+#include "renderer/FrameStatisticsCollector.hpp"
+#include "renderer/GeometryArena.hpp"
+#include "renderer/GpuClusterCuller.hpp"
 #include "renderer/IRenderer.hpp"
+#include "renderer/LodSelector.hpp"
+#include "renderer/MemoryBudget.hpp"
 #include "renderer/Mesh.hpp"
+#include "renderer/MeshUploader.hpp"
+#include "renderer/ParticleSystem.hpp"
+#include "renderer/RenderGraph.hpp"
+#include "renderer/RendererMetrics.hpp"
+#include "renderer/RendererSettings.hpp"
+#include "renderer/ResidencyTracker.hpp"
+#include "renderer/TextureImage.hpp"
+#include "renderer/TextureUploader.hpp"
 #include "window/IWindow.hpp"
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <cstddef>
+#include <future>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace VkTest1::Renderer::Detail
 {
@@ -17,6 +45,8 @@ struct QueueFamilyInfo
 {
     std::optional<std::uint32_t> graphicsQueueFamilyIndex{};
     std::optional<std::uint32_t> presentationQueueFamilyIndex{};
+    // A compute-only family if there is one (async compute). Otherwise the graphics family.
+    std::optional<std::uint32_t> computeQueueFamilyIndex{};
 };
 
 struct PhysicalDevice
@@ -24,6 +54,10 @@ struct PhysicalDevice
     vk::raii::PhysicalDevice device;
     QueueFamilyInfo queueFamilyInfo{};
     std::uint32_t deviceIndex;
+    // The best supported way to measure presentation times. Its extensions are enabled on the device.
+    PresentTimingSource presentTimingSource{ PresentTimingSource::Cpu };
+    // VK_EXT_memory_budget. Enabled on the device if supported.
+    bool hasMemoryBudget{ false };
 };
 
 struct SwapchainImage
@@ -38,41 +72,205 @@ struct Swapchain
     vk::raii::SwapchainKHR swapchain;
     vk::Format imageFormat;
     vk::Extent2D imageExtent;
+    vk::ImageUsageFlags imageUsage;
     std::vector<SwapchainImage> images;
 };
 
+// SPIR-V binaries of the shaders, loaded on the asset loader threads.
+// Kept after startup, so recreating the pipelines does not read the files again.
+struct ShaderBinaries
+{
+    std::shared_future<std::vector<std::byte>> vertex;
+    std::shared_future<std::vector<std::byte>> fragment;
+    // Invalid if the depth pre-pass is disabled.
+    std::shared_future<std::vector<std::byte>> depthVertex;
+    // Invalid if the particle system is disabled.
+    std::shared_future<std::vector<std::byte>> particleVertex;
+    std::shared_future<std::vector<std::byte>> particleFragment;
+    std::shared_future<std::vector<std::byte>> particleEmit;
+    std::shared_future<std::vector<std::byte>> particlePrepare;
+    std::shared_future<std::vector<std::byte>> particleSimulate;
+    std::shared_future<std::vector<std::byte>> particleCompact;
+    // Invalid unless the clusters are culled on the GPU.
+    std::shared_future<std::vector<std::byte>> clusterCull;
+};
+
+// The pipelines of the render passes. Shared by all outputs, because their render passes are compatible and the
+// viewport is dynamic.
+struct Pipelines
+{
+    // Null if the depth pre-pass is disabled.
+    vk::raii::Pipeline depthPrePass;
+    vk::raii::Pipeline mesh;
+    // Null if the particle system is disabled.
+    vk::raii::Pipeline particle;
+};
+
+struct FrameGraph
+{
+    RenderGraph graph;
+    // The swapchain image. Set before every execution.
+    RenderGraphResource backbuffer;
+    // Empty if the depth pre-pass is disabled.
+    std::optional<RenderGraphPass> depthPrePass;
+    RenderGraphPass colorPass;
+    // The backbuffer is left for FrameCapture::recordCopy().
+    bool isCaptured;
+};
+
+// A window the renderer draws into, with everything that depends on its swapchain.
+// Its surface is the one with the same index in VulkanRenderer::m_surfaces.
+struct Output
+{
+    // As of the last frame state.
+    std::pair<Common::Uint, Common::Uint> windowSize;
+    Swapchain swapchain;
+    FrameGraph frameGraph;
+    // One per frame in flight.
+    std::vector<vk::raii::Semaphore> imageAvailable;
+    FrameStatisticsCollector frameStatistics;
+    // Stays set while the window is minimized. The output is skipped until then.
+    bool isSwapchainOutdated{ false };
+};
+
+//
+// Draws the same scene into every window. The windows share the device, the pipelines, the meshes and the command
+// buffers. A frame acquires an image from every swapchain, renders all of them in one command buffer and presents
+// them with one present call.
+//
+// The first window is the primary one: its frames are captured and its statistics are reported.
+//
+// The windows are only used by the constructor. Later their sizes come with the frame states, so the renderer can
+// run on another thread than the windows.
+//
 class VulkanRenderer : public IRenderer
 {
 public:
-    explicit VulkanRenderer(Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Window::IWindow*> window);
+    // The windows must have a common swapchain format. The metrics of the renderer are added to the registry.
+    explicit VulkanRenderer(
+        Common::NotNull<Assets::IAssetLoader*> assetLoader, Common::NotNull<Common::JobSystem*> jobSystem,
+        std::vector<Common::NotNull<Window::IWindow*>> windows, Common::NotNull<Logging::ILogger*> logger,
+        Common::NotNull<Common::MetricsRegistry*> metricsRegistry, const RendererSettings& settings);
 
     ~VulkanRenderer() override;
 
-    void draw() override;
+    void addTexture(std::future<Texture::TextureData> textureData) override;
+
+    std::uint32_t addMesh(std::future<Geometry::MeshData> meshData, std::optional<std::uint32_t> texture) override;
+
+    void removeMesh(std::uint32_t mesh) override;
+
+    void draw(const FrameState& frameState) override;
+
+    const FrameStatistics& getFrameStatistics() const override;
+
+    void setCaptureSink(CaptureSink sink) override;
 
 private:
+    std::vector<Output> createOutputs(std::span<const Common::NotNull<Window::IWindow*>> windows);
+
+    // Recreates the outdated swapchains of the windows that are not minimized.
+    void recreateOutdatedSwapchains();
+
+    // Recreates the swapchain and everything that depends on its images or extent. The device must be idle.
+    void recreateSwapchain(std::size_t outputIndex);
+
+    // The passes record with the pipelines and meshes of this renderer.
+    FrameGraph createFrameGraph(const Swapchain& swapchain, bool isCaptured);
+
+    // Compiles the pipelines in parallel. Waits for the shader binaries they need.
+    Pipelines createPipelines();
+
+    // Sorts the draws of the meshes for the frame graph passes. Marks the meshes in view and their textures as used,
+    // and uploads them again if they were evicted.
+    void buildDrawList(std::pmr::memory_resource& memory);
+
+    // Evicts what the waiting uploads need room for, and what exceeds the memory budget. After the draw list, so the
+    // meshes and textures it uses are marked.
+    void evictUnderPressure();
+
+    // Evict the least recently used mesh or texture that no frame in flight uses. False if there is none.
+    bool evictMesh();
+    bool evictTexture();
+
+    // A mesh index that no mesh has, the lowest freed one if any.
+    std::uint32_t allocateMeshIndex();
+
+    RendererSettings m_settings;
     unsigned int m_currentFrame{ 0 };
-    Common::NotNull<Common::IFileSystem*> m_fileSystem{};
-    Common::NotNull<Window::IWindow*> m_window{};
+    Common::NotNull<Assets::IAssetLoader*> m_assetLoader{};
+    Common::NotNull<Common::JobSystem*> m_jobSystem{};
+    Common::NotNull<Logging::ILogger*> m_logger{};
+    // The CPU side data of a frame lives until the fence of the frame has signaled.
+    Common::FrameArena m_frameArena;
+    // Before everything else, so the loads start right away.
+    ShaderBinaries m_shaders;
+    // Handed over to the mesh uploader once it exists.
+    std::future<Geometry::MeshData> m_quadMesh;
     vk::raii::Context m_context{};
     vk::raii::Instance m_instance;
     vk::raii::DebugUtilsMessengerEXT m_debugMessenger;
-    vk::raii::SurfaceKHR m_surface;
+    // One per window.
+    std::vector<vk::raii::SurfaceKHR> m_surfaces;
     PhysicalDevice m_physicalDevice;
     vk::raii::Device m_device;
-    Swapchain m_swapchain;
+    // Before the uploaders, which count into it.
+    RendererMetrics m_metrics;
+    // Before the uploaders, which allocate from it.
+    MemoryBudget m_memoryBudget;
+    vk::Format m_depthFormat;
+    // Before the outputs, whose swapchains are created with the usage the capture needs.
+    FrameCapture m_frameCapture;
+    // One per window, in the order of the windows.
+    std::vector<Output> m_outputs;
     vk::raii::Queue m_graphicsQueue;
     vk::raii::Queue m_presentationQueue;
-    vk::raii::RenderPass m_renderPass;
+    vk::raii::Queue m_computeQueue;
+    // Empty if the particle system is disabled.
+    std::optional<ParticleSystem> m_particleSystem;
+    // The textures and the meshlet buffer. Before everything that writes or binds it.
+    BindlessDescriptors m_bindlessDescriptors;
+    // The vertices, indices and meshlets of all meshes. Before the meshes, which free their ranges into it.
+    GeometryArena m_geometryArena;
+    // Empty unless the clusters are culled on the GPU.
+    std::optional<GpuClusterCuller> m_gpuClusterCuller;
+    TextureUploader m_textureUploader;
     vk::raii::PipelineLayout m_pipelineLayout;
-    vk::raii::Pipeline m_pipeline;
-    std::vector<vk::raii::Framebuffer> m_framebuffers;
+    // Null if the particle system is disabled.
+    vk::raii::PipelineLayout m_particlePipelineLayout;
+    Pipelines m_pipelines;
     vk::raii::CommandPool m_graphicsCommandPool;
     std::vector<vk::raii::CommandBuffer> m_commandBuffers;
-    std::vector<vk::raii::Semaphore> m_imageAvailable;
+    // One per frame in flight. The present waits for it on behalf of every output.
     std::vector<vk::raii::Semaphore> m_renderFinished;
     std::vector<vk::raii::Fence> m_drawFence;
-    Mesh m_firstMesh;
+    MeshUploader m_meshUploader;
+    // Indexed by the mesh index. Empty while the mesh is loading or evicted, or if it failed to load or was removed.
+    // The indices of removed meshes are reused, so the vector stays as large as the most meshes at a time, and the
+    // indices fit into the draw states.
+    std::vector<std::optional<Mesh>> m_meshes{};
+    // The mesh index of every mesh number that is not removed. The internal meshes have no number.
+    std::unordered_map<std::uint32_t, std::uint32_t> m_meshIndices{};
+    // Of removed meshes, as a heap with the lowest on top.
+    std::vector<std::uint32_t> m_freeMeshIndices{};
+    // The number of mesh indices handed out so far, free ones included.
+    std::uint32_t m_meshIndexCount{ 0 };
+    // The number of meshes added so far.
+    std::uint32_t m_addedMeshCount{ 0 };
+    // Indexed like the meshes.
+    LodSelector m_lodSelector;
+    ResidencyTracker m_meshResidency;
+    // Indexed by the texture index of the meshes. Empty while the texture is loading or evicted, or if it failed to
+    // load.
+    std::vector<std::optional<TextureImage>> m_textures{};
+    // The number of textures added so far.
+    std::uint32_t m_addedTextureCount{ 0 };
+    ResidencyTracker m_textureResidency;
+    // The index ranges of the CPU cluster culling of the current frame, per visible mesh, empty if it isn't culled on
+    // the CPU. The draw list points into them. In the frame arenas of the threads that culled them.
+    std::optional<std::pmr::vector<std::optional<std::pmr::vector<IndexRange>>>> m_indexRanges{};
+    // Of the current frame. Its memory is in the frame arena.
+    std::optional<DrawList> m_drawList{};
 };
 
 } // namespace VkTest1::Renderer::Detail
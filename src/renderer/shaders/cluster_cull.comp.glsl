@@ -0,0 +1,90 @@
+// GLSL 4.5
+#version 450
+
+// Culls the meshlets of one mesh LOD. Writes one VkDrawIndexedIndirectCommand per meshlet: the culled ones get no
+// instances. Must match GpuClusterCuller.cpp.
+
+layout(local_size_x = 64) in;
+
+// Must match BindlessDescriptors in VulkanRenderer.cpp.
+const uint c_maxStorageBufferCount = 4096;
+
+// Geometry::Meshlet. Scalars, so the stride is 40 bytes as on the CPU.
+struct Meshlet
+{
+    float centerX;
+    float centerY;
+    float centerZ;
+    float radius;
+    float coneAxisX;
+    float coneAxisY;
+    float coneAxisZ;
+    float coneCutoff;
+    uint firstIndex;
+    uint indexCount;
+};
+
+struct DrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+// The slot of the meshlet buffer of the geometry arena.
+layout(constant_id = 0) const uint c_meshletBuffer = 0;
+
+// The bindless storage buffers. c_meshletBuffer has the meshlets of all meshes.
+layout(std430, set = 0, binding = 1) readonly buffer Meshlets
+{
+    Meshlet meshlets[];
+} meshletBuffers[c_maxStorageBufferCount];
+
+// The draws of the frame. The dynamic offset selects the frame.
+layout(std430, set = 1, binding = 0) writeonly buffer Draws
+{
+    DrawIndexedIndirectCommand draws[];
+};
+
+layout(push_constant) uniform PushConstants
+{
+    // Inside is dot(xyz, p) + w >= 0.
+    vec4 frustumPlanes[6];
+    vec3 viewDirection;
+    uint firstMeshlet;
+    uint meshletCount;
+    // Where the commands of the meshlets start in draws.
+    uint firstDraw;
+    // Of the mesh in the geometry arena. The meshlets have indices relative to them.
+    uint firstIndex;
+    int vertexOffset;
+} pc;
+
+void main()
+{
+    const uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.meshletCount)
+    {
+        return;
+    }
+
+    const Meshlet meshlet = meshletBuffers[c_meshletBuffer].meshlets[pc.firstMeshlet + i];
+    const vec3 center = vec3(meshlet.centerX, meshlet.centerY, meshlet.centerZ);
+    bool visible = true;
+    for (int plane = 0; plane < 6; ++plane)
+    {
+        visible = visible && dot(pc.frustumPlanes[plane].xyz, center) + pc.frustumPlanes[plane].w >= -meshlet.radius;
+    }
+    // All normals face away if the direction to the eye is outside of the cone widened by 90 degrees.
+    const vec3 coneAxis = vec3(meshlet.coneAxisX, meshlet.coneAxisY, meshlet.coneAxisZ);
+    visible = visible && dot(-pc.viewDirection, coneAxis) <= meshlet.coneCutoff;
+
+    draws[pc.firstDraw + i] = DrawIndexedIndirectCommand(
+        meshlet.indexCount,
+        visible ? 1u : 0u,
+        pc.firstIndex + meshlet.firstIndex,
+        pc.vertexOffset,
+        /* firstInstance */ 0u);
+}
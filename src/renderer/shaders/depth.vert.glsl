@@ -0,0 +1,14 @@
+// GLSL 4.5
+#version 450
+
+// Depth pre-pass. Reads only the position from the vertex buffer.
+
+layout(location = 0) in vec3 position;
+
+// The color pass tests depth with eEqual, so both passes must compute bit identical positions.
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = vec4(position, 1.0);
+}
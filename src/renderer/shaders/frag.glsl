@@ -2,9 +2,23 @@
 #version 450
 
 layout(location = 0) in vec4 color;
+layout(location = 1) in vec2 texCoord;
 layout(location = 0) out vec4 outColor;
 
+// Must match BindlessDescriptors in VulkanRenderer.cpp.
+const uint c_maxTextureCount = 1024;
+
+// The bindless textures.
+layout(set = 0, binding = 0) uniform sampler2D textures[c_maxTextureCount];
+
+// Must match DrawList.cpp.
+layout(push_constant) uniform PushConstants
+{
+    // The slot of the texture of the mesh. The texture is white for the meshes without one.
+    uint textureIndex;
+} pc;
+
 void main()
 {
-    outColor = color;
+    outColor = color * texture(textures[pc.textureIndex], texCoord);
 }
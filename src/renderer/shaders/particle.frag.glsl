@@ -0,0 +1,12 @@
+// GLSL 4.5
+#version 450
+
+// Outputs the interpolated particle color.
+
+layout(location = 0) in vec4 color;
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    outColor = color;
+}
@@ -0,0 +1,32 @@
+// GLSL 4.5
+#version 450
+
+struct Particle
+{
+    vec4 position;
+    vec4 velocity;
+    vec4 color;
+};
+
+// The output of the compact pass. See particles.glsl.
+layout(std430, set = 0, binding = 1) readonly buffer OutParticles
+{
+    Particle particles[];
+};
+
+layout(location = 0) out vec4 fragmentColor;
+
+// Half size of the quad in NDC.
+const float c_halfSize = 0.004;
+
+// Two triangles.
+const vec2 c_corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(1.0, 1.0), vec2(-1.0, 1.0), vec2(-1.0, -1.0));
+
+void main()
+{
+    const Particle particle = particles[gl_InstanceIndex];
+    gl_Position = vec4(particle.position.xy + c_corners[gl_VertexIndex] * c_halfSize, particle.position.z, 1.0);
+    fragmentColor = particle.color;
+}
@@ -0,0 +1,27 @@
+// GLSL 4.5
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "particles.glsl"
+
+layout(local_size_x = c_groupSize) in;
+
+void main()
+{
+    const uint i = gl_GlobalInvocationID.x;
+    if (i >= aliveCount[pc.inList])
+    {
+        return;
+    }
+
+    const Particle particle = inParticles[i];
+    if (particle.position.w <= 0.0)
+    {
+        return;
+    }
+
+    // The order of the particles doesn't matter. They are blended with depth test but without depth write.
+    const uint index = atomicAdd(aliveCount[1 - pc.inList], 1);
+    outParticles[index] = particle;
+    atomicAdd(instanceCount, 1);
+}
@@ -0,0 +1,50 @@
+// GLSL 4.5
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "particles.glsl"
+
+layout(local_size_x = c_groupSize) in;
+
+// PCG hash. Good enough for particles, and stateless.
+uint hash(uint value)
+{
+    const uint state = value * 747796405u + 2891336453u;
+    const uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random(inout uint seed)
+{
+    seed = hash(seed);
+    return float(seed) / 4294967295.0;
+}
+
+void main()
+{
+    const uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.emitCount)
+    {
+        return;
+    }
+
+    // When full, the count overshoots the capacity. The prepare pass clamps it.
+    const uint index = atomicAdd(aliveCount[pc.inList], 1);
+    if (index >= pc.capacity)
+    {
+        return;
+    }
+
+    uint seed = hash(pc.seed ^ hash(i));
+
+    // A fountain at the bottom of the screen. Y points down in NDC.
+    const float angle = (random(seed) - 0.5) * 0.6;
+    const float speed = 0.8 + random(seed) * 0.6;
+    const float life = 2.0 + random(seed) * 2.0;
+
+    Particle particle;
+    particle.position = vec4(0.0, 0.9, 0.2 + random(seed) * 0.7, life);
+    particle.velocity = vec4(sin(angle) * speed, -cos(angle) * speed, 0.0, life);
+    particle.color = vec4(1.0, 0.5 + random(seed) * 0.5, random(seed) * 0.3, 1.0);
+    inParticles[index] = particle;
+}
@@ -0,0 +1,25 @@
+// GLSL 4.5
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "particles.glsl"
+
+// Runs as a single invocation between the emit and the simulate passes.
+layout(local_size_x = 1) in;
+
+void main()
+{
+    const uint count = min(aliveCount[pc.inList], pc.capacity);
+    aliveCount[pc.inList] = count;
+    aliveCount[1 - pc.inList] = 0;
+
+    groupCountX = (count + c_groupSize - 1) / c_groupSize;
+    groupCountY = 1;
+    groupCountZ = 1;
+
+    // A quad (two triangles) per particle. The compact pass counts the instances.
+    vertexCount = 6;
+    instanceCount = 0;
+    firstVertex = 0;
+    firstInstance = 0;
+}
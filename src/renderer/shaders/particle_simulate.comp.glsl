@@ -0,0 +1,27 @@
+// GLSL 4.5
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "particles.glsl"
+
+layout(local_size_x = c_groupSize) in;
+
+// Y points down in NDC.
+const vec3 c_gravity = vec3(0.0, 0.9, 0.0);
+
+void main()
+{
+    const uint i = gl_GlobalInvocationID.x;
+    if (i >= aliveCount[pc.inList])
+    {
+        return;
+    }
+
+    Particle particle = inParticles[i];
+    particle.velocity.xyz += c_gravity * pc.deltaTime;
+    particle.position.xyz += particle.velocity.xyz * pc.deltaTime;
+    particle.position.w = max(particle.position.w - pc.deltaTime, 0.0);
+    // Fade out.
+    particle.color.a = particle.position.w / particle.velocity.w;
+    inParticles[i] = particle;
+}
@@ -0,0 +1,50 @@
+// Shared by the particle shaders. Must match ParticleSystem.hpp.
+
+struct Particle
+{
+    // xyz: Position in NDC. w: Remaining life in seconds. Dead at 0.
+    vec4 position;
+    // xyz: Velocity in NDC per second. w: Total life in seconds.
+    vec4 velocity;
+    vec4 color;
+};
+
+// The particles of the previous frame plus the emitted ones.
+layout(std430, set = 0, binding = 0) buffer InParticles
+{
+    Particle inParticles[];
+};
+
+// The particles still alive after this frame. The draw reads them.
+layout(std430, set = 0, binding = 1) buffer OutParticles
+{
+    Particle outParticles[];
+};
+
+layout(std430, set = 0, binding = 2) buffer State
+{
+    // VkDrawIndirectCommand
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+    // VkDispatchIndirectCommand
+    uint groupCountX;
+    uint groupCountY;
+    uint groupCountZ;
+    uint padding;
+    // Particle count of the two lists. The descriptor sets swap the lists every frame, inList tells which is which.
+    uint aliveCount[2];
+};
+
+layout(push_constant) uniform PushConstants
+{
+    float deltaTime;
+    uint emitCount;
+    uint seed;
+    uint inList;
+    uint capacity;
+} pc;
+
+// Must match ParticleSystem.cpp.
+const uint c_groupSize = 64;
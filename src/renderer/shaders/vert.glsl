@@ -3,11 +3,17 @@
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 color;
+layout(location = 2) in vec2 texCoord;
 
 layout(location = 0) out vec4 fragmentColor;
+layout(location = 1) out vec2 fragmentTexCoord;
+
+// Must match the depth pre-pass exactly. See depth.vert.glsl.
+invariant gl_Position;
 
 void main()
 {
     gl_Position = vec4(position, 1.0);
     fragmentColor = vec4(color, 1.0);
+    fragmentTexCoord = texCoord;
 }
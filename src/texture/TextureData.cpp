@@ -0,0 +1,52 @@
+#include "texture/TextureData.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace VkTest1::Texture
+{
+
+bool isBlockCompressed(TextureFormat format)
+{
+    return format != TextureFormat::Rgba8;
+}
+
+std::uint64_t getMipLevelSize(TextureFormat format, std::uint32_t width, std::uint32_t height)
+{
+    const auto blockCount{ std::uint64_t{ (width + 3) / 4 } * ((height + 3) / 4) };
+    switch (format)
+    {
+        case TextureFormat::Rgba8:
+            return std::uint64_t{ width } * height * 4;
+        case TextureFormat::Bc1:
+            return blockCount * 8;
+        case TextureFormat::Bc7:
+            return blockCount * 16;
+    }
+    return 0;
+}
+
+std::uint32_t getFullMipLevelCount(std::uint32_t width, std::uint32_t height)
+{
+    return static_cast<std::uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+}
+
+std::vector<MipLevel> getMipLevels(
+    TextureFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mipLevelCount,
+    std::uint64_t alignment)
+{
+    std::vector<MipLevel> mipLevels{};
+    mipLevels.reserve(mipLevelCount);
+    auto offset{ std::uint64_t{ 0 } };
+    for (auto i{ 0u }; i != mipLevelCount; ++i)
+    {
+        const auto mipWidth{ std::max(width >> i, 1u) };
+        const auto mipHeight{ std::max(height >> i, 1u) };
+        const auto size{ getMipLevelSize(format, mipWidth, mipHeight) };
+        mipLevels.push_back(MipLevel{ mipWidth, mipHeight, offset, size });
+        offset = (offset + size + alignment - 1) / alignment * alignment;
+    }
+    return mipLevels;
+}
+
+} // namespace VkTest1::Texture
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VkTest1::Texture
+{
+
+enum class TextureFormat : std::uint32_t
+{
+    // 4 bytes per texel.
+    Rgba8 = 0,
+    // 8 bytes per 4x4 block. RGB, no alpha. 8:1 compared with RGBA8.
+    Bc1 = 1,
+    // 16 bytes per 4x4 block. RGBA. 4:1 compared with RGBA8.
+    Bc7 = 2,
+};
+
+struct MipLevel
+{
+    std::uint32_t width;
+    std::uint32_t height;
+    // Into TextureData::data.
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+// CPU side texture data. This is what the asset loader produces and the renderer uploads.
+// The texels are stored in the format the GPU samples, so uploading is a copy.
+struct TextureData
+{
+    TextureFormat format{ TextureFormat::Rgba8 };
+    std::uint32_t width{ 0 };
+    std::uint32_t height{ 0 };
+    // From the largest to the smallest. The first one has the size of the texture.
+    std::vector<MipLevel> mipLevels{};
+    std::vector<std::byte> data{};
+};
+
+bool isBlockCompressed(TextureFormat format);
+
+// The size of the data of a width x height mip level. Block compressed formats store partial blocks whole.
+std::uint64_t getMipLevelSize(TextureFormat format, std::uint32_t width, std::uint32_t height);
+
+// The number of levels of a full mip chain, down to 1x1.
+std::uint32_t getFullMipLevelCount(std::uint32_t width, std::uint32_t height);
+
+// The mip levels of a texture, packed one after the other, each aligned to alignment.
+std::vector<MipLevel> getMipLevels(
+    TextureFormat format, std::uint32_t width, std::uint32_t height, std::uint32_t mipLevelCount,
+    std::uint64_t alignment);
+
+} // namespace VkTest1::Texture
@@ -0,0 +1,86 @@
+#include "texture/TextureFile.hpp"
+
+#include "common/Errors.hpp"
+
+#include <cstring>
+
+namespace VkTest1::Texture
+{
+
+namespace
+{
+
+constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Larger than any image a GPU can sample.
+constexpr std::uint32_t s_maxTextureSize{ 65536 };
+
+} // namespace
+
+std::vector<std::byte> encodeTextureFile(const TextureData& textureData)
+{
+    TextureFileHeader header{};
+    header.format = textureData.format;
+    header.width = textureData.width;
+    header.height = textureData.height;
+    header.mipLevelCount = static_cast<std::uint32_t>(textureData.mipLevels.size());
+    header.dataOffset = alignUp(sizeof(TextureFileHeader), s_textureFileDataAlignment);
+
+    std::vector<std::byte> contents(header.dataOffset + textureData.data.size());
+    std::memcpy(contents.data(), &header, sizeof(header));
+    std::memcpy(contents.data() + header.dataOffset, textureData.data.data(), textureData.data.size());
+    return contents;
+}
+
+TextureData decodeTextureFile(std::span<const std::byte> contents)
+{
+    TextureFileHeader header{};
+    if (contents.size() < sizeof(header))
+    {
+        throw Common::FormatError{ "Texture file: Too small." };
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+
+    if (header.magic != s_textureFileMagic)
+    {
+        throw Common::FormatError{ "Texture file: Bad magic number." };
+    }
+    if (header.version != s_textureFileVersion)
+    {
+        throw Common::FormatError{ "Texture file: Unsupported version." };
+    }
+    if (header.format != TextureFormat::Rgba8 && header.format != TextureFormat::Bc1 &&
+        header.format != TextureFormat::Bc7)
+    {
+        throw Common::FormatError{ "Texture file: Unknown format." };
+    }
+    if (header.width == 0 || header.height == 0 || header.width > s_maxTextureSize ||
+        header.height > s_maxTextureSize || header.mipLevelCount == 0 ||
+        header.mipLevelCount > getFullMipLevelCount(header.width, header.height))
+    {
+        throw Common::FormatError{ "Texture file: Bad size." };
+    }
+
+    TextureData textureData{};
+    textureData.format = header.format;
+    textureData.width = header.width;
+    textureData.height = header.height;
+    textureData.mipLevels = getMipLevels(
+        header.format, header.width, header.height, header.mipLevelCount, s_textureFileDataAlignment);
+
+    const auto& lastMipLevel{ textureData.mipLevels.back() };
+    const auto dataSize{ lastMipLevel.offset + lastMipLevel.size };
+    if (header.dataOffset > contents.size() || dataSize > contents.size() - header.dataOffset)
+    {
+        throw Common::FormatError{ "Texture file: Data out of range." };
+    }
+
+    textureData.data.resize(dataSize);
+    std::memcpy(textureData.data.data(), contents.data() + header.dataOffset, dataSize);
+    return textureData;
+}
+
+} // namespace VkTest1::Texture
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "texture/TextureData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Texture
+{
+
+//
+// Binary texture file format (.vttex).
+//
+// +--------------------+ offset 0
+// | TextureFileHeader  |
+// +--------------------+ header.dataOffset (aligned to s_textureFileDataAlignment)
+// | Mip level 0        | getMipLevelSize(format, width, height) bytes
+// +--------------------+ aligned to s_textureFileDataAlignment
+// | Mip level 1        |
+// | ...                |
+// +--------------------+
+//
+// All values are little endian. The mip levels are stored in the format the GPU samples (usually block
+// compressed by texture_convert), so loading is a bounds check and a copy, no decoding.
+//
+
+constexpr std::uint32_t s_textureFileMagic{ 0x5854'4B56 }; // "VKTX"
+constexpr std::uint32_t s_textureFileVersion{ 1 };
+// Also a multiple of every block size, as buffer to image copies require.
+constexpr std::uint64_t s_textureFileDataAlignment{ 16 };
+
+struct TextureFileHeader
+{
+    std::uint32_t magic{ s_textureFileMagic };
+    std::uint32_t version{ s_textureFileVersion };
+    TextureFormat format{ TextureFormat::Rgba8 };
+    std::uint32_t width{ 0 };
+    std::uint32_t height{ 0 };
+    std::uint32_t mipLevelCount{ 0 };
+    std::uint64_t dataOffset{ 0 };
+};
+
+static_assert(sizeof(TextureFileHeader) == 32, "The header layout is part of the file format.");
+
+// The mip levels of textureData must have the layout getMipLevels() returns for s_textureFileDataAlignment.
+std::vector<std::byte> encodeTextureFile(const TextureData& textureData);
+
+// Throws Common::FormatError if the contents are not a valid texture file.
+TextureData decodeTextureFile(std::span<const std::byte> contents);
+
+} // namespace VkTest1::Texture
@@ -11,9 +11,21 @@
 namespace VkTest1::Window::Detail
 {
 
+namespace
+{
+
+// GLFW is initialized by the first window and terminated after the last one, because terminating destroys every
+// window. GLFW may only be used from the main thread, so this needs no synchronization.
+Common::Uint s_windowCount{ 0 };
+
+} // namespace
+
 GlfwWindow::GlfwWindow(Common::Uint width, Common::Uint height, const char* title)
 {
-    glfwInit();
+    if (s_windowCount++ == 0)
+    {
+        glfwInit();
+    }
 
     // We don't want GLFW to use any API by default. We will use Vulkan API.
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -27,7 +39,10 @@ GlfwWindow::GlfwWindow(Common::Uint width, Common::Uint height, const char* titl
 GlfwWindow::~GlfwWindow()
 {
     glfwDestroyWindow(m_window);
-    glfwTerminate();
+    if (--s_windowCount == 0)
+    {
+        glfwTerminate();
+    }
 }
 
 bool GlfwWindow::shouldClose() const
@@ -74,4 +89,16 @@ std::pair<Common::Uint, Common::Uint> GlfwWindow::getSize() const
     return { width, height };
 }
 
+Common::Uint GlfwWindow::getRefreshRate() const
+{
+    // A windowed window has no monitor of its own. Assume it is on the primary one.
+    auto* monitor{ glfwGetWindowMonitor(m_window) };
+    if (monitor == nullptr)
+    {
+        monitor = glfwGetPrimaryMonitor();
+    }
+    const auto* videoMode{ monitor != nullptr ? glfwGetVideoMode(monitor) : nullptr };
+    return videoMode != nullptr ? static_cast<Common::Uint>(videoMode->refreshRate) : 0;
+}
+
 } // namespace VkTest1::Window::Detail
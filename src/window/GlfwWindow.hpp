@@ -23,6 +23,8 @@ public:
 
     std::pair<Common::Uint, Common::Uint> getSize() const override;
 
+    Common::Uint getRefreshRate() const override;
+
 private:
     Common::NotNull<GLFWwindow*> m_window;
 };
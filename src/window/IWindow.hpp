@@ -21,6 +21,9 @@ public:
     virtual OpaqueSurface createSurface(void* rendererInstance) = 0;
 
     virtual std::pair<Common::Uint, Common::Uint> getSize() const = 0;
+
+    // Of the display the window is on, in Hz. 0 if unknown.
+    virtual Common::Uint getRefreshRate() const = 0;
 };
 
 } // namespace VkTest1::Window
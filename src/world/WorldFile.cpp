@@ -0,0 +1,190 @@
+#include "world/WorldFile.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace VkTest1::World
+{
+
+namespace
+{
+
+constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool isRangeInside(std::uint64_t offset, std::uint64_t size, std::uint64_t totalSize)
+{
+    return offset <= totalSize && size <= totalSize - offset;
+}
+
+// The end of a table, or empty if it overflows.
+std::optional<std::uint64_t> getTableEnd(std::uint64_t offset, std::uint32_t count, std::uint64_t entrySize)
+{
+    const auto size{ count * entrySize };
+    if (offset > std::numeric_limits<std::uint64_t>::max() - size)
+    {
+        return std::nullopt;
+    }
+    return offset + size;
+}
+
+WorldFileHeader decodeHeader(std::span<const std::byte> contents)
+{
+    WorldFileHeader header{};
+    if (contents.size() < sizeof(header))
+    {
+        throw Common::FormatError{ "World file: Too small." };
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (header.magic != s_worldFileMagic)
+    {
+        throw Common::FormatError{ "World file: Bad magic number." };
+    }
+    if (header.version != s_worldFileVersion)
+    {
+        throw Common::FormatError{ "World file: Unsupported version." };
+    }
+    return header;
+}
+
+bool isChunkValid(const WorldChunk& chunk, std::span<const WorldMesh> meshes)
+{
+    for (auto axis{ 0 }; axis != 3; ++axis)
+    {
+        if (!std::isfinite(chunk.boundsMin[axis]) || !std::isfinite(chunk.boundsMax[axis]) ||
+            chunk.boundsMin[axis] > chunk.boundsMax[axis])
+        {
+            return false;
+        }
+    }
+    if (!isRangeInside(chunk.firstMesh, chunk.meshCount, meshes.size()) ||
+        chunk.dataSize > std::numeric_limits<std::uint64_t>::max() - chunk.dataOffset ||
+        chunk.dataSize > std::numeric_limits<std::size_t>::max())
+    {
+        return false;
+    }
+    return std::ranges::all_of(
+        meshes.subspan(chunk.firstMesh, chunk.meshCount),
+        [&chunk](const WorldMesh& mesh)
+        {
+            return isRangeInside(mesh.dataOffset, mesh.dataSize, chunk.dataSize);
+        });
+}
+
+} // namespace
+
+std::vector<std::byte> encodeWorldFile(std::span<const WorldChunkData> chunks)
+{
+    WorldFileHeader header{};
+    header.chunkCount = static_cast<std::uint32_t>(chunks.size());
+    for (const auto& chunk : chunks)
+    {
+        header.meshCount += static_cast<std::uint32_t>(chunk.meshes.size());
+    }
+    header.chunkTableOffset = sizeof(WorldFileHeader);
+    header.meshTableOffset = header.chunkTableOffset + header.chunkCount * sizeof(WorldChunk);
+
+    std::vector<WorldChunk> chunkTable(chunks.size());
+    std::vector<WorldMesh> meshTable{};
+    meshTable.reserve(header.meshCount);
+    auto dataOffset{ alignUp(header.meshTableOffset + header.meshCount * sizeof(WorldMesh), s_worldFileDataAlignment) };
+    for (auto i{ std::size_t{ 0 } }; i != chunks.size(); ++i)
+    {
+        auto& entry{ chunkTable[i] };
+        for (auto axis{ 0 }; axis != 3; ++axis)
+        {
+            entry.boundsMin[axis] = chunks[i].bounds.min[axis];
+            entry.boundsMax[axis] = chunks[i].bounds.max[axis];
+        }
+        entry.firstMesh = static_cast<std::uint32_t>(meshTable.size());
+        entry.meshCount = static_cast<std::uint32_t>(chunks[i].meshes.size());
+        entry.dataOffset = dataOffset;
+        for (const auto& mesh : chunks[i].meshes)
+        {
+            entry.dataSize = alignUp(entry.dataSize, s_worldFileDataAlignment);
+            meshTable.push_back(WorldMesh{ /* dataOffset */ entry.dataSize,
+                                           /* dataSize */ mesh.meshFile.size(),
+                                           mesh.texture.value_or(s_worldNoTexture) });
+            entry.dataSize += mesh.meshFile.size();
+        }
+        dataOffset = alignUp(dataOffset + entry.dataSize, s_worldFileDataAlignment);
+    }
+
+    std::vector<std::byte> contents(dataOffset);
+    std::memcpy(contents.data(), &header, sizeof(header));
+    std::memcpy(contents.data() + header.chunkTableOffset, chunkTable.data(), chunkTable.size() * sizeof(WorldChunk));
+    std::memcpy(contents.data() + header.meshTableOffset, meshTable.data(), meshTable.size() * sizeof(WorldMesh));
+    for (auto i{ std::size_t{ 0 } }; i != chunks.size(); ++i)
+    {
+        for (auto j{ std::size_t{ 0 } }; j != chunks[i].meshes.size(); ++j)
+        {
+            const auto& meshFile{ chunks[i].meshes[j].meshFile };
+            const auto& entry{ meshTable[chunkTable[i].firstMesh + j] };
+            const auto offset{ chunkTable[i].dataOffset + entry.dataOffset };
+            std::memcpy(contents.data() + offset, meshFile.data(), meshFile.size());
+        }
+    }
+    return contents;
+}
+
+std::uint64_t getWorldIndexSize(std::span<const std::byte> contents)
+{
+    const auto header{ decodeHeader(contents) };
+    const auto chunkTableEnd{ getTableEnd(header.chunkTableOffset, header.chunkCount, sizeof(WorldChunk)) };
+    const auto meshTableEnd{ getTableEnd(header.meshTableOffset, header.meshCount, sizeof(WorldMesh)) };
+    if (!chunkTableEnd.has_value() || !meshTableEnd.has_value() ||
+        std::max(*chunkTableEnd, *meshTableEnd) > std::numeric_limits<std::size_t>::max())
+    {
+        throw Common::FormatError{ "World file: Tables out of range." };
+    }
+    return std::max({ std::uint64_t{ sizeof(WorldFileHeader) }, *chunkTableEnd, *meshTableEnd });
+}
+
+WorldIndex decodeWorldIndex(std::span<const std::byte> contents)
+{
+    const auto header{ decodeHeader(contents) };
+    if (getWorldIndexSize(contents) > contents.size())
+    {
+        throw Common::FormatError{ "World file: Tables out of range." };
+    }
+
+    WorldIndex index{};
+    index.chunks.resize(header.chunkCount);
+    std::memcpy(
+        index.chunks.data(), contents.data() + header.chunkTableOffset, header.chunkCount * sizeof(WorldChunk));
+    index.meshes.resize(header.meshCount);
+    std::memcpy(index.meshes.data(), contents.data() + header.meshTableOffset, header.meshCount * sizeof(WorldMesh));
+    if (!std::ranges::all_of(
+            index.chunks,
+            [&index](const WorldChunk& chunk)
+            {
+                return isChunkValid(chunk, index.meshes);
+            }))
+    {
+        throw Common::FormatError{ "World file: Invalid chunk." };
+    }
+    return index;
+}
+
+std::span<const std::byte> getWorldMeshFile(std::span<const std::byte> chunkData, const WorldMesh& mesh)
+{
+    if (!isRangeInside(mesh.dataOffset, mesh.dataSize, chunkData.size()))
+    {
+        throw Common::FormatError{ "World file: Mesh out of range." };
+    }
+    return chunkData.subspan(mesh.dataOffset, mesh.dataSize);
+}
+
+Geometry::Bounds getBounds(const WorldChunk& chunk)
+{
+    return Geometry::Bounds{ Geometry::Position{ chunk.boundsMin[0], chunk.boundsMin[1], chunk.boundsMin[2] },
+                             Geometry::Position{ chunk.boundsMax[0], chunk.boundsMax[1], chunk.boundsMax[2] } };
+}
+
+} // namespace VkTest1::World
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace VkTest1::World
+{
+
+//
+// Binary world file format (.vtworld). A world too large for memory, split into spatial chunks that are read one at
+// a time.
+//
+// +--------------------+ offset 0
+// | WorldFileHeader    |
+// +--------------------+ header.chunkTableOffset
+// | Chunk table        | chunkCount * WorldChunk
+// +--------------------+ header.meshTableOffset
+// | Mesh table         | meshCount * WorldMesh, the meshes of each chunk one after the other
+// +--------------------+ aligned to s_worldFileDataAlignment
+// | Chunk data         | per chunk: its meshes as .vtmesh files, each aligned to s_worldFileDataAlignment
+// +--------------------+
+//
+// All values are little endian. The header and the tables (the index) are small and read up front; the data of a
+// chunk is one contiguous range, so loading a chunk is one read.
+//
+
+constexpr std::uint32_t s_worldFileMagic{ 0x5754'4B56 }; // "VKTW"
+constexpr std::uint32_t s_worldFileVersion{ 1 };
+constexpr std::uint64_t s_worldFileDataAlignment{ 16 };
+// The texture of a mesh that has none.
+constexpr std::uint32_t s_worldNoTexture{ 0xFFFF'FFFF };
+
+struct WorldFileHeader
+{
+    std::uint32_t magic{ s_worldFileMagic };
+    std::uint32_t version{ s_worldFileVersion };
+    std::uint32_t chunkCount{ 0 };
+    std::uint32_t meshCount{ 0 };
+    std::uint64_t chunkTableOffset{ 0 };
+    std::uint64_t meshTableOffset{ 0 };
+};
+
+struct WorldChunk
+{
+    // Of all its meshes.
+    float boundsMin[3]{};
+    float boundsMax[3]{};
+    // In the mesh table.
+    std::uint32_t firstMesh{ 0 };
+    std::uint32_t meshCount{ 0 };
+    // In the file.
+    std::uint64_t dataOffset{ 0 };
+    std::uint64_t dataSize{ 0 };
+};
+
+struct WorldMesh
+{
+    // Of the .vtmesh file, in the data of its chunk.
+    std::uint64_t dataOffset{ 0 };
+    std::uint64_t dataSize{ 0 };
+    // The number of a texture the renderer has, or s_worldNoTexture.
+    std::uint32_t texture{ s_worldNoTexture };
+    std::uint32_t reserved{ 0 };
+};
+
+static_assert(sizeof(WorldFileHeader) == 32, "The header layout is part of the file format.");
+static_assert(sizeof(WorldChunk) == 48, "The chunk table layout is part of the file format.");
+static_assert(sizeof(WorldMesh) == 24, "The mesh table layout is part of the file format.");
+
+// The tables of a world file.
+struct WorldIndex
+{
+    std::vector<WorldChunk> chunks;
+    std::vector<WorldMesh> meshes;
+};
+
+// A chunk to encode.
+struct WorldChunkData
+{
+    struct Mesh
+    {
+        // The contents of a .vtmesh file.
+        std::vector<std::byte> meshFile;
+        std::optional<std::uint32_t> texture;
+    };
+
+    Geometry::Bounds bounds;
+    std::vector<Mesh> meshes;
+};
+
+std::vector<std::byte> encodeWorldFile(std::span<const WorldChunkData> chunks);
+
+// The number of bytes at the start of the file that hold the index, from the header. Throws Common::FormatError if
+// the contents don't start with a valid header.
+std::uint64_t getWorldIndexSize(std::span<const std::byte> contents);
+
+// The contents must hold at least the index. Throws Common::FormatError if the index is not valid.
+WorldIndex decodeWorldIndex(std::span<const std::byte> contents);
+
+// The .vtmesh file of the mesh in the data of its chunk. Throws Common::FormatError if it is out of range.
+std::span<const std::byte> getWorldMeshFile(std::span<const std::byte> chunkData, const WorldMesh& mesh);
+
+Geometry::Bounds getBounds(const WorldChunk& chunk);
+
+} // namespace VkTest1::World
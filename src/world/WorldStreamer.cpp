@@ -0,0 +1,218 @@
+#include "world/WorldStreamer.hpp"
+
+#include "geometry/MeshFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace VkTest1::World
+{
+
+namespace
+{
+
+WorldIndex readIndex(Common::IFileSystem& fileSystem, const std::filesystem::path& path)
+{
+    const auto header{ fileSystem.readFileRange(path, /* offset */ 0, sizeof(WorldFileHeader)) };
+    return decodeWorldIndex(fileSystem.readFileRange(path, /* offset */ 0, getWorldIndexSize(header)));
+}
+
+// Zero if the boxes overlap.
+float getDistance(const Geometry::Bounds& lhs, const Geometry::Bounds& rhs)
+{
+    // Along each axis, the gap between the boxes, or a negative value if they overlap on it.
+    const auto gap{ glm::max(lhs.min - rhs.max, rhs.min - lhs.max) };
+    return glm::length(glm::max(gap, glm::vec3{ 0.0f }));
+}
+
+} // namespace
+
+WorldStreamer::WorldStreamer(
+    Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Assets::IAssetLoader*> assetLoader,
+    Common::NotNull<Renderer::IRenderer*> renderer, Common::NotNull<Logging::ILogger*> logger,
+    std::filesystem::path path, const WorldStreamerSettings& settings) :
+    m_assetLoader{ assetLoader },
+    m_renderer{ renderer },
+    m_logger{ logger },
+    m_path{ std::move(path) },
+    m_settings{ settings }
+{
+    auto index{ readIndex(*fileSystem, m_path) };
+    m_meshes = std::move(index.meshes);
+    m_chunks.reserve(index.chunks.size());
+    for (const auto& entry : index.chunks)
+    {
+        m_chunks.push_back(Chunk{ entry });
+    }
+    m_candidates.reserve(m_chunks.size());
+    m_logger->info("World: {} chunks, {} meshes.", m_chunks.size(), m_meshes.size());
+}
+
+void WorldStreamer::update(const Geometry::Bounds& view)
+{
+    for (auto& chunk : m_chunks)
+    {
+        chunk.distance = getDistance(getBounds(chunk.entry), view);
+    }
+
+    // -- FINISH LOADS
+
+    for (auto i{ std::size_t{ 0 } }; i != m_chunks.size(); ++i)
+    {
+        auto& chunk{ m_chunks[i] };
+        if (chunk.state != ChunkState::Loading ||
+            chunk.data.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+        {
+            continue;
+        }
+        try
+        {
+            auto data{ chunk.data.get() };
+            if (chunk.distance > m_settings.unloadDistance)
+            {
+                // Moved out of range while it was read.
+                chunk.state = ChunkState::Unloaded;
+                m_usedMemory -= chunk.entry.dataSize;
+                continue;
+            }
+            addMeshes(chunk, std::move(data));
+            chunk.state = ChunkState::Loaded;
+            m_logger->debug("World: Chunk {} loaded, {} meshes.", i, chunk.meshes.size());
+        }
+        catch (const std::exception& ex)
+        {
+            // A broken chunk must not take down the frame loop.
+            m_logger->error("World: Cannot load chunk {}: {}", i, ex.what());
+            chunk.state = ChunkState::Failed;
+            m_usedMemory -= chunk.entry.dataSize;
+        }
+    }
+
+    // -- UNLOAD DISTANT CHUNKS
+
+    for (auto i{ std::size_t{ 0 } }; i != m_chunks.size(); ++i)
+    {
+        if (m_chunks[i].state == ChunkState::Loaded && m_chunks[i].distance > m_settings.unloadDistance)
+        {
+            unload(i);
+        }
+    }
+
+    // -- START LOADS
+
+    startLoads();
+}
+
+void WorldStreamer::addMeshes(Chunk& chunk, std::vector<std::byte> data)
+{
+    // Shared by the decodes of the meshes. Released after the last one.
+    const auto sharedData{ std::make_shared<const std::vector<std::byte>>(std::move(data)) };
+    for (const auto& mesh : std::span{ m_meshes }.subspan(chunk.entry.firstMesh, chunk.entry.meshCount))
+    {
+        auto meshData{ m_assetLoader->generateMesh(
+            Assets::LoadPriority::Normal,
+            [sharedData, mesh]
+            {
+                return Geometry::decodeMeshFile(getWorldMeshFile(*sharedData, mesh));
+            }) };
+        const auto texture{ mesh.texture != s_worldNoTexture ? std::optional{ mesh.texture } : std::nullopt };
+        chunk.meshes.push_back(m_renderer->addMesh(std::move(meshData), texture));
+    }
+}
+
+void WorldStreamer::unload(std::size_t chunkIndex)
+{
+    auto& chunk{ m_chunks[chunkIndex] };
+    for (const auto mesh : chunk.meshes)
+    {
+        m_renderer->removeMesh(mesh);
+    }
+    chunk.meshes.clear();
+    chunk.state = ChunkState::Unloaded;
+    m_usedMemory -= chunk.entry.dataSize;
+    m_logger->debug("World: Chunk {} unloaded.", chunkIndex);
+}
+
+void WorldStreamer::startLoads()
+{
+    m_candidates.clear();
+    for (auto i{ std::uint32_t{ 0 } }; i != m_chunks.size(); ++i)
+    {
+        if (m_chunks[i].state == ChunkState::Unloaded && m_chunks[i].distance <= m_settings.loadDistance)
+        {
+            m_candidates.push_back(i);
+        }
+    }
+    std::ranges::sort(
+        m_candidates,
+        {},
+        [this](std::uint32_t i)
+        {
+            return m_chunks[i].distance;
+        });
+
+    auto ioQuota{ m_settings.ioQuota != 0 ? m_settings.ioQuota : std::numeric_limits<std::uint64_t>::max() };
+    auto hasStarted{ false };
+    for (const auto i : m_candidates)
+    {
+        auto& chunk{ m_chunks[i] };
+        const auto dataSize{ chunk.entry.dataSize };
+        if (dataSize > m_settings.memoryBudget)
+        {
+            m_logger->warning("World: Chunk {} is larger than the memory budget.", i);
+            chunk.state = ChunkState::Failed;
+            continue;
+        }
+        if (hasStarted && dataSize > ioQuota)
+        {
+            // Only the first chunk of an update may go over the quota, so this one starts in the next update. The
+            // candidates after it are farther, so they wait too.
+            return;
+        }
+        while (m_usedMemory + dataSize > m_settings.memoryBudget)
+        {
+            if (!unloadFarthest(chunk.distance))
+            {
+                // What uses the budget is nearer or still loading. The candidates after this one are farther, so
+                // they wait too.
+                return;
+            }
+        }
+
+        // The chunks in view first, so what is visible arrives before what is next to it.
+        const auto priority{ chunk.distance == 0.0f ? Assets::LoadPriority::High : Assets::LoadPriority::Normal };
+        chunk.data = m_assetLoader->loadFileRange(m_path, chunk.entry.dataOffset, dataSize, priority);
+        chunk.state = ChunkState::Loading;
+        m_usedMemory += dataSize;
+        ioQuota -= std::min(ioQuota, dataSize);
+        hasStarted = true;
+    }
+}
+
+bool WorldStreamer::unloadFarthest(float distance)
+{
+    std::optional<std::size_t> farthest{};
+    for (auto i{ std::size_t{ 0 } }; i != m_chunks.size(); ++i)
+    {
+        const auto& chunk{ m_chunks[i] };
+        if (chunk.state == ChunkState::Loaded && chunk.distance > distance &&
+            (!farthest.has_value() || chunk.distance > m_chunks[*farthest].distance))
+        {
+            farthest = i;
+        }
+    }
+    if (!farthest.has_value())
+    {
+        return false;
+    }
+    unload(*farthest);
+    return true;
+}
+
+} // namespace VkTest1::World
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "assets/IAssetLoader.hpp"
+#include "common/IFileSystem.hpp"
+#include "common/Types.hpp"
+#include "geometry/MeshData.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/IRenderer.hpp"
+#include "world/WorldFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <vector>
+
+namespace VkTest1::World
+{
+
+struct WorldStreamerSettings
+{
+    // The chunks whose bounds are at most this far from the view are loaded, the nearest first.
+    float loadDistance{ 0.5f };
+    // The loaded chunks farther than this from the view are unloaded. Above loadDistance, so a chunk at the edge
+    // doesn't load and unload over and over.
+    float unloadDistance{ 1.0f };
+    // The data of the chunks that are loading or loaded at a time, in bytes. About the memory their meshes take in
+    // the renderer. A chunk that is nearer than a loaded one takes its place if it doesn't fit.
+    std::uint64_t memoryBudget{ 256ull << 20 };
+    // The chunk data whose reads start per update, in bytes. A chunk larger than the quota still starts, alone in its
+    // update. 0 is unlimited.
+    std::uint64_t ioQuota{ 0 };
+};
+
+//
+// Keeps the chunks of a world file near the view in the renderer, so the world can be larger than the memory of the
+// device. The renderer uploads within its own upload quota and memory budget.
+//
+// A chunk goes through the following states:
+//
+// 1. Unloaded
+// 2. Loading: Its data is read on the asset loader threads. It is dropped once read if it is out of range by then.
+// 3. Loaded: Its meshes are decoded on the job system and added to the renderer. Unloading removes them.
+//
+// Only the index of the file stays in memory. The data of a chunk is released once its meshes are decoded.
+//
+class WorldStreamer
+{
+public:
+    // Reads the index of the world file right away. Throws Common::IoError if it cannot be read and
+    // Common::FormatError if it is not valid. The textures of the meshes are numbers of textures in the renderer.
+    explicit WorldStreamer(
+        Common::NotNull<Common::IFileSystem*> fileSystem, Common::NotNull<Assets::IAssetLoader*> assetLoader,
+        Common::NotNull<Renderer::IRenderer*> renderer, Common::NotNull<Logging::ILogger*> logger,
+        std::filesystem::path path, const WorldStreamerSettings& settings);
+
+    // Never blocks. Adds the chunks that finished loading, unloads the ones that moved out of range and starts
+    // loading the ones that moved into range. The view is the volume that is visible.
+    void update(const Geometry::Bounds& view);
+
+    std::size_t getChunkCount() const
+    {
+        return m_chunks.size();
+    }
+
+private:
+    enum class ChunkState
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+        // Failed to load, or larger than the budget. Never tried again.
+        Failed,
+    };
+
+    struct Chunk
+    {
+        WorldChunk entry;
+        ChunkState state{ ChunkState::Unloaded };
+        // From the view, as of the last update.
+        float distance{ 0.0f };
+        // Valid while loading.
+        std::future<std::vector<std::byte>> data{};
+        // The numbers of its meshes in the renderer while loaded.
+        std::vector<std::uint32_t> meshes{};
+    };
+
+    // Adds the meshes of the chunk to the renderer. Their data is decoded on the job system.
+    void addMeshes(Chunk& chunk, std::vector<std::byte> data);
+
+    // Removes the meshes of the loaded chunk from the renderer.
+    void unload(std::size_t chunkIndex);
+
+    // Starts loading the chunks in range, the nearest first, within the I/O quota and the memory budget.
+    void startLoads();
+
+    // Unloads the farthest loaded chunk that is farther than the distance. False if there is none.
+    bool unloadFarthest(float distance);
+
+    Common::NotNull<Assets::IAssetLoader*> m_assetLoader;
+    Common::NotNull<Renderer::IRenderer*> m_renderer;
+    Common::NotNull<Logging::ILogger*> m_logger;
+    std::filesystem::path m_path;
+    WorldStreamerSettings m_settings;
+    std::vector<WorldMesh> m_meshes;
+    std::vector<Chunk> m_chunks;
+    // The data of the loading and loaded chunks.
+    std::uint64_t m_usedMemory{ 0 };
+    // The indices of the chunks to load, by distance. Kept, so the updates don't allocate.
+    std::vector<std::uint32_t> m_candidates{};
+};
+
+} // namespace VkTest1::World
@@ -0,0 +1,97 @@
+#include "Tests.hpp"
+
+#include "assets/AssetLoader.hpp"
+#include "common/IFileSystem.hpp"
+#include "common/JobSystem.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+namespace
+{
+
+// Every read blocks until the gate opens.
+class GatedFileSystem : public Common::IFileSystem
+{
+public:
+    std::vector<std::byte> readFile(const std::filesystem::path& /* path */) override
+    {
+        m_entered.set_value();
+        m_gate.wait();
+        return {};
+    }
+
+    std::vector<std::byte> readFileRange(
+        const std::filesystem::path& path, std::uint64_t /* offset */, std::size_t /* size */) override
+    {
+        return readFile(path);
+    }
+
+    // Waits until the first read has started.
+    void waitUntilEntered()
+    {
+        m_enteredFuture.wait();
+    }
+
+    void open()
+    {
+        m_gateOpener.set_value();
+    }
+
+private:
+    std::promise<void> m_entered{};
+    std::future<void> m_enteredFuture{ m_entered.get_future() };
+    std::promise<void> m_gateOpener{};
+    std::shared_future<void> m_gate{ m_gateOpener.get_future().share() };
+};
+
+void testGenerateMeshPriority()
+{
+    GatedFileSystem fileSystem{};
+    // One worker and one I/O thread, so the jobs run in the order they are handed over.
+    Common::JobSystem jobSystem{ 1 };
+    Assets::Detail::AssetLoader assetLoader{ &fileSystem, &jobSystem, /* ioThreadCount */ 1 };
+
+    // Keeps the I/O thread busy while the generators are queued.
+    auto read{ assetLoader.loadFile("blocking", Assets::LoadPriority::Normal) };
+    fileSystem.waitUntilEntered();
+
+    std::mutex mutex{};
+    std::vector<std::string> order{};
+    const auto createGenerator = [&](std::string name)
+    {
+        return [&, name]
+        {
+            const std::scoped_lock lock{ mutex };
+            order.push_back(name);
+            return Geometry::MeshData{};
+        };
+    };
+    auto background{ assetLoader.generateMesh(Assets::LoadPriority::Background, createGenerator("background")) };
+    auto high{ assetLoader.generateMesh(Assets::LoadPriority::High, createGenerator("high")) };
+
+    fileSystem.open();
+    read.get();
+    background.get();
+    high.get();
+    check(order == std::vector<std::string>{ "high", "background" }, "the generators start in priority order");
+}
+
+} // namespace
+
+std::vector<TestCase> createAssetTests()
+{
+    return {
+        TestCase{ "AssetLoader/generateMesh priority", testGenerateMeshPriority },
+    };
+}
+
+} // namespace VkTest1::Test
@@ -0,0 +1,467 @@
+#include "Tests.hpp"
+
+#include "common/FrameArena.hpp"
+#include "common/JobSystem.hpp"
+#include "common/LinearArena.hpp"
+#include "common/WorkStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+namespace
+{
+
+// More than the cores of most machines, so the workers really contend.
+constexpr unsigned int s_workerCount{ 4 };
+
+void testDequeOrder()
+{
+    Common::WorkStealingDeque<int> deque{ 4 };
+    std::vector<int> items{ 0, 1, 2, 3, 4 };
+    check(deque.pop() == nullptr, "pop() of an empty deque");
+    check(deque.steal() == nullptr, "steal() of an empty deque");
+    for (auto i{ 0 }; i != 4; ++i)
+    {
+        check(deque.push(&items[i]), "push() below the capacity");
+    }
+    check(!deque.push(&items[4]), "push() of a full deque");
+
+    // The owner takes the newest, thieves the oldest.
+    check(deque.pop() == &items[3], "pop() takes the newest item");
+    check(deque.steal() == &items[0], "steal() takes the oldest item");
+    check(deque.pop() == &items[2], "pop() after steal()");
+    check(deque.steal() == &items[1], "steal() of the last item");
+    check(deque.pop() == nullptr, "pop() after the last item was stolen");
+    check(deque.push(&items[4]), "push() after the deque was emptied");
+    check(deque.pop() == &items[4], "pop() after the deque was emptied");
+}
+
+// The owner pushes and pops while thieves steal. Every item must be taken exactly once.
+void testDequeConcurrentSteal()
+{
+    constexpr std::size_t itemCount{ 20'000 };
+    constexpr unsigned int thiefCount{ 3 };
+
+    Common::WorkStealingDeque<std::size_t> deque{ 256 };
+    std::vector<std::size_t> items(itemCount);
+    std::iota(items.begin(), items.end(), std::size_t{ 0 });
+    std::vector<std::atomic<std::uint32_t>> takeCounts(itemCount);
+    std::atomic<bool> isDone{ false };
+    std::atomic<std::size_t> stolenCount{ 0 };
+
+    std::vector<std::jthread> thieves{};
+    for (auto i{ 0u }; i != thiefCount; ++i)
+    {
+        thieves.emplace_back(
+            [&]
+            {
+                while (!isDone.load())
+                {
+                    if (auto* item{ deque.steal() })
+                    {
+                        takeCounts[*item].fetch_add(1);
+                        stolenCount.fetch_add(1);
+                    }
+                }
+            });
+    }
+
+    for (auto i{ std::size_t{ 0 } }; i != itemCount;)
+    {
+        if (deque.push(&items[i]))
+        {
+            ++i;
+        }
+        // Pop every other item, so pop and steal race on the last one.
+        if (i % 2 == 0)
+        {
+            if (auto* item{ deque.pop() })
+            {
+                takeCounts[*item].fetch_add(1);
+            }
+        }
+    }
+    while (auto* item{ deque.pop() })
+    {
+        takeCounts[*item].fetch_add(1);
+    }
+    isDone = true;
+    thieves.clear();
+
+    check(
+        std::ranges::all_of(
+            takeCounts,
+            [](const std::atomic<std::uint32_t>& count)
+            {
+                return count.load() == 1;
+            }),
+        "every item is taken exactly once");
+    // Not guaranteed, but with 20000 items the thieves get some unless stealing is broken.
+    check(stolenCount.load() != 0, "the thieves stole items");
+}
+
+void testScheduleAndWait()
+{
+    Common::JobSystem jobSystem{ s_workerCount };
+    std::atomic<std::uint32_t> runCount{ 0 };
+    Common::JobCounter counter{};
+    for (auto i{ 0 }; i != 1000; ++i)
+    {
+        jobSystem.schedule(
+            [&runCount]
+            {
+                runCount.fetch_add(1);
+            },
+            &counter);
+    }
+    jobSystem.wait(counter);
+    check(runCount.load() == 1000, "wait() returns after all jobs ran");
+
+    // Reusable after wait().
+    jobSystem.schedule(
+        [&runCount]
+        {
+            runCount.fetch_add(1);
+        },
+        &counter);
+    jobSystem.wait(counter);
+    check(runCount.load() == 1001, "a counter can be reused after wait()");
+}
+
+// Jobs that schedule jobs on their worker's deque. The other workers steal them.
+void testNestedJobs()
+{
+    Common::JobSystem jobSystem{ s_workerCount };
+    // The last one is for the test thread, which runs jobs while it waits.
+    std::vector<std::atomic<std::uint32_t>> threadRunCounts(s_workerCount + 1);
+    std::atomic<std::uint32_t> runCount{ 0 };
+    Common::JobCounter counter{};
+    jobSystem.schedule(
+        [&]
+        {
+            Common::JobCounter innerCounter{};
+            for (auto i{ 0 }; i != 1000; ++i)
+            {
+                jobSystem.schedule(
+                    [&]
+                    {
+                        // Long enough that one worker can't run them all before the others steal.
+                        std::this_thread::sleep_for(std::chrono::microseconds{ 20 });
+                        threadRunCounts[jobSystem.getWorkerIndex().value_or(s_workerCount)].fetch_add(1);
+                        runCount.fetch_add(1);
+                    },
+                    &innerCounter);
+            }
+            // A job waits for the jobs it spawned.
+            jobSystem.wait(innerCounter);
+        },
+        &counter);
+    jobSystem.wait(counter);
+
+    check(runCount.load() == 1000, "the nested jobs ran");
+    check(!jobSystem.getWorkerIndex().has_value(), "the test thread is not a worker");
+    const auto threadCount{ std::ranges::count_if(
+        threadRunCounts,
+        [](const std::atomic<std::uint32_t>& count)
+        {
+            return count.load() != 0;
+        }) };
+    check(threadCount > 1, "other threads stole nested jobs");
+}
+
+void testScheduleAfter()
+{
+    Common::JobSystem jobSystem{ s_workerCount };
+    std::atomic<std::uint32_t> firstRunCount{ 0 };
+    std::atomic<std::uint32_t> firstRunCountSeen{ 0 };
+    std::atomic<bool> isSecondDone{ false };
+    std::atomic<bool> wasSecondDoneSeen{ false };
+
+    Common::JobCounter first{};
+    Common::JobCounter second{};
+    Common::JobCounter third{};
+    for (auto i{ 0 }; i != 100; ++i)
+    {
+        jobSystem.schedule(
+            [&firstRunCount]
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds{ 10 });
+                firstRunCount.fetch_add(1);
+            },
+            &first);
+    }
+    // A chain: first -> second -> third.
+    jobSystem.scheduleAfter(
+        first,
+        [&]
+        {
+            firstRunCountSeen = firstRunCount.load();
+            jobSystem.scheduleAfter(
+                second,
+                [&]
+                {
+                    wasSecondDoneSeen = isSecondDone.load();
+                },
+                &third);
+            isSecondDone = true;
+        },
+        &second);
+    jobSystem.wait(second);
+    jobSystem.wait(third);
+
+    check(firstRunCountSeen.load() == 100, "a continuation runs after all jobs of its dependency");
+    check(wasSecondDoneSeen.load(), "a continuation of a continuation runs after it");
+
+    // A dependency without jobs: the continuation is scheduled right away.
+    Common::JobCounter empty{};
+    std::atomic<bool> hasRun{ false };
+    jobSystem.scheduleAfter(
+        empty,
+        [&hasRun]
+        {
+            hasRun = true;
+        },
+        &third);
+    jobSystem.wait(third);
+    check(hasRun.load(), "a continuation of a finished dependency runs");
+}
+
+void testExceptions()
+{
+    Common::JobSystem jobSystem{ s_workerCount };
+    std::atomic<std::uint32_t> runCount{ 0 };
+    Common::JobCounter counter{};
+    for (auto i{ 0 }; i != 100; ++i)
+    {
+        jobSystem.schedule(
+            [&runCount, i]
+            {
+                runCount.fetch_add(1);
+                if (i % 10 == 0)
+                {
+                    throw std::runtime_error{ "job failed" };
+                }
+            },
+            &counter);
+    }
+    checkThrows<std::runtime_error>(
+        [&]
+        {
+            jobSystem.wait(counter);
+        },
+        "wait() rethrows the exception of a job");
+    check(runCount.load() == 100, "the other jobs of the group still run");
+
+    // The exception is consumed by the wait() that rethrew it.
+    jobSystem.schedule([] {}, &counter);
+    jobSystem.wait(counter);
+
+    // Without a counter, it is dropped.
+    jobSystem.schedule(
+        []
+        {
+            throw std::runtime_error{ "dropped" };
+        });
+
+    // A continuation's exception goes to its own counter.
+    Common::JobCounter continuationCounter{};
+    jobSystem.schedule([] {}, &counter);
+    jobSystem.scheduleAfter(
+        counter,
+        []
+        {
+            throw std::logic_error{ "continuation failed" };
+        },
+        &continuationCounter);
+    jobSystem.wait(counter);
+    checkThrows<std::logic_error>(
+        [&]
+        {
+            jobSystem.wait(continuationCounter);
+        },
+        "wait() rethrows the exception of a continuation");
+}
+
+void testParallelFor()
+{
+    Common::JobSystem jobSystem{ s_workerCount };
+    // Empty, smaller than a chunk, not a multiple of the grain size, a grain size of 0 (treated as 1), and large.
+    struct Case
+    {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t grainSize;
+    };
+    for (const auto& [begin, end, grainSize] : { Case{ 0, 0, 16 },
+                                                 Case{ 5, 3, 16 },
+                                                 Case{ 0, 7, 16 },
+                                                 Case{ 3, 1003, 64 },
+                                                 Case{ 0, 100, 0 },
+                                                 Case{ 0, 100'000, 1000 } })
+    {
+        std::vector<std::atomic<std::uint32_t>> visitCounts(std::max(begin, end));
+        std::atomic<std::size_t> maxChunkSize{ 0 };
+        jobSystem.parallelFor(
+            begin,
+            end,
+            grainSize,
+            [&](std::size_t chunkBegin, std::size_t chunkEnd)
+            {
+                for (auto i{ chunkBegin }; i != chunkEnd; ++i)
+                {
+                    visitCounts[i].fetch_add(1);
+                }
+                auto size{ maxChunkSize.load() };
+                while (chunkEnd - chunkBegin > size && !maxChunkSize.compare_exchange_weak(size, chunkEnd - chunkBegin))
+                {
+                }
+            });
+        for (auto i{ std::size_t{ 0 } }; i != visitCounts.size(); ++i)
+        {
+            const auto expected{ (i >= begin && i < end) ? 1u : 0u };
+            check(visitCounts[i].load() == expected, "every index of the range is visited exactly once");
+        }
+        check(maxChunkSize.load() <= std::max<std::size_t>(grainSize, 1), "chunks are at most the grain size");
+    }
+
+    checkThrows<std::runtime_error>(
+        [&]
+        {
+            jobSystem.parallelFor(
+                0,
+                1000,
+                10,
+                [](std::size_t chunkBegin, std::size_t /* chunkEnd */)
+                {
+                    if (chunkBegin == 500)
+                    {
+                        throw std::runtime_error{ "chunk failed" };
+                    }
+                });
+        },
+        "parallelFor() rethrows the exception of a chunk");
+
+    // Nested in a job: the inner loop runs on the workers too.
+    std::atomic<std::uint64_t> sum{ 0 };
+    Common::JobCounter counter{};
+    jobSystem.schedule(
+        [&]
+        {
+            jobSystem.parallelFor(
+                0,
+                10'000,
+                100,
+                [&sum](std::size_t chunkBegin, std::size_t chunkEnd)
+                {
+                    for (auto i{ chunkBegin }; i != chunkEnd; ++i)
+                    {
+                        sum.fetch_add(i);
+                    }
+                });
+        },
+        &counter);
+    jobSystem.wait(counter);
+    check(sum.load() == 10'000ull * 9'999 / 2, "a parallelFor() in a job covers its range");
+}
+
+void testLinearArena()
+{
+    Common::LinearArena arena{ 64 };
+    const auto* first{ arena.allocate(16, 16) };
+    check(reinterpret_cast<std::uintptr_t>(first) % 16 == 0, "allocate() aligns");
+    // Larger than the block, so the arena grows.
+    check(arena.allocate(1000, 8) != first, "allocate() of more than the block");
+    check(arena.getUsedSize() >= 1016, "getUsedSize() counts every block");
+    const auto capacity{ arena.getCapacity() };
+    arena.reset();
+    check(arena.getUsedSize() == 0, "reset() frees everything");
+    check(arena.getCapacity() == capacity, "reset() keeps the capacity in one block");
+    check(
+        arena.allocate(capacity, 1) != nullptr && arena.getCapacity() == capacity,
+        "the merged block holds the peak usage");
+
+    auto moved{ std::move(arena) };
+    check(moved.getCapacity() == capacity, "a move takes the blocks");
+    check(arena.getCapacity() == 0 && arena.getUsedSize() == 0, "a moved-from arena is empty");
+    const auto* pointer{ arena.allocate(24, 8) };
+    check(pointer != nullptr && arena.getUsedSize() >= 24, "a moved-from arena allocates again");
+    arena = std::move(moved);
+    check(arena.getCapacity() == capacity && moved.getCapacity() == 0, "a move assignment takes the blocks");
+    check(moved.allocate(8, 8) != nullptr, "a moved-from arena allocates again after a move assignment");
+}
+
+void testFrameArena()
+{
+    Common::JobSystem jobSystem{ s_workerCount };
+    Common::FrameArena frameArena{ &jobSystem, /* frameCount */ 2, /* capacity */ 256 };
+    frameArena.beginFrame(0);
+    auto& mainResource{ frameArena.getResource() };
+    check(&frameArena.getResource() == &mainResource, "a thread gets the same arena during a frame");
+
+    // Every thread that runs a job allocates from its own arena.
+    std::mutex mutex{};
+    std::vector<std::pair<std::thread::id, std::pmr::memory_resource*>> resources{};
+    Common::JobCounter counter{};
+    for (auto i{ 0 }; i != 1000; ++i)
+    {
+        jobSystem.schedule(
+            [&]
+            {
+                auto& resource{ frameArena.getResource() };
+                std::pmr::vector<int> values{ &resource };
+                values.resize(16);
+                const std::scoped_lock lock{ mutex };
+                resources.emplace_back(std::this_thread::get_id(), &resource);
+            },
+            &counter);
+    }
+    jobSystem.wait(counter);
+    for (const auto& [threadId, resource] : resources)
+    {
+        for (const auto& [otherThreadId, otherResource] : resources)
+        {
+            check((threadId == otherThreadId) == (resource == otherResource), "the arenas are per thread");
+        }
+        check(
+            (threadId == std::this_thread::get_id()) == (resource == &mainResource),
+            "a thread that is not a worker gets the arena of the drawing thread");
+    }
+    check(frameArena.getUsedSize() >= 1000 * 16 * sizeof(int), "getUsedSize() counts the arenas of the workers");
+
+    frameArena.beginFrame(1);
+    check(&frameArena.getResource() != &mainResource, "every frame has its own arenas");
+    check(frameArena.getUsedSize() == 0, "a new frame starts empty");
+    frameArena.beginFrame(0);
+    check(frameArena.getUsedSize() == 0, "beginFrame() frees what the frame allocated last time");
+}
+
+} // namespace
+
+std::vector<TestCase> createCommonTests()
+{
+    return {
+        TestCase{ "WorkStealingDeque/order", testDequeOrder },
+        TestCase{ "WorkStealingDeque/concurrent steal", testDequeConcurrentSteal },
+        TestCase{ "JobSystem/schedule and wait", testScheduleAndWait },
+        TestCase{ "JobSystem/nested jobs", testNestedJobs },
+        TestCase{ "JobSystem/scheduleAfter", testScheduleAfter },
+        TestCase{ "JobSystem/exceptions", testExceptions },
+        TestCase{ "JobSystem/parallelFor", testParallelFor },
+        TestCase{ "LinearArena", testLinearArena },
+        TestCase{ "FrameArena", testFrameArena },
+    };
+}
+
+} // namespace VkTest1::Test
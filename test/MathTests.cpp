@@ -0,0 +1,251 @@
+#include "Tests.hpp"
+
+#include "math/BatchMath.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+namespace
+{
+
+// Around the vector widths (4 and 8) and their multiples, so every kernel runs with and without a remainder, and
+// larger than the runs of composeLocalToWorld().
+constexpr std::size_t s_batchSizes[]{ 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 600 };
+
+// The kernels add in the order of glm, but the compiler may fuse its multiplications and additions.
+bool isNear(float value, float expected, float scale)
+{
+    return std::abs(value - expected) <= 1e-5f * std::max(1.0f, scale);
+}
+
+bool isNear(const glm::mat4& matrix, const glm::mat4& expected)
+{
+    auto scale{ 0.0f };
+    for (auto element{ 0 }; element != 16; ++element)
+    {
+        scale = std::max(scale, std::abs(expected[element / 4][element % 4]));
+    }
+    for (auto element{ 0 }; element != 16; ++element)
+    {
+        if (!isNear(matrix[element / 4][element % 4], expected[element / 4][element % 4], scale))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The identity times diagonal plus elements in [-range, range].
+glm::mat4 createMatrix(std::mt19937& random, bool isAffine, float diagonal = 0.0f, float range = 1.0f)
+{
+    std::uniform_real_distribution<float> distribution{ -range, range };
+    glm::mat4 matrix{ diagonal };
+    for (auto column{ 0 }; column != 4; ++column)
+    {
+        for (auto row{ 0 }; row != 4; ++row)
+        {
+            matrix[column][row] += distribution(random);
+        }
+    }
+    if (isAffine)
+    {
+        matrix[0][3] = 0.0f;
+        matrix[1][3] = 0.0f;
+        matrix[2][3] = 0.0f;
+        matrix[3][3] = 1.0f;
+    }
+    return matrix;
+}
+
+Math::Mat4Batch createMatrices(std::mt19937& random, std::size_t size, bool isAffine)
+{
+    Math::Mat4Batch matrices{ size };
+    for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+    {
+        matrices.set(i, createMatrix(random, isAffine));
+    }
+    return matrices;
+}
+
+void testMultiply(Math::SimdLevel level)
+{
+    const Math::BatchMath batchMath{ level };
+    std::mt19937 random{ 1 };
+    for (const auto size : s_batchSizes)
+    {
+        const auto a{ createMatrices(random, size, /* isAffine */ false) };
+        auto b{ createMatrices(random, size, /* isAffine */ false) };
+        const auto uniformA{ createMatrix(random, /* isAffine */ false) };
+
+        Math::Mat4Batch out{};
+        batchMath.multiply(a, b, out);
+        check(out.size() == size, "multiply() resizes the output");
+        Math::Mat4Batch uniformOut{};
+        batchMath.multiply(uniformA, b, uniformOut);
+        check(uniformOut.size() == size, "multiply() with one matrix resizes the output");
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            check(isNear(out.get(i), a.get(i) * b.get(i)), std::format("multiply() of matrix {} of {}", i, size));
+            check(
+                isNear(uniformOut.get(i), uniformA * b.get(i)),
+                std::format("multiply() with one matrix of matrix {} of {}", i, size));
+        }
+
+        // In place.
+        batchMath.multiply(a, b, b);
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            check(b.get(i) == out.get(i), std::format("multiply() into b of matrix {} of {}", i, size));
+        }
+    }
+}
+
+void testTransformAabbs(Math::SimdLevel level)
+{
+    const Math::BatchMath batchMath{ level };
+    std::mt19937 random{ 2 };
+    std::uniform_real_distribution<float> distribution{ -10.0f, 10.0f };
+    for (const auto size : s_batchSizes)
+    {
+        const auto matrices{ createMatrices(random, size, /* isAffine */ true) };
+        Math::AabbBatch boxes{ size };
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            Geometry::Bounds box{};
+            for (auto axis{ 0 }; axis != 3; ++axis)
+            {
+                const auto a{ distribution(random) };
+                const auto b{ distribution(random) };
+                box.min[axis] = std::min(a, b);
+                box.max[axis] = std::max(a, b);
+            }
+            boxes.set(i, box);
+        }
+
+        Math::AabbBatch out{};
+        batchMath.transformAabbs(matrices, boxes, out);
+        check(out.size() == size, "transformAabbs() resizes the output");
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            // The bounds of the transformed corners.
+            const auto matrix{ matrices.get(i) };
+            const auto box{ boxes.get(i) };
+            glm::vec3 expectedMin{ std::numeric_limits<float>::infinity() };
+            glm::vec3 expectedMax{ -std::numeric_limits<float>::infinity() };
+            for (auto corner{ 0 }; corner != 8; ++corner)
+            {
+                const glm::vec4 position{ matrix * glm::vec4{ (corner & 1) != 0 ? box.max.x : box.min.x,
+                                                              (corner & 2) != 0 ? box.max.y : box.min.y,
+                                                              (corner & 4) != 0 ? box.max.z : box.min.z,
+                                                              1.0f } };
+                for (auto axis{ 0 }; axis != 3; ++axis)
+                {
+                    expectedMin[axis] = std::min(expectedMin[axis], position[axis]);
+                    expectedMax[axis] = std::max(expectedMax[axis], position[axis]);
+                }
+            }
+            const auto bounds{ out.get(i) };
+            for (auto axis{ 0 }; axis != 3; ++axis)
+            {
+                const auto scale{ std::max(std::abs(expectedMin[axis]), std::abs(expectedMax[axis])) };
+                check(
+                    isNear(bounds.min[axis], expectedMin[axis], scale) &&
+                        isNear(bounds.max[axis], expectedMax[axis], scale),
+                    std::format("transformAabbs() of box {} of {}", i, size));
+            }
+        }
+
+        // In place.
+        batchMath.transformAabbs(matrices, boxes, boxes);
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            check(
+                boxes.get(i).min == out.get(i).min && boxes.get(i).max == out.get(i).max,
+                std::format("transformAabbs() into boxes of box {} of {}", i, size));
+        }
+    }
+}
+
+void testComposeLocalToWorld(Math::SimdLevel level)
+{
+    const Math::BatchMath batchMath{ level };
+    std::mt19937 random{ 3 };
+    for (const auto size : s_batchSizes)
+    {
+        // A forest of binary trees in breadth first order, whose first roots are the first 3 nodes.
+        std::vector<std::uint32_t> parents(size);
+        Math::Mat4Batch local{ size };
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            parents[i] = i < 3 ? Math::BatchMath::s_noParent : static_cast<std::uint32_t>((i - 3) / 2);
+            // Near half the identity, so the products down the trees stay in range.
+            local.set(i, createMatrix(random, /* isAffine */ true, /* diagonal */ 0.5f, /* range */ 0.25f));
+        }
+
+        Math::Mat4Batch world{};
+        batchMath.composeLocalToWorld(local, parents, world);
+        check(world.size() == size, "composeLocalToWorld() resizes the output");
+        std::vector<glm::mat4> expected(size);
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            expected[i] =
+                parents[i] == Math::BatchMath::s_noParent ? local.get(i) : expected[parents[i]] * local.get(i);
+            check(isNear(world.get(i), expected[i]), std::format("composeLocalToWorld() of node {} of {}", i, size));
+        }
+
+        // In place.
+        batchMath.composeLocalToWorld(local, parents, local);
+        for (auto i{ std::size_t{ 0 } }; i != size; ++i)
+        {
+            check(
+                local.get(i) == world.get(i),
+                std::format("composeLocalToWorld() into local of node {} of {}", i, size));
+        }
+    }
+}
+
+} // namespace
+
+std::vector<TestCase> createMathTests()
+{
+    std::vector<TestCase> tests{};
+    // The kernels of the instruction sets that the CPU doesn't support can't run.
+    for (const auto level :
+         { Math::SimdLevel::Scalar, Math::SimdLevel::Sse41, Math::SimdLevel::Avx2, Math::SimdLevel::Neon })
+    {
+        if (!Math::BatchMath::isSupported(level))
+        {
+            continue;
+        }
+        const auto prefix{ std::format("BatchMath/{}/", Math::toString(level)) };
+        tests.push_back(TestCase{ prefix + "multiply",
+                                  [level]
+                                  {
+                                      testMultiply(level);
+                                  } });
+        tests.push_back(TestCase{ prefix + "transformAabbs",
+                                  [level]
+                                  {
+                                      testTransformAabbs(level);
+                                  } });
+        tests.push_back(TestCase{ prefix + "composeLocalToWorld",
+                                  [level]
+                                  {
+                                      testComposeLocalToWorld(level);
+                                  } });
+    }
+    return tests;
+}
+
+} // namespace VkTest1::Test
@@ -0,0 +1,111 @@
+#include "Tests.hpp"
+
+#include "common/Errors.hpp"
+#include "renderer/IRenderer.hpp"
+#include "renderer/RenderThread.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+namespace
+{
+
+// What the render thread called. Only read after it is stopped.
+struct RendererCalls
+{
+    std::uint32_t addedMeshCount{ 0 };
+    std::vector<std::uint32_t> removedMeshes{};
+    std::uint32_t drawCount{ 0 };
+};
+
+class RecordingRenderer : public Renderer::IRenderer
+{
+public:
+    explicit RecordingRenderer(RendererCalls& calls) :
+        m_calls{ calls }
+    {
+    }
+
+    void addTexture(std::future<Texture::TextureData> /* textureData */) override
+    {
+    }
+
+    std::uint32_t addMesh(
+        std::future<Geometry::MeshData> /* meshData */, std::optional<std::uint32_t> /* texture */) override
+    {
+        return m_calls.addedMeshCount++;
+    }
+
+    void removeMesh(std::uint32_t mesh) override
+    {
+        m_calls.removedMeshes.push_back(mesh);
+    }
+
+    void draw(const Renderer::FrameState& /* frameState */) override
+    {
+        ++m_calls.drawCount;
+    }
+
+    const Renderer::FrameStatistics& getFrameStatistics() const override
+    {
+        return m_frameStatistics;
+    }
+
+    void setCaptureSink(Renderer::CaptureSink /* sink */) override
+    {
+    }
+
+private:
+    RendererCalls& m_calls;
+    Renderer::FrameStatistics m_frameStatistics{};
+};
+
+void testRenderThreadRemoveMesh()
+{
+    RendererCalls calls{};
+    {
+        Renderer::Detail::RenderThread renderThread{ std::make_unique<RecordingRenderer>(calls),
+                                                     std::chrono::milliseconds{ 100 } };
+        check(renderThread.addMesh({}, std::nullopt) == 0, "the meshes are numbered from 0");
+        check(renderThread.addMesh({}, std::nullopt) == 1, "the meshes are numbered in the order they are added");
+
+        checkThrows<Common::RendererError>(
+            [&]
+            {
+                renderThread.removeMesh(2);
+            },
+            "removeMesh() of a mesh that was never added throws on the calling thread");
+        renderThread.removeMesh(0);
+        checkThrows<Common::RendererError>(
+            [&]
+            {
+                renderThread.removeMesh(0);
+            },
+            "removeMesh() of a removed mesh throws on the calling thread");
+
+        // The render thread still runs.
+        renderThread.draw(Renderer::FrameState{});
+        renderThread.removeMesh(1);
+        renderThread.draw(Renderer::FrameState{ /* frameNumber */ 1 });
+    }
+    check(calls.addedMeshCount == 2, "the meshes are added on the render thread");
+    check(calls.removedMeshes == std::vector<std::uint32_t>{ 0, 1 }, "only the valid removals reach the renderer");
+    check(calls.drawCount >= 1, "the render thread draws after a bad removal");
+}
+
+} // namespace
+
+std::vector<TestCase> createRendererTests()
+{
+    return {
+        TestCase{ "RenderThread/removeMesh", testRenderThreadRemoveMesh },
+    };
+}
+
+} // namespace VkTest1::Test
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <format>
+#include <functional>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace VkTest1::Test
+{
+
+struct TestCase
+{
+    std::string name;
+    // Throws TestFailure if the test fails. Any other exception fails it too.
+    std::function<void()> run;
+};
+
+class TestFailure : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Throws TestFailure with the location of the call if the condition is false.
+inline void check(
+    bool condition, std::string_view what, std::source_location location = std::source_location::current())
+{
+    if (!condition)
+    {
+        throw TestFailure{ std::format("{}:{}: {}", location.file_name(), location.line(), what) };
+    }
+}
+
+// Throws TestFailure if calling function doesn't throw a TException.
+template<typename TException, typename TFunction>
+void checkThrows(
+    TFunction&& function, std::string_view what, std::source_location location = std::source_location::current())
+{
+    try
+    {
+        std::invoke(std::forward<TFunction>(function));
+    }
+    catch (const TException&)
+    {
+        return;
+    }
+    check(false, what, location);
+}
+
+} // namespace VkTest1::Test
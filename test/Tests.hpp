@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Test.hpp"
+
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+// Of the Assets module: the order of the asset loader.
+std::vector<TestCase> createAssetTests();
+
+// Of the Common module: the work-stealing deque and the job system.
+std::vector<TestCase> createCommonTests();
+
+// Of the Math module: the batch kernels of every instruction set that the CPU supports, compared with glm.
+std::vector<TestCase> createMathTests();
+
+// Of the Renderer module, as far as it runs without Vulkan: the render thread with a fake renderer.
+std::vector<TestCase> createRendererTests();
+
+// Of the tools: the BC encoder kernels of every instruction set that the CPU supports, compared with the scalar ones.
+std::vector<TestCase> createToolTests();
+
+// Of the World module: the streamer, with fakes of the file system, the asset loader and the renderer.
+std::vector<TestCase> createWorldTests();
+
+} // namespace VkTest1::Test
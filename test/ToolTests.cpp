@@ -0,0 +1,123 @@
+#include "Tests.hpp"
+
+#include "common/CpuFeatures.hpp"
+#include "texture_convert/BcKernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+namespace
+{
+
+using Tools::Detail::s_blockTexelCount;
+
+// Random texels, or a single color, so that ties between the palette colors occur too.
+Tools::Detail::BlockChannels createBlock(std::mt19937& random, bool isUniform)
+{
+    std::uniform_int_distribution<int> distribution{ 0, 255 };
+    Tools::Detail::BlockChannels block{};
+    for (auto c{ 0u }; c != 4; ++c)
+    {
+        const auto uniformValue{ static_cast<float>(distribution(random)) };
+        for (auto i{ 0u }; i != s_blockTexelCount; ++i)
+        {
+            block.channels[c][i] = isUniform ? uniformValue : static_cast<float>(distribution(random));
+        }
+    }
+    return block;
+}
+
+// The vector kernels must match the scalar ones exactly, or the encoded textures would depend on the CPU.
+void testBcKernels(const Tools::Detail::BcKernels& kernels)
+{
+    const auto& scalarKernels{ Tools::Detail::getScalarBcKernels() };
+    std::mt19937 random{ 4 };
+    std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+    std::uniform_int_distribution<int> colorDistribution{ 0, 255 };
+    for (auto blockIndex{ 0 }; blockIndex != 200; ++blockIndex)
+    {
+        const auto block{ createBlock(random, /* isUniform */ blockIndex % 4 == 0) };
+        for (const auto channelCount : { std::size_t{ 3 }, std::size_t{ 4 } })
+        {
+            float mean[4]{};
+            float axis[4]{};
+            for (auto c{ 0u }; c != 4; ++c)
+            {
+                mean[c] = static_cast<float>(colorDistribution(random));
+                axis[c] = distribution(random);
+            }
+            auto minProjection{ 0.0f };
+            auto maxProjection{ 0.0f };
+            kernels.projectOntoAxis(block, mean, axis, channelCount, minProjection, maxProjection);
+            auto expectedMinProjection{ 0.0f };
+            auto expectedMaxProjection{ 0.0f };
+            scalarKernels.projectOntoAxis(
+                block, mean, axis, channelCount, expectedMinProjection, expectedMaxProjection);
+            check(
+                minProjection == expectedMinProjection && maxProjection == expectedMaxProjection,
+                std::format("projectOntoAxis() of block {} with {} channels", blockIndex, channelCount));
+
+            for (const auto paletteSize : { std::size_t{ 1 }, std::size_t{ 4 }, std::size_t{ 16 } })
+            {
+                // Repeated colors, so that the first of the equally close ones must be chosen.
+                Tools::Detail::Palette palette{};
+                for (auto entry{ 0u }; entry != paletteSize; ++entry)
+                {
+                    for (auto c{ 0u }; c != 4; ++c)
+                    {
+                        palette.colors[entry][c] = entry % 3 == 2 ? palette.colors[entry - 1][c]
+                                                                  : static_cast<float>(colorDistribution(random));
+                    }
+                }
+                std::uint8_t indices[s_blockTexelCount]{};
+                float errors[s_blockTexelCount]{};
+                kernels.chooseIndices(block, palette, paletteSize, channelCount, indices, errors);
+                std::uint8_t expectedIndices[s_blockTexelCount]{};
+                float expectedErrors[s_blockTexelCount]{};
+                scalarKernels.chooseIndices(block, palette, paletteSize, channelCount, expectedIndices, expectedErrors);
+                for (auto i{ 0u }; i != s_blockTexelCount; ++i)
+                {
+                    check(
+                        indices[i] == expectedIndices[i] && errors[i] == expectedErrors[i],
+                        std::format(
+                            "chooseIndices() of texel {} of block {} with {} colors and {} channels",
+                            i,
+                            blockIndex,
+                            paletteSize,
+                            channelCount));
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::vector<TestCase> createToolTests()
+{
+    std::vector<TestCase> tests{};
+    // The kernels of the instruction sets that the CPU doesn't support can't run.
+    const auto addTest = [&tests](std::string name, const Tools::Detail::BcKernels* kernels, bool isSupported)
+    {
+        if (kernels != nullptr && isSupported)
+        {
+            tests.push_back(TestCase{ std::format("BcKernels/{}", name),
+                                      [kernels]
+                                      {
+                                          testBcKernels(*kernels);
+                                      } });
+        }
+    };
+    addTest("SSE 4.1", Tools::Detail::getSse41BcKernels(), Common::isSse41Supported());
+    addTest("AVX2", Tools::Detail::getAvx2BcKernels(), Common::isAvx2Supported());
+    return tests;
+}
+
+} // namespace VkTest1::Test
@@ -0,0 +1,205 @@
+#include "Tests.hpp"
+
+#include "assets/IAssetLoader.hpp"
+#include "common/IFileSystem.hpp"
+#include "logging/ILogger.hpp"
+#include "renderer/IRenderer.hpp"
+#include "world/WorldFile.hpp"
+#include "world/WorldStreamer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+namespace VkTest1::Test
+{
+
+namespace
+{
+
+class FakeFileSystem : public Common::IFileSystem
+{
+public:
+    explicit FakeFileSystem(std::vector<std::byte> contents) :
+        m_contents{ std::move(contents) }
+    {
+    }
+
+    std::vector<std::byte> readFile(const std::filesystem::path& /* path */) override
+    {
+        return m_contents;
+    }
+
+    std::vector<std::byte> readFileRange(
+        const std::filesystem::path& /* path */, std::uint64_t offset, std::size_t size) override
+    {
+        if (offset > m_contents.size() || size > m_contents.size() - offset)
+        {
+            throw std::out_of_range{ "Read past the end of the file." };
+        }
+        return { m_contents.begin() + offset, m_contents.begin() + offset + size };
+    }
+
+private:
+    std::vector<std::byte> m_contents;
+};
+
+// Records the reads and never finishes them, so the chunks stay loading.
+class FakeAssetLoader : public Assets::IAssetLoader
+{
+public:
+    struct Read
+    {
+        std::uint64_t offset;
+        std::size_t size;
+    };
+
+    std::future<std::vector<std::byte>> loadFile(
+        const std::filesystem::path& /* path */, Assets::LoadPriority /* priority */) override
+    {
+        throw std::logic_error{ "Not used by the streamer." };
+    }
+
+    std::future<std::vector<std::byte>> loadFileRange(
+        const std::filesystem::path& /* path */, std::uint64_t offset, std::size_t size,
+        Assets::LoadPriority /* priority */) override
+    {
+        m_reads.push_back(Read{ offset, size });
+        return m_pendingReads.emplace_back().get_future();
+    }
+
+    std::future<Geometry::MeshData> loadMesh(
+        const std::filesystem::path& /* path */, Assets::LoadPriority /* priority */,
+        Assets::MeshDecoder /* decoder */) override
+    {
+        throw std::logic_error{ "Not used by the streamer." };
+    }
+
+    std::future<Texture::TextureData> loadTexture(
+        const std::filesystem::path& /* path */, Assets::LoadPriority /* priority */,
+        Assets::TextureDecoder /* decoder */) override
+    {
+        throw std::logic_error{ "Not used by the streamer." };
+    }
+
+    std::future<Geometry::MeshData> generateMesh(
+        Assets::LoadPriority /* priority */, Assets::MeshGenerator /* generator */) override
+    {
+        throw std::logic_error{ "Not used, since no read finishes." };
+    }
+
+    const std::vector<Read>& getReads() const
+    {
+        return m_reads;
+    }
+
+private:
+    std::vector<Read> m_reads{};
+    std::vector<std::promise<std::vector<std::byte>>> m_pendingReads{};
+};
+
+class FakeRenderer : public Renderer::IRenderer
+{
+public:
+    void addTexture(std::future<Texture::TextureData> /* textureData */) override
+    {
+    }
+
+    std::uint32_t addMesh(
+        std::future<Geometry::MeshData> /* meshData */, std::optional<std::uint32_t> /* texture */) override
+    {
+        return m_meshCount++;
+    }
+
+    void removeMesh(std::uint32_t /* mesh */) override
+    {
+    }
+
+    void draw(const Renderer::FrameState& /* frameState */) override
+    {
+    }
+
+    const Renderer::FrameStatistics& getFrameStatistics() const override
+    {
+        return m_frameStatistics;
+    }
+
+    void setCaptureSink(Renderer::CaptureSink /* sink */) override
+    {
+    }
+
+private:
+    std::uint32_t m_meshCount{ 0 };
+    Renderer::FrameStatistics m_frameStatistics{};
+};
+
+class NullLogger : public Logging::ILogger
+{
+public:
+    bool isEnabled(Logging::Severity /* severity */) const override
+    {
+        return false;
+    }
+
+    void write(const Logging::LogMessage& /* message */) override
+    {
+    }
+};
+
+// A chunk with one mesh file of the size. The streamer doesn't look into the data until it is read.
+World::WorldChunkData createChunk(float x, std::size_t dataSize)
+{
+    return World::WorldChunkData{
+        Geometry::Bounds{ Geometry::Position{ x, 0.0f, 0.0f }, Geometry::Position{ x + 1.0f, 1.0f, 1.0f } },
+        { World::WorldChunkData::Mesh{ std::vector<std::byte>(dataSize), std::nullopt } }
+    };
+}
+
+void testIoQuota()
+{
+    // The small chunk is in view, the large one next to it.
+    const World::WorldChunkData chunks[]{ createChunk(0.0f, 100), createChunk(2.0f, 1000) };
+    const auto contents{ World::encodeWorldFile(chunks) };
+    const auto index{ World::decodeWorldIndex(contents) };
+
+    FakeFileSystem fileSystem{ contents };
+    FakeAssetLoader assetLoader{};
+    FakeRenderer renderer{};
+    NullLogger logger{};
+    World::WorldStreamerSettings settings{};
+    settings.loadDistance = 5.0f;
+    settings.unloadDistance = 10.0f;
+    settings.ioQuota = 500;
+    World::WorldStreamer streamer{ &fileSystem, &assetLoader, &renderer, &logger, "world.vtworld", settings };
+    check(streamer.getChunkCount() == 2, "the streamer reads the index");
+
+    const Geometry::Bounds view{ Geometry::Position{ 0.0f, 0.0f, 0.0f }, Geometry::Position{ 1.0f, 1.0f, 1.0f } };
+    streamer.update(view);
+    check(assetLoader.getReads().size() == 1, "a chunk larger than the rest of the quota doesn't start");
+    check(
+        assetLoader.getReads()[0].offset == index.chunks[0].dataOffset &&
+            assetLoader.getReads()[0].size == index.chunks[0].dataSize,
+        "the nearest chunk starts first");
+
+    streamer.update(view);
+    check(assetLoader.getReads().size() == 2, "a chunk larger than the quota starts as the first of its update");
+    check(assetLoader.getReads()[1].offset == index.chunks[1].dataOffset, "the large chunk starts alone");
+
+    streamer.update(view);
+    check(assetLoader.getReads().size() == 2, "a loading chunk doesn't start again");
+}
+
+} // namespace
+
+std::vector<TestCase> createWorldTests()
+{
+    return {
+        TestCase{ "WorldStreamer/I/O quota", testIoQuota },
+    };
+}
+
+} // namespace VkTest1::Test
@@ -0,0 +1,90 @@
+#include "Test.hpp"
+#include "Tests.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iterator>
+#include <print>
+#include <span>
+#include <string_view>
+#include <vector>
+
+using namespace VkTest1;
+
+namespace
+{
+
+void printUsage()
+{
+    std::println("Usage: vulkan_test_01_tests [--filter <text>] [--list]");
+    std::println("Runs the tests whose name contains the filter text, all by default. Fails if one of them fails.");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::span<char*> args{ argv + 1, static_cast<std::size_t>(argc - 1) };
+
+    std::string_view filter{};
+    auto isListing{ false };
+    for (auto i{ 0u }; i != args.size(); ++i)
+    {
+        const std::string_view arg{ args[i] };
+        if (arg == "--filter" && i + 1 != args.size())
+        {
+            filter = args[++i];
+        }
+        else if (arg == "--list")
+        {
+            isListing = true;
+        }
+        else
+        {
+            printUsage();
+            return (arg == "-h" || arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    auto tests{ Test::createAssetTests() };
+    std::ranges::move(Test::createCommonTests(), std::back_inserter(tests));
+    std::ranges::move(Test::createMathTests(), std::back_inserter(tests));
+    std::ranges::move(Test::createRendererTests(), std::back_inserter(tests));
+    std::ranges::move(Test::createToolTests(), std::back_inserter(tests));
+    std::ranges::move(Test::createWorldTests(), std::back_inserter(tests));
+    std::erase_if(
+        tests,
+        [filter](const Test::TestCase& test)
+        {
+            return !test.name.contains(filter);
+        });
+    if (isListing)
+    {
+        for (const auto& test : tests)
+        {
+            std::println("{}", test.name);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    auto failedCount{ 0u };
+    for (const auto& test : tests)
+    {
+        const auto startTime{ std::chrono::steady_clock::now() };
+        try
+        {
+            test.run();
+            const std::chrono::duration<double, std::milli> time{ std::chrono::steady_clock::now() - startTime };
+            std::println("PASSED  {} ({:.1f} ms)", test.name, time.count());
+        }
+        catch (const std::exception& ex)
+        {
+            std::println("FAILED  {}: {}", test.name, ex.what());
+            ++failedCount;
+        }
+    }
+    std::println("{} of {} tests passed.", tests.size() - failedCount, tests.size());
+    return failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,492 @@
+#include "MeshSimplifier.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+// Below this, a level saves too little to be worth its indices.
+constexpr std::size_t s_minTriangleCount{ 16 };
+// A level must have at most this fraction of the triangles of the previous one.
+constexpr double s_minReduction{ 0.85 };
+// Relative to the diagonal of the bounds. Beyond this, a level no longer looks like the mesh at any size.
+constexpr double s_maxRelativeError{ 0.02 };
+
+//
+// The sum of the squared distances to a set of planes, as a symmetric 4x4 matrix. The planes are weighted by the area
+// of their triangles, so the error of a vertex is dominated by its big neighbors.
+//
+struct Quadric
+{
+    // The upper triangle of the matrix: aa, ab, ac, ad, bb, bc, bd, cc, cd, dd.
+    std::array<double, 10> m{};
+    double weight{ 0.0 };
+};
+
+Quadric makeTriangleQuadric(const glm::dvec3& p0, const glm::dvec3& p1, const glm::dvec3& p2)
+{
+    const auto normal{ glm::cross(p1 - p0, p2 - p0) };
+    const auto doubleArea{ glm::length(normal) };
+    if (doubleArea == 0.0)
+    {
+        // Degenerate. Its plane is undefined.
+        return {};
+    }
+
+    const auto n{ normal / doubleArea };
+    const auto d{ -glm::dot(n, p0) };
+    const auto w{ doubleArea * 0.5 };
+    return Quadric{ { w * n.x * n.x,
+                      w * n.x * n.y,
+                      w * n.x * n.z,
+                      w * n.x * d,
+                      w * n.y * n.y,
+                      w * n.y * n.z,
+                      w * n.y * d,
+                      w * n.z * n.z,
+                      w * n.z * d,
+                      w * d * d },
+                    w };
+}
+
+Quadric operator+(const Quadric& lhs, const Quadric& rhs)
+{
+    Quadric sum{};
+    for (auto i{ 0u }; i != sum.m.size(); ++i)
+    {
+        sum.m[i] = lhs.m[i] + rhs.m[i];
+    }
+    sum.weight = lhs.weight + rhs.weight;
+    return sum;
+}
+
+// The mean squared distance of p to the planes.
+double evaluate(const Quadric& q, const glm::dvec3& p)
+{
+    if (q.weight == 0.0)
+    {
+        return 0.0;
+    }
+    const auto& m{ q.m };
+    const auto error{ m[0] * p.x * p.x + 2.0 * m[1] * p.x * p.y + 2.0 * m[2] * p.x * p.z + 2.0 * m[3] * p.x +
+                      m[4] * p.y * p.y + 2.0 * m[5] * p.y * p.z + 2.0 * m[6] * p.y + m[7] * p.z * p.z +
+                      2.0 * m[8] * p.z + m[9] };
+    // Rounding can make it slightly negative.
+    return std::max(error, 0.0) / q.weight;
+}
+
+using Triangle = std::array<std::uint32_t, 3>;
+
+bool contains(const Triangle& triangle, std::uint32_t vertex)
+{
+    return std::ranges::find(triangle, vertex) != triangle.end();
+}
+
+class Simplifier
+{
+public:
+    explicit Simplifier(std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices);
+
+    // Collapses edges until at most targetTriangleCount triangles are left or no valid collapse within maxError
+    // remains.
+    void simplify(std::size_t targetTriangleCount, double maxError);
+
+    std::size_t getTriangleCount() const
+    {
+        return m_triangleCount;
+    }
+
+    // The largest deviation caused by a collapse so far.
+    double getError() const
+    {
+        return std::sqrt(m_maxCost);
+    }
+
+    // The remaining triangles in their original order.
+    void appendIndices(std::vector<std::uint32_t>& indices) const;
+
+private:
+    // Merges vertex "from" into vertex "to".
+    struct Collapse
+    {
+        double cost;
+        std::uint32_t from;
+        std::uint32_t to;
+        // Of the two vertices when the cost was computed. A changed version means the cost is stale.
+        std::uint32_t fromVersion;
+        std::uint32_t toVersion;
+
+        bool operator>(const Collapse& other) const
+        {
+            return cost > other.cost;
+        }
+    };
+
+    void lockBordersAndSeams(std::span<const Geometry::Vertex> vertices);
+
+    // The vertices that share a triangle with the vertex, sorted.
+    void getNeighbors(std::uint32_t vertex, std::vector<std::uint32_t>& neighbors) const;
+
+    void pushCollapse(std::uint32_t from, std::uint32_t to);
+    // Both directions of every edge of the vertex.
+    void pushCollapses(std::uint32_t vertex);
+
+    bool isCurrent(const Collapse& collapse) const;
+    // Rejects collapses that would make the mesh non-manifold or fold a triangle over.
+    bool isValid(std::uint32_t from, std::uint32_t to);
+    void collapse(std::uint32_t from, std::uint32_t to);
+
+    std::vector<glm::dvec3> m_positions;
+    std::vector<Quadric> m_quadrics;
+    std::vector<std::uint32_t> m_versions;
+    std::vector<bool> m_isLocked;
+    std::vector<bool> m_isCollapsed;
+    std::vector<Triangle> m_triangles{};
+    std::vector<bool> m_isRemoved{};
+    // The triangles of each vertex. May still list removed triangles.
+    std::vector<std::vector<std::uint32_t>> m_vertexTriangles;
+    std::size_t m_triangleCount{ 0 };
+    double m_maxCost{ 0.0 };
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> m_queue{};
+    // Scratch space of isValid().
+    std::vector<std::uint32_t> m_fromNeighbors{};
+    std::vector<std::uint32_t> m_toNeighbors{};
+};
+
+Simplifier::Simplifier(std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices) :
+    m_positions(vertices.size()),
+    m_quadrics(vertices.size()),
+    m_versions(vertices.size(), 0),
+    m_isLocked(vertices.size(), false),
+    m_isCollapsed(vertices.size(), false),
+    m_vertexTriangles(vertices.size())
+{
+    std::ranges::transform(
+        vertices,
+        m_positions.begin(),
+        [](const Geometry::Vertex& vertex)
+        {
+            return glm::dvec3{ vertex.position };
+        });
+
+    m_triangles.reserve(indices.size() / 3);
+    for (auto i{ 0u }; i + 2 < indices.size(); i += 3)
+    {
+        const Triangle triangle{ indices[i], indices[i + 1], indices[i + 2] };
+        if (std::ranges::any_of(
+                triangle,
+                [&vertices](std::uint32_t index)
+                {
+                    return index >= vertices.size();
+                }))
+        {
+            throw Common::FormatError{ "Index out of range." };
+        }
+        // Degenerate triangles are dropped right away.
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+        {
+            continue;
+        }
+
+        const auto triangleIndex{ static_cast<std::uint32_t>(m_triangles.size()) };
+        const auto quadric{ makeTriangleQuadric(
+            m_positions[triangle[0]], m_positions[triangle[1]], m_positions[triangle[2]]) };
+        for (const auto vertex : triangle)
+        {
+            m_quadrics[vertex] = m_quadrics[vertex] + quadric;
+            m_vertexTriangles[vertex].push_back(triangleIndex);
+        }
+        m_triangles.push_back(triangle);
+    }
+    m_isRemoved.assign(m_triangles.size(), false);
+    m_triangleCount = m_triangles.size();
+
+    lockBordersAndSeams(vertices);
+
+    std::vector<std::uint32_t> neighbors{};
+    for (auto vertex{ 0u }; vertex != m_positions.size(); ++vertex)
+    {
+        getNeighbors(vertex, neighbors);
+        for (const auto neighbor : neighbors)
+        {
+            // Every edge once.
+            if (neighbor > vertex)
+            {
+                pushCollapse(vertex, neighbor);
+                pushCollapse(neighbor, vertex);
+            }
+        }
+    }
+}
+
+void Simplifier::lockBordersAndSeams(std::span<const Geometry::Vertex> vertices)
+{
+    // A border edge belongs to one triangle. Edges of more than two triangles are non-manifold; locked as well.
+    std::unordered_map<std::uint64_t, std::uint32_t> edgeTriangleCounts{};
+    const auto getEdgeKey = [](std::uint32_t a, std::uint32_t b)
+    {
+        return (std::uint64_t{ std::min(a, b) } << 32) | std::max(a, b);
+    };
+    for (const auto& triangle : m_triangles)
+    {
+        for (auto corner{ 0u }; corner != 3; ++corner)
+        {
+            ++edgeTriangleCounts[getEdgeKey(triangle[corner], triangle[(corner + 1) % 3])];
+        }
+    }
+    for (const auto& [key, count] : edgeTriangleCounts)
+    {
+        if (count != 2)
+        {
+            m_isLocked[key >> 32] = true;
+            m_isLocked[key & 0xFFFF'FFFF] = true;
+        }
+    }
+
+    // Sorting by position puts the vertices of a seam next to each other.
+    std::vector<std::uint32_t> order(vertices.size());
+    for (auto i{ 0u }; i != order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::ranges::sort(
+        order,
+        [&vertices](std::uint32_t lhs, std::uint32_t rhs)
+        {
+            const auto& a{ vertices[lhs].position };
+            const auto& b{ vertices[rhs].position };
+            return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+        });
+    for (auto i{ 1u }; i < order.size(); ++i)
+    {
+        if (vertices[order[i - 1]].position == vertices[order[i]].position)
+        {
+            m_isLocked[order[i - 1]] = true;
+            m_isLocked[order[i]] = true;
+        }
+    }
+}
+
+void Simplifier::getNeighbors(std::uint32_t vertex, std::vector<std::uint32_t>& neighbors) const
+{
+    neighbors.clear();
+    for (const auto triangleIndex : m_vertexTriangles[vertex])
+    {
+        if (m_isRemoved[triangleIndex])
+        {
+            continue;
+        }
+        for (const auto corner : m_triangles[triangleIndex])
+        {
+            if (corner != vertex)
+            {
+                neighbors.push_back(corner);
+            }
+        }
+    }
+    std::ranges::sort(neighbors);
+    const auto duplicates{ std::ranges::unique(neighbors) };
+    neighbors.erase(duplicates.begin(), duplicates.end());
+}
+
+void Simplifier::pushCollapse(std::uint32_t from, std::uint32_t to)
+{
+    if (m_isLocked[from])
+    {
+        return;
+    }
+    const auto cost{ evaluate(m_quadrics[from] + m_quadrics[to], m_positions[to]) };
+    m_queue.push(Collapse{ cost, from, to, m_versions[from], m_versions[to] });
+}
+
+void Simplifier::pushCollapses(std::uint32_t vertex)
+{
+    std::vector<std::uint32_t> neighbors{};
+    getNeighbors(vertex, neighbors);
+    for (const auto neighbor : neighbors)
+    {
+        pushCollapse(vertex, neighbor);
+        pushCollapse(neighbor, vertex);
+    }
+}
+
+bool Simplifier::isCurrent(const Collapse& collapse) const
+{
+    return !m_isCollapsed[collapse.from] && !m_isCollapsed[collapse.to] &&
+           m_versions[collapse.from] == collapse.fromVersion && m_versions[collapse.to] == collapse.toVersion;
+}
+
+bool Simplifier::isValid(std::uint32_t from, std::uint32_t to)
+{
+    // The link condition: the vertices may only share the neighbors opposite to their common edge. Otherwise the
+    // collapse pinches the surface.
+    getNeighbors(from, m_fromNeighbors);
+    getNeighbors(to, m_toNeighbors);
+    auto sharedNeighborCount{ 0u };
+    for (const auto neighbor : m_fromNeighbors)
+    {
+        sharedNeighborCount += std::ranges::binary_search(m_toNeighbors, neighbor) ? 1 : 0;
+    }
+    auto sharedTriangleCount{ 0u };
+    for (const auto triangleIndex : m_vertexTriangles[from])
+    {
+        if (!m_isRemoved[triangleIndex] && contains(m_triangles[triangleIndex], to))
+        {
+            ++sharedTriangleCount;
+        }
+    }
+    if (sharedNeighborCount > sharedTriangleCount)
+    {
+        return false;
+    }
+
+    // The triangles that stay must not flip.
+    for (const auto triangleIndex : m_vertexTriangles[from])
+    {
+        const auto& triangle{ m_triangles[triangleIndex] };
+        if (m_isRemoved[triangleIndex] || contains(triangle, to))
+        {
+            continue;
+        }
+        std::array<glm::dvec3, 3> corners{};
+        std::array<glm::dvec3, 3> movedCorners{};
+        for (auto corner{ 0u }; corner != 3; ++corner)
+        {
+            corners[corner] = m_positions[triangle[corner]];
+            movedCorners[corner] = m_positions[(triangle[corner] == from) ? to : triangle[corner]];
+        }
+        const auto normal{ glm::cross(corners[1] - corners[0], corners[2] - corners[0]) };
+        const auto movedNormal{ glm::cross(movedCorners[1] - movedCorners[0], movedCorners[2] - movedCorners[0]) };
+        if (glm::dot(normal, movedNormal) <= 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Simplifier::collapse(std::uint32_t from, std::uint32_t to)
+{
+    m_quadrics[to] = m_quadrics[to] + m_quadrics[from];
+    m_isCollapsed[from] = true;
+
+    for (const auto triangleIndex : m_vertexTriangles[from])
+    {
+        if (m_isRemoved[triangleIndex])
+        {
+            continue;
+        }
+        auto& triangle{ m_triangles[triangleIndex] };
+        if (contains(triangle, to))
+        {
+            // Collapsed to a line.
+            m_isRemoved[triangleIndex] = true;
+            --m_triangleCount;
+            continue;
+        }
+        std::ranges::replace(triangle, from, to);
+        m_vertexTriangles[to].push_back(triangleIndex);
+    }
+    m_vertexTriangles[from].clear();
+    std::erase_if(
+        m_vertexTriangles[to],
+        [this](std::uint32_t triangleIndex)
+        {
+            return m_isRemoved[triangleIndex];
+        });
+
+    // The costs of the edges of the kept vertex changed. The other costs are still right; whether those collapses
+    // are still valid is checked when they come up.
+    ++m_versions[to];
+    pushCollapses(to);
+}
+
+void Simplifier::simplify(std::size_t targetTriangleCount, double maxError)
+{
+    const auto maxCost{ maxError * maxError };
+    while (m_triangleCount > targetTriangleCount && !m_queue.empty() && m_queue.top().cost <= maxCost)
+    {
+        const auto next{ m_queue.top() };
+        m_queue.pop();
+        if (!isCurrent(next) || !isValid(next.from, next.to))
+        {
+            continue;
+        }
+        collapse(next.from, next.to);
+        m_maxCost = std::max(m_maxCost, next.cost);
+    }
+}
+
+void Simplifier::appendIndices(std::vector<std::uint32_t>& indices) const
+{
+    for (auto i{ 0u }; i != m_triangles.size(); ++i)
+    {
+        if (!m_isRemoved[i])
+        {
+            indices.insert(indices.end(), m_triangles[i].begin(), m_triangles[i].end());
+        }
+    }
+}
+
+} // namespace
+
+void generateLods(Geometry::MeshData& meshData, std::uint32_t maxLodCount)
+{
+    meshData.lods.clear();
+    if (meshData.indices.empty())
+    {
+        return;
+    }
+    if (meshData.indices.size() > std::numeric_limits<std::uint32_t>::max() / 2)
+    {
+        // The levels together need up to twice the indices, and the LOD ranges are 32 bit.
+        throw Common::FormatError{ "Too many indices for LODs." };
+    }
+
+    const auto fullIndexCount{ static_cast<std::uint32_t>(meshData.indices.size()) };
+    meshData.lods.push_back(Geometry::MeshLod{ /* firstIndex */ 0, /* indexCount */ fullIndexCount, /* error */ 0.0f });
+
+    const auto bounds{ Geometry::computeBounds(meshData.vertices) };
+    const auto maxError{ s_maxRelativeError * glm::length(glm::dvec3{ bounds.max - bounds.min }) };
+    Simplifier simplifier{ meshData.vertices, meshData.indices };
+    auto previousTriangleCount{ simplifier.getTriangleCount() };
+    while (meshData.lods.size() < maxLodCount)
+    {
+        const auto targetTriangleCount{ previousTriangleCount / 2 };
+        if (targetTriangleCount < s_minTriangleCount)
+        {
+            break;
+        }
+
+        simplifier.simplify(targetTriangleCount, maxError);
+        const auto triangleCount{ simplifier.getTriangleCount() };
+        if (static_cast<double>(triangleCount) > static_cast<double>(previousTriangleCount) * s_minReduction)
+        {
+            // Locked vertices, invalid collapses or the error limit left too little to remove.
+            break;
+        }
+
+        const auto firstIndex{ static_cast<std::uint32_t>(meshData.indices.size()) };
+        simplifier.appendIndices(meshData.indices);
+        meshData.lods.push_back(Geometry::MeshLod{ firstIndex,
+                                                   static_cast<std::uint32_t>(meshData.indices.size() - firstIndex),
+                                                   static_cast<float>(simplifier.getError()) });
+        previousTriangleCount = triangleCount;
+    }
+}
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <cstdint>
+
+namespace VkTest1::Tools
+{
+
+//
+// Generates the levels of detail of an indexed mesh by edge collapse with quadric error metrics (Garland-Heckbert).
+//
+// Every level has about half the triangles of the previous one. It stops at maxLodCount levels, or when a level would
+// have too few triangles or would barely be smaller than the previous one.
+//
+// An edge collapse merges one vertex into the other, so the levels only reference vertices of the full detail mesh:
+// their indices are appended to meshData.indices and all levels share the vertex buffer. meshData.lods gets one entry
+// per level, the full detail one included.
+//
+// Vertices on open borders and on attribute seams (several vertices at the same position, e.g. with different
+// texture coordinates) are never merged away, so the silhouette of open meshes and the seams don't tear.
+//
+// Non-indexed meshes are left as they are.
+//
+void generateLods(Geometry::MeshData& meshData, std::uint32_t maxLodCount);
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,304 @@
+#include "MeshletBuilder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+constexpr std::uint32_t s_noMeshlet{ std::numeric_limits<std::uint32_t>::max() };
+
+using Triangle = std::array<std::uint32_t, 3>;
+
+// The normalized cross(p1 - p0, p2 - p0). Zero for degenerate triangles.
+glm::vec3 getNormal(std::span<const Geometry::Vertex> vertices, const Triangle& triangle)
+{
+    const auto& p0{ vertices[triangle[0]].position };
+    const auto normal{ glm::cross(vertices[triangle[1]].position - p0, vertices[triangle[2]].position - p0) };
+    const auto length{ glm::length(normal) };
+    return (length > 0.0f) ? normal / length : glm::vec3{ 0.0f, 0.0f, 0.0f };
+}
+
+glm::vec3 getCentroid(std::span<const Geometry::Vertex> vertices, const Triangle& triangle)
+{
+    return (vertices[triangle[0]].position + vertices[triangle[1]].position + vertices[triangle[2]].position) / 3.0f;
+}
+
+void computeBounds(
+    std::span<const Geometry::Vertex> vertices, std::span<const Triangle> triangles, Geometry::Meshlet& meshlet)
+{
+    // The center of the bounding box is close enough to the center of the smallest sphere.
+    auto min{ vertices[triangles.front()[0]].position };
+    auto max{ min };
+    for (const auto& triangle : triangles)
+    {
+        for (const auto vertex : triangle)
+        {
+            min = glm::min(min, vertices[vertex].position);
+            max = glm::max(max, vertices[vertex].position);
+        }
+    }
+    meshlet.center = (min + max) * 0.5f;
+    meshlet.radius = 0.0f;
+    for (const auto& triangle : triangles)
+    {
+        for (const auto vertex : triangle)
+        {
+            meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, vertices[vertex].position));
+        }
+    }
+
+    // The axis is the mean normal. The half angle of the cone is the largest angle between the axis and a normal.
+    auto normalSum{ glm::vec3{ 0.0f, 0.0f, 0.0f } };
+    for (const auto& triangle : triangles)
+    {
+        normalSum += getNormal(vertices, triangle);
+    }
+    const auto normalSumLength{ glm::length(normalSum) };
+    meshlet.coneAxis = (normalSumLength > 0.0f) ? normalSum / normalSumLength : glm::vec3{ 0.0f, 0.0f, 1.0f };
+    meshlet.coneCutoff = 1.0f;
+    if (normalSumLength == 0.0f)
+    {
+        return;
+    }
+
+    auto minCosine{ 1.0f };
+    for (const auto& triangle : triangles)
+    {
+        const auto normal{ getNormal(vertices, triangle) };
+        if (normal != glm::vec3{ 0.0f, 0.0f, 0.0f })
+        {
+            minCosine = std::min(minCosine, glm::dot(meshlet.coneAxis, normal));
+        }
+    }
+    // At 90 degrees or more, some triangle faces every direction the axis doesn't.
+    if (minCosine > 0.0f)
+    {
+        meshlet.coneCutoff = std::sqrt(1.0f - minCosine * minCosine);
+    }
+}
+
+//
+// Builds the meshlets of one LOD.
+//
+class LodMeshletBuilder
+{
+public:
+    explicit LodMeshletBuilder(std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices);
+
+    // Appends the meshlets to meshlets and writes the triangles in meshlet order to indices.
+    // indexOffset is the position of the indices in the index buffer of the mesh.
+    void build(std::span<std::uint32_t> indices, std::uint32_t indexOffset, std::vector<Geometry::Meshlet>& meshlets);
+
+private:
+    // Adds the triangle to the current meshlet and its neighbors to the candidates.
+    void addTriangle(std::uint32_t triangleIndex);
+    // The best unused candidate that fits into the current meshlet, if any.
+    std::optional<std::uint32_t> findNextTriangle();
+    // The first unused triangle next to the previous meshlets, or else in index order.
+    std::optional<std::uint32_t> findSeed();
+
+    std::span<const Geometry::Vertex> m_vertices;
+    std::vector<Triangle> m_triangles{};
+    // The triangles of each vertex, as ranges of m_adjacentTriangles.
+    std::vector<std::uint32_t> m_adjacencyOffsets;
+    std::vector<std::uint32_t> m_adjacentTriangles{};
+    std::vector<bool> m_isUsed{};
+    // The meshlet each vertex was last added to.
+    std::vector<std::uint32_t> m_vertexMeshlets;
+    std::uint32_t m_meshletNumber{ 0 };
+    std::uint32_t m_meshletVertexCount{ 0 };
+    std::vector<std::uint32_t> m_meshletTriangles{};
+    glm::vec3 m_seedCentroid{};
+    // The triangles that share a vertex with the current meshlet. May contain used ones.
+    std::vector<std::uint32_t> m_candidates{};
+    // Where findSeed() continues in index order.
+    std::uint32_t m_seedCursor{ 0 };
+};
+
+LodMeshletBuilder::LodMeshletBuilder(
+    std::span<const Geometry::Vertex> vertices, std::span<const std::uint32_t> indices) :
+    m_vertices{ vertices },
+    m_adjacencyOffsets(vertices.size() + 1, 0),
+    m_vertexMeshlets(vertices.size(), s_noMeshlet)
+{
+    m_triangles.reserve(indices.size() / 3);
+    for (auto i{ 0u }; i + 2 < indices.size(); i += 3)
+    {
+        m_triangles.push_back(Triangle{ indices[i], indices[i + 1], indices[i + 2] });
+    }
+    m_isUsed.assign(m_triangles.size(), false);
+
+    // Counting sort of the corners by vertex.
+    for (const auto& triangle : m_triangles)
+    {
+        for (const auto vertex : triangle)
+        {
+            ++m_adjacencyOffsets[vertex + 1];
+        }
+    }
+    for (auto i{ 1u }; i != m_adjacencyOffsets.size(); ++i)
+    {
+        m_adjacencyOffsets[i] += m_adjacencyOffsets[i - 1];
+    }
+    m_adjacentTriangles.resize(m_adjacencyOffsets.back());
+    auto nextSlots{ m_adjacencyOffsets };
+    for (auto i{ 0u }; i != m_triangles.size(); ++i)
+    {
+        for (const auto vertex : m_triangles[i])
+        {
+            m_adjacentTriangles[nextSlots[vertex]++] = i;
+        }
+    }
+}
+
+void LodMeshletBuilder::build(
+    std::span<std::uint32_t> indices, std::uint32_t indexOffset, std::vector<Geometry::Meshlet>& meshlets)
+{
+    std::vector<Triangle> orderedTriangles{};
+    orderedTriangles.reserve(m_triangles.size());
+    while (const auto seed{ findSeed() })
+    {
+        m_meshletVertexCount = 0;
+        m_meshletTriangles.clear();
+        m_candidates.clear();
+        m_seedCentroid = getCentroid(m_vertices, m_triangles[*seed]);
+        addTriangle(*seed);
+        while (m_meshletTriangles.size() != Geometry::s_maxMeshletTriangleCount)
+        {
+            const auto next{ findNextTriangle() };
+            if (!next.has_value())
+            {
+                break;
+            }
+            addTriangle(*next);
+        }
+
+        const auto firstTriangle{ orderedTriangles.size() };
+        for (const auto triangleIndex : m_meshletTriangles)
+        {
+            orderedTriangles.push_back(m_triangles[triangleIndex]);
+        }
+        Geometry::Meshlet meshlet{};
+        meshlet.firstIndex = indexOffset + static_cast<std::uint32_t>(firstTriangle * 3);
+        meshlet.indexCount = static_cast<std::uint32_t>(m_meshletTriangles.size() * 3);
+        computeBounds(m_vertices, std::span{ orderedTriangles }.subspan(firstTriangle), meshlet);
+        meshlets.push_back(meshlet);
+        ++m_meshletNumber;
+    }
+
+    for (auto i{ 0u }; i != orderedTriangles.size(); ++i)
+    {
+        std::ranges::copy(orderedTriangles[i], indices.begin() + i * 3);
+    }
+}
+
+void LodMeshletBuilder::addTriangle(std::uint32_t triangleIndex)
+{
+    m_isUsed[triangleIndex] = true;
+    m_meshletTriangles.push_back(triangleIndex);
+    for (const auto vertex : m_triangles[triangleIndex])
+    {
+        if (m_vertexMeshlets[vertex] == m_meshletNumber)
+        {
+            continue;
+        }
+        m_vertexMeshlets[vertex] = m_meshletNumber;
+        ++m_meshletVertexCount;
+        for (auto i{ m_adjacencyOffsets[vertex] }; i != m_adjacencyOffsets[vertex + 1]; ++i)
+        {
+            if (!m_isUsed[m_adjacentTriangles[i]])
+            {
+                m_candidates.push_back(m_adjacentTriangles[i]);
+            }
+        }
+    }
+}
+
+std::optional<std::uint32_t> LodMeshletBuilder::findNextTriangle()
+{
+    std::erase_if(
+        m_candidates,
+        [this](std::uint32_t triangleIndex)
+        {
+            return m_isUsed[triangleIndex];
+        });
+
+    std::optional<std::uint32_t> best{};
+    auto bestNewVertexCount{ 0u };
+    auto bestDistance{ 0.0f };
+    for (const auto triangleIndex : m_candidates)
+    {
+        const auto& triangle{ m_triangles[triangleIndex] };
+        const auto newVertexCount{ static_cast<std::uint32_t>(std::ranges::count_if(
+            triangle,
+            [this](std::uint32_t vertex)
+            {
+                return m_vertexMeshlets[vertex] != m_meshletNumber;
+            })) };
+        if (m_meshletVertexCount + newVertexCount > Geometry::s_maxMeshletVertexCount)
+        {
+            continue;
+        }
+        const auto offset{ getCentroid(m_vertices, triangle) - m_seedCentroid };
+        const auto distance{ glm::dot(offset, offset) };
+        if (!best.has_value() || newVertexCount < bestNewVertexCount ||
+            (newVertexCount == bestNewVertexCount && distance < bestDistance))
+        {
+            best = triangleIndex;
+            bestNewVertexCount = newVertexCount;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+std::optional<std::uint32_t> LodMeshletBuilder::findSeed()
+{
+    // The candidates left over from the previous meshlet are next to it.
+    for (const auto triangleIndex : m_candidates)
+    {
+        if (!m_isUsed[triangleIndex])
+        {
+            return triangleIndex;
+        }
+    }
+    for (; m_seedCursor != m_triangles.size(); ++m_seedCursor)
+    {
+        if (!m_isUsed[m_seedCursor])
+        {
+            return m_seedCursor;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+void buildMeshlets(Geometry::MeshData& meshData)
+{
+    meshData.meshlets.clear();
+    if (meshData.indices.empty())
+    {
+        return;
+    }
+
+    const std::vector<Geometry::MeshLod> singleLod{ Geometry::MeshLod{
+        /* firstIndex */ 0, /* indexCount */ static_cast<std::uint32_t>(meshData.indices.size()), /* error */ 0.0f } };
+    for (const auto& lod : meshData.lods.empty() ? singleLod : meshData.lods)
+    {
+        const auto lodIndices{ std::span{ meshData.indices }.subspan(lod.firstIndex, lod.indexCount) };
+        LodMeshletBuilder builder{ meshData.vertices, lodIndices };
+        builder.build(lodIndices, lod.firstIndex, meshData.meshlets);
+    }
+}
+
+} // namespace VkTest1::Tools
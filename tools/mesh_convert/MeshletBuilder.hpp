@@ -0,0 +1,21 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+namespace VkTest1::Tools
+{
+
+//
+// Partitions every LOD of an indexed mesh into meshlets of at most Geometry::s_maxMeshletVertexCount vertices and
+// Geometry::s_maxMeshletTriangleCount triangles, and computes their bounding spheres and normal cones.
+//
+// A meshlet grows from a seed triangle by adding the neighboring triangle that brings in the fewest new vertices, and
+// of those the one closest to the seed. So the meshlets are compact, which keeps their bounds tight and their normal
+// cones narrow.
+//
+// The triangles of each LOD are reordered so that every meshlet is a contiguous range of meshData.indices.
+// Non-indexed meshes are left as they are.
+//
+void buildMeshlets(Geometry::MeshData& meshData);
+
+} // namespace VkTest1::Tools
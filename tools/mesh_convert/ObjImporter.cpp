@@ -0,0 +1,163 @@
+#include "ObjImporter.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+std::string_view nextToken(std::string_view& line)
+{
+    const auto begin{ line.find_first_not_of(" \t\r") };
+    if (begin == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+    line.remove_prefix(begin);
+    const auto end{ std::min(line.find_first_of(" \t\r"), line.size()) };
+    const auto token{ line.substr(0, end) };
+    line.remove_prefix(end);
+    return token;
+}
+
+template<typename T>
+T parseNumber(std::string_view token)
+{
+    T value{};
+    const auto result{ std::from_chars(token.data(), token.data() + token.size(), value) };
+    if (result.ec != std::errc{})
+    {
+        throw Common::FormatError{ "OBJ: Invalid number '" + std::string{ token } + "'." };
+    }
+    return value;
+}
+
+std::uint32_t parseIndex(std::string_view token, std::size_t count)
+{
+    const auto index{ parseNumber<long long>(token) };
+    // OBJ indices are 1 based. Negative indices are relative to the end of the current list.
+    const auto absoluteIndex{ (index < 0) ? static_cast<long long>(count) + index : index - 1 };
+    if (absoluteIndex < 0 || absoluteIndex >= static_cast<long long>(count))
+    {
+        throw Common::FormatError{ "OBJ: Vertex index out of range." };
+    }
+    return static_cast<std::uint32_t>(absoluteIndex);
+}
+
+// A position and a texture coordinate. The texture coordinate is s_noTexCoord if the face didn't give one.
+using VertexReference = std::pair<std::uint32_t, std::uint32_t>;
+
+constexpr std::uint32_t s_noTexCoord{ std::numeric_limits<std::uint32_t>::max() };
+
+// "v", "v/vt", "v//vn" or "v/vt/vn". We only need "v" and "vt".
+VertexReference parseVertexReference(std::string_view token, std::size_t positionCount, std::size_t texCoordCount)
+{
+    const auto firstSlash{ token.find('/') };
+    const auto position{ parseIndex(token.substr(0, firstSlash), positionCount) };
+    if (firstSlash == std::string_view::npos)
+    {
+        return { position, s_noTexCoord };
+    }
+
+    const auto texCoordToken{ token.substr(firstSlash + 1, token.find('/', firstSlash + 1) - firstSlash - 1) };
+    if (texCoordToken.empty())
+    {
+        return { position, s_noTexCoord };
+    }
+    return { position, parseIndex(texCoordToken, texCoordCount) };
+}
+
+} // namespace
+
+Geometry::MeshData importObj(std::istream& stream)
+{
+    // OBJ indexes the positions and the texture coordinates separately. Every distinct pair of them becomes a vertex.
+    std::vector<Geometry::Vertex> positions{};
+    std::vector<Geometry::TexCoord> texCoords{};
+    std::map<VertexReference, std::uint32_t> vertexIndices{};
+
+    Geometry::MeshData meshData{};
+    std::vector<std::uint32_t> polygon{};
+
+    std::string lineBuffer{};
+    while (std::getline(stream, lineBuffer))
+    {
+        std::string_view line{ lineBuffer };
+        const auto keyword{ nextToken(line) };
+
+        if (keyword == "v")
+        {
+            Geometry::Vertex vertex{ /* position */ { 0.0f, 0.0f, 0.0f }, /* color */ { 1.0f, 1.0f, 1.0f } };
+            for (auto axis{ 0 }; axis != 3; ++axis)
+            {
+                vertex.position[axis] = parseNumber<float>(nextToken(line));
+            }
+            if (const auto red{ nextToken(line) }; !red.empty())
+            {
+                vertex.color[0] = parseNumber<float>(red);
+                vertex.color[1] = parseNumber<float>(nextToken(line));
+                vertex.color[2] = parseNumber<float>(nextToken(line));
+            }
+            positions.push_back(vertex);
+        }
+        else if (keyword == "vt")
+        {
+            // OBJ has v = 0 at the bottom, Vulkan samples v = 0 at the top row.
+            const auto u{ parseNumber<float>(nextToken(line)) };
+            const auto vToken{ nextToken(line) };
+            const auto v{ vToken.empty() ? 0.0f : parseNumber<float>(vToken) };
+            texCoords.emplace_back(u, 1.0f - v);
+        }
+        else if (keyword == "f")
+        {
+            polygon.clear();
+            for (auto token{ nextToken(line) }; !token.empty(); token = nextToken(line))
+            {
+                const auto reference{ parseVertexReference(token, positions.size(), texCoords.size()) };
+                const auto [it, isNew] = vertexIndices.try_emplace(
+                    reference, static_cast<std::uint32_t>(meshData.vertices.size()));
+                if (isNew)
+                {
+                    auto vertex{ positions[reference.first] };
+                    if (reference.second != s_noTexCoord)
+                    {
+                        vertex.texCoord = texCoords[reference.second];
+                    }
+                    meshData.vertices.push_back(vertex);
+                }
+                polygon.push_back(it->second);
+            }
+            if (polygon.size() < 3)
+            {
+                throw Common::FormatError{ "OBJ: Face with less than 3 vertices." };
+            }
+            for (auto i{ 1u }; i + 1 < polygon.size(); ++i)
+            {
+                meshData.indices.insert(meshData.indices.end(), { polygon[0], polygon[i], polygon[i + 1] });
+            }
+        }
+    }
+
+    if (meshData.indices.empty())
+    {
+        // No faces: The vertices are a non-indexed triangle list.
+        meshData.vertices = std::move(positions);
+    }
+
+    meshData.bounds = Geometry::computeBounds(meshData.vertices);
+    return meshData;
+}
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <istream>
+
+namespace VkTest1::Tools
+{
+
+//
+// Imports a Wavefront OBJ mesh.
+//
+// Supported:
+// - "v x y z [r g b]" positions with the optional (non standard but common) vertex color.
+// - "vt u v" texture coordinates. v is flipped, because OBJ has its origin at the bottom left.
+// - "f" faces with "v", "v/vt", "v//vn" and "v/vt/vn" references, including negative (relative) indices.
+//   Polygons are triangulated as fans.
+//
+// Every distinct position/texture coordinate pair becomes a vertex.
+// Everything else (normals, materials, groups) is ignored.
+//
+Geometry::MeshData importObj(std::istream& stream);
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,369 @@
+#include "PlyImporter.hpp"
+
+#include "common/Errors.hpp"
+
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+enum class ScalarType
+{
+    Int8,
+    Uint8,
+    Int16,
+    Uint16,
+    Int32,
+    Uint32,
+    Float32,
+    Float64
+};
+
+struct Property
+{
+    std::string name;
+    ScalarType type;
+    // Only set for list properties.
+    std::optional<ScalarType> countType{};
+};
+
+struct Element
+{
+    std::string name;
+    std::size_t count;
+    std::vector<Property> properties{};
+};
+
+ScalarType parseScalarType(const std::string& name)
+{
+    static const std::unordered_map<std::string, ScalarType> s_types{
+        { "char", ScalarType::Int8 },       { "int8", ScalarType::Int8 },       { "uchar", ScalarType::Uint8 },
+        { "uint8", ScalarType::Uint8 },     { "short", ScalarType::Int16 },     { "int16", ScalarType::Int16 },
+        { "ushort", ScalarType::Uint16 },   { "uint16", ScalarType::Uint16 },   { "int", ScalarType::Int32 },
+        { "int32", ScalarType::Int32 },     { "uint", ScalarType::Uint32 },     { "uint32", ScalarType::Uint32 },
+        { "float", ScalarType::Float32 },   { "float32", ScalarType::Float32 }, { "double", ScalarType::Float64 },
+        { "float64", ScalarType::Float64 }
+    };
+    const auto it{ s_types.find(name) };
+    if (it == s_types.end())
+    {
+        throw Common::FormatError{ "PLY: Unknown property type '" + name + "'." };
+    }
+    return it->second;
+}
+
+bool isIntegerType(ScalarType type)
+{
+    return type != ScalarType::Float32 && type != ScalarType::Float64;
+}
+
+double getIntegerTypeMax(ScalarType type)
+{
+    switch (type)
+    {
+        case ScalarType::Int8:
+            return 127.0;
+        case ScalarType::Uint8:
+            return 255.0;
+        case ScalarType::Int16:
+            return 32767.0;
+        case ScalarType::Uint16:
+            return 65535.0;
+        case ScalarType::Int32:
+            return 2147483647.0;
+        default:
+            return 4294967295.0;
+    }
+}
+
+template<typename T>
+double readBinary(std::istream& stream)
+{
+    static_assert(std::endian::native == std::endian::little, "Only little endian hosts are supported.");
+    T value{};
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return static_cast<double>(value);
+}
+
+class ValueReader
+{
+public:
+    ValueReader(std::istream& stream, bool isBinary) :
+        m_stream{ stream },
+        m_isBinary{ isBinary }
+    {
+    }
+
+    double read(ScalarType type)
+    {
+        double value{};
+        if (!m_isBinary)
+        {
+            m_stream >> value;
+        }
+        else
+        {
+            switch (type)
+            {
+                case ScalarType::Int8:
+                    value = readBinary<std::int8_t>(m_stream);
+                    break;
+                case ScalarType::Uint8:
+                    value = readBinary<std::uint8_t>(m_stream);
+                    break;
+                case ScalarType::Int16:
+                    value = readBinary<std::int16_t>(m_stream);
+                    break;
+                case ScalarType::Uint16:
+                    value = readBinary<std::uint16_t>(m_stream);
+                    break;
+                case ScalarType::Int32:
+                    value = readBinary<std::int32_t>(m_stream);
+                    break;
+                case ScalarType::Uint32:
+                    value = readBinary<std::uint32_t>(m_stream);
+                    break;
+                case ScalarType::Float32:
+                    value = readBinary<float>(m_stream);
+                    break;
+                case ScalarType::Float64:
+                    value = readBinary<double>(m_stream);
+                    break;
+            }
+        }
+        if (!m_stream)
+        {
+            throw Common::FormatError{ "PLY: Unexpected end of data." };
+        }
+        return value;
+    }
+
+private:
+    std::istream& m_stream;
+    bool m_isBinary;
+};
+
+std::vector<Element> readHeader(std::istream& stream, bool& isBinary)
+{
+    std::string line{};
+    if (!std::getline(stream, line) || line.substr(0, 3) != "ply")
+    {
+        throw Common::FormatError{ "PLY: Missing magic number." };
+    }
+
+    std::vector<Element> elements{};
+    while (std::getline(stream, line))
+    {
+        std::istringstream lineStream{ line };
+        std::string keyword{};
+        lineStream >> keyword;
+
+        if (keyword == "format")
+        {
+            std::string format{};
+            lineStream >> format;
+            if (format == "ascii")
+            {
+                isBinary = false;
+            }
+            else if (format == "binary_little_endian")
+            {
+                isBinary = true;
+            }
+            else
+            {
+                throw Common::FormatError{ "PLY: Unsupported format '" + format + "'." };
+            }
+        }
+        else if (keyword == "element")
+        {
+            Element element{};
+            lineStream >> element.name >> element.count;
+            elements.push_back(std::move(element));
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+            {
+                throw Common::FormatError{ "PLY: Property without element." };
+            }
+            std::string type{};
+            lineStream >> type;
+            Property property{};
+            if (type == "list")
+            {
+                std::string countType{};
+                lineStream >> countType >> type;
+                property.countType = parseScalarType(countType);
+            }
+            property.type = parseScalarType(type);
+            lineStream >> property.name;
+            elements.back().properties.push_back(std::move(property));
+        }
+        else if (keyword == "end_header")
+        {
+            return elements;
+        }
+    }
+    throw Common::FormatError{ "PLY: Missing end_header." };
+}
+
+void readVertices(ValueReader& reader, const Element& element, Geometry::MeshData& meshData)
+{
+    meshData.vertices.reserve(element.count);
+    for (auto i{ 0u }; i != element.count; ++i)
+    {
+        Geometry::Vertex vertex{ /* position */ { 0.0f, 0.0f, 0.0f }, /* color */ { 1.0f, 1.0f, 1.0f } };
+        for (const auto& property : element.properties)
+        {
+            if (property.countType.has_value())
+            {
+                // Skip unknown list properties.
+                const auto count{ static_cast<std::size_t>(reader.read(*property.countType)) };
+                for (auto j{ 0u }; j != count; ++j)
+                {
+                    reader.read(property.type);
+                }
+                continue;
+            }
+
+            const auto value{ reader.read(property.type) };
+            const auto colorScale{ isIntegerType(property.type) ? 1.0 / getIntegerTypeMax(property.type) : 1.0 };
+            if (property.name == "x")
+            {
+                vertex.position[0] = static_cast<float>(value);
+            }
+            else if (property.name == "y")
+            {
+                vertex.position[1] = static_cast<float>(value);
+            }
+            else if (property.name == "z")
+            {
+                vertex.position[2] = static_cast<float>(value);
+            }
+            else if (property.name == "red")
+            {
+                vertex.color[0] = static_cast<float>(value * colorScale);
+            }
+            else if (property.name == "green")
+            {
+                vertex.color[1] = static_cast<float>(value * colorScale);
+            }
+            else if (property.name == "blue")
+            {
+                vertex.color[2] = static_cast<float>(value * colorScale);
+            }
+            else if (property.name == "s" || property.name == "u" || property.name == "texture_u")
+            {
+                vertex.texCoord[0] = static_cast<float>(value);
+            }
+            else if (property.name == "t" || property.name == "v" || property.name == "texture_v")
+            {
+                // PLY has v = 0 at the bottom, like OBJ.
+                vertex.texCoord[1] = 1.0f - static_cast<float>(value);
+            }
+        }
+        meshData.vertices.push_back(vertex);
+    }
+}
+
+void readFaces(ValueReader& reader, const Element& element, Geometry::MeshData& meshData)
+{
+    std::vector<std::uint32_t> polygon{};
+    for (auto i{ 0u }; i != element.count; ++i)
+    {
+        for (const auto& property : element.properties)
+        {
+            if (!property.countType.has_value())
+            {
+                reader.read(property.type);
+                continue;
+            }
+
+            const auto count{ static_cast<std::size_t>(reader.read(*property.countType)) };
+            polygon.clear();
+            for (auto j{ 0u }; j != count; ++j)
+            {
+                polygon.push_back(static_cast<std::uint32_t>(reader.read(property.type)));
+            }
+
+            if (property.name != "vertex_indices" && property.name != "vertex_index")
+            {
+                continue;
+            }
+            if (polygon.size() < 3)
+            {
+                throw Common::FormatError{ "PLY: Face with less than 3 vertices." };
+            }
+            for (auto j{ 1u }; j + 1 < polygon.size(); ++j)
+            {
+                meshData.indices.insert(meshData.indices.end(), { polygon[0], polygon[j], polygon[j + 1] });
+            }
+        }
+    }
+}
+
+void skipElement(ValueReader& reader, const Element& element)
+{
+    for (auto i{ 0u }; i != element.count; ++i)
+    {
+        for (const auto& property : element.properties)
+        {
+            const auto count{ property.countType.has_value()
+                                  ? static_cast<std::size_t>(reader.read(*property.countType))
+                                  : std::size_t{ 1 } };
+            for (auto j{ 0u }; j != count; ++j)
+            {
+                reader.read(property.type);
+            }
+        }
+    }
+}
+
+} // namespace
+
+Geometry::MeshData importPly(std::istream& stream)
+{
+    auto isBinary{ false };
+    const auto elements{ readHeader(stream, isBinary) };
+
+    ValueReader reader{ stream, isBinary };
+    Geometry::MeshData meshData{};
+    for (const auto& element : elements)
+    {
+        if (element.name == "vertex")
+        {
+            readVertices(reader, element, meshData);
+        }
+        else if (element.name == "face")
+        {
+            readFaces(reader, element, meshData);
+        }
+        else
+        {
+            skipElement(reader, element);
+        }
+    }
+
+    for (const auto index : meshData.indices)
+    {
+        if (index >= meshData.vertices.size())
+        {
+            throw Common::FormatError{ "PLY: Vertex index out of range." };
+        }
+    }
+
+    meshData.bounds = Geometry::computeBounds(meshData.vertices);
+    return meshData;
+}
+
+} // namespace VkTest1::Tools
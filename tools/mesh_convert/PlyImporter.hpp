@@ -0,0 +1,23 @@
+#pragma once
+
+#include "geometry/MeshData.hpp"
+
+#include <istream>
+
+namespace VkTest1::Tools
+{
+
+//
+// Imports a Stanford PLY mesh.
+//
+// Supported:
+// - ascii and binary_little_endian encodings.
+// - "vertex" element with x, y, z and the optional red, green, blue properties
+//   (integer colors are normalized to [0, 1]) and the optional s, t (or u, v) texture coordinates.
+// - "face" element with a vertex_indices (or vertex_index) list. Polygons are triangulated as fans.
+//
+// Other elements and properties are skipped. The stream must be opened in binary mode.
+//
+Geometry::MeshData importPly(std::istream& stream);
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,174 @@
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
+#include "ObjImporter.hpp"
+#include "PlyImporter.hpp"
+
+#include "common/Errors.hpp"
+#include "common/JobSystem.hpp"
+#include "geometry/MeshFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace VkTest1;
+
+namespace
+{
+
+// Including the full detail one. Each level halves the triangles, so the last one has 1/128 of them.
+constexpr std::uint32_t s_maxLodCount{ 8 };
+
+std::string toLower(std::string text)
+{
+    std::ranges::transform(
+        text,
+        text.begin(),
+        [](unsigned char c)
+        {
+            return static_cast<char>(std::tolower(c));
+        });
+    return text;
+}
+
+Geometry::MeshData importMesh(const std::filesystem::path& inputPath)
+{
+    std::ifstream stream{ inputPath, std::ios::binary };
+    if (!stream.is_open())
+    {
+        throw Common::IoError{ "Cannot open file." };
+    }
+
+    const auto extension{ toLower(inputPath.extension().string()) };
+    if (extension == ".obj")
+    {
+        return Tools::importObj(stream);
+    }
+    if (extension == ".ply")
+    {
+        return Tools::importPly(stream);
+    }
+    throw Common::FormatError{ "Unsupported file type. Expected .obj or .ply." };
+}
+
+struct ConversionResult
+{
+    std::size_t lodCount;
+    std::size_t meshletCount;
+};
+
+ConversionResult convertMesh(
+    const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, bool generateLods)
+{
+    auto meshData{ importMesh(inputPath) };
+    if (generateLods)
+    {
+        Tools::generateLods(meshData, s_maxLodCount);
+    }
+    Tools::buildMeshlets(meshData);
+    const auto contents{ Geometry::encodeMeshFile(meshData) };
+
+    std::ofstream stream{ outputPath, std::ios::binary };
+    stream.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+    if (!stream.good())
+    {
+        throw Common::IoError{ "Cannot write file." };
+    }
+    return ConversionResult{ std::max<std::size_t>(meshData.lods.size(), 1), meshData.meshlets.size() };
+}
+
+void printUsage()
+{
+    std::println("Usage: mesh_convert [-o <output directory>] [--no-lods] <input.obj|input.ply>...");
+    std::println("Converts each input into a .vtmesh file. By default next to the input file.");
+    std::println("Indexed meshes get up to {} levels of detail unless --no-lods is given.", s_maxLodCount);
+    std::println("Each level of an indexed mesh is split into meshlets for cluster culling.");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::span<char*> args{ argv + 1, static_cast<std::size_t>(argc - 1) };
+
+    std::optional<std::filesystem::path> outputDirectory{};
+    auto generateLods{ true };
+    std::vector<std::filesystem::path> inputPaths{};
+    for (auto i{ 0u }; i != args.size(); ++i)
+    {
+        const std::string_view arg{ args[i] };
+        if (arg == "-o" && i + 1 != args.size())
+        {
+            outputDirectory = args[++i];
+        }
+        else if (arg == "--no-lods")
+        {
+            generateLods = false;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return EXIT_SUCCESS;
+        }
+        else
+        {
+            inputPaths.emplace_back(arg);
+        }
+    }
+
+    if (inputPaths.empty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    // Each input is independent, so they are converted in parallel, one per job. The main thread helps while it
+    // waits, so one worker fewer than cores.
+    Common::JobSystem jobSystem{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+    std::atomic<bool> hasFailed{ false };
+    std::mutex printMutex{};
+
+    jobSystem.parallelFor(
+        0,
+        inputPaths.size(),
+        1,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i{ begin }; i != end; ++i)
+            {
+                const auto& inputPath{ inputPaths[i] };
+                auto outputPath{ outputDirectory.has_value() ? *outputDirectory / inputPath.filename() : inputPath };
+                outputPath.replace_extension(".vtmesh");
+
+                try
+                {
+                    const auto result{ convertMesh(inputPath, outputPath, generateLods) };
+                    const std::scoped_lock lock{ printMutex };
+                    std::println(
+                        "{} -> {} ({} LODs, {} meshlets)",
+                        inputPath.string(),
+                        outputPath.string(),
+                        result.lodCount,
+                        result.meshletCount);
+                }
+                catch (const std::exception& ex)
+                {
+                    hasFailed = true;
+                    const std::scoped_lock lock{ printMutex };
+                    std::println("{}: ERROR: {}", inputPath.string(), ex.what());
+                }
+            }
+        });
+
+    return hasFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,452 @@
+#include "BcEncoder.hpp"
+
+#include "BcKernels.hpp"
+
+#include "common/CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+constexpr auto s_texelCount{ Detail::s_blockTexelCount };
+
+// RGBA in [0, 255].
+using Color = std::array<float, 4>;
+
+using Indices = std::array<std::uint8_t, s_texelCount>;
+
+// The widest kernels that the CPU supports.
+const Detail::BcKernels& findKernels()
+{
+    if (const auto* kernels{ Detail::getAvx2BcKernels() }; kernels != nullptr && Common::isAvx2Supported())
+    {
+        return *kernels;
+    }
+    if (const auto* kernels{ Detail::getSse41BcKernels() }; kernels != nullptr && Common::isSse41Supported())
+    {
+        return *kernels;
+    }
+    return Detail::getScalarBcKernels();
+}
+
+const Detail::BcKernels& getKernels()
+{
+    static const auto& s_kernels{ findKernels() };
+    return s_kernels;
+}
+
+Detail::BlockChannels splitChannels(const TexelBlock& texels)
+{
+    Detail::BlockChannels channels{};
+    for (auto i{ 0u }; i != s_texelCount; ++i)
+    {
+        for (auto c{ 0u }; c != 4; ++c)
+        {
+            channels.channels[c][i] = static_cast<float>(texels[i * 4 + c]);
+        }
+    }
+    return channels;
+}
+
+Color getTexel(const Detail::BlockChannels& texels, std::size_t i)
+{
+    return Color{ texels.channels[0][i], texels.channels[1][i], texels.channels[2][i], texels.channels[3][i] };
+}
+
+float getSquaredDistance(const Color& a, const Color& b, std::size_t channelCount)
+{
+    auto distance{ 0.0f };
+    for (auto c{ 0u }; c != channelCount; ++c)
+    {
+        distance += (a[c] - b[c]) * (a[c] - b[c]);
+    }
+    return distance;
+}
+
+// The endpoints of the segment of the principal axis of the texels that covers all of them.
+std::pair<Color, Color> fitPrincipalAxis(const Detail::BlockChannels& texels, std::size_t channelCount)
+{
+    Color mean{};
+    for (auto i{ 0u }; i != s_texelCount; ++i)
+    {
+        const auto texel{ getTexel(texels, i) };
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            mean[c] += texel[c] / s_texelCount;
+        }
+    }
+
+    std::array<std::array<float, 4>, 4> covariance{};
+    for (auto i{ 0u }; i != s_texelCount; ++i)
+    {
+        const auto texel{ getTexel(texels, i) };
+        for (auto row{ 0u }; row != channelCount; ++row)
+        {
+            for (auto column{ 0u }; column != channelCount; ++column)
+            {
+                covariance[row][column] += (texel[row] - mean[row]) * (texel[column] - mean[column]);
+            }
+        }
+    }
+
+    // Power iteration, starting from the channel with the largest variance. A few steps are enough, the segment
+    // only has to be roughly aligned with the texels.
+    Color axis{};
+    auto largestVariance{ 0u };
+    for (auto c{ 1u }; c != channelCount; ++c)
+    {
+        if (covariance[c][c] > covariance[largestVariance][largestVariance])
+        {
+            largestVariance = c;
+        }
+    }
+    axis[largestVariance] = 1.0f;
+    for (auto iteration{ 0 }; iteration != 8; ++iteration)
+    {
+        Color next{};
+        for (auto row{ 0u }; row != channelCount; ++row)
+        {
+            for (auto column{ 0u }; column != channelCount; ++column)
+            {
+                next[row] += covariance[row][column] * axis[column];
+            }
+        }
+        const auto length{ std::sqrt(getSquaredDistance(next, Color{}, channelCount)) };
+        if (length < std::numeric_limits<float>::epsilon())
+        {
+            // All texels are the same.
+            return { mean, mean };
+        }
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    auto minProjection{ 0.0f };
+    auto maxProjection{ 0.0f };
+    getKernels().projectOntoAxis(texels, mean.data(), axis.data(), channelCount, minProjection, maxProjection);
+
+    Color first{ mean };
+    Color second{ mean };
+    for (auto c{ 0u }; c != channelCount; ++c)
+    {
+        first[c] = std::clamp(mean[c] + minProjection * axis[c], 0.0f, 255.0f);
+        second[c] = std::clamp(mean[c] + maxProjection * axis[c], 0.0f, 255.0f);
+    }
+    return { first, second };
+}
+
+// The endpoints that minimize the squared error for the given indices. weights[index] is the weight of the second
+// endpoint. Returns nothing if the indices don't determine the endpoints (e.g. all are the same).
+std::optional<std::pair<Color, Color>> fitLeastSquares(
+    const Detail::BlockChannels& texels, const Indices& indices, std::span<const float> weights,
+    std::size_t channelCount)
+{
+    auto aa{ 0.0f };
+    auto ab{ 0.0f };
+    auto bb{ 0.0f };
+    Color ax{};
+    Color bx{};
+    for (auto i{ 0u }; i != s_texelCount; ++i)
+    {
+        const auto texel{ getTexel(texels, i) };
+        const auto b{ weights[indices[i]] };
+        const auto a{ 1.0f - b };
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            ax[c] += a * texel[c];
+            bx[c] += b * texel[c];
+        }
+    }
+
+    const auto determinant{ aa * bb - ab * ab };
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return std::nullopt;
+    }
+
+    Color first{};
+    Color second{};
+    for (auto c{ 0u }; c != channelCount; ++c)
+    {
+        first[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+        second[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+    }
+    return std::pair{ first, second };
+}
+
+// Picks the closest palette entry for every texel. Returns the total squared error.
+float chooseIndices(
+    const Detail::BlockChannels& texels, const Detail::Palette& palette, std::size_t paletteSize,
+    std::size_t channelCount, Indices& indices)
+{
+    std::array<float, s_texelCount> errors{};
+    getKernels().chooseIndices(texels, palette, paletteSize, channelCount, indices.data(), errors.data());
+    // In texel order, like the kernels of every instruction set.
+    auto totalError{ 0.0f };
+    for (const auto error : errors)
+    {
+        totalError += error;
+    }
+    return totalError;
+}
+
+//
+// BC1
+//
+
+// Index 2 is 2/3 of the first endpoint and 1/3 of the second one, index 3 the other way round.
+constexpr std::array<float, 4> s_bc1Weights{ 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+std::uint16_t packRgb565(const Color& color)
+{
+    const auto quantize = [](float value, int maxValue)
+    {
+        return static_cast<std::uint16_t>(std::clamp(std::lround(value * maxValue / 255.0f), 0l, long{ maxValue }));
+    };
+    return static_cast<std::uint16_t>(
+        quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 | quantize(color[2], 31));
+}
+
+Color unpackRgb565(std::uint16_t packed)
+{
+    const auto r{ packed >> 11 & 31 };
+    const auto g{ packed >> 5 & 63 };
+    const auto b{ packed & 31 };
+    // The lowest bits repeat the highest ones, so 0 and the maximum map to 0 and 255.
+    return Color{ static_cast<float>(r << 3 | r >> 2),
+                  static_cast<float>(g << 2 | g >> 4),
+                  static_cast<float>(b << 3 | b >> 2),
+                  255.0f };
+}
+
+struct Bc1Block
+{
+    std::uint16_t color0;
+    std::uint16_t color1;
+    Indices indices;
+    float error;
+};
+
+Bc1Block quantizeBc1(const Detail::BlockChannels& texels, const Color& first, const Color& second)
+{
+    Bc1Block block{ packRgb565(first), packRgb565(second), {}, 0.0f };
+    // color0 > color1 selects the 4 color mode. With color0 == color1 the block has a single color, and index 0
+    // is that color in both modes.
+    if (block.color0 < block.color1)
+    {
+        std::swap(block.color0, block.color1);
+    }
+
+    const auto color0{ unpackRgb565(block.color0) };
+    const auto color1{ unpackRgb565(block.color1) };
+    Detail::Palette palette{};
+    const auto paletteSize{ block.color0 == block.color1 ? 1u : 4u };
+    for (auto entry{ 0u }; entry != paletteSize; ++entry)
+    {
+        for (auto c{ 0u }; c != 3; ++c)
+        {
+            palette.colors[entry][c] = color0[c] + (color1[c] - color0[c]) * s_bc1Weights[entry];
+        }
+    }
+    block.error = chooseIndices(texels, palette, paletteSize, 3, block.indices);
+    return block;
+}
+
+//
+// BC7
+//
+
+constexpr std::array<float, 16> s_bc7Weights{ 0 / 64.0f,  4 / 64.0f,  9 / 64.0f,  13 / 64.0f, 17 / 64.0f, 21 / 64.0f,
+                                               26 / 64.0f, 30 / 64.0f, 34 / 64.0f, 38 / 64.0f, 43 / 64.0f, 47 / 64.0f,
+                                               51 / 64.0f, 55 / 64.0f, 60 / 64.0f, 64 / 64.0f };
+constexpr std::array<int, 16> s_bc7IntegerWeights{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct Bc7Endpoint
+{
+    // 7 bits per channel.
+    std::array<std::uint8_t, 4> color;
+    std::uint8_t pBit;
+};
+
+std::array<int, 4> expandEndpoint(const Bc7Endpoint& endpoint)
+{
+    std::array<int, 4> expanded{};
+    for (auto c{ 0u }; c != 4; ++c)
+    {
+        expanded[c] = endpoint.color[c] << 1 | endpoint.pBit;
+    }
+    return expanded;
+}
+
+// Tries both p-bits and keeps the one that gets closer to the color.
+Bc7Endpoint quantizeEndpoint(const Color& color)
+{
+    Bc7Endpoint best{};
+    auto bestError{ std::numeric_limits<float>::max() };
+    for (std::uint8_t pBit{ 0 }; pBit != 2; ++pBit)
+    {
+        Bc7Endpoint endpoint{ {}, pBit };
+        for (auto c{ 0u }; c != 4; ++c)
+        {
+            endpoint.color[c] = static_cast<std::uint8_t>(std::clamp(std::lround((color[c] - pBit) / 2.0f), 0l, 127l));
+        }
+        const auto expanded{ expandEndpoint(endpoint) };
+        auto error{ 0.0f };
+        for (auto c{ 0u }; c != 4; ++c)
+        {
+            error += (expanded[c] - color[c]) * (expanded[c] - color[c]);
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            best = endpoint;
+        }
+    }
+    return best;
+}
+
+struct Bc7Block
+{
+    Bc7Endpoint endpoint0;
+    Bc7Endpoint endpoint1;
+    Indices indices;
+    float error;
+};
+
+Bc7Block quantizeBc7(const Detail::BlockChannels& texels, const Color& first, const Color& second)
+{
+    Bc7Block block{ quantizeEndpoint(first), quantizeEndpoint(second), {}, 0.0f };
+
+    const auto expanded0{ expandEndpoint(block.endpoint0) };
+    const auto expanded1{ expandEndpoint(block.endpoint1) };
+    Detail::Palette palette{};
+    for (auto entry{ 0u }; entry != s_bc7IntegerWeights.size(); ++entry)
+    {
+        const auto weight{ s_bc7IntegerWeights[entry] };
+        for (auto c{ 0u }; c != 4; ++c)
+        {
+            palette.colors[entry][c] =
+                static_cast<float>(((64 - weight) * expanded0[c] + weight * expanded1[c] + 32) >> 6);
+        }
+    }
+    block.error = chooseIndices(texels, palette, s_bc7IntegerWeights.size(), 4, block.indices);
+    return block;
+}
+
+class BitWriter
+{
+public:
+    explicit BitWriter(std::span<std::byte> bytes) :
+        m_bytes{ bytes }
+    {
+    }
+
+    // Least significant bit first.
+    void write(std::uint32_t value, unsigned int bitCount)
+    {
+        for (auto i{ 0u }; i != bitCount; ++i, ++m_position)
+        {
+            if ((value >> i & 1) != 0)
+            {
+                m_bytes[m_position / 8] |= std::byte{ 1 } << (m_position % 8);
+            }
+        }
+    }
+
+private:
+    std::span<std::byte> m_bytes;
+    std::size_t m_position{ 0 };
+};
+
+} // namespace
+
+std::array<std::byte, 8> encodeBc1Block(const TexelBlock& texels)
+{
+    const auto channels{ splitChannels(texels) };
+    const auto [first, second] = fitPrincipalAxis(channels, 3);
+    auto block{ quantizeBc1(channels, first, second) };
+    if (block.color0 != block.color1)
+    {
+        if (const auto refined{ fitLeastSquares(channels, block.indices, s_bc1Weights, 3) })
+        {
+            const auto refinedBlock{ quantizeBc1(channels, refined->first, refined->second) };
+            if (refinedBlock.error < block.error)
+            {
+                block = refinedBlock;
+            }
+        }
+    }
+
+    std::uint32_t indexBits{ 0 };
+    for (auto i{ 0u }; i != s_texelCount; ++i)
+    {
+        indexBits |= std::uint32_t{ block.indices[i] } << (i * 2);
+    }
+
+    std::array<std::byte, 8> encoded{};
+    std::memcpy(encoded.data(), &block.color0, 2);
+    std::memcpy(encoded.data() + 2, &block.color1, 2);
+    std::memcpy(encoded.data() + 4, &indexBits, 4);
+    return encoded;
+}
+
+std::array<std::byte, 16> encodeBc7Block(const TexelBlock& texels)
+{
+    const auto channels{ splitChannels(texels) };
+    const auto [first, second] = fitPrincipalAxis(channels, 4);
+    auto block{ quantizeBc7(channels, first, second) };
+    if (const auto refined{ fitLeastSquares(channels, block.indices, s_bc7Weights, 4) })
+    {
+        const auto refinedBlock{ quantizeBc7(channels, refined->first, refined->second) };
+        if (refinedBlock.error < block.error)
+        {
+            block = refinedBlock;
+        }
+    }
+
+    // The most significant bit of the first index isn't stored, it must be 0. Swapping the endpoints mirrors the
+    // indices.
+    if (block.indices[0] >= 8)
+    {
+        std::swap(block.endpoint0, block.endpoint1);
+        for (auto& index : block.indices)
+        {
+            index = static_cast<std::uint8_t>(15 - index);
+        }
+    }
+
+    std::array<std::byte, 16> encoded{};
+    BitWriter writer{ encoded };
+    // Mode 6 is 6 zero bits and a one.
+    writer.write(1 << 6, 7);
+    for (auto c{ 0u }; c != 4; ++c)
+    {
+        writer.write(block.endpoint0.color[c], 7);
+        writer.write(block.endpoint1.color[c], 7);
+    }
+    writer.write(block.endpoint0.pBit, 1);
+    writer.write(block.endpoint1.pBit, 1);
+    writer.write(block.indices[0], 3);
+    for (auto i{ 1u }; i != s_texelCount; ++i)
+    {
+        writer.write(block.indices[i], 4);
+    }
+    return encoded;
+}
+
+} // namespace VkTest1::Tools
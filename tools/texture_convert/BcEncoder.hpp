@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace VkTest1::Tools
+{
+
+// The 16 texels of a 4x4 block, row by row, 4 bytes (RGBA) each.
+using TexelBlock = std::array<std::uint8_t, 64>;
+
+//
+// BC1: Two RGB565 endpoints and a 2 bit index per texel into the 4 colors interpolated between them.
+// Alpha is dropped.
+//
+// The endpoints are fitted to the principal axis of the block's colors (range fit) and then refined once by least
+// squares for the chosen indices. The refined endpoints are only kept if they are better.
+//
+std::array<std::byte, 8> encodeBc1Block(const TexelBlock& texels);
+
+//
+// BC7, always in mode 6: One subset, two RGBA endpoints with 7 bits per channel plus a shared lowest bit (p-bit)
+// each, and a 4 bit index per texel. Mode 6 is the most versatile single mode, good for color and alpha that vary
+// together. Fitted like BC1.
+//
+// A full BC7 encoder also tries the partitioned modes, which are better for blocks with several distinct colors.
+//
+std::array<std::byte, 16> encodeBc7Block(const TexelBlock& texels);
+
+} // namespace VkTest1::Tools
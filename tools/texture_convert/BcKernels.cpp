@@ -0,0 +1,63 @@
+#include "BcKernels.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace VkTest1::Tools::Detail
+{
+
+namespace
+{
+
+void projectOntoAxis(
+    const BlockChannels& texels, const float* mean, const float* axis, std::size_t channelCount,
+    float& minProjection, float& maxProjection)
+{
+    minProjection = std::numeric_limits<float>::max();
+    maxProjection = std::numeric_limits<float>::lowest();
+    for (auto i{ 0u }; i != s_blockTexelCount; ++i)
+    {
+        auto projection{ 0.0f };
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            projection += (texels.channels[c][i] - mean[c]) * axis[c];
+        }
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+}
+
+void chooseIndices(
+    const BlockChannels& texels, const Palette& palette, std::size_t paletteSize, std::size_t channelCount,
+    std::uint8_t* indices, float* errors)
+{
+    for (auto i{ 0u }; i != s_blockTexelCount; ++i)
+    {
+        auto bestError{ std::numeric_limits<float>::max() };
+        for (auto entry{ 0u }; entry != paletteSize; ++entry)
+        {
+            auto error{ 0.0f };
+            for (auto c{ 0u }; c != channelCount; ++c)
+            {
+                const auto difference{ texels.channels[c][i] - palette.colors[entry][c] };
+                error += difference * difference;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                indices[i] = static_cast<std::uint8_t>(entry);
+            }
+        }
+        errors[i] = bestError;
+    }
+}
+
+} // namespace
+
+const BcKernels& getScalarBcKernels()
+{
+    static constexpr BcKernels s_kernels{ projectOntoAxis, chooseIndices };
+    return s_kernels;
+}
+
+} // namespace VkTest1::Tools::Detail
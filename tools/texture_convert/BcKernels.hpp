@@ -0,0 +1,51 @@
+#pragma once
+
+// Included by the translation units that are compiled with instruction set flags, so it must not pull in inline
+// functions of the standard library: the linker could pick their copy for the whole program.
+#include <cstddef>
+#include <cstdint>
+
+namespace VkTest1::Tools::Detail
+{
+
+constexpr std::size_t s_blockTexelCount{ 16 };
+
+// The 16 texels of a block, channel (RGBA) by channel, in [0, 255].
+struct alignas(32) BlockChannels
+{
+    float channels[4][s_blockTexelCount];
+};
+
+// The colors that the indices of a block choose from, RGBA each.
+struct Palette
+{
+    float colors[16][4];
+};
+
+//
+// The per-texel kernels of the encoder for one instruction set.
+//
+// The vector kernels process several texels at once, but do the same multiplications and additions in the same order
+// as the scalar ones, without fused multiply-add. So every instruction set encodes the same blocks.
+//
+struct BcKernels
+{
+    // The smallest and largest projection of the texels onto the axis through the mean. The first channelCount
+    // channels of mean and axis are used.
+    void (*projectOntoAxis)(
+        const BlockChannels& texels, const float* mean, const float* axis, std::size_t channelCount,
+        float& minProjection, float& maxProjection);
+    // For every texel, the first of the palette colors [0, paletteSize) with the smallest squared distance over the
+    // first channelCount channels, and that distance.
+    void (*chooseIndices)(
+        const BlockChannels& texels, const Palette& palette, std::size_t paletteSize, std::size_t channelCount,
+        std::uint8_t* indices, float* errors);
+};
+
+const BcKernels& getScalarBcKernels();
+// Null if the build has no kernels of the instruction set, e.g. on other architectures. Whether the CPU supports the
+// instruction set is up to the caller.
+const BcKernels* getSse41BcKernels();
+const BcKernels* getAvx2BcKernels();
+
+} // namespace VkTest1::Tools::Detail
@@ -0,0 +1,108 @@
+#include "BcKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <cfloat>
+
+#include <immintrin.h>
+
+namespace VkTest1::Tools::Detail
+{
+
+namespace
+{
+
+constexpr std::size_t s_width{ 8 };
+
+void projectOntoAxis(
+    const BlockChannels& texels, const float* mean, const float* axis, std::size_t channelCount,
+    float& minProjection, float& maxProjection)
+{
+    auto minimum{ _mm256_set1_ps(FLT_MAX) };
+    auto maximum{ _mm256_set1_ps(-FLT_MAX) };
+    for (auto i{ 0u }; i != s_blockTexelCount; i += s_width)
+    {
+        auto projection{ _mm256_setzero_ps() };
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            const auto difference{ _mm256_sub_ps(_mm256_load_ps(texels.channels[c] + i), _mm256_set1_ps(mean[c])) };
+            projection = _mm256_add_ps(projection, _mm256_mul_ps(difference, _mm256_set1_ps(axis[c])));
+        }
+        minimum = _mm256_min_ps(minimum, projection);
+        maximum = _mm256_max_ps(maximum, projection);
+    }
+
+    alignas(32) float minima[s_width];
+    alignas(32) float maxima[s_width];
+    _mm256_store_ps(minima, minimum);
+    _mm256_store_ps(maxima, maximum);
+    minProjection = minima[0];
+    maxProjection = maxima[0];
+    for (auto lane{ 1u }; lane != s_width; ++lane)
+    {
+        minProjection = minima[lane] < minProjection ? minima[lane] : minProjection;
+        maxProjection = maxima[lane] > maxProjection ? maxima[lane] : maxProjection;
+    }
+}
+
+void chooseIndices(
+    const BlockChannels& texels, const Palette& palette, std::size_t paletteSize, std::size_t channelCount,
+    std::uint8_t* indices, float* errors)
+{
+    for (auto i{ 0u }; i != s_blockTexelCount; i += s_width)
+    {
+        __m256 texel[4];
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            texel[c] = _mm256_load_ps(texels.channels[c] + i);
+        }
+
+        auto bestError{ _mm256_set1_ps(FLT_MAX) };
+        // As floats, so the index and the error are selected by the same blend.
+        auto bestIndex{ _mm256_setzero_ps() };
+        for (auto entry{ 0u }; entry != paletteSize; ++entry)
+        {
+            auto error{ _mm256_setzero_ps() };
+            for (auto c{ 0u }; c != channelCount; ++c)
+            {
+                const auto difference{ _mm256_sub_ps(texel[c], _mm256_set1_ps(palette.colors[entry][c])) };
+                error = _mm256_add_ps(error, _mm256_mul_ps(difference, difference));
+            }
+            const auto isBetter{ _mm256_cmp_ps(error, bestError, _CMP_LT_OQ) };
+            bestError = _mm256_blendv_ps(bestError, error, isBetter);
+            bestIndex = _mm256_blendv_ps(bestIndex, _mm256_set1_ps(static_cast<float>(entry)), isBetter);
+        }
+
+        _mm256_storeu_ps(errors + i, bestError);
+        alignas(32) std::int32_t laneIndices[s_width];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), _mm256_cvtps_epi32(bestIndex));
+        for (auto lane{ 0u }; lane != s_width; ++lane)
+        {
+            indices[i + lane] = static_cast<std::uint8_t>(laneIndices[lane]);
+        }
+    }
+}
+
+} // namespace
+
+const BcKernels* getAvx2BcKernels()
+{
+    static constexpr BcKernels s_kernels{ projectOntoAxis, chooseIndices };
+    return &s_kernels;
+}
+
+} // namespace VkTest1::Tools::Detail
+
+#else
+
+namespace VkTest1::Tools::Detail
+{
+
+const BcKernels* getAvx2BcKernels()
+{
+    return nullptr;
+}
+
+} // namespace VkTest1::Tools::Detail
+
+#endif
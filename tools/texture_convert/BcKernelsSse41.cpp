@@ -0,0 +1,108 @@
+#include "BcKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <cfloat>
+
+#include <immintrin.h>
+
+namespace VkTest1::Tools::Detail
+{
+
+namespace
+{
+
+constexpr std::size_t s_width{ 4 };
+
+void projectOntoAxis(
+    const BlockChannels& texels, const float* mean, const float* axis, std::size_t channelCount,
+    float& minProjection, float& maxProjection)
+{
+    auto minimum{ _mm_set1_ps(FLT_MAX) };
+    auto maximum{ _mm_set1_ps(-FLT_MAX) };
+    for (auto i{ 0u }; i != s_blockTexelCount; i += s_width)
+    {
+        auto projection{ _mm_setzero_ps() };
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            const auto difference{ _mm_sub_ps(_mm_load_ps(texels.channels[c] + i), _mm_set1_ps(mean[c])) };
+            projection = _mm_add_ps(projection, _mm_mul_ps(difference, _mm_set1_ps(axis[c])));
+        }
+        minimum = _mm_min_ps(minimum, projection);
+        maximum = _mm_max_ps(maximum, projection);
+    }
+
+    alignas(16) float minima[s_width];
+    alignas(16) float maxima[s_width];
+    _mm_store_ps(minima, minimum);
+    _mm_store_ps(maxima, maximum);
+    minProjection = minima[0];
+    maxProjection = maxima[0];
+    for (auto lane{ 1u }; lane != s_width; ++lane)
+    {
+        minProjection = minima[lane] < minProjection ? minima[lane] : minProjection;
+        maxProjection = maxima[lane] > maxProjection ? maxima[lane] : maxProjection;
+    }
+}
+
+void chooseIndices(
+    const BlockChannels& texels, const Palette& palette, std::size_t paletteSize, std::size_t channelCount,
+    std::uint8_t* indices, float* errors)
+{
+    for (auto i{ 0u }; i != s_blockTexelCount; i += s_width)
+    {
+        __m128 texel[4];
+        for (auto c{ 0u }; c != channelCount; ++c)
+        {
+            texel[c] = _mm_load_ps(texels.channels[c] + i);
+        }
+
+        auto bestError{ _mm_set1_ps(FLT_MAX) };
+        // As floats, so the index and the error are selected by the same blend.
+        auto bestIndex{ _mm_setzero_ps() };
+        for (auto entry{ 0u }; entry != paletteSize; ++entry)
+        {
+            auto error{ _mm_setzero_ps() };
+            for (auto c{ 0u }; c != channelCount; ++c)
+            {
+                const auto difference{ _mm_sub_ps(texel[c], _mm_set1_ps(palette.colors[entry][c])) };
+                error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+            }
+            const auto isBetter{ _mm_cmplt_ps(error, bestError) };
+            bestError = _mm_blendv_ps(bestError, error, isBetter);
+            bestIndex = _mm_blendv_ps(bestIndex, _mm_set1_ps(static_cast<float>(entry)), isBetter);
+        }
+
+        _mm_storeu_ps(errors + i, bestError);
+        alignas(16) std::int32_t laneIndices[s_width];
+        _mm_store_si128(reinterpret_cast<__m128i*>(laneIndices), _mm_cvtps_epi32(bestIndex));
+        for (auto lane{ 0u }; lane != s_width; ++lane)
+        {
+            indices[i + lane] = static_cast<std::uint8_t>(laneIndices[lane]);
+        }
+    }
+}
+
+} // namespace
+
+const BcKernels* getSse41BcKernels()
+{
+    static constexpr BcKernels s_kernels{ projectOntoAxis, chooseIndices };
+    return &s_kernels;
+}
+
+} // namespace VkTest1::Tools::Detail
+
+#else
+
+namespace VkTest1::Tools::Detail
+{
+
+const BcKernels* getSse41BcKernels()
+{
+    return nullptr;
+}
+
+} // namespace VkTest1::Tools::Detail
+
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace VkTest1::Tools
+{
+
+// An uncompressed image, 4 bytes (RGBA) per texel, row by row from the top.
+struct Image
+{
+    std::uint32_t width{ 0 };
+    std::uint32_t height{ 0 };
+    std::vector<std::uint8_t> texels{};
+};
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,189 @@
+#include "NetpbmImporter.hpp"
+
+#include "common/Errors.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+// Larger than any image a GPU can sample.
+constexpr std::uint32_t s_maxImageSize{ 65536 };
+
+struct Header
+{
+    std::uint32_t width{ 0 };
+    std::uint32_t height{ 0 };
+    std::uint32_t depth{ 0 };
+    std::uint32_t maxValue{ 0 };
+};
+
+// The next whitespace separated token of a P5/P6 header. Skips comments.
+std::string readToken(std::istream& stream)
+{
+    std::string token{};
+    while (stream >> token && token.starts_with('#'))
+    {
+        stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    if (!stream)
+    {
+        throw Common::FormatError{ "Netpbm: Unexpected end of header." };
+    }
+    return token;
+}
+
+std::uint32_t readNumber(std::istream& stream)
+{
+    const auto token{ readToken(stream) };
+    try
+    {
+        return static_cast<std::uint32_t>(std::stoul(token));
+    }
+    catch (const std::exception&)
+    {
+        throw Common::FormatError{ "Netpbm: Bad number '" + token + "'." };
+    }
+}
+
+Header readPnmHeader(std::istream& stream, std::uint32_t depth)
+{
+    Header header{};
+    header.width = readNumber(stream);
+    header.height = readNumber(stream);
+    header.maxValue = readNumber(stream);
+    header.depth = depth;
+    // Exactly one whitespace character separates the header from the samples.
+    stream.get();
+    return header;
+}
+
+Header readPamHeader(std::istream& stream)
+{
+    Header header{};
+    std::string tupleType{};
+    for (std::string line{}; std::getline(stream, line);)
+    {
+        const auto separator{ line.find(' ') };
+        const auto key{ line.substr(0, separator) };
+        const auto value{ separator == std::string::npos ? std::string{} : line.substr(separator + 1) };
+        try
+        {
+            if (key == "ENDHDR")
+            {
+                break;
+            }
+            if (key == "WIDTH")
+            {
+                header.width = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (key == "HEIGHT")
+            {
+                header.height = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (key == "DEPTH")
+            {
+                header.depth = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (key == "MAXVAL")
+            {
+                header.maxValue = static_cast<std::uint32_t>(std::stoul(value));
+            }
+        }
+        catch (const std::exception&)
+        {
+            throw Common::FormatError{ "Netpbm: Bad header line '" + line + "'." };
+        }
+        // TUPLTYPE and comments are ignored, the depth says everything that is needed.
+    }
+    if (!stream)
+    {
+        throw Common::FormatError{ "Netpbm: Unexpected end of header." };
+    }
+    return header;
+}
+
+} // namespace
+
+Image importNetpbm(std::istream& stream)
+{
+    std::string magic(2, '\0');
+    stream.read(magic.data(), magic.size());
+    if (!stream)
+    {
+        throw Common::FormatError{ "Netpbm: Too small." };
+    }
+
+    Header header{};
+    if (magic == "P5")
+    {
+        header = readPnmHeader(stream, 1);
+    }
+    else if (magic == "P6")
+    {
+        header = readPnmHeader(stream, 3);
+    }
+    else if (magic == "P7")
+    {
+        stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        header = readPamHeader(stream);
+    }
+    else
+    {
+        throw Common::FormatError{ "Netpbm: Unsupported type. Expected P5, P6 or P7." };
+    }
+
+    if (header.width == 0 || header.height == 0 || header.width > s_maxImageSize || header.height > s_maxImageSize)
+    {
+        throw Common::FormatError{ "Netpbm: Bad size." };
+    }
+    if (header.depth == 0 || header.depth > 4)
+    {
+        throw Common::FormatError{ "Netpbm: Unsupported depth." };
+    }
+    if (header.maxValue == 0 || header.maxValue > 65535)
+    {
+        throw Common::FormatError{ "Netpbm: Bad maximum value." };
+    }
+
+    const auto sampleSize{ header.maxValue > 255 ? 2u : 1u };
+    const auto texelCount{ std::size_t{ header.width } * header.height };
+    std::vector<std::uint8_t> samples(texelCount * header.depth * sampleSize);
+    stream.read(reinterpret_cast<char*>(samples.data()), static_cast<std::streamsize>(samples.size()));
+    if (!stream)
+    {
+        throw Common::FormatError{ "Netpbm: Unexpected end of data." };
+    }
+
+    // Depth 1 and 2 are grey, 3 and 4 are RGB; 2 and 4 have alpha.
+    const auto readSample = [&](std::size_t texel, std::uint32_t channel) -> std::uint8_t
+    {
+        const auto offset{ (texel * header.depth + channel) * sampleSize };
+        // 16 bit samples are big endian.
+        const auto value{ sampleSize == 2 ? std::uint32_t{ samples[offset] } << 8 | samples[offset + 1]
+                                          : std::uint32_t{ samples[offset] } };
+        const auto scaled{ (std::min(value, header.maxValue) * 255 + header.maxValue / 2) / header.maxValue };
+        return static_cast<std::uint8_t>(scaled);
+    };
+    const auto colorChannelCount{ header.depth >= 3 ? 3u : 1u };
+    const auto hasAlpha{ header.depth == 2 || header.depth == 4 };
+
+    Image image{ header.width, header.height, std::vector<std::uint8_t>(texelCount * 4) };
+    for (auto i{ std::size_t{ 0 } }; i != texelCount; ++i)
+    {
+        for (auto c{ 0u }; c != 3; ++c)
+        {
+            image.texels[i * 4 + c] = readSample(i, colorChannelCount == 3 ? c : 0);
+        }
+        image.texels[i * 4 + 3] = hasAlpha ? readSample(i, colorChannelCount) : std::uint8_t{ 255 };
+    }
+    return image;
+}
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include <istream>
+
+namespace VkTest1::Tools
+{
+
+//
+// Imports a Netpbm image.
+//
+// Supported:
+// - P5 (PGM, grey), P6 (PPM, RGB) and P7 (PAM) with GRAYSCALE, GRAYSCALE_ALPHA, RGB and RGB_ALPHA tuples.
+// - 8 and 16 bit samples (any MAXVAL up to 65535). Samples are scaled to 8 bits.
+//
+// Grey is expanded to RGB, a missing alpha is opaque. The stream must be opened in binary mode.
+//
+Image importNetpbm(std::istream& stream);
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,135 @@
+#include "TextureEncoder.hpp"
+
+#include "BcEncoder.hpp"
+
+#include "texture/TextureFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace VkTest1::Tools
+{
+
+namespace
+{
+
+// Texels outside the image repeat the last row or column, so partial blocks don't pull the endpoints away.
+TexelBlock getTexelBlock(const Image& image, std::uint32_t blockX, std::uint32_t blockY)
+{
+    TexelBlock block{};
+    for (auto y{ 0u }; y != 4; ++y)
+    {
+        for (auto x{ 0u }; x != 4; ++x)
+        {
+            const auto imageX{ std::min(blockX * 4 + x, image.width - 1) };
+            const auto imageY{ std::min(blockY * 4 + y, image.height - 1) };
+            std::memcpy(&block[(y * 4 + x) * 4], &image.texels[(std::size_t{ imageY } * image.width + imageX) * 4], 4);
+        }
+    }
+    return block;
+}
+
+void encodeMipLevel(
+    const Image& image, Texture::TextureFormat format, std::byte* destination, Common::JobSystem& jobSystem)
+{
+    if (format == Texture::TextureFormat::Rgba8)
+    {
+        std::memcpy(destination, image.texels.data(), image.texels.size());
+        return;
+    }
+
+    const auto blockSize{ format == Texture::TextureFormat::Bc1 ? 8u : 16u };
+    const auto blockCountX{ (image.width + 3) / 4 };
+    const auto blockCountY{ (image.height + 3) / 4 };
+    // A block row of a large image is plenty of work for a job, and the small mip levels don't matter.
+    jobSystem.parallelFor(
+        0,
+        blockCountY,
+        1,
+        [&](std::size_t rowBegin, std::size_t rowEnd)
+        {
+            for (auto blockY{ static_cast<std::uint32_t>(rowBegin) }; blockY != rowEnd; ++blockY)
+            {
+                for (auto blockX{ 0u }; blockX != blockCountX; ++blockX)
+                {
+                    const auto block{ getTexelBlock(image, blockX, blockY) };
+                    auto* blockDestination{ destination + (std::size_t{ blockY } * blockCountX + blockX) * blockSize };
+                    if (format == Texture::TextureFormat::Bc1)
+                    {
+                        std::memcpy(blockDestination, encodeBc1Block(block).data(), blockSize);
+                    }
+                    else
+                    {
+                        std::memcpy(blockDestination, encodeBc7Block(block).data(), blockSize);
+                    }
+                }
+            }
+        });
+}
+
+} // namespace
+
+Image generateMipLevel(const Image& image)
+{
+    Image mipLevel{ std::max(image.width / 2, 1u), std::max(image.height / 2, 1u), {} };
+    mipLevel.texels.resize(std::size_t{ mipLevel.width } * mipLevel.height * 4);
+
+    // With an odd size, the last source texel joins the last box, which then is 3 wide.
+    const auto getSourceRange = [](std::uint32_t destination, std::uint32_t destinationSize, std::uint32_t sourceSize)
+    {
+        const auto begin{ std::min(destination * 2, sourceSize - 1) };
+        const auto end{ destination + 1 == destinationSize ? sourceSize : std::min(begin + 2, sourceSize) };
+        return std::pair{ begin, end };
+    };
+
+    for (auto y{ 0u }; y != mipLevel.height; ++y)
+    {
+        const auto [beginY, endY] = getSourceRange(y, mipLevel.height, image.height);
+        for (auto x{ 0u }; x != mipLevel.width; ++x)
+        {
+            const auto [beginX, endX] = getSourceRange(x, mipLevel.width, image.width);
+            for (auto c{ 0u }; c != 4; ++c)
+            {
+                auto sum{ 0u };
+                for (auto sourceY{ beginY }; sourceY != endY; ++sourceY)
+                {
+                    for (auto sourceX{ beginX }; sourceX != endX; ++sourceX)
+                    {
+                        sum += image.texels[(std::size_t{ sourceY } * image.width + sourceX) * 4 + c];
+                    }
+                }
+                const auto count{ (endY - beginY) * (endX - beginX) };
+                mipLevel.texels[(std::size_t{ y } * mipLevel.width + x) * 4 + c] =
+                    static_cast<std::uint8_t>((sum + count / 2) / count);
+            }
+        }
+    }
+    return mipLevel;
+}
+
+Texture::TextureData encodeTexture(
+    const Image& image, Texture::TextureFormat format, bool generateMipLevels, Common::JobSystem& jobSystem)
+{
+    Texture::TextureData textureData{};
+    textureData.format = format;
+    textureData.width = image.width;
+    textureData.height = image.height;
+    const auto mipLevelCount{ generateMipLevels ? Texture::getFullMipLevelCount(image.width, image.height) : 1u };
+    textureData.mipLevels = Texture::getMipLevels(
+        format, image.width, image.height, mipLevelCount, Texture::s_textureFileDataAlignment);
+    textureData.data.resize(textureData.mipLevels.back().offset + textureData.mipLevels.back().size);
+
+    // Every level is filtered from the previous one, so the levels are encoded one after the other.
+    auto mipLevel{ image };
+    for (auto i{ 0u }; i != mipLevelCount; ++i)
+    {
+        if (i != 0)
+        {
+            mipLevel = generateMipLevel(mipLevel);
+        }
+        encodeMipLevel(mipLevel, format, textureData.data.data() + textureData.mipLevels[i].offset, jobSystem);
+    }
+    return textureData;
+}
+
+} // namespace VkTest1::Tools
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include "common/JobSystem.hpp"
+#include "texture/TextureData.hpp"
+
+namespace VkTest1::Tools
+{
+
+// Halves the size of the image (rounding down, at least 1) with a box filter. A texel of an odd-sized image's last
+// row or column is averaged into the texel next to it.
+Image generateMipLevel(const Image& image);
+
+// Encodes the image and, if generateMipLevels is set, its full mip chain into the format. The mip levels are laid out
+// as in a texture file. Block rows are encoded in parallel on the job system.
+Texture::TextureData encodeTexture(
+    const Image& image, Texture::TextureFormat format, bool generateMipLevels, Common::JobSystem& jobSystem);
+
+} // namespace VkTest1::Tools
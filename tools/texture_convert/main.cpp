@@ -0,0 +1,179 @@
+#include "NetpbmImporter.hpp"
+#include "TextureEncoder.hpp"
+
+#include "common/Errors.hpp"
+#include "common/JobSystem.hpp"
+#include "texture/TextureFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace VkTest1;
+
+namespace
+{
+
+std::string toLower(std::string text)
+{
+    std::ranges::transform(
+        text,
+        text.begin(),
+        [](unsigned char c)
+        {
+            return static_cast<char>(std::tolower(c));
+        });
+    return text;
+}
+
+std::optional<Texture::TextureFormat> parseFormat(std::string_view name)
+{
+    if (name == "bc1")
+    {
+        return Texture::TextureFormat::Bc1;
+    }
+    if (name == "bc7")
+    {
+        return Texture::TextureFormat::Bc7;
+    }
+    if (name == "rgba8")
+    {
+        return Texture::TextureFormat::Rgba8;
+    }
+    return std::nullopt;
+}
+
+Tools::Image importImage(const std::filesystem::path& inputPath)
+{
+    std::ifstream stream{ inputPath, std::ios::binary };
+    if (!stream.is_open())
+    {
+        throw Common::IoError{ "Cannot open file." };
+    }
+
+    const auto extension{ toLower(inputPath.extension().string()) };
+    if (extension == ".ppm" || extension == ".pgm" || extension == ".pam" || extension == ".pnm")
+    {
+        return Tools::importNetpbm(stream);
+    }
+    throw Common::FormatError{ "Unsupported file type. Expected .ppm, .pgm, .pam or .pnm." };
+}
+
+void convertTexture(
+    const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, Texture::TextureFormat format,
+    bool generateMipLevels, Common::JobSystem& jobSystem)
+{
+    const auto textureData{ Tools::encodeTexture(importImage(inputPath), format, generateMipLevels, jobSystem) };
+    const auto contents{ Texture::encodeTextureFile(textureData) };
+
+    std::ofstream stream{ outputPath, std::ios::binary };
+    stream.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+    if (!stream.good())
+    {
+        throw Common::IoError{ "Cannot write file." };
+    }
+}
+
+void printUsage()
+{
+    std::println("Usage: texture_convert [-o <output directory>] [--format bc1|bc7|rgba8] [--no-mips] <input>...");
+    std::println("Converts each Netpbm input (.ppm, .pgm, .pam) into a .vttex file. By default next to the input file.");
+    std::println("The default format is bc7. bc1 is half the size but drops alpha.");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::span<char*> args{ argv + 1, static_cast<std::size_t>(argc - 1) };
+
+    std::optional<std::filesystem::path> outputDirectory{};
+    auto format{ Texture::TextureFormat::Bc7 };
+    auto generateMipLevels{ true };
+    std::vector<std::filesystem::path> inputPaths{};
+    for (auto i{ 0u }; i != args.size(); ++i)
+    {
+        const std::string_view arg{ args[i] };
+        if (arg == "-o" && i + 1 != args.size())
+        {
+            outputDirectory = args[++i];
+        }
+        else if (arg == "--format" && i + 1 != args.size())
+        {
+            const auto parsedFormat{ parseFormat(args[++i]) };
+            if (!parsedFormat.has_value())
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            format = *parsedFormat;
+        }
+        else if (arg == "--no-mips")
+        {
+            generateMipLevels = false;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return EXIT_SUCCESS;
+        }
+        else
+        {
+            inputPaths.emplace_back(arg);
+        }
+    }
+
+    if (inputPaths.empty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    // Block compression is the expensive part, so the blocks of every input are spread over all cores. The inputs
+    // are converted in parallel too, which keeps the cores busy while small inputs or mip levels are encoded.
+    // The main thread helps while it waits, so one worker fewer than cores.
+    Common::JobSystem jobSystem{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+    std::atomic<bool> hasFailed{ false };
+    std::mutex printMutex{};
+
+    jobSystem.parallelFor(
+        0,
+        inputPaths.size(),
+        1,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i{ begin }; i != end; ++i)
+            {
+                const auto& inputPath{ inputPaths[i] };
+                auto outputPath{ outputDirectory.has_value() ? *outputDirectory / inputPath.filename() : inputPath };
+                outputPath.replace_extension(".vttex");
+
+                try
+                {
+                    const auto startTime{ std::chrono::steady_clock::now() };
+                    convertTexture(inputPath, outputPath, format, generateMipLevels, jobSystem);
+                    const std::chrono::duration<double> duration{ std::chrono::steady_clock::now() - startTime };
+                    const std::scoped_lock lock{ printMutex };
+                    std::println("{} -> {} ({:.2f} s)", inputPath.string(), outputPath.string(), duration.count());
+                }
+                catch (const std::exception& ex)
+                {
+                    hasFailed = true;
+                    const std::scoped_lock lock{ printMutex };
+                    std::println("{}: ERROR: {}", inputPath.string(), ex.what());
+                }
+            }
+        });
+
+    return hasFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+#include "common/Errors.hpp"
+#include "common/FileSystem.hpp"
+#include "geometry/MeshFile.hpp"
+#include "world/WorldFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <print>
+#include <span>
+#include <string_view>
+#include <vector>
+
+using namespace VkTest1;
+
+namespace
+{
+
+struct Input
+{
+    std::filesystem::path path;
+    std::optional<std::uint32_t> texture;
+    Geometry::Position offset;
+};
+
+using Cell = std::array<std::int64_t, 3>;
+
+template<typename T>
+std::optional<T> parseNumber(std::string_view text)
+{
+    T number{};
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (ec != std::errc{} || end != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+    return number;
+}
+
+// "x,y,z"
+std::optional<Geometry::Position> parseOffset(std::string_view text)
+{
+    Geometry::Position offset{};
+    for (auto axis{ 0 }; axis != 3; ++axis)
+    {
+        const auto separator{ axis != 2 ? text.find(',') : text.size() };
+        if (separator == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+        const auto value{ parseNumber<float>(text.substr(0, separator)) };
+        if (!value.has_value())
+        {
+            return std::nullopt;
+        }
+        offset[axis] = *value;
+        text = text.substr(std::min(separator + 1, text.size()));
+    }
+    return offset;
+}
+
+void translate(Geometry::MeshData& meshData, const Geometry::Position& offset)
+{
+    for (auto& vertex : meshData.vertices)
+    {
+        vertex.position += offset;
+    }
+    for (auto& meshlet : meshData.meshlets)
+    {
+        meshlet.center += offset;
+    }
+    meshData.bounds.min += offset;
+    meshData.bounds.max += offset;
+}
+
+// The cell of the grid that holds the center of the bounds.
+Cell getCell(const Geometry::Bounds& bounds, float chunkSize)
+{
+    const auto center{ (bounds.min + bounds.max) * 0.5f };
+    Cell cell{};
+    for (auto axis{ 0 }; axis != 3; ++axis)
+    {
+        cell[axis] = static_cast<std::int64_t>(std::floor(center[axis] / chunkSize));
+    }
+    return cell;
+}
+
+void addBounds(Geometry::Bounds& bounds, const Geometry::Bounds& other)
+{
+    bounds.min = glm::min(bounds.min, other.min);
+    bounds.max = glm::max(bounds.max, other.max);
+}
+
+// False if an input cannot be read. The world is not written then.
+bool buildWorld(std::span<const Input> inputs, const std::filesystem::path& outputPath, float chunkSize)
+{
+    Common::FileSystem fileSystem{};
+    // Ordered by cell, so the chunk order doesn't depend on the order of the inputs.
+    std::map<Cell, World::WorldChunkData> chunks{};
+    for (const auto& input : inputs)
+    {
+        try
+        {
+            auto meshData{ Geometry::decodeMeshFile(fileSystem.readFile(input.path)) };
+            if (meshData.vertices.empty())
+            {
+                throw Common::FormatError{ "The mesh is empty." };
+            }
+            translate(meshData, input.offset);
+            const auto [it, isNew] = chunks.try_emplace(getCell(meshData.bounds, chunkSize));
+            auto& chunk{ it->second };
+            if (isNew)
+            {
+                chunk.bounds = meshData.bounds;
+            }
+            else
+            {
+                addBounds(chunk.bounds, meshData.bounds);
+            }
+            chunk.meshes.push_back(World::WorldChunkData::Mesh{ Geometry::encodeMeshFile(meshData), input.texture });
+        }
+        catch (const std::exception& ex)
+        {
+            std::println("{}: ERROR: {}", input.path.string(), ex.what());
+            return false;
+        }
+    }
+
+    std::vector<World::WorldChunkData> chunkData{};
+    chunkData.reserve(chunks.size());
+    for (auto& [cell, chunk] : chunks)
+    {
+        chunkData.push_back(std::move(chunk));
+    }
+    const auto contents{ World::encodeWorldFile(chunkData) };
+
+    std::ofstream stream{ outputPath, std::ios::binary };
+    stream.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+    if (!stream.good())
+    {
+        throw Common::IoError{ "Cannot write file." };
+    }
+    std::println(
+        "{} meshes in {} chunks -> {} ({} bytes)",
+        inputs.size(),
+        chunkData.size(),
+        outputPath.string(),
+        contents.size());
+    return true;
+}
+
+void printUsage()
+{
+    std::println("Usage: world_build -o <output> [--chunk-size <units>] [--texture <n>|--no-texture]");
+    std::println("                   [--offset <x,y,z>] <input>...");
+    std::println("Packs .vtmesh files into a .vtworld file. Each mesh goes into the chunk of the grid cell that holds");
+    std::println("the center of its bounds; meshes are not split. The default chunk size is 2 units (the clip space).");
+    std::println("--texture, --no-texture and --offset apply to the inputs after them. The texture is the number of a");
+    std::println("--texture of the renderer, the offset moves the mesh.");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::span<char*> args{ argv + 1, static_cast<std::size_t>(argc - 1) };
+
+    std::optional<std::filesystem::path> outputPath{};
+    auto chunkSize{ 2.0f };
+    std::vector<Input> inputs{};
+    // Of the inputs that come next.
+    std::optional<std::uint32_t> texture{};
+    Geometry::Position offset{ 0.0f, 0.0f, 0.0f };
+    for (auto i{ 0u }; i != args.size(); ++i)
+    {
+        const std::string_view arg{ args[i] };
+        const auto hasValue{ i + 1 != args.size() };
+        if (arg == "-o" && hasValue)
+        {
+            outputPath = args[++i];
+        }
+        else if (arg == "--chunk-size" && hasValue)
+        {
+            const auto size{ parseNumber<float>(args[++i]) };
+            if (!size.has_value() || !std::isfinite(*size) || *size <= 0.0f)
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            chunkSize = *size;
+        }
+        else if (arg == "--texture" && hasValue)
+        {
+            texture = parseNumber<std::uint32_t>(args[++i]);
+            if (!texture.has_value() || *texture == World::s_worldNoTexture)
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--no-texture")
+        {
+            texture.reset();
+        }
+        else if (arg == "--offset" && hasValue)
+        {
+            const auto parsedOffset{ parseOffset(args[++i]) };
+            if (!parsedOffset.has_value())
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            offset = *parsedOffset;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return EXIT_SUCCESS;
+        }
+        else if (arg.starts_with("-"))
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            inputs.push_back(Input{ arg, texture, offset });
+        }
+    }
+
+    if (!outputPath.has_value() || inputs.empty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        return buildWorld(inputs, *outputPath, chunkSize) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& ex)
+    {
+        std::println("ERROR: {}", ex.what());
+        return EXIT_FAILURE;
+    }
+}